@@ -0,0 +1,462 @@
+/***************************************************************************
+               skyrender_benchmark.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*
+ * Draws scripted views of the sky map into images, without a display, and reports the time taken by each frame
+ * and by each sky component, and the number of memory allocations of each frame, as JSON.
+ *
+ * The views are read from a JSON array of steps, or a built-in sequence is used. A step is drawn for a number of
+ * frames, moving the focus and the time between frames:
+ *
+ *   [ { "name": "orion", "ra": 83.8, "dec": 5.0, "zoom": 500, "projection": "Lambert", "altAz": false,
+ *       "pan": [ 1.0, 0.0 ], "timeStep": 0, "frames": 20 } ]
+ *
+ * ra, dec and pan are in degrees, zoom in pixels per radian as Options::zoomFactor(), timeStep in seconds and
+ * projection is one of Projector::Projection.
+ */
+
+/* Project Includes */
+#include "kstarsdata.h"
+#include "Options.h"
+#include "skymap.h"
+#include "skyqpainter.h"
+#include "auxiliary/colorscheme.h"
+#include "projections/projector.h"
+#include "skycomponents/deepstarcomponent.h"
+#include "skycomponents/skylabeler.h"
+#include "skycomponents/skymapcomposite.h"
+#include "skycomponents/starcomponent.h"
+
+#include <KLocalizedString>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaEnum>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<quint64> allocations { 0 };
+}
+
+// Allocations are counted in every thread, the star loader and the concurrent star updates included. Only
+// operator new is replaced, as a whole with its delete: Qt containers allocate with malloc, which is not counted.
+void *operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+struct Step
+{
+    QString name;
+    double ra { 0 };
+    double dec { 0 };
+    double zoom { 1000 };
+    int projection { Projector::Lambert };
+    bool altAz { false };
+    double panRA { 0 };
+    double panDec { 0 };
+    double timeStep { 0 };
+    int frames { 10 };
+};
+
+QString projectionName(int projection)
+{
+    return QMetaEnum::fromType<Projector::Projection>().valueToKey(projection);
+}
+
+QVector<Step> defaultSteps()
+{
+    QVector<Step> steps;
+
+    Step step;
+    step.name = "wide-orion";
+    step.ra   = 83.8;
+    step.dec  = 5.0;
+    step.zoom = MINZOOM;
+    steps.append(step);
+
+    step.name  = "pan-milky-way";
+    step.ra    = 280.0;
+    step.dec   = 0.0;
+    step.zoom  = 600;
+    step.panRA = 2.0;
+    step.frames = 30;
+    steps.append(step);
+
+    step.name  = "zoom-m31";
+    step.ra    = 10.68;
+    step.dec   = 41.27;
+    step.zoom  = 20000;
+    step.panRA = 0.0;
+    step.frames = 10;
+    steps.append(step);
+
+    step.name     = "altaz-time";
+    step.ra       = 83.8;
+    step.dec      = 5.0;
+    step.zoom     = 1000;
+    step.altAz    = true;
+    step.timeStep = 60;
+    step.frames   = 20;
+    steps.append(step);
+
+    // The other projections, in the same view
+    step.altAz    = false;
+    step.timeStep = 0;
+    step.frames   = 10;
+    for (int projection = Projector::AzimuthalEquidistant; projection < Projector::UnknownProjection; projection++)
+    {
+        step.name       = "projection-" + projectionName(projection).toLower();
+        step.projection = projection;
+        steps.append(step);
+    }
+
+    return steps;
+}
+
+bool readSteps(const QString &fileName, QVector<Step> &steps)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Unable to open file: " << fileName;
+        return false;
+    }
+
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (!document.isArray())
+    {
+        qWarning() << "Invalid benchmark script" << fileName << error.errorString();
+        return false;
+    }
+
+    const QMetaEnum projections = QMetaEnum::fromType<Projector::Projection>();
+    for (const QJsonValue &value : document.array())
+    {
+        const QJsonObject object = value.toObject();
+        Step step;
+        step.name     = object.value("name").toString(QString("step-%1").arg(steps.size() + 1));
+        step.ra       = object.value("ra").toDouble(step.ra);
+        step.dec      = object.value("dec").toDouble(step.dec);
+        step.zoom     = object.value("zoom").toDouble(step.zoom);
+        step.altAz    = object.value("altAz").toBool(step.altAz);
+        step.panRA    = object.value("pan").toArray().at(0).toDouble(0);
+        step.panDec   = object.value("pan").toArray().at(1).toDouble(0);
+        step.timeStep = object.value("timeStep").toDouble(step.timeStep);
+        step.frames   = object.value("frames").toInt(step.frames);
+
+        if (object.contains("projection"))
+        {
+            bool ok         = false;
+            step.projection = projections.keyToValue(object.value("projection").toString().toLatin1(), &ok);
+            if (!ok)
+            {
+                qWarning() << "Unknown projection" << object.value("projection").toString() << "in" << step.name;
+                return false;
+            }
+        }
+
+        steps.append(step);
+    }
+
+    return true;
+}
+
+double toMs(qint64 ns)
+{
+    return ns / 1.0e6;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    // Nothing is shown, the sky map is drawn into images
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    // The data and the configuration of KStars are used
+    app.setApplicationName("kstars");
+    KLocalizedString::setApplicationDomain("kstars");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Draws scripted views of the sky map and reports the draw times as JSON");
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption("width", "Width of the sky map", "pixels", "1280"));
+    parser.addOption(QCommandLineOption("height", "Height of the sky map", "pixels", "800"));
+    parser.addOption(QCommandLineOption("script", "JSON array of the steps to draw", "file"));
+    parser.addOption(QCommandLineOption("output", "File of the report, standard output by default", "file"));
+    parser.addOption(QCommandLineOption("date", "Date and time in ISO format", "date", "2017-10-17T22:00:00Z"));
+    parser.addOption(QCommandLineOption("warmup", "Frames drawn and not reported before each step", "frames", "2"));
+    parser.process(app);
+
+    const int width  = parser.value("width").toInt();
+    const int height = parser.value("height").toInt();
+    const int warmup = parser.value("warmup").toInt();
+    if (width <= 0 || height <= 0)
+    {
+        qWarning() << "Invalid size" << parser.value("width") << parser.value("height");
+        return 1;
+    }
+    if (warmup < 1)
+    {
+        qWarning() << "At least one warm-up frame is needed to load the stars of a step";
+        return 1;
+    }
+
+    QVector<Step> steps;
+    if (parser.isSet("script"))
+    {
+        if (!readSteps(parser.value("script"), steps))
+            return 1;
+    }
+    else
+    {
+        steps = defaultSteps();
+    }
+
+    KStarsDateTime date = QDateTime::fromString(parser.value("date"), Qt::ISODate);
+    if (!date.isValid())
+    {
+        qWarning() << "Invalid date" << parser.value("date");
+        return 1;
+    }
+
+    // Same setup as kstars --dump
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+
+    KStarsData *data = KStarsData::Create();
+    if (!data->initialize())
+    {
+        qWarning() << "Could not load the data of KStars";
+        return 1;
+    }
+    data->setLocationFromOptions();
+    data->colorScheme()->loadFromConfig();
+    data->clock()->setUTC(date);
+
+    SkyMap *map = SkyMap::Create();
+    map->resize(width, height);
+
+    data->setFullTimeUpdate();
+    data->updateTime(data->geo());
+
+    const qint64 loadTime = loadTimer.nsecsElapsed();
+
+    SkyMapComposite *skyComposite = data->skyComposite();
+    skyComposite->setDrawProfiling(true);
+
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    QHash<QString, qint64> totalTimes;
+
+    auto drawFrame = [&]() {
+        map->setupProjector();
+
+        SkyQPainter painter(map, &image);
+        painter.begin();
+        painter.setRenderHint(QPainter::Antialiasing, Options::useAntialias());
+        painter.drawSkyBackground();
+        skyComposite->draw(&painter);
+        SkyLabeler::Instance()->draw(painter);
+        painter.end();
+    };
+
+    QJsonArray stepReports;
+    for (const Step &step : steps)
+    {
+        Options::setProjection(step.projection);
+        Options::setUseAltAz(step.altAz);
+        Options::setZoomFactor(step.zoom);
+
+        double ra  = step.ra;
+        double dec = step.dec;
+
+        QJsonArray frameReports;
+        QVector<double> frameTimes;
+
+        for (int frame = -warmup; frame < step.frames; frame++)
+        {
+            // The stars queued by the warm-up frames are loaded before the first reported frame
+            if (frame == 0 && StarComponent::Instance())
+            {
+                for (DeepStarComponent *deepStars : StarComponent::Instance()->deepStarComponents())
+                    deepStars->waitForLoading();
+            }
+
+            // Queued work such as loaded star blocks and textures is taken in between the frames
+            app.processEvents();
+
+            if (frame > 0)
+            {
+                ra  = fmod(ra + step.panRA + 360.0, 360.0);
+                dec = qBound(-90.0, dec + step.panDec, 90.0);
+                if (step.timeStep != 0)
+                {
+                    data->clock()->setUTC(data->ut().addSecs(step.timeStep));
+                    data->updateTime(data->geo());
+                }
+            }
+            map->setFocus(dms(ra), dms(dec));
+            map->setDestination(*map->focus());
+
+            skyComposite->takeDrawTimes();
+
+#ifdef COUNT_DMS_SINCOS_CALLS
+            const unsigned long trigCallsBefore = dms::trig_function_calls;
+#endif
+            const quint64 allocationsBefore = allocations.load();
+            QElapsedTimer frameTimer;
+            frameTimer.start();
+
+            drawFrame();
+
+            const qint64 frameTime       = frameTimer.nsecsElapsed();
+            const quint64 frameAllocations = allocations.load() - allocationsBefore;
+#ifdef COUNT_DMS_SINCOS_CALLS
+            const unsigned long frameTrigCalls = dms::trig_function_calls - trigCallsBefore;
+#endif
+            const QHash<QString, qint64> drawTimes = skyComposite->takeDrawTimes();
+
+            if (frame < 0)
+                continue;
+
+            QJsonObject components;
+            for (auto it = drawTimes.constBegin(); it != drawTimes.constEnd(); ++it)
+            {
+                components.insert(it.key(), toMs(it.value()));
+                totalTimes[it.key()] += it.value();
+            }
+
+            unsigned long dynamicLoad = 0, updateCache = 0, drawUnnamed = 0, visibleStars = 0;
+            if (StarComponent::Instance())
+            {
+                for (DeepStarComponent *deepStars : StarComponent::Instance()->deepStarComponents())
+                {
+                    dynamicLoad += deepStars->dynamicLoadTime();
+                    updateCache += deepStars->updateCacheTime();
+                    drawUnnamed += deepStars->drawUnnamedTime();
+                    visibleStars += deepStars->visibleStars();
+                }
+            }
+
+            QJsonObject unnamedStars;
+            unnamedStars.insert("dynamicLoadMs", double(dynamicLoad));
+            unnamedStars.insert("updateCacheMs", double(updateCache));
+            unnamedStars.insert("drawMs", double(drawUnnamed));
+            unnamedStars.insert("drawn", double(visibleStars));
+
+            QJsonObject frameReport;
+            frameReport.insert("frameMs", toMs(frameTime));
+            frameReport.insert("allocations", double(frameAllocations));
+            frameReport.insert("components", components);
+            frameReport.insert("unnamedStars", unnamedStars);
+#ifdef COUNT_DMS_SINCOS_CALLS
+            frameReport.insert("trigCalls", double(frameTrigCalls));
+#endif
+            frameReports.append(frameReport);
+            frameTimes.append(toMs(frameTime));
+        }
+
+        QJsonObject stepReport;
+        stepReport.insert("name", step.name);
+        stepReport.insert("projection", projectionName(step.projection));
+        stepReport.insert("zoom", step.zoom);
+        stepReport.insert("altAz", step.altAz);
+        stepReport.insert("frames", frameReports);
+
+        if (!frameTimes.isEmpty())
+        {
+            std::sort(frameTimes.begin(), frameTimes.end());
+            double sum = 0;
+            for (double frameTime : frameTimes)
+                sum += frameTime;
+            stepReport.insert("meanFrameMs", sum / frameTimes.size());
+            stepReport.insert("medianFrameMs", frameTimes.at(frameTimes.size() / 2));
+            stepReport.insert("maxFrameMs", frameTimes.last());
+        }
+
+        stepReports.append(stepReport);
+    }
+
+    QJsonObject totals;
+    for (auto it = totalTimes.constBegin(); it != totalTimes.constEnd(); ++it)
+        totals.insert(it.key(), toMs(it.value()));
+
+    QJsonObject report;
+    report.insert("width", width);
+    report.insert("height", height);
+    report.insert("date", date.toString(Qt::ISODate));
+    report.insert("loadMs", toMs(loadTime));
+    report.insert("allocationCounter", QString("operator new"));
+    report.insert("steps", stepReports);
+    report.insert("components", totals);
+
+    const QByteArray json = QJsonDocument(report).toJson();
+    if (parser.isSet("output"))
+    {
+        QFile file(parser.value("output"));
+        if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size())
+        {
+            qWarning() << "Could not write the report to" << file.fileName();
+            return 1;
+        }
+    }
+    else
+    {
+        fwrite(json.constData(), 1, json.size(), stdout);
+    }
+
+    skyComposite->setDrawProfiling(false);
+    delete map;
+    delete data;
+    return 0;
+}
@@ -0,0 +1,196 @@
+/***************************************************************************
+                 test_catalogdb.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_catalogdb.h"
+#include "catalogdata.h"
+#include "catalogentrydata.h"
+#include "kspaths.h"
+
+#include <QSqlQuery>
+
+TestCatalogDB::TestCatalogDB() : QObject()
+{
+}
+
+void TestCatalogDB::initTestCase()
+{
+    // Keep the user database out of the way
+    QStandardPaths::setTestModeEnabled(true);
+    QString path = KSPaths::writableLocation(QStandardPaths::GenericDataLocation);
+    QDir().mkpath(path);
+
+    m_DBFile = path + QString("skycomponents.sqlite");
+    QFile::remove(m_DBFile);
+
+    QVERIFY(m_DB.Initialize());
+    QVERIFY(QFile::exists(m_DBFile));
+}
+
+void TestCatalogDB::cleanupTestCase()
+{
+    QFile::remove(m_DBFile);
+}
+
+int TestCatalogDB::addCatalog(const QString &name)
+{
+    CatalogData catalog;
+    catalog.catalog_name = name;
+    catalog.prefix       = name;
+    m_DB.AddCatalog(catalog);
+    return m_DB.FindCatalog(name);
+}
+
+QList<CatalogEntryData> TestCatalogDB::makeEntries(const QString &catalog, int count, double offset)
+{
+    QList<CatalogEntryData> entries;
+    for (int i = 0; i < count; i++)
+    {
+        CatalogEntryData entry;
+        entry.catalog_name = catalog;
+        entry.ID           = i;
+        entry.long_name    = QString("%1 %2").arg(catalog).arg(i);
+        // 0.05 degrees apart, much more than the matching tolerance
+        entry.ra             = 10.0 + (i % 200) * 0.05 + offset;
+        entry.dec            = -40.0 + (i / 200) * 0.05 + offset;
+        entry.type           = 3;
+        entry.magnitude      = 8.0 + (i % 11) * 0.5;
+        entry.position_angle = 0;
+        entry.major_axis     = 1.5;
+        entry.minor_axis     = 1.0;
+        entry.flux           = 0;
+        entries.append(entry);
+    }
+    return entries;
+}
+
+int TestCatalogDB::count(const QString &query)
+{
+    QSqlDatabase db = QSqlDatabase::database("skydb");
+    QSqlQuery q(db);
+    int result = -1;
+    if (q.exec(query) && q.next())
+        result = q.value(0).toInt();
+    db.close();
+    return result;
+}
+
+void TestCatalogDB::testInvalidEntries()
+{
+    int catid = addCatalog("Invalid");
+    QVERIFY(catid >= 0);
+
+    QList<CatalogEntryData> entries = makeEntries("Invalid", 3, 0);
+    entries[0].ra  = 0.0;
+    entries[1].dec = KSParser::EBROKEN_DOUBLE;
+
+    int dso = count("SELECT COUNT(*) FROM DSO");
+    QCOMPARE(m_DB.AddEntries(entries, catid), 1);
+    QCOMPARE(m_DB.AddEntries(entries, -1), 0);
+    QCOMPARE(count("SELECT COUNT(*) FROM DSO"), dso + 1);
+}
+
+void TestCatalogDB::testFuzzyMatch()
+{
+    const int N = 300;
+    int reference = addCatalog("Reference");
+    int close     = addCatalog("Close");
+    int far       = addCatalog("Far");
+
+    QCOMPARE(m_DB.AddEntries(makeEntries("Reference", N, 0.25), reference), N);
+    int dso = count("SELECT COUNT(*) FROM DSO");
+
+    // Within the tolerance of FindFuzzyEntry(): the existing objects are designated again
+    QList<CatalogEntryData> entries = makeEntries("Close", N, 0.2505);
+    QCOMPARE(m_DB.AddEntries(entries, close), N);
+    QCOMPARE(count("SELECT COUNT(*) FROM DSO"), dso);
+
+    // Same objects as a lookup entry by entry
+    for (int i = 0; i < N; i += 37)
+    {
+        int uid = count(QString("SELECT UID_DSO FROM ObjectDesignation WHERE id_Catalog = %1 AND IDNumber = %2")
+                            .arg(close)
+                            .arg(i));
+        QCOMPARE(uid, m_DB.FindFuzzyEntry(entries[i].ra, entries[i].dec, entries[i].magnitude));
+        QCOMPARE(uid, count(QString("SELECT UID_DSO FROM ObjectDesignation WHERE id_Catalog = %1 AND IDNumber = %2")
+                                .arg(reference)
+                                .arg(i)));
+    }
+
+    // Out of the tolerance: new objects
+    QCOMPARE(m_DB.AddEntries(makeEntries("Far", N, 0.26), far), N);
+    QCOMPARE(count("SELECT COUNT(*) FROM DSO"), dso + N);
+}
+
+void TestCatalogDB::testMatchWithinImport()
+{
+    int catid = addCatalog("Duplicates");
+
+    QList<CatalogEntryData> entries = makeEntries("Duplicates", 2, 0.5);
+    entries[1]           = entries[0];
+    entries[1].ID        = 1;
+    entries[1].ra        = entries[0].ra + 0.001;
+    entries[1].magnitude = entries[0].magnitude + 0.05;
+
+    int dso = count("SELECT COUNT(*) FROM DSO");
+    QCOMPARE(m_DB.AddEntries(entries, catid), 2);
+    QCOMPARE(count("SELECT COUNT(*) FROM DSO"), dso + 1);
+    QCOMPARE(count(QString("SELECT COUNT(DISTINCT UID_DSO) FROM ObjectDesignation WHERE id_Catalog = %1").arg(catid)),
+             1);
+}
+
+void TestCatalogDB::benchmarkImport_data()
+{
+    QTest::addColumn<bool>("bulk");
+    QTest::addColumn<int>("entries");
+    QTest::newRow("1000 entries, one by one") << false << 1000;
+    QTest::newRow("1000 entries, bulk") << true << 1000;
+    QTest::newRow("20000 entries, bulk") << true << 20000;
+}
+
+void TestCatalogDB::benchmarkImport()
+{
+    QFETCH(bool, bulk);
+    QFETCH(int, entries);
+
+    static int run = 0;
+    int added      = 0;
+
+    QBENCHMARK
+    {
+        // A new catalog each time, whose objects match those of the previous runs
+        QString name = QString("Benchmark %1").arg(run++);
+        int catid    = addCatalog(name);
+        QList<CatalogEntryData> catalog = makeEntries(name, entries, -5.0);
+
+        if (bulk)
+            added = m_DB.AddEntries(catalog, catid);
+        else
+        {
+            added = 0;
+            foreach (const CatalogEntryData &entry, catalog)
+            {
+                if (m_DB.AddEntry(entry, catid))
+                    added++;
+            }
+        }
+    }
+
+    QCOMPARE(added, entries);
+}
+
+QTEST_GUILESS_MAIN(TestCatalogDB)
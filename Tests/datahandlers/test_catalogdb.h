@@ -0,0 +1,67 @@
+/***************************************************************************
+                  test_catalogdb.h  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_CATALOGDB_H
+#define TEST_CATALOGDB_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "catalogdb.h"
+
+class CatalogEntryData;
+
+/**
+ * @class TestCatalogDB
+ * @short Checks that a bulk import of a custom catalog matches the same objects as adding entries one at a time,
+ * and benchmarks both
+ */
+
+class TestCatalogDB : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestCatalogDB();
+    ~TestCatalogDB(){};
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testInvalidEntries();
+    void testFuzzyMatch();
+    void testMatchWithinImport();
+
+    void benchmarkImport_data();
+    void benchmarkImport();
+
+  private:
+    /** @short Add a catalog to the database and return its ID */
+    int addCatalog(const QString &name);
+
+    /** @short Entries at pseudo-random positions, all far enough apart not to match each other */
+    QList<CatalogEntryData> makeEntries(const QString &catalog, int count, double offset);
+
+    /** @short Run a single value query on the database */
+    int count(const QString &query);
+
+    CatalogDB m_DB;
+    QString m_DBFile;
+};
+
+#endif
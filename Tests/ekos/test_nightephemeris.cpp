@@ -0,0 +1,97 @@
+/***************************************************************************
+                 test_nightephemeris.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Sat 14 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_nightephemeris.h"
+#include "nightephemeris.h"
+
+#include "dms.h"
+
+#include <cmath>
+
+using Ekos::NightEphemeris;
+
+namespace
+{
+// Altitude in degrees of a point at the given local sidereal time
+double altitude(double ra, double dec, double latitude, double lst)
+{
+    double H = (lst - ra) * 15.0 * dms::DegToRad;
+    double phi = latitude * dms::DegToRad, delta = dec * dms::DegToRad;
+    return asin(sin(phi) * sin(delta) + cos(phi) * cos(delta) * cos(H)) / dms::DegToRad;
+}
+}
+
+TestNightEphemeris::TestNightEphemeris() : QObject()
+{
+}
+
+void TestNightEphemeris::testAltitudeWindows_data()
+{
+    QTest::addColumn<double>("ra");
+    QTest::addColumn<double>("dec");
+    QTest::addColumn<double>("latitude");
+    QTest::addColumn<double>("lst0");
+    QTest::addColumn<double>("minAltitude");
+    QTest::addColumn<double>("from");
+
+    QTest::newRow("M31 from mid-north") << 0.712 << 41.27 << 45.0 << 3.2 << 30.0 << 17.5;
+    QTest::newRow("M42 from the equator") << 5.588 << -5.39 << 0.0 << 20.1 << 15.0 << 0.0;
+    QTest::newRow("Omega Cen from the south") << 13.447 << -47.48 << -33.9 << 11.0 << 40.0 << 22.75;
+    QTest::newRow("low target, high threshold") << 18.0 << -30.0 << 50.0 << 6.0 << 5.0 << 12.0;
+    QTest::newRow("window already open") << 7.0 << 20.0 << 35.0 << 7.5 << 10.0 << 0.25;
+}
+
+void TestNightEphemeris::testAltitudeWindows()
+{
+    QFETCH(double, ra);
+    QFETCH(double, dec);
+    QFETCH(double, latitude);
+    QFETCH(double, lst0);
+    QFETCH(double, minAltitude);
+    QFETCH(double, from);
+
+    QVector<NightEphemeris::Window> windows =
+        NightEphemeris::solveAltitudeWindows(ra, dec, latitude, lst0, minAltitude, from, from + 24);
+
+    // Same scan as Scheduler::calculateAltitudeTime() used to run
+    for (double hour = from; hour < from + 24; hour += 1.0 / 60.0)
+    {
+        bool above  = altitude(ra, dec, latitude, lst0 + hour * NightEphemeris::SiderealRate) > minAltitude;
+        bool inside = false;
+        for (const NightEphemeris::Window &w : windows)
+            inside |= (hour >= w.first && hour < w.second);
+        QCOMPARE(inside, above);
+    }
+
+    for (int i = 1; i < windows.size(); i++)
+        QVERIFY(windows[i - 1].second < windows[i].first);
+}
+
+void TestNightEphemeris::testCircumpolar()
+{
+    // Polaris never sets from mid-northern latitudes, and never rises from the south
+    QVector<NightEphemeris::Window> windows =
+        NightEphemeris::solveAltitudeWindows(2.53, 89.26, 45.0, 0.0, 30.0, 3.0, 27.0);
+    QCOMPARE(windows.size(), 1);
+    QCOMPARE(windows[0].first, 3.0);
+    QCOMPARE(windows[0].second, 27.0);
+
+    QVERIFY(NightEphemeris::solveAltitudeWindows(2.53, 89.26, -45.0, 0.0, 0.0, 3.0, 27.0).isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestNightEphemeris)
@@ -0,0 +1,43 @@
+/***************************************************************************
+                 test_nightephemeris.h  -  KStars Planetarium
+                             -------------------
+    begin                : Sat 14 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_NIGHTEPHEMERIS_H
+#define TEST_NIGHTEPHEMERIS_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+/**
+ * @class TestNightEphemeris
+ * @short Checks the scheduler altitude windows against a one-minute scan of the altitude
+ */
+
+class TestNightEphemeris : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestNightEphemeris();
+    ~TestNightEphemeris(){};
+
+  private slots:
+    void testAltitudeWindows_data();
+    void testAltitudeWindows();
+    void testCircumpolar();
+};
+
+#endif
@@ -0,0 +1,205 @@
+/***************************************************************************
+                  test_fitsbayer.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_fitsbayer.h"
+#include "fitsbayer.h"
+
+#include <random>
+#include <vector>
+
+Q_DECLARE_METATYPE(dc1394bayer_method_t)
+Q_DECLARE_METATYPE(dc1394color_filter_t)
+
+namespace
+{
+template <typename T>
+std::vector<T> makeFrame(int width, int height)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> uniform(0, std::numeric_limits<T>::max());
+
+    std::vector<T> frame(width * height);
+    for (T &value : frame)
+        value = uniform(generator);
+    return frame;
+}
+
+// What FITSData::debayer_8bit() and debayer_16bit() did: decode the whole frame, then split the channels
+template <typename T>
+std::vector<T> serialDebayer(const std::vector<T> &frame, int width, int height, dc1394color_filter_t filter,
+                             dc1394bayer_method_t method)
+{
+    const int size = width * height;
+    std::vector<T> rgb(size * 3, T(0)), planar(size * 3);
+
+    if (FITSBayer::decode(frame.data(), rgb.data(), width, height, filter, method) != DC1394_SUCCESS)
+        return std::vector<T>();
+
+    for (int i = 0; i < size; i++)
+        for (int c = 0; c < 3; c++)
+            planar[size * c + i] = rgb[i * 3 + c];
+    return planar;
+}
+
+template <typename T>
+std::vector<T> bandedDebayer(const std::vector<T> &frame, int width, int height, const BayerParams &params)
+{
+    std::vector<T> planar(width * height * 3);
+    if (FITSBayer::debayer(frame.data(), width, height, params, planar.data()) != DC1394_SUCCESS)
+        return std::vector<T>();
+    return planar;
+}
+
+template <typename T>
+void compareDebayer(int width, int height, dc1394color_filter_t filter, dc1394bayer_method_t method)
+{
+    std::vector<T> frame = makeFrame<T>(width, height);
+
+    BayerParams params;
+    params.method  = method;
+    params.filter  = filter;
+    params.offsetX = params.offsetY = 0;
+
+    std::vector<T> expected = serialDebayer(frame, width, height, filter, method);
+    std::vector<T> banded   = bandedDebayer(frame, width, height, params);
+
+    QVERIFY(expected.empty() == false);
+    QVERIFY(banded == expected);
+}
+}
+
+TestFITSBayer::TestFITSBayer() : QObject()
+{
+}
+
+void TestFITSBayer::testParity_data()
+{
+    QTest::addColumn<dc1394bayer_method_t>("method");
+    QTest::addColumn<dc1394color_filter_t>("filter");
+    QTest::addColumn<int>("bits");
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+
+    // AHD and downsampling run on the whole frame. The dc1394 routines read past odd sized frames, except
+    // nearest neighbor and bilinear which are not theirs anymore.
+    const QList<QPair<dc1394bayer_method_t, QString>> methods = {
+        { DC1394_BAYER_METHOD_NEAREST, "nearest" },    { DC1394_BAYER_METHOD_SIMPLE, "simple" },
+        { DC1394_BAYER_METHOD_BILINEAR, "bilinear" },  { DC1394_BAYER_METHOD_HQLINEAR, "HQ linear" },
+        { DC1394_BAYER_METHOD_EDGESENSE, "edge sense" }, { DC1394_BAYER_METHOD_VNG, "VNG" }
+    };
+    const QStringList filters = { "RGGB", "GBRG", "GRBG", "BGGR" };
+
+    for (const auto &method : methods)
+    {
+        for (int f = 0; f < filters.size(); f++)
+        {
+            dc1394color_filter_t filter = static_cast<dc1394color_filter_t>(DC1394_COLOR_FILTER_MIN + f);
+
+            for (int bits : { 8, 16 })
+            {
+                QString name = QString("%1, %2, %3 bit").arg(method.second, filters[f]).arg(bits);
+                QTest::newRow(name.toLatin1().constData()) << method.first << filter << bits << 602 << 390;
+
+                if (method.first == DC1394_BAYER_METHOD_NEAREST || method.first == DC1394_BAYER_METHOD_BILINEAR)
+                    QTest::newRow((name + ", odd size").toLatin1().constData())
+                        << method.first << filter << bits << 601 << 389;
+            }
+        }
+    }
+}
+
+void TestFITSBayer::testParity()
+{
+    QFETCH(dc1394bayer_method_t, method);
+    QFETCH(dc1394color_filter_t, filter);
+    QFETCH(int, bits);
+    QFETCH(int, width);
+    QFETCH(int, height);
+
+    if (bits == 8)
+        compareDebayer<uint8_t>(width, height, filter, method);
+    else
+        compareDebayer<uint16_t>(width, height, filter, method);
+}
+
+void TestFITSBayer::testOffsets()
+{
+    const int width = 200, height = 130;
+    std::vector<uint16_t> frame = makeFrame<uint16_t>(width, height);
+
+    BayerParams shifted;
+    shifted.method  = DC1394_BAYER_METHOD_VNG;
+    shifted.filter  = DC1394_COLOR_FILTER_RGGB;
+    shifted.offsetX = 1;
+    shifted.offsetY = 1;
+
+    // Skipping a row and a column of RGGB leaves BGGR, without moving the frame
+    BayerParams plain = shifted;
+    plain.filter      = DC1394_COLOR_FILTER_BGGR;
+    plain.offsetX = plain.offsetY = 0;
+
+    QVERIFY(bandedDebayer(frame, width, height, shifted) == bandedDebayer(frame, width, height, plain));
+
+    QCOMPARE(FITSBayer::shiftFilter(DC1394_COLOR_FILTER_RGGB, 1, 0), DC1394_COLOR_FILTER_GRBG);
+    QCOMPARE(FITSBayer::shiftFilter(DC1394_COLOR_FILTER_RGGB, 0, 1), DC1394_COLOR_FILTER_GBRG);
+    QCOMPARE(FITSBayer::shiftFilter(DC1394_COLOR_FILTER_GBRG, 1, 1), DC1394_COLOR_FILTER_GRBG);
+    QCOMPARE(FITSBayer::shiftFilter(DC1394_COLOR_FILTER_BGGR, 2, 0), DC1394_COLOR_FILTER_BGGR);
+}
+
+void TestFITSBayer::benchmarkDebayer_data()
+{
+    QTest::addColumn<dc1394bayer_method_t>("method");
+    QTest::addColumn<bool>("banded");
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+
+    QTest::newRow("24 MP, nearest, serial") << DC1394_BAYER_METHOD_NEAREST << false << 6000 << 4000;
+    QTest::newRow("24 MP, nearest, banded") << DC1394_BAYER_METHOD_NEAREST << true << 6000 << 4000;
+    QTest::newRow("24 MP, bilinear, serial") << DC1394_BAYER_METHOD_BILINEAR << false << 6000 << 4000;
+    QTest::newRow("24 MP, bilinear, banded") << DC1394_BAYER_METHOD_BILINEAR << true << 6000 << 4000;
+    QTest::newRow("6 MP, VNG, serial") << DC1394_BAYER_METHOD_VNG << false << 3000 << 2000;
+    QTest::newRow("6 MP, VNG, banded") << DC1394_BAYER_METHOD_VNG << true << 3000 << 2000;
+}
+
+void TestFITSBayer::benchmarkDebayer()
+{
+    QFETCH(dc1394bayer_method_t, method);
+    QFETCH(bool, banded);
+    QFETCH(int, width);
+    QFETCH(int, height);
+
+    std::vector<uint16_t> frame = makeFrame<uint16_t>(width, height);
+
+    BayerParams params;
+    params.method  = method;
+    params.filter  = DC1394_COLOR_FILTER_RGGB;
+    params.offsetX = params.offsetY = 0;
+
+    std::vector<uint16_t> rgb;
+    QBENCHMARK
+    {
+        if (banded)
+            rgb = bandedDebayer(frame, width, height, params);
+        else
+            rgb = serialDebayer(frame, width, height, params.filter, method);
+    }
+
+    QCOMPARE(rgb.size(), size_t(width * height * 3));
+}
+
+QTEST_GUILESS_MAIN(TestFITSBayer)
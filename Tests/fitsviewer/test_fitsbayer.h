@@ -0,0 +1,47 @@
+/***************************************************************************
+                   test_fitsbayer.h  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_FITSBAYER_H
+#define TEST_FITSBAYER_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+/**
+ * @class TestFITSBayer
+ * @short Checks the banded debayering against the dc1394 routines run on the whole frame, and benchmarks both
+ */
+
+class TestFITSBayer : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestFITSBayer();
+    ~TestFITSBayer(){};
+
+  private slots:
+    void testParity_data();
+    void testParity();
+
+    void testOffsets();
+
+    void benchmarkDebayer_data();
+    void benchmarkDebayer();
+};
+
+#endif
@@ -0,0 +1,253 @@
+/***************************************************************************
+                 test_fitsdisplay.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_fitsdisplay.h"
+#include "fitsdisplay.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+enum SampleType
+{
+    Byte,
+    UnsignedShort,
+    Short,
+    Float,
+    Double
+};
+
+template <typename T>
+std::vector<T> makeFrame(int width, int height, int channels, double low, double high)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> uniform(low, high);
+
+    std::vector<T> frame(width * height * channels);
+    for (T &value : frame)
+        value = static_cast<T>(uniform(generator));
+    return frame;
+}
+
+QImage makeImage(int width, int height, int channels)
+{
+    if (channels == 3)
+        return QImage(width, height, QImage::Format_RGB32);
+
+    QImage image(width, height, QImage::Format_Indexed8);
+    image.setColorCount(256);
+    for (int i = 0; i < 256; i++)
+        image.setColor(i, qRgb(i, i, i));
+    return image;
+}
+
+// The loop of FITSView::rescale() before the conversion was done in parallel. With clamp, the samples are clamped
+// first, as FITSData::applyFilter() did to a copy of the buffer for the auto stretch.
+template <typename T>
+void serialRender(const T *data, int channels, double min, double max, bool clamp, QImage &image)
+{
+    const int width = image.width(), height = image.height();
+    const uint32_t size = width * height;
+    const T low = min, high = max;
+
+    std::vector<T> copy(data, data + size * channels);
+    if (clamp)
+        for (T &value : copy)
+            value = qBound(low, value, high);
+    const T *buffer = copy.data();
+
+    double bscale = 255. / (max - min);
+    double bzero  = (-min) * (255. / (max - min));
+
+    for (int j = 0; j < height; j++)
+    {
+        if (channels == 1)
+        {
+            unsigned char *scanLine = image.scanLine(j);
+            for (int i = 0; i < width; i++)
+                scanLine[i] = qBound(0.0, buffer[j * width + i] * bscale + bzero, 255.0);
+        }
+        else
+        {
+            QRgb *scanLine = reinterpret_cast<QRgb *>(image.scanLine(j));
+            for (int i = 0; i < width; i++)
+                scanLine[i] = qRgb(buffer[j * width + i] * bscale + bzero, buffer[j * width + i + size] * bscale + bzero,
+                                   buffer[j * width + i + size * 2] * bscale + bzero);
+        }
+    }
+}
+
+template <typename T>
+void compareRender(int channels, double min, double max, bool clamp, double low, double high)
+{
+    const int width = 1001, height = 67;
+    std::vector<T> frame = makeFrame<T>(width, height, channels, low, high);
+
+    QImage expected = makeImage(width, height, channels);
+    serialRender(frame.data(), channels, min, max, clamp, expected);
+
+    FITSDisplay::Stretch stretch;
+    stretch.min   = min;
+    stretch.max   = max;
+    stretch.clamp = clamp;
+
+    QImage image = makeImage(width, height, channels);
+    FITSDisplay::render(frame.data(), channels, stretch, image);
+
+    QCOMPARE(image, expected);
+}
+}
+
+TestFITSDisplay::TestFITSDisplay() : QObject()
+{
+}
+
+void TestFITSDisplay::testRender_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<int>("channels");
+    QTest::addColumn<bool>("clamp");
+
+    QTest::newRow("8 bit mono") << int(Byte) << 1 << false;
+    QTest::newRow("16 bit mono") << int(UnsignedShort) << 1 << false;
+    QTest::newRow("16 bit mono, auto stretch") << int(UnsignedShort) << 1 << true;
+    QTest::newRow("signed 16 bit mono, auto stretch") << int(Short) << 1 << true;
+    QTest::newRow("16 bit colour, auto stretch") << int(UnsignedShort) << 3 << true;
+    QTest::newRow("float mono, auto stretch") << int(Float) << 1 << true;
+    QTest::newRow("float colour, auto stretch") << int(Float) << 3 << true;
+    QTest::newRow("double colour") << int(Double) << 3 << false;
+}
+
+void TestFITSDisplay::testRender()
+{
+    QFETCH(int, type);
+    QFETCH(int, channels);
+    QFETCH(bool, clamp);
+
+    // The range of the data for the plain stretch, a narrower one for the auto stretch
+    switch (type)
+    {
+        case Byte:
+            compareRender<uint8_t>(channels, 0, 255, clamp, 0, 255);
+            break;
+        case UnsignedShort:
+            compareRender<uint16_t>(channels, clamp ? 1200.4 : 0, clamp ? 9000.8 : 65535, clamp, 0, 65535);
+            break;
+        case Short:
+            compareRender<int16_t>(channels, -500.5, 3000.2, clamp, -32768, 32767);
+            break;
+        case Float:
+            compareRender<float>(channels, clamp ? 0.1 : 0, clamp ? 0.7 : 1, clamp, 0, 1);
+            break;
+        case Double:
+            compareRender<double>(channels, -10, 10, clamp, -10, 10);
+            break;
+    }
+}
+
+void TestFITSDisplay::testHalve()
+{
+    // Odd sizes, the last row and column are dropped
+    QImage image = makeImage(5, 3, 1);
+    for (int j = 0; j < image.height(); j++)
+        for (int i = 0; i < image.width(); i++)
+            image.scanLine(j)[i] = 10 * j + i;
+
+    QImage half = FITSDisplay::halve(image);
+    QCOMPARE(half.size(), QSize(2, 1));
+    QCOMPARE(half.format(), QImage::Format_Indexed8);
+    QCOMPARE(half.colorTable(), image.colorTable());
+    // (0 + 1 + 10 + 11 + 2) / 4 and (2 + 3 + 12 + 13 + 2) / 4
+    QCOMPARE(int(half.scanLine(0)[0]), 6);
+    QCOMPARE(int(half.scanLine(0)[1]), 8);
+
+    QImage colour = makeImage(2, 2, 3);
+    colour.setPixel(0, 0, qRgb(255, 0, 0));
+    colour.setPixel(1, 0, qRgb(255, 0, 0));
+    colour.setPixel(0, 1, qRgb(0, 0, 100));
+    colour.setPixel(1, 1, qRgb(0, 0, 100));
+
+    half = FITSDisplay::halve(colour);
+    QCOMPARE(half.size(), QSize(1, 1));
+    QCOMPARE(half.pixel(0, 0), qRgb(128, 0, 50));
+}
+
+void TestFITSDisplay::testLevels()
+{
+    QImage image = makeImage(6000, 4000, 1);
+    image.fill(7);
+
+    FITSDisplay::Pyramid pyramid;
+    pyramid.build(image);
+
+    // 3000, 1500, 750, 375, 187 pixels wide
+    QCOMPARE(pyramid.levels(), 5);
+
+    QVERIFY(&pyramid.level(image, 1) == &image);
+    QVERIFY(&pyramid.level(image, 4) == &image);
+    QVERIFY(&pyramid.level(image, 0.6) == &image);
+    QCOMPARE(pyramid.level(image, 0.5).width(), 3000);
+    QCOMPARE(pyramid.level(image, 0.3).width(), 3000);
+    QCOMPARE(pyramid.level(image, 0.25).width(), 1500);
+    QCOMPARE(pyramid.level(image, 0.1).width(), 750);
+    QCOMPARE(pyramid.level(image, 0.01).width(), 187);
+
+    // A uniform image stays uniform
+    const QImage &smallest = pyramid.level(image, 0.01);
+    QCOMPARE(int(smallest.scanLine(smallest.height() - 1)[smallest.width() - 1]), 7);
+
+    pyramid.clear();
+    QCOMPARE(pyramid.levels(), 0);
+    QVERIFY(&pyramid.level(image, 0.1) == &image);
+}
+
+void TestFITSDisplay::benchmarkRender_data()
+{
+    QTest::addColumn<bool>("parallel");
+    QTest::addColumn<int>("channels");
+    QTest::newRow("24 MP mono, serial") << false << 1;
+    QTest::newRow("24 MP mono, parallel") << true << 1;
+    QTest::newRow("24 MP colour, serial") << false << 3;
+    QTest::newRow("24 MP colour, parallel") << true << 3;
+}
+
+void TestFITSDisplay::benchmarkRender()
+{
+    QFETCH(bool, parallel);
+    QFETCH(int, channels);
+
+    const int width = 6000, height = 4000;
+    std::vector<uint16_t> frame = makeFrame<uint16_t>(width, height, channels, 0, 65535);
+    QImage image = makeImage(width, height, channels);
+
+    FITSDisplay::Stretch stretch;
+    stretch.min   = 1200;
+    stretch.max   = 9000;
+    stretch.clamp = true;
+
+    QBENCHMARK
+    {
+        if (parallel)
+            FITSDisplay::render(frame.data(), channels, stretch, image);
+        else
+            serialRender(frame.data(), channels, stretch.min, stretch.max, stretch.clamp, image);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestFITSDisplay)
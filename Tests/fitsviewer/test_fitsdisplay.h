@@ -0,0 +1,49 @@
+/***************************************************************************
+                  test_fitsdisplay.h  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_FITSDISPLAY_H
+#define TEST_FITSDISPLAY_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+/**
+ * @class TestFITSDisplay
+ * @short Checks the parallel conversion of FITS data against the loop FITSView used before, the levels of the
+ * display pyramid, and benchmarks the conversion of a large frame
+ */
+
+class TestFITSDisplay : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestFITSDisplay();
+    ~TestFITSDisplay(){};
+
+  private slots:
+    void testRender_data();
+    void testRender();
+
+    void testHalve();
+    void testLevels();
+
+    void benchmarkRender_data();
+    void benchmarkRender();
+};
+
+#endif
@@ -0,0 +1,253 @@
+/***************************************************************************
+                 test_fitskernels.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Sat 14 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_fitskernels.h"
+#include "fitskernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace
+{
+// Same filter as FITS_LOG in FITSData::applyFilter()
+template <typename T>
+struct LogFilter
+{
+    T min, max;
+    double coeff;
+    T operator()(T value) const
+    {
+        return qBound(min, static_cast<T>(round(coeff * log(1 + qBound(min, value, max)))), max);
+    }
+};
+
+template <typename T>
+LogFilter<T> makeLogFilter(T min, T max)
+{
+    LogFilter<T> filter = { min, max, max / log(1 + max) };
+    return filter;
+}
+
+// The single-threaded Welford loop FITSData used before
+template <typename T>
+void welford(const std::vector<T> &data, double &mean, double &stddev)
+{
+    double m = data[0], s = 0;
+    for (size_t i = 1; i < data.size(); i++)
+    {
+        double next = m + (data[i] - m) / (i + 1);
+        s += (data[i] - m) * (data[i] - next);
+        m = next;
+    }
+    mean   = m;
+    stddev = sqrt(s / (data.size() - 1));
+}
+}
+
+TestFITSKernels::TestFITSKernels() : QObject()
+{
+}
+
+void TestFITSKernels::makeFrames(int width, int height)
+{
+    std::mt19937 generator(42);
+    std::normal_distribution<double> sky(1000.0, 30.0);
+
+    m_Frame16.resize(width * height);
+    m_FrameFloat.resize(width * height);
+    for (int i = 0; i < width * height; i++)
+    {
+        double value = sky(generator);
+        // A few saturated stars
+        if (i % 9973 == 0)
+            value = 65535;
+        m_Frame16[i]    = static_cast<uint16_t>(qBound(0.0, value, 65535.0));
+        m_FrameFloat[i] = static_cast<float>(value / 65535.0);
+    }
+}
+
+void TestFITSKernels::testStatistics()
+{
+    makeFrames(1000, 700);
+
+    double mean, stddev;
+    welford(m_Frame16, mean, stddev);
+    FITSKernels::Statistics s = FITSKernels::statistics(m_Frame16.data(), m_Frame16.size());
+    QCOMPARE(s.count, double(m_Frame16.size()));
+    QVERIFY(fabs(s.mean - mean) < 1e-9 * mean);
+    QVERIFY(fabs(sqrt(s.variance()) - stddev) < 1e-9 * stddev);
+    QCOMPARE(s.min, double(*std::min_element(m_Frame16.begin(), m_Frame16.end())));
+    QCOMPARE(s.max, 65535.0);
+
+    welford(m_FrameFloat, mean, stddev);
+    s = FITSKernels::statistics(m_FrameFloat.data(), m_FrameFloat.size());
+    QVERIFY(fabs(s.mean - mean) < 1e-9 * mean);
+    QVERIFY(fabs(sqrt(s.variance()) - stddev) < 1e-9 * stddev);
+    QCOMPARE(s.min, double(*std::min_element(m_FrameFloat.begin(), m_FrameFloat.end())));
+}
+
+void TestFITSKernels::testTransform()
+{
+    makeFrames(1000, 700);
+
+    // 16-bit data goes through the lookup table, and must match the filter exactly
+    std::vector<uint16_t> frame16 = m_Frame16;
+    LogFilter<uint16_t> filter16  = makeLogFilter<uint16_t>(900, 1200);
+    FITSKernels::Statistics s     = FITSKernels::transform(frame16.data(), frame16.size(), 1000, filter16);
+    for (size_t i = 0; i < frame16.size(); i++)
+        QCOMPARE(frame16[i], filter16(m_Frame16[i]));
+
+    // Statistics are only taken over the requested samples
+    QCOMPARE(s.count, 1000.0);
+    std::vector<uint16_t> head(frame16.begin(), frame16.begin() + 1000);
+    double mean, stddev;
+    welford(head, mean, stddev);
+    QVERIFY(fabs(s.mean - mean) < 1e-9 * mean);
+
+    std::vector<float> frameFloat = m_FrameFloat;
+    LogFilter<float> filterFloat  = makeLogFilter<float>(0.01f, 0.02f);
+    FITSKernels::transform(frameFloat.data(), frameFloat.size(), 0, filterFloat);
+    for (size_t i = 0; i < frameFloat.size(); i++)
+        QCOMPARE(frameFloat[i], filterFloat(m_FrameFloat[i]));
+}
+
+void TestFITSKernels::testSubtractSaturated()
+{
+    makeFrames(1000, 700);
+
+    // Dark frames are brighter than the light frame for about half of the pixels
+    std::vector<uint16_t> dark(m_Frame16.rbegin(), m_Frame16.rend());
+    std::vector<uint16_t> light = m_Frame16;
+    FITSKernels::subtractSaturated(light.data(), dark.data(), light.size());
+    for (size_t i = 0; i < light.size(); i++)
+        QCOMPARE(light[i], static_cast<uint16_t>(m_Frame16[i] > dark[i] ? m_Frame16[i] - dark[i] : 0));
+
+    std::vector<float> darkFloat(m_FrameFloat.rbegin(), m_FrameFloat.rend());
+    std::vector<float> lightFloat = m_FrameFloat;
+    FITSKernels::subtractSaturated(lightFloat.data(), darkFloat.data(), lightFloat.size());
+    for (size_t i = 0; i < lightFloat.size(); i++)
+        QCOMPARE(lightFloat[i], m_FrameFloat[i] > darkFloat[i] ? m_FrameFloat[i] - darkFloat[i] : 0.0f);
+}
+
+void TestFITSKernels::testMedian()
+{
+    const uint32_t count = 200000;
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> value(0, 65535);
+
+    for (int n = 1; n <= 6; n++)
+    {
+        std::vector<std::vector<uint16_t>> frames(n, std::vector<uint16_t>(count));
+        QVector<const uint16_t *> pointers;
+        for (std::vector<uint16_t> &frame : frames)
+        {
+            for (uint16_t &sample : frame)
+                sample = value(generator);
+            pointers.append(frame.data());
+        }
+
+        std::vector<uint16_t> out(count);
+        FITSKernels::median(pointers, out.data(), count);
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            std::vector<int> values;
+            for (const std::vector<uint16_t> &frame : frames)
+                values.push_back(frame[i]);
+            std::sort(values.begin(), values.end());
+            int expected = (n % 2) ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+            QCOMPARE(int(out[i]), expected);
+        }
+    }
+}
+
+void TestFITSKernels::benchmarkStatistics_data()
+{
+    QTest::addColumn<bool>("useFloat");
+    QTest::addColumn<bool>("useKernels");
+    QTest::newRow("16-bit, scalar") << false << false;
+    QTest::newRow("16-bit, kernels") << false << true;
+    QTest::newRow("float, scalar") << true << false;
+    QTest::newRow("float, kernels") << true << true;
+}
+
+void TestFITSKernels::benchmarkStatistics()
+{
+    QFETCH(bool, useFloat);
+    QFETCH(bool, useKernels);
+    makeFrames(3000, 2000);
+
+    double mean = 0, stddev = 0;
+    QBENCHMARK
+    {
+        if (useKernels && useFloat)
+            mean = FITSKernels::statistics(m_FrameFloat.data(), m_FrameFloat.size()).mean;
+        else if (useKernels)
+            mean = FITSKernels::statistics(m_Frame16.data(), m_Frame16.size()).mean;
+        else if (useFloat)
+            welford(m_FrameFloat, mean, stddev);
+        else
+            welford(m_Frame16, mean, stddev);
+    }
+    QVERIFY(mean > 0);
+}
+
+void TestFITSKernels::benchmarkFilter_data()
+{
+    benchmarkStatistics_data();
+}
+
+void TestFITSKernels::benchmarkFilter()
+{
+    QFETCH(bool, useFloat);
+    QFETCH(bool, useKernels);
+    makeFrames(3000, 2000);
+
+    LogFilter<uint16_t> filter16 = makeLogFilter<uint16_t>(900, 1200);
+    LogFilter<float> filterFloat = makeLogFilter<float>(0.01f, 0.02f);
+    std::vector<uint16_t> frame16;
+    std::vector<float> frameFloat;
+    double mean, stddev;
+
+    QBENCHMARK
+    {
+        // Each run filters a fresh copy and updates the statistics, as FITSView does when the stretch changes
+        frame16    = m_Frame16;
+        frameFloat = m_FrameFloat;
+
+        if (useKernels && useFloat)
+            FITSKernels::transform(frameFloat.data(), frameFloat.size(), frameFloat.size(), filterFloat);
+        else if (useKernels)
+            FITSKernels::transform(frame16.data(), frame16.size(), frame16.size(), filter16);
+        else if (useFloat)
+        {
+            for (float &value : frameFloat)
+                value = filterFloat(value);
+            welford(frameFloat, mean, stddev);
+        }
+        else
+        {
+            for (uint16_t &value : frame16)
+                value = filter16(value);
+            welford(frame16, mean, stddev);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestFITSKernels)
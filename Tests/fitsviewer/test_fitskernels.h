@@ -0,0 +1,59 @@
+/***************************************************************************
+                  test_fitskernels.h  -  KStars Planetarium
+                             -------------------
+    begin                : Sat 14 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_FITSKERNELS_H
+#define TEST_FITSKERNELS_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include <vector>
+
+/**
+ * @class TestFITSKernels
+ * @short Checks the FITSKernels statistics, filters, dark subtraction and median against plain loops, and
+ * benchmarks statistics and filters on synthetic 16-bit and float frames
+ */
+
+class TestFITSKernels : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestFITSKernels();
+    ~TestFITSKernels(){};
+
+  private slots:
+    void testStatistics();
+    void testTransform();
+    void testSubtractSaturated();
+    void testMedian();
+
+    void benchmarkStatistics_data();
+    void benchmarkStatistics();
+    void benchmarkFilter_data();
+    void benchmarkFilter();
+
+  private:
+    /** @short Fill the frames with a noisy sky background of the given size */
+    void makeFrames(int width, int height);
+
+    std::vector<uint16_t> m_Frame16;
+    std::vector<float> m_FrameFloat;
+};
+
+#endif
@@ -0,0 +1,334 @@
+/***************************************************************************
+              test_fitsstardetector.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_fitsstardetector.h"
+#include "fitsstardetector.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace
+{
+// Same thresholds as the first pass of FITSData::findCentroid() on a frame that is not diffuse
+const int MinEdgeWidth      = 5;
+const int MinEdgesPerCenter = 3;
+const double Dispersion     = 1.8;
+const double Sigmas         = 1.5;
+
+struct Star
+{
+    float x, y, HFR;
+    int val;
+};
+
+bool lessThan(const Star &s1, const Star &s2)
+{
+    return s1.y < s2.y || (s1.y == s2.y && s1.x < s2.x);
+}
+
+bool greaterThan(Edge *s1, Edge *s2)
+{
+    return s1->sum > s2->sum;
+}
+
+// The serial scan and the quadratic merge FITSData::findCentroid() used before. Ties between edges are sorted
+// stably, as qSort() gave no guarantee on their order.
+QVector<Star> serialStars(const uint16_t *buffer, int width, const QRect &area, double min, double threshold)
+{
+    QList<Edge *> edges;
+    double avg = 0, sum = 0;
+    int starDiameter = 0, pixVal = 0;
+
+    for (int i = area.top(); i <= area.bottom(); i++)
+    {
+        starDiameter = 0;
+
+        for (int j = area.left(); j <= area.right(); j++)
+        {
+            pixVal = buffer[j + (i * width)] - min;
+
+            if (pixVal >= threshold)
+            {
+                avg += j * pixVal;
+                sum += pixVal;
+                starDiameter++;
+            }
+            else if (sum > 0)
+            {
+                if (starDiameter >= MinEdgeWidth)
+                {
+                    float center = avg / sum + 0.5;
+                    if (center > 0)
+                    {
+                        int i_center = floor(center);
+
+                        if (((buffer[i_center + (i * width)] - min) /
+                                 (buffer[i_center + (i * width) - starDiameter / 2] - min) >=
+                             Dispersion) &&
+                            ((buffer[i_center + (i * width)] - min) /
+                                 (buffer[i_center + (i * width) + starDiameter / 2] - min) >=
+                             Dispersion))
+                        {
+                            Edge *newEdge    = new Edge();
+                            newEdge->x       = center;
+                            newEdge->y       = i + 0.5;
+                            newEdge->scanned = 0;
+                            newEdge->val     = buffer[i_center + (i * width)] - min;
+                            newEdge->width   = starDiameter;
+                            newEdge->HFR     = 0;
+                            newEdge->sum     = sum;
+                            edges.append(newEdge);
+                        }
+                    }
+                }
+
+                avg = sum = starDiameter = 0;
+            }
+        }
+    }
+
+    std::stable_sort(edges.begin(), edges.end(), greaterThan);
+
+    QVector<Star> stars;
+    for (int i = 0; i < edges.count(); i++)
+    {
+        if (edges[i]->scanned == 1)
+            continue;
+
+        int cen_v = edges[i]->sum;
+        int cen_w = edges[i]->width;
+        float avg_x = 0, avg_y = 0;
+        int cen_count = 0;
+        sum           = 0;
+
+        for (int j = 0; j < edges.count(); j++)
+        {
+            if (edges[j]->scanned)
+                continue;
+
+            if (FITSStarDetector::collides(*edges[j], *edges[i]))
+            {
+                if (edges[j]->sum >= cen_v)
+                {
+                    cen_v = edges[j]->sum;
+                    cen_w = edges[j]->width;
+                }
+
+                edges[j]->scanned = 1;
+                cen_count++;
+
+                avg_x += edges[j]->x * edges[j]->val;
+                avg_y += edges[j]->y * edges[j]->val;
+                sum += edges[j]->val;
+            }
+        }
+
+        if (cen_count < MinEdgesPerCenter)
+            continue;
+
+        float x = avg_x / sum, y = avg_y / sum;
+        float cen_width = cen_w;
+        int cen_x = floor(x), cen_y = floor(y);
+
+        double FSum = 0;
+        for (int k = cen_width / 2; k >= -(cen_width / 2); k--)
+            FSum += buffer[cen_x - k + (cen_y * width)] - min;
+
+        double HF = FSum / 2.0;
+        double TF = buffer[cen_y * width + cen_x] - min;
+        int pixelCounter = 1;
+
+        for (int k = 1; k < cen_width / 2; k++)
+        {
+            if (TF >= HF)
+                break;
+            TF += buffer[cen_y * width + cen_x + k] - min;
+            TF += buffer[cen_y * width + cen_x - k] - min;
+            pixelCounter++;
+        }
+
+        Star star = { x, y, float(pixelCounter * (HF / TF)), int(FSum) };
+        stars.append(star);
+    }
+
+    qDeleteAll(edges);
+    return stars;
+}
+
+QVector<Star> tiledStars(const uint16_t *buffer, int width, const QRect &area, double min, double threshold)
+{
+    FITSStarDetector::EdgeParameters parameters;
+    parameters.threshold       = threshold;
+    parameters.min             = min;
+    parameters.minEdgeWidth    = MinEdgeWidth;
+    parameters.dispersionRatio = Dispersion;
+    // The serial scan has no limit
+    parameters.maxEdges = std::numeric_limits<int>::max();
+
+    QVector<Edge> edges = FITSStarDetector::findEdges(buffer, width, area, parameters);
+
+    QVector<Star> stars;
+    for (const FITSStarDetector::Center &center : FITSStarDetector::clusterEdges(edges))
+    {
+        if (center.count < MinEdgesPerCenter)
+            continue;
+
+        Edge edge = Edge();
+        edge.x     = center.x;
+        edge.y     = center.y;
+        edge.width = center.width;
+        FITSStarDetector::halfFluxRadius(buffer, width, min, edge);
+
+        Star star = { edge.x, edge.y, edge.HFR, edge.val };
+        stars.append(star);
+    }
+    return stars;
+}
+
+// Flux weighted HFR, as FITSData::getHFR()
+double averageHFR(const QVector<Star> &stars)
+{
+    double sum = 0, flux = 0;
+    for (const Star &star : stars)
+    {
+        sum += star.val * star.HFR;
+        flux += star.val;
+    }
+    return flux > 0 ? sum / flux : -1;
+}
+}
+
+TestFITSStarDetector::TestFITSStarDetector() : QObject()
+{
+}
+
+void TestFITSStarDetector::makeStarField(int width, int height, int stars)
+{
+    std::mt19937 generator(42);
+    std::normal_distribution<double> sky(1000.0, 20.0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    m_Width  = width;
+    m_Height = height;
+    m_Frame.resize(width * height);
+
+    std::vector<double> frame(width * height);
+    for (double &value : frame)
+        value = sky(generator);
+
+    // Gaussian stars, away from the borders
+    for (int s = 0; s < stars; s++)
+    {
+        double cx    = 20 + uniform(generator) * (width - 40);
+        double cy    = 20 + uniform(generator) * (height - 40);
+        double sigma = 1.2 + uniform(generator) * 1.8;
+        double peak  = 2000 + uniform(generator) * 40000;
+        int radius   = ceil(sigma * 5);
+
+        for (int y = qMax(0, int(cy) - radius); y <= qMin(height - 1, int(cy) + radius); y++)
+            for (int x = qMax(0, int(cx) - radius); x <= qMin(width - 1, int(cx) + radius); x++)
+                frame[x + y * width] +=
+                    peak * exp(-((x - cx) * (x - cx) + (y - cy) * (y - cy)) / (2 * sigma * sigma));
+    }
+
+    double sum = 0, squares = 0;
+    m_Min = 65535;
+    for (int i = 0; i < width * height; i++)
+    {
+        m_Frame[i] = static_cast<uint16_t>(qBound(0.0, frame[i], 65535.0));
+        sum += m_Frame[i];
+        squares += double(m_Frame[i]) * m_Frame[i];
+        m_Min = qMin(m_Min, double(m_Frame[i]));
+    }
+    m_Mean   = sum / m_Frame.size();
+    m_StdDev = sqrt(squares / m_Frame.size() - m_Mean * m_Mean);
+}
+
+void TestFITSStarDetector::testParity_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<int>("stars");
+    QTest::newRow("guide frame") << 640 << 480 << 20;
+    QTest::newRow("focus frame") << 1600 << 1200 << 150;
+    QTest::newRow("crowded field") << 1600 << 1200 << 800;
+}
+
+void TestFITSStarDetector::testParity()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(int, stars);
+    makeStarField(width, height, stars);
+
+    double threshold = m_Mean + m_StdDev * Sigmas - m_Min;
+    QRect area(round(width / 15.0), round(height / 15.0), width - 2 * round(width / 15.0),
+               height - 2 * round(height / 15.0));
+
+    QVector<Star> serial = serialStars(m_Frame.data(), width, area, m_Min, threshold);
+    QVector<Star> tiled  = tiledStars(m_Frame.data(), width, area, m_Min, threshold);
+
+    QVERIFY(serial.size() > 0);
+    QCOMPARE(tiled.size(), serial.size());
+
+    std::sort(serial.begin(), serial.end(), lessThan);
+    std::sort(tiled.begin(), tiled.end(), lessThan);
+    for (int i = 0; i < serial.size(); i++)
+    {
+        QCOMPARE(tiled[i].x, serial[i].x);
+        QCOMPARE(tiled[i].y, serial[i].y);
+        QCOMPARE(tiled[i].HFR, serial[i].HFR);
+        QCOMPARE(tiled[i].val, serial[i].val);
+    }
+
+    QCOMPARE(averageHFR(tiled), averageHFR(serial));
+}
+
+void TestFITSStarDetector::benchmarkDetection_data()
+{
+    QTest::addColumn<bool>("tiled");
+    QTest::addColumn<int>("stars");
+    QTest::newRow("24 MP, 300 stars, serial") << false << 300;
+    QTest::newRow("24 MP, 300 stars, tiled") << true << 300;
+    QTest::newRow("24 MP, 1000 stars, serial") << false << 1000;
+    QTest::newRow("24 MP, 1000 stars, tiled") << true << 1000;
+}
+
+void TestFITSStarDetector::benchmarkDetection()
+{
+    QFETCH(bool, tiled);
+    QFETCH(int, stars);
+    makeStarField(6000, 4000, stars);
+
+    double threshold = m_Mean + m_StdDev * Sigmas - m_Min;
+    QRect area(0, 0, m_Width, m_Height);
+    QVector<Star> found;
+
+    QBENCHMARK
+    {
+        if (tiled)
+            found = tiledStars(m_Frame.data(), m_Width, area, m_Min, threshold);
+        else
+            found = serialStars(m_Frame.data(), m_Width, area, m_Min, threshold);
+    }
+
+    QVERIFY(found.size() > 0);
+}
+
+QTEST_GUILESS_MAIN(TestFITSStarDetector)
@@ -0,0 +1,59 @@
+/***************************************************************************
+               test_fitsstardetector.h  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_FITSSTARDETECTOR_H
+#define TEST_FITSSTARDETECTOR_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include <vector>
+
+/**
+ * @class TestFITSStarDetector
+ * @short Checks the tiled star detector against the serial scan FITSData used before, and benchmarks both on
+ * synthetic star fields
+ */
+
+class TestFITSStarDetector : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestFITSStarDetector();
+    ~TestFITSStarDetector(){};
+
+  private slots:
+    void testParity_data();
+    void testParity();
+
+    void benchmarkDetection_data();
+    void benchmarkDetection();
+
+  private:
+    /** @short Fill the frame with a noisy sky background and the given number of stars */
+    void makeStarField(int width, int height, int stars);
+
+    std::vector<uint16_t> m_Frame;
+    int m_Width { 0 };
+    int m_Height { 0 };
+    double m_Mean { 0 };
+    double m_StdDev { 0 };
+    double m_Min { 0 };
+};
+
+#endif
@@ -0,0 +1,163 @@
+/***************************************************************************
+                 test_fitswcsgrid.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_fitswcsgrid.h"
+#include "fitswcsgrid.h"
+
+#include <wcshdr.h>
+
+namespace
+{
+// WCS of a width x height image read from header cards, as FITSData::loadWCS() does
+class TestWCS
+{
+  public:
+    TestWCS(const QStringList &keywords, int width, int height)
+    {
+        QStringList cards = keywords;
+        cards << "NAXIS   = 2" << QString("NAXIS1  = %1").arg(width) << QString("NAXIS2  = %1").arg(height) << "END";
+
+        QByteArray header;
+        for (const QString &card : cards)
+            header += card.leftJustified(80, ' ', true).toLatin1();
+
+        int nreject = 0;
+        if (wcspih(header.data(), cards.size(), WCSHDR_all, 0, &nreject, &m_Count, &m_Wcs) == 0 && m_Wcs)
+            m_Valid = wcsset(m_Wcs) == 0;
+    }
+
+    ~TestWCS()
+    {
+        if (m_Wcs)
+            wcsvfree(&m_Count, &m_Wcs);
+    }
+
+    bool isValid() const { return m_Valid; }
+    wcsprm *wcs() const { return m_Wcs; }
+
+  private:
+    wcsprm *m_Wcs { nullptr };
+    int m_Count { 0 };
+    bool m_Valid { false };
+};
+
+// Angle between two unit vectors, in arcseconds
+double separation(const double v1[3], const double v2[3])
+{
+    double cross[3] = { v1[1] * v2[2] - v1[2] * v2[1], v1[2] * v2[0] - v1[0] * v2[2], v1[0] * v2[1] - v1[1] * v2[0] };
+    double dot      = v1[0] * v2[0] + v1[1] * v2[1] + v1[2] * v2[2];
+    return atan2(sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]), dot) / dms::DegToRad * 3600.0;
+}
+}
+
+TestFITSWCSGrid::TestFITSWCSGrid() : QObject()
+{
+}
+
+void TestFITSWCSGrid::testParity_data()
+{
+    QTest::addColumn<QStringList>("keywords");
+    QTest::addColumn<bool>("linear");
+
+    // 1.5 arcseconds per pixel, rotated by 30 degrees
+    const QStringList tan = { "CTYPE1  = 'RA---TAN'",          "CTYPE2  = 'DEC--TAN'",
+                              "CRPIX1  = 1024.5",              "CRPIX2  = 768.5",
+                              "CD1_1   = -3.6084391824352E-4", "CD1_2   = 2.0833333333333E-4",
+                              "CD2_1   = 2.0833333333333E-4",  "CD2_2   = 3.6084391824352E-4" };
+
+    QTest::newRow("TAN") << (tan + QStringList { "CRVAL1  = 83.82", "CRVAL2  = -5.39" }) << true;
+    QTest::newRow("TAN, RA wrapping around") << (tan + QStringList { "CRVAL1  = 0.05", "CRVAL2  = 20.0" }) << true;
+    QTest::newRow("TAN, celestial pole") << (tan + QStringList { "CRVAL1  = 37.95", "CRVAL2  = 89.26" }) << true;
+
+    // Other projections and TAN with a reference point off the tangent point are left to wcslib
+    QTest::newRow("SIN") << QStringList { "CTYPE1  = 'RA---SIN'",          "CTYPE2  = 'DEC--SIN'",
+                                          "CRPIX1  = 1024.5",              "CRPIX2  = 768.5",
+                                          "CRVAL1  = 83.82",               "CRVAL2  = -5.39",
+                                          "CD1_1   = -3.6084391824352E-4", "CD1_2   = 2.0833333333333E-4",
+                                          "CD2_1   = 2.0833333333333E-4",  "CD2_2   = 3.6084391824352E-4" }
+                         << false;
+    QTest::newRow("TAN, LONPOLE") << (tan + QStringList { "CRVAL1  = 83.82", "CRVAL2  = -5.39", "LONPOLE = 150.0" })
+                                  << false;
+}
+
+void TestFITSWCSGrid::testParity()
+{
+    QFETCH(QStringList, keywords);
+    QFETCH(bool, linear);
+
+    const int width = 2048, height = 1536;
+    TestWCS wcs(keywords, width, height);
+    QVERIFY(wcs.isValid());
+
+    FITSWCSGrid grid;
+    QString error;
+    QVERIFY2(grid.build(wcs.wcs(), width, height, error), error.toLatin1().constData());
+    QCOMPARE(grid.isLinear(), linear);
+
+    // Pixels off the grid points and on the edges, within 0.01 arcseconds of wcslib
+    for (int y = 0; y < height; y += 37)
+    {
+        for (double x : { 0.0, 13.25, 500.5, 1023.0, 1777.75, double(width - 1) })
+        {
+            double v[3], expected[3];
+            QVERIFY(grid.pixelToVector(x, y, v, error));
+            QVERIFY(grid.wcsToVector(x, y, expected, error));
+            if (separation(v, expected) > 0.01)
+                QFAIL(QString("Pixel %1, %2 is %3\" away from wcsp2s")
+                          .arg(x)
+                          .arg(y)
+                          .arg(separation(v, expected))
+                          .toLatin1()
+                          .constData());
+        }
+    }
+
+    double minRA, maxRA, minDec, maxDec;
+    grid.getRange(minRA, maxRA, minDec, maxDec);
+    QVERIFY(minRA <= maxRA);
+    QVERIFY(minDec >= -90.0 && maxDec <= 90.0 && minDec <= maxDec);
+}
+
+void TestFITSWCSGrid::testInvalidPoints()
+{
+    // One degree per pixel over 400 x 400 pixels: the corners are off the Hammer-Aitoff ellipse
+    const int width = 400, height = 400;
+    TestWCS wcs({ "CTYPE1  = 'RA---AIT'", "CTYPE2  = 'DEC--AIT'", "CRPIX1  = 200.5", "CRPIX2  = 200.5",
+                  "CRVAL1  = 0.0", "CRVAL2  = 0.0", "CDELT1  = -1.0", "CDELT2  = 1.0" },
+                width, height);
+    QVERIFY(wcs.isValid());
+
+    // Only the points wcsp2s rejects fail, not the whole grid
+    FITSWCSGrid grid;
+    QString error;
+    QVERIFY2(grid.build(wcs.wcs(), width, height, error), error.toLatin1().constData());
+
+    double v[3], expected[3];
+    QVERIFY(grid.pixelToVector(200, 200, v, error));
+    QVERIFY(grid.wcsToVector(200, 200, expected, error));
+    QVERIFY(separation(v, expected) < 0.01);
+    QVERIFY(grid.pixelToVector(0, 0, v, error) == false);
+
+    // The range only covers the points that were converted
+    double minRA, maxRA, minDec, maxDec;
+    grid.getRange(minRA, maxRA, minDec, maxDec);
+    QVERIFY(minRA <= maxRA);
+    QVERIFY(minDec >= -90.0 && maxDec <= 90.0 && minDec <= maxDec);
+}
+
+QTEST_GUILESS_MAIN(TestFITSWCSGrid)
@@ -0,0 +1,44 @@
+/***************************************************************************
+                  test_fitswcsgrid.h  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_FITSWCSGRID_H
+#define TEST_FITSWCSGRID_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+/**
+ * @class TestFITSWCSGrid
+ * @short Checks the pixel coordinates of FITSWCSGrid against wcsp2s, and the grid points wcsp2s cannot convert
+ */
+
+class TestFITSWCSGrid : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestFITSWCSGrid();
+    ~TestFITSWCSGrid(){};
+
+  private slots:
+    void testParity_data();
+    void testParity();
+
+    void testInvalidPoints();
+};
+
+#endif
@@ -0,0 +1,203 @@
+/***************************************************************************
+                 test_serrecorder.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_serrecorder.h"
+#include "serrecorder.h"
+
+#include <QTemporaryDir>
+
+#include <cstring>
+
+namespace
+{
+qint32 int32At(const QByteArray &data, int offset)
+{
+    qint32 value = 0;
+    QDataStream stream(data.mid(offset, 4));
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream >> value;
+    return value;
+}
+
+qint64 int64At(const QByteArray &data, int offset)
+{
+    qint64 value = 0;
+    QDataStream stream(data.mid(offset, 8));
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream >> value;
+    return value;
+}
+}
+
+TestSERRecorder::TestSERRecorder() : QObject()
+{
+}
+
+void TestSERRecorder::testTime()
+{
+    QCOMPARE(SERRecorder::toSERTime(QDateTime(QDate(1970, 1, 1), QTime(0, 0), Qt::UTC)),
+             Q_INT64_C(621355968000000000));
+    QCOMPARE(SERRecorder::toSERTime(QDateTime(QDate(1, 1, 1), QTime(0, 0), Qt::UTC)), Q_INT64_C(0));
+
+    // Local time is counted in its own time zone
+    QDateTime local(QDate(2017, 10, 17), QTime(22, 30), Qt::OffsetFromUTC, 3 * 3600);
+    QCOMPARE(SERRecorder::toSERTime(local) - SERRecorder::toSERTime(local.toUTC()), Q_INT64_C(3 * 3600 * 10000000));
+}
+
+void TestSERRecorder::testHeader()
+{
+    SERRecorder::Format format;
+    format.width    = 640;
+    format.height   = 480;
+    format.colorID  = SERRecorder::SER_RGB;
+    format.bitDepth = 16;
+
+    QDateTime start(QDate(2017, 10, 17), QTime(22, 30), Qt::UTC);
+    QByteArray header = SERRecorder::header(format, 1234, start, "Observer", "Camera",
+                                            "A telescope with a name longer than forty characters");
+
+    QCOMPARE(header.size(), SERRecorder::HeaderSize);
+    QCOMPARE(header.left(14), QByteArray("LUCAM-RECORDER"));
+    QCOMPARE(int32At(header, 18), 100);
+    QCOMPARE(int32At(header, 22), 0);
+    QCOMPARE(int32At(header, 26), 640);
+    QCOMPARE(int32At(header, 30), 480);
+    QCOMPARE(int32At(header, 34), 16);
+    QCOMPARE(int32At(header, 38), 1234);
+    QCOMPARE(QByteArray(header.constData() + 42), QByteArray("Observer"));
+    QCOMPARE(QByteArray(header.constData() + 82), QByteArray("Camera"));
+    QCOMPARE(header.mid(122, 40), QByteArray("A telescope with a name longer than fort"));
+    QCOMPARE(int64At(header, 162), SERRecorder::toSERTime(start));
+    QCOMPARE(int64At(header, 170), SERRecorder::toSERTime(start));
+}
+
+void TestSERRecorder::testRing()
+{
+    FrameRing ring(2, 16);
+    qint64 timestamp = 0;
+
+    uchar *first = ring.acquire();
+    QVERIFY(first != nullptr);
+    memset(first, 1, 16);
+    ring.commit(10);
+
+    uchar *second = ring.acquire();
+    QVERIFY(second != nullptr && second != first);
+    memset(second, 2, 16);
+    ring.commit(20);
+
+    // Full: the frame is dropped instead of waiting for the consumer
+    QVERIFY(ring.acquire() == nullptr);
+    QCOMPARE(ring.dropped(), 1);
+
+    // Frames are read in place, oldest first
+    const uchar *frame = ring.next(&timestamp);
+    QVERIFY(frame == first);
+    QCOMPARE(timestamp, qint64(10));
+    ring.release();
+
+    QVERIFY(ring.acquire() == first);
+    ring.commit(30);
+
+    QVERIFY(ring.next(&timestamp) == second);
+    QCOMPARE(timestamp, qint64(20));
+    ring.release();
+    QVERIFY(ring.next(&timestamp) == first);
+    QCOMPARE(timestamp, qint64(30));
+    ring.release();
+
+    // Closed and empty
+    ring.close();
+    QVERIFY(ring.next(&timestamp) == nullptr);
+}
+
+void TestSERRecorder::testRecording_data()
+{
+    QTest::addColumn<int>("colorID");
+    QTest::addColumn<int>("bitDepth");
+    QTest::addColumn<int>("frames");
+    QTest::newRow("mono 8 bit") << int(SERRecorder::SER_MONO) << 8 << 200;
+    QTest::newRow("mono 16 bit") << int(SERRecorder::SER_MONO) << 16 << 100;
+    QTest::newRow("RGB 8 bit") << int(SERRecorder::SER_RGB) << 8 << 50;
+    QTest::newRow("no frames") << int(SERRecorder::SER_MONO) << 8 << 0;
+}
+
+void TestSERRecorder::testRecording()
+{
+    QFETCH(int, colorID);
+    QFETCH(int, bitDepth);
+    QFETCH(int, frames);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString filename = dir.path() + "/test.ser";
+
+    SERRecorder::Format format;
+    format.width    = 320;
+    format.height   = 240;
+    format.colorID  = static_cast<SERRecorder::ColorID>(colorID);
+    format.bitDepth = bitDepth;
+    const int frameSize = format.bytesPerFrame();
+
+    SERRecorder recorder;
+    QVERIFY(recorder.start(filename, format, "Observer"));
+    QVERIFY(recorder.isRecording());
+
+    // Frames of the wrong size are refused
+    QByteArray frame(frameSize, 0);
+    QVERIFY(!recorder.addFrame(frame.constData(), frameSize - 1));
+
+    QVector<QByteArray> sent;
+    for (int i = 0; i < frames; i++)
+    {
+        for (int j = 0; j < frameSize; j++)
+            frame[j] = char((i * 7 + j) & 0xFF);
+        if (recorder.addFrame(frame.constData(), frameSize))
+            sent.append(frame);
+    }
+
+    recorder.stop();
+    QVERIFY(!recorder.isRecording());
+    QCOMPARE(recorder.framesQueued(), sent.size());
+    QCOMPARE(recorder.framesQueued() + recorder.framesDropped(), frames);
+
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray data = file.readAll();
+
+    const int count = sent.size();
+    QCOMPARE(data.size(), SERRecorder::HeaderSize + count * frameSize + count * 8);
+    QCOMPARE(int32At(data, 18), colorID);
+    QCOMPARE(int32At(data, 34), bitDepth);
+    QCOMPARE(int32At(data, 38), count);
+
+    for (int i = 0; i < count; i++)
+        QVERIFY(data.mid(SERRecorder::HeaderSize + i * frameSize, frameSize) == sent[i]);
+
+    // Trailer of UTC timestamps, in order, not before the start of the recording
+    const int trailer = SERRecorder::HeaderSize + count * frameSize;
+    for (int i = 0; i < count; i++)
+    {
+        qint64 timestamp = int64At(data, trailer + i * 8);
+        QVERIFY(timestamp >= int64At(data, 170) - 10000000);
+        if (i > 0)
+            QVERIFY(timestamp >= int64At(data, trailer + (i - 1) * 8));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestSERRecorder)
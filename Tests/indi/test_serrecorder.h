@@ -0,0 +1,46 @@
+/***************************************************************************
+                  test_serrecorder.h  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_SERRECORDER_H
+#define TEST_SERRECORDER_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+/**
+ * @class TestSERRecorder
+ * @short Checks the SER header and the files written through the frame ring
+ */
+
+class TestSERRecorder : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestSERRecorder();
+    ~TestSERRecorder(){};
+
+  private slots:
+    void testTime();
+    void testHeader();
+    void testRing();
+
+    void testRecording_data();
+    void testRecording();
+};
+
+#endif
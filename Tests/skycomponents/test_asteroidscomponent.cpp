@@ -0,0 +1,81 @@
+/***************************************************************************
+             test_asteroidscomponent.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_asteroidscomponent.h"
+#include "asteroidscomponent.h"
+
+#include <cmath>
+#include <limits>
+
+namespace
+{
+// The first columns of asteroids.dat, the names are all that is checked
+const char *Data = "#full_name,epoch_mjd,q,a\n"
+                   "\"     1 Ceres\",57000,2.557,2.767\n"
+                   "\"    52 Europa\",57000,2.77,3.10\n"
+                   "\"   433 Eros\",57001,1.133,1.458\n"
+                   "\"  3200 Phaethon\",57000,0.14,1.27\n"
+                   "\"100000 Astronautica\",57000,2.31,2.39\n";
+
+OrbitalElementStore::Sequence sequence()
+{
+    OrbitalElementStore::Sequence sequence;
+    sequence.append(qMakePair(QString("full name"), KSParser::D_QSTRING));
+    sequence.append(qMakePair(QString("epoch_mjd"), KSParser::D_INT));
+    sequence.append(qMakePair(QString("q"), KSParser::D_DOUBLE));
+    sequence.append(qMakePair(QString("a"), KSParser::D_DOUBLE));
+    return sequence;
+}
+}
+
+TestAsteroidsComponent::TestAsteroidsComponent() : QObject()
+{
+}
+
+void TestAsteroidsComponent::testListedNames()
+{
+    QVERIFY(m_Dir.isValid());
+
+    QFile file(m_Dir.path() + "/asteroids.dat");
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(Data);
+    file.close();
+
+    OrbitalElementStore store(sequence());
+    QVERIFY(store.load(file.fileName(), m_Dir.path() + "/asteroids.bin"));
+
+    // objectNames(SkyObject::ASTEROID) holds these, whether the asteroids were created or not
+    QStringList names = AsteroidsComponent::listedNames(store);
+    QCOMPARE(names.size(), store.size());
+    QCOMPARE(names, QStringList() << "Ceres"
+                                  << "Europa (Asteroid)"
+                                  << "Eros"
+                                  << "Phaethon"
+                                  << "Astronautica");
+}
+
+void TestAsteroidsComponent::testBrightestMagnitude()
+{
+    // Outside the orbit of the Earth, the bound is reached at perihelion, at opposition
+    QCOMPARE(AsteroidsComponent::brightestMagnitude(3.34, 2.557), 3.34 + 5 * log10(2.557 * (2.557 - 1.0167)));
+
+    // Asteroids that may come close to the Earth are always created
+    QCOMPARE(AsteroidsComponent::brightestMagnitude(10.4, 1.0), -std::numeric_limits<double>::infinity());
+}
+
+QTEST_GUILESS_MAIN(TestAsteroidsComponent)
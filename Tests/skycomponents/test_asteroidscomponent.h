@@ -0,0 +1,46 @@
+/***************************************************************************
+              test_asteroidscomponent.h  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_ASTEROIDSCOMPONENT_H
+#define TEST_ASTEROIDSCOMPONENT_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QTemporaryDir>
+
+/**
+ * @class TestAsteroidsComponent
+ * @short Checks that the names of all the asteroids of the data file are listed, created or not
+ */
+
+class TestAsteroidsComponent : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestAsteroidsComponent();
+    ~TestAsteroidsComponent(){};
+
+  private slots:
+    void testListedNames();
+    void testBrightestMagnitude();
+
+  private:
+    QTemporaryDir m_Dir;
+};
+
+#endif
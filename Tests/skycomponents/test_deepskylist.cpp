@@ -0,0 +1,86 @@
+/***************************************************************************
+                 test_deepskylist.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_deepskylist.h"
+#include "deepskylist.h"
+#include "deepskyobject.h"
+
+#include <limits>
+
+TestDeepSkyList::TestDeepSkyList() : QObject()
+{
+}
+
+void TestDeepSkyList::testSort()
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    DeepSkyObject faint(SkyObject::GALAXY, dms(10.0), dms(40.0), 14.2, "NGC 1", QString(), QString(), "NGC", 2.0);
+    DeepSkyObject unknown(SkyObject::GALAXY, dms(10.0), dms(40.0), 99.9, "NGC 2", QString(), QString(), "NGC", 2.0);
+    DeepSkyObject bright(SkyObject::GALAXY, dms(10.0), dms(40.0), 8.1, "NGC 3", QString(), QString(), "NGC", 2.0);
+    DeepSkyObject undefined(SkyObject::GALAXY, dms(10.0), dms(40.0), nan, "NGC 4", QString(), QString(), "NGC", 2.0);
+
+    DeepSkyList list;
+    list.append(&faint);
+    list.append(&unknown);
+    list.append(&bright);
+    list.append(&undefined);
+    list.sort();
+
+    // Brightest first, unknown magnitudes last in the order they were appended
+    QCOMPARE(list.size(), 4);
+    QCOMPARE(list.at(0), &bright);
+    QCOMPARE(list.at(1), &faint);
+    QCOMPARE(list.at(2), &unknown);
+    QCOMPARE(list.at(3), &undefined);
+}
+
+void TestDeepSkyList::testSelect()
+{
+    DeepSkyObject large(SkyObject::GALAXY, dms(10.0), dms(40.0), 9.0, "NGC 1", QString(), QString(), "NGC", 20.0);
+    DeepSkyObject small(SkyObject::GALAXY, dms(10.0), dms(40.0), 10.0, "NGC 2", QString(), QString(), "NGC", 0.5);
+    DeepSkyObject faint(SkyObject::GALAXY, dms(10.0), dms(40.0), 15.0, "NGC 3", QString(), QString(), "NGC", 20.0);
+    DeepSkyObject unknown(SkyObject::GALAXY, dms(10.0), dms(40.0), 99.9, "NGC 4", QString(), QString(), "NGC", 20.0);
+
+    DeepSkyList list;
+    list.append(&unknown);
+    list.append(&faint);
+    list.append(&small);
+    list.append(&large);
+    list.sort();
+
+    // At a zoom of 1000 pixels per radian an object is larger than a pixel from a major axis of 3.4'
+    QVector<DeepSkyObject *> selected;
+    list.select(12.0, false, 1000.0, selected);
+    QCOMPARE(selected, QVector<DeepSkyObject *>({ &large }));
+
+    selected.clear();
+    list.select(12.0, true, 1000.0, selected);
+    QCOMPARE(selected, QVector<DeepSkyObject *>({ &large, &unknown }));
+
+    // Any size is drawn when zoomed in far enough
+    selected.clear();
+    list.select(16.0, false, 3000.0, selected);
+    QCOMPARE(selected, QVector<DeepSkyObject *>({ &large, &small, &faint }));
+
+    // Custom catalogs select by magnitude only
+    selected.clear();
+    list.select(12.0, true, selected);
+    QCOMPARE(selected, QVector<DeepSkyObject *>({ &large, &small, &unknown }));
+}
+
+QTEST_GUILESS_MAIN(TestDeepSkyList)
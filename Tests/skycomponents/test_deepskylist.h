@@ -0,0 +1,42 @@
+/***************************************************************************
+                  test_deepskylist.h  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_DEEPSKYLIST_H
+#define TEST_DEEPSKYLIST_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+/**
+ * @class TestDeepSkyList
+ * @short Checks the order of the objects of a trixel and their selection by magnitude and size
+ */
+
+class TestDeepSkyList : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestDeepSkyList();
+    ~TestDeepSkyList(){};
+
+  private slots:
+    void testSort();
+    void testSelect();
+};
+
+#endif
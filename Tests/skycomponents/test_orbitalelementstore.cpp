@@ -0,0 +1,167 @@
+/***************************************************************************
+             test_orbitalelementstore.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_orbitalelementstore.h"
+#include "orbitalelementstore.h"
+
+namespace
+{
+enum Field
+{
+    Name,
+    Epoch,
+    Perihelion,
+    Magnitude,
+    NEO,
+    Extent,
+    Unused
+};
+
+OrbitalElementStore::Sequence sequence()
+{
+    OrbitalElementStore::Sequence sequence;
+    sequence.append(qMakePair(QString("full name"), KSParser::D_QSTRING));
+    sequence.append(qMakePair(QString("epoch_mjd"), KSParser::D_INT));
+    sequence.append(qMakePair(QString("q"), KSParser::D_DOUBLE));
+    sequence.append(qMakePair(QString("H"), KSParser::D_FLOAT));
+    sequence.append(qMakePair(QString("neo"), KSParser::D_QSTRING));
+    sequence.append(qMakePair(QString("extent"), KSParser::D_QSTRING));
+    sequence.append(qMakePair(QString("unused"), KSParser::D_SKIP));
+    return sequence;
+}
+
+// Comments, quoted delimiters, empty and broken numbers, an incomplete row and line ends of both kinds
+const char *Data = "#full_name,epoch_mjd,q,H,neo,extent,unused\n"
+                   "\"     1 Ceres\",57000,2.557665961167666,3.34,N,\"974.6 x 909.4\",x\n"
+                   "\"   433 Eros, with a comma\",57001,1.133,10.4,Y,,y\n"
+                   "# a comment\n"
+                   "incomplete,1,2\n"
+                   "\"       (2014 AB)\",,.5,,N,12x3,z\r\n"
+                   "\"     9 Metis\",57000.5,abc, 7.1 ,N,\"a,b,c\",\n"
+                   "\"    10 Hygiea\",57000,2.78,5.43,N,,w\n";
+}
+
+TestOrbitalElementStore::TestOrbitalElementStore() : QObject()
+{
+}
+
+void TestOrbitalElementStore::initTestCase()
+{
+    QVERIFY(m_Dir.isValid());
+    m_DataFile  = m_Dir.path() + "/asteroids.dat";
+    m_CacheFile = m_Dir.path() + "/asteroids.bin";
+}
+
+void TestOrbitalElementStore::writeData(const QByteArray &data)
+{
+    QFile file(m_DataFile);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(data);
+}
+
+void TestOrbitalElementStore::testParity()
+{
+    writeData(Data);
+    QFile::remove(m_CacheFile);
+
+    OrbitalElementStore store(sequence());
+    QVERIFY(store.load(m_DataFile, m_CacheFile));
+
+    KSParser parser(m_DataFile, '#', sequence());
+    int row = 0;
+    while (parser.HasNextRow())
+    {
+        QHash<QString, QVariant> content = parser.ReadNextRow();
+        QVERIFY(row < store.size());
+
+        QCOMPARE(store.text(row, Name), content["full name"].toString());
+        QCOMPARE(store.number(row, Epoch), double(content["epoch_mjd"].toInt()));
+        QCOMPARE(store.number(row, Perihelion), content["q"].toDouble());
+        QCOMPARE(store.number(row, Magnitude), double(content["H"].toFloat()));
+        QCOMPARE(store.text(row, NEO), content["neo"].toString());
+        QCOMPARE(store.text(row, Extent), content["extent"].toString());
+        row++;
+    }
+
+    QCOMPARE(store.size(), 5);
+    QCOMPARE(row, store.size());
+
+    QCOMPARE(store.text(1, Name), QString("   433 Eros, with a comma"));
+    QCOMPARE(store.text(3, Extent), QString("a,b,c"));
+    QCOMPARE(store.number(3, Magnitude), double(7.1f));
+}
+
+void TestOrbitalElementStore::testCache()
+{
+    writeData(Data);
+    QFile::remove(m_CacheFile);
+
+    // Built from the text file, then mapped
+    OrbitalElementStore store(sequence());
+    QVERIFY(store.load(m_DataFile, m_CacheFile));
+    QVERIFY(QFile::exists(m_CacheFile));
+    QVERIFY(store.isMapped());
+
+    // Read from the cache alone
+    OrbitalElementStore cached(sequence());
+    QVERIFY(cached.load(m_DataFile, m_CacheFile));
+    QVERIFY(cached.isMapped());
+    QCOMPARE(cached.size(), store.size());
+    for (int row = 0; row < store.size(); row++)
+    {
+        QCOMPARE(cached.text(row, Name), store.text(row, Name));
+        QCOMPARE(cached.number(row, Perihelion), store.number(row, Perihelion));
+    }
+
+    // A new data file replaces the cache
+    store.clear();
+    cached.clear();
+    writeData(QByteArray(Data) + "\"    11 Parthenope\",57000,2.21,6.55,N,,\n");
+
+    OrbitalElementStore updated(sequence());
+    QVERIFY(updated.load(m_DataFile, m_CacheFile));
+    QCOMPARE(updated.size(), 6);
+    QCOMPARE(updated.text(5, Name), QString("    11 Parthenope"));
+
+    // A cache of other fields is not used
+    OrbitalElementStore::Sequence other = sequence();
+    other[Extent].second = KSParser::D_SKIP;
+    updated.clear();
+
+    OrbitalElementStore otherStore(other);
+    QVERIFY(otherStore.load(m_DataFile, m_CacheFile));
+    QCOMPARE(otherStore.size(), 6);
+    QCOMPARE(otherStore.number(5, Perihelion), 2.21);
+}
+
+void TestOrbitalElementStore::testUnwritableCache()
+{
+    writeData(Data);
+
+    OrbitalElementStore store(sequence());
+    QVERIFY(store.load(m_DataFile, m_Dir.path() + "/missing/asteroids.bin"));
+    QVERIFY(!store.isMapped());
+    QCOMPARE(store.size(), 5);
+    QCOMPARE(store.text(4, Name), QString("    10 Hygiea"));
+
+    OrbitalElementStore missing(sequence());
+    QVERIFY(!missing.load(m_Dir.path() + "/missing.dat", m_CacheFile));
+    QCOMPARE(missing.size(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestOrbitalElementStore)
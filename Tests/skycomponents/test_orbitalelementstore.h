@@ -0,0 +1,53 @@
+/***************************************************************************
+              test_orbitalelementstore.h  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_ORBITALELEMENTSTORE_H
+#define TEST_ORBITALELEMENTSTORE_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QTemporaryDir>
+
+/**
+ * @class TestOrbitalElementStore
+ * @short Checks that the element store reads the same rows as KSParser, and that its cache is used and rebuilt
+ */
+
+class TestOrbitalElementStore : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestOrbitalElementStore();
+    ~TestOrbitalElementStore(){};
+
+  private slots:
+    void initTestCase();
+
+    void testParity();
+    void testCache();
+    void testUnwritableCache();
+
+  private:
+    void writeData(const QByteArray &data);
+
+    QTemporaryDir m_Dir;
+    QString m_DataFile;
+    QString m_CacheFile;
+};
+
+#endif
@@ -0,0 +1,161 @@
+/***************************************************************************
+               test_skyobjectindex.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_skyobjectindex.h"
+#include "skycomposite.h"
+#include "skyobjectindex.h"
+#include "skyobject.h"
+#include "planetmoons.h"
+#include "trailobject.h"
+
+TestSkyObjectIndex::TestSkyObjectIndex() : QObject()
+{
+}
+
+void TestSkyObjectIndex::testFind()
+{
+    SkyComposite deepSky, catalog;
+    SkyObject m31(SkyObject::GALAXY, 10.68, 41.27, 3.4, "M 31", "NGC 224", "Andromeda Galaxy");
+    SkyObject ngc224(SkyObject::GALAXY, 10.68, 41.27, 3.4, "NGC 224");
+    SkyObject same(SkyObject::STAR, 0.0, 0.0, 0.0, "Vega", "vega", "VEGA");
+
+    SkyObjectIndex index;
+    index.add(&m31, &deepSky);
+    index.add(&ngc224, &catalog);
+    index.add(&same, &catalog);
+
+    // All the names, ignoring case
+    QCOMPARE(index.find("m 31").size(), 1);
+    QCOMPARE(index.find("ANDROMEDA galaxy").first().object, &m31);
+    QCOMPARE(index.find("Andromeda Galaxy").first().owner, &deepSky);
+
+    // Entries of the same name in the order they were added
+    QVector<SkyObjectIndex::Entry> entries = index.find("ngc 224");
+    QCOMPARE(entries.size(), 2);
+    QCOMPARE(entries[0].object, &m31);
+    QCOMPARE(entries[1].object, &ngc224);
+    QCOMPARE(entries[1].owner, &catalog);
+
+    // Names that only differ by case are added once
+    QCOMPARE(index.find("Vega").size(), 1);
+
+    // Additional names, empty ones are ignored
+    index.add(&same, &catalog, "alpha Lyrae");
+    index.add(&same, &catalog, QString());
+    QCOMPARE(index.find("Alpha LYRAE").first().object, &same);
+    QVERIFY(index.find(QString()).isEmpty());
+    QVERIFY(index.find("M 3").isEmpty());
+}
+
+void TestSkyObjectIndex::testPrefix()
+{
+    SkyComposite owner;
+    SkyObject m3(SkyObject::GLOBULAR_CLUSTER, 205.55, 28.38, 6.2, "M 3", "NGC 5272");
+    SkyObject m31(SkyObject::GALAXY, 10.68, 41.27, 3.4, "M 31", "NGC 224", "Andromeda Galaxy");
+    SkyObject m33(SkyObject::GALAXY, 23.46, 30.66, 5.7, "M 33", "NGC 598", "Triangulum Galaxy");
+
+    SkyObjectIndex index;
+    index.add(&m33, &owner);
+    index.add(&m31, &owner);
+    index.add(&m3, &owner);
+
+    // In the order of the names
+    QList<SkyObject *> found = index.findByPrefix("m 3");
+    QCOMPARE(found.size(), 3);
+    QCOMPARE(found[0], &m3);
+    QCOMPARE(found[1], &m31);
+    QCOMPARE(found[2], &m33);
+
+    QCOMPARE(index.findByPrefix("NGC", 2).size(), 2);
+    QCOMPARE(index.findByPrefix("ngc 5").size(), 2);
+    QCOMPARE(index.findByPrefix("triangulum").first(), &m33);
+    QVERIFY(index.findByPrefix("x").isEmpty());
+
+    // An object found under several names is returned once
+    QCOMPARE(index.findByPrefix(QString()).size(), 3);
+
+    // Names added after a search are found
+    SkyObject m13(SkyObject::GLOBULAR_CLUSTER, 250.42, 36.46, 5.8, "M 13", "NGC 6205");
+    index.add(&m13, &owner);
+    QCOMPARE(index.findByPrefix("m 1").first(), &m13);
+}
+
+void TestSkyObjectIndex::testRemove()
+{
+    SkyComposite comets, asteroids;
+    SkyObject halley(SkyObject::COMET, 0.0, 0.0, 0.0, "1P/Halley");
+    SkyObject ceres(SkyObject::ASTEROID, 0.0, 0.0, 0.0, "Ceres");
+    SkyObject shared(SkyObject::ASTEROID, 0.0, 0.0, 0.0, "Chiron");
+    SkyObject sharedComet(SkyObject::COMET, 0.0, 0.0, 0.0, "Chiron");
+
+    SkyObjectIndex index;
+    index.add(&halley, &comets);
+    index.add(&sharedComet, &comets);
+    index.add(&ceres, &asteroids);
+    index.add(&shared, &asteroids);
+    QCOMPARE(index.size(), 3);
+    QCOMPARE(index.findByPrefix("c").size(), 3);
+
+    index.remove(&comets);
+    QCOMPARE(index.size(), 2);
+    QVERIFY(index.find("1p/halley").isEmpty());
+    QCOMPARE(index.find("chiron").size(), 1);
+    QCOMPARE(index.find("chiron").first().object, &shared);
+    QCOMPARE(index.findByPrefix("c").size(), 2);
+
+    index.clear();
+    QCOMPARE(index.size(), 0);
+    QVERIFY(index.findByPrefix(QString()).isEmpty());
+}
+
+namespace
+{
+// Moons named as JupiterMoons names them, at no position
+class TestMoons : public PlanetMoons
+{
+  public:
+    TestMoons()
+    {
+        Moon.append(new TrailObject(SkyObject::MOON, 0.0, 0.0, 5.0, "Io"));
+        Moon.append(new TrailObject(SkyObject::MOON, 0.0, 0.0, 5.3, "Europa"));
+        Moon.append(new TrailObject(SkyObject::MOON, 0.0, 0.0, 4.6, "Ganymede"));
+        Moon.append(new TrailObject(SkyObject::MOON, 0.0, 0.0, 5.7, "Callisto"));
+    }
+
+    void findPosition(const KSNumbers *, const KSPlanetBase *, const KSSun *) Q_DECL_OVERRIDE {}
+};
+}
+
+void TestSkyObjectIndex::testPlanetMoons()
+{
+    SkyComposite solarSystem;
+    TestMoons moons;
+
+    // As PlanetMoonsComponent adds them
+    SkyObjectIndex index;
+    for (int i = 0; i < moons.nMoons(); ++i)
+        index.add(moons.moon(i), &solarSystem);
+
+    QCOMPARE(index.find("io").size(), 1);
+    QCOMPARE(index.find("IO").first().object, static_cast<SkyObject *>(moons.moon(0)));
+    QCOMPARE(index.find("Callisto").first().object, static_cast<SkyObject *>(moons.moon(3)));
+    QCOMPARE(index.find("ganymede").first().object->type(), int(SkyObject::MOON));
+    QCOMPARE(index.findByPrefix("eu").first(), static_cast<SkyObject *>(moons.moon(1)));
+}
+
+QTEST_GUILESS_MAIN(TestSkyObjectIndex)
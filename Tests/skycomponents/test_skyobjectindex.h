@@ -0,0 +1,44 @@
+/***************************************************************************
+                test_skyobjectindex.h  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_SKYOBJECTINDEX_H
+#define TEST_SKYOBJECTINDEX_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+/**
+ * @class TestSkyObjectIndex
+ * @short Checks the lookups of the name index by exact name and by prefix, and the removal of a component
+ */
+
+class TestSkyObjectIndex : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestSkyObjectIndex();
+    ~TestSkyObjectIndex(){};
+
+  private slots:
+    void testFind();
+    void testPrefix();
+    void testRemove();
+    void testPlanetMoons();
+};
+
+#endif
@@ -0,0 +1,204 @@
+/***************************************************************************
+              test_ksephemeriscache.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_ksephemeriscache.h"
+#include "ksephemeriscache.h"
+
+#include "auxiliary/geolocation.h"
+#include "ksnumbers.h"
+#include "ksmoon.h"
+#include "ksplanet.h"
+#include "kssun.h"
+#include "skypoint.h"
+#include "time/kstarsdatetime.h"
+
+#include <cmath>
+#include <random>
+
+namespace
+{
+// 2017-10-17 0h UT, and the two nights after
+const long double startJD = 2458043.5;
+const long double stopJD  = startJD + 2.0;
+
+// Arcseconds between two points
+double separation(const SkyPoint &a, const SkyPoint &b)
+{
+    double sinRA1, cosRA1, sinDec1, cosDec1, sinRA2, cosRA2, sinDec2, cosDec2;
+    a.ra().SinCos(sinRA1, cosRA1);
+    a.dec().SinCos(sinDec1, cosDec1);
+    b.ra().SinCos(sinRA2, cosRA2);
+    b.dec().SinCos(sinDec2, cosDec2);
+
+    double x1 = cosRA1 * cosDec1, y1 = sinRA1 * cosDec1, z1 = sinDec1;
+    double x2 = cosRA2 * cosDec2, y2 = sinRA2 * cosDec2, z2 = sinDec2;
+    double cx = y1 * z2 - z1 * y2, cy = z1 * x2 - x1 * z2, cz = x1 * y2 - y1 * x2;
+
+    return atan2(sqrt(cx * cx + cy * cy + cz * cz), x1 * x2 + y1 * y2 + z1 * z2) / dms::DegToRad * 3600.0;
+}
+
+// Direct computation, as the fit samples it
+void directPosition(KSPlanetBase *body, KSPlanet *earth, long double jd, const GeoLocation *geo)
+{
+    KSNumbers num(jd);
+    earth->findApparentPosition(&num);
+    if (geo)
+    {
+        CachingDms LST(geo->GSTtoLST(KStarsDateTime(jd).gst()));
+        body->findApparentPosition(&num, geo->lat(), &LST, earth);
+    }
+    else
+        body->findApparentPosition(&num, nullptr, nullptr, earth);
+}
+}
+
+TestKSEphemerisCache::TestKSEphemerisCache() : QObject(), m_Geo(new GeoLocation(dms(-71.06), dms(42.36)))
+{
+}
+
+TestKSEphemerisCache::~TestKSEphemerisCache()
+{
+}
+
+void TestKSEphemerisCache::initTestCase()
+{
+    // Find the data files of the source tree, and keep the binary caches out of the user directories
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_DataDir.isValid());
+    QVERIFY(QFile::link(KSTARS_DATA_DIR, m_DataDir.path() + "/kstars"));
+    qputenv("XDG_DATA_DIRS", QFile::encodeName(m_DataDir.path()));
+}
+
+KSPlanetBase *TestKSEphemerisCache::createBody(const QString &name)
+{
+    if (name == "Sun")
+        return new KSSun();
+    if (name == "Moon")
+        return new KSMoon();
+    if (name == "Venus")
+        return new KSPlanet(KSPlanetBase::VENUS);
+    if (name == "Mars")
+        return new KSPlanet(KSPlanetBase::MARS);
+    return new KSPlanet(KSPlanetBase::JUPITER);
+}
+
+void TestKSEphemerisCache::testAccuracy_data()
+{
+    QTest::addColumn<QString>("body");
+    QTest::addColumn<bool>("topocentric");
+
+    QTest::newRow("Sun") << "Sun" << false;
+    QTest::newRow("Moon, geocentric") << "Moon" << false;
+    QTest::newRow("Moon, topocentric") << "Moon" << true;
+    QTest::newRow("Venus, topocentric") << "Venus" << true;
+    QTest::newRow("Mars") << "Mars" << false;
+    QTest::newRow("Jupiter, topocentric") << "Jupiter" << true;
+}
+
+void TestKSEphemerisCache::testAccuracy()
+{
+    QFETCH(QString, body);
+    QFETCH(bool, topocentric);
+    const GeoLocation *geo = topocentric ? m_Geo.get() : nullptr;
+
+    std::unique_ptr<KSPlanetBase> object(createBody(body));
+    KSPlanet earth(I18N_NOOP("Earth"), QString(), QColor("white"), 12756.28);
+    QVERIFY(object->loadData());
+    QVERIFY(earth.loadData());
+
+    KSEphemerisCache cache;
+    QVERIFY(cache.fit(*object, startJD, stopJD, geo));
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> uniform(0.0, double(stopJD - startJD));
+
+    double maxSeparation = 0, maxLong = 0, maxRearth = 0;
+    for (int i = 0; i < 500; ++i)
+    {
+        long double jd = startJD + uniform(generator);
+        QVERIFY(cache.covers(jd));
+
+        directPosition(object.get(), &earth, jd, geo);
+
+        SkyPoint fitted;
+        cache.position(jd, fitted);
+        maxSeparation = qMax(maxSeparation, separation(fitted, *object));
+
+        double dLong = fabs(cache.ecLong(jd) - object->ecLong().Degrees());
+        maxLong      = qMax(maxLong, qMin(dLong, 360.0 - dLong) * 3600.0);
+        maxLong      = qMax(maxLong, fabs(cache.ecLat(jd) - object->ecLat().Degrees()) * 3600.0);
+        maxRearth    = qMax(maxRearth, fabs(cache.rearth(jd) - object->rearth()) / object->rearth());
+    }
+
+    // A few milliarcseconds in practice
+    QVERIFY2(maxSeparation < 0.05, qPrintable(QString("%1 arcsec").arg(maxSeparation)));
+    QVERIFY2(maxLong < 0.05, qPrintable(QString("%1 arcsec").arg(maxLong)));
+    QVERIFY2(maxRearth < 1e-8, qPrintable(QString::number(maxRearth)));
+}
+
+void TestKSEphemerisCache::testCoverage()
+{
+    KSSun sun;
+    KSEphemerisCache cache;
+    QVERIFY(!cache.covers(startJD));
+
+    QVERIFY(cache.fit(sun, startJD, startJD + 1.5));
+    QVERIFY(cache.covers(startJD));
+    QVERIFY(cache.covers(startJD + 1.5));
+    QVERIFY(!cache.covers(startJD - 0.01));
+    QVERIFY(!cache.covers(startJD + 2.01));
+
+    cache.clear();
+    QVERIFY(!cache.covers(startJD));
+}
+
+void TestKSEphemerisCache::benchmarkPosition_data()
+{
+    QTest::addColumn<bool>("cached");
+    QTest::newRow("Moon, direct") << false;
+    QTest::newRow("Moon, cached") << true;
+}
+
+void TestKSEphemerisCache::benchmarkPosition()
+{
+    QFETCH(bool, cached);
+
+    KSMoon moon;
+    KSPlanet earth(I18N_NOOP("Earth"), QString(), QColor("white"), 12756.28);
+    QVERIFY(moon.loadData());
+    QVERIFY(earth.loadData());
+
+    KSEphemerisCache cache;
+    QVERIFY(cache.fit(moon, startJD, stopJD, m_Geo.get()));
+
+    // A position every minute of the two nights
+    SkyPoint position;
+    QBENCHMARK
+    {
+        for (int i = 0; i < 2 * 24 * 60; ++i)
+        {
+            long double jd = startJD + i / (24.0 * 60.0);
+            if (cached)
+                cache.position(jd, position);
+            else
+                directPosition(&moon, &earth, jd, m_Geo.get());
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestKSEphemerisCache)
@@ -0,0 +1,64 @@
+/***************************************************************************
+               test_ksephemeriscache.h  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_KSEPHEMERISCACHE_H
+#define TEST_KSEPHEMERISCACHE_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QTemporaryDir>
+
+#include <memory>
+
+class GeoLocation;
+class KSPlanetBase;
+
+/**
+ * @class TestKSEphemerisCache
+ * @short Checks the Chebyshev fit of the Sun, the Moon and planets against the direct VSOP87 and Meeus series,
+ * and benchmarks a query against the direct computation
+ */
+
+class TestKSEphemerisCache : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestKSEphemerisCache();
+    ~TestKSEphemerisCache();
+
+  private slots:
+    void initTestCase();
+
+    void testAccuracy_data();
+    void testAccuracy();
+
+    void testCoverage();
+
+    void benchmarkPosition_data();
+    void benchmarkPosition();
+
+  private:
+    /** @short Create the body named in the data tag */
+    KSPlanetBase *createBody(const QString &name);
+
+    // Directory pointing to the data files of the source tree
+    QTemporaryDir m_DataDir;
+    std::unique_ptr<GeoLocation> m_Geo;
+};
+
+#endif
@@ -0,0 +1,139 @@
+/***************************************************************************
+                   test_ksplanet.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_ksplanet.h"
+#include "ksplanet.h"
+
+namespace
+{
+// Gives access to the orbital data classes, which are protected in KSPlanet
+class VSOPPlanet : public KSPlanet
+{
+  public:
+    using KSPlanet::OBArray;
+    using KSPlanet::OrbitDataColl;
+    using KSPlanet::OrbitDataManager;
+};
+
+// Julian millenia from J2000, as KSPlanet::findGeocentricPosition passes them, from 1000 BC to 3000 AD
+const double millenia[] = { -3.0, -1.0, -0.25, 0.0, 0.1795, 0.5, 1.0 };
+
+void compareSeries(const VSOPPlanet::OBArray &text, const VSOPPlanet::OBArray &cache)
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        QCOMPARE(cache[i].size(), text[i].size());
+        QVERIFY(cache[i].A == text[i].A);
+        QVERIFY(cache[i].B == text[i].B);
+        QVERIFY(cache[i].C == text[i].C);
+    }
+
+    // The arrays are copied bit for bit, so the sums are exactly the same
+    for (double T : millenia)
+        QCOMPARE(VSOPPlanet::OrbitDataColl::evaluate(cache, T), VSOPPlanet::OrbitDataColl::evaluate(text, T));
+}
+}
+
+TestKSPlanet::TestKSPlanet() : QObject()
+{
+}
+
+TestKSPlanet::~TestKSPlanet()
+{
+}
+
+void TestKSPlanet::initTestCase()
+{
+    // Find the data files of the source tree, and keep the binary caches out of the user directories
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_DataDir.isValid());
+    QVERIFY(QFile::link(KSTARS_DATA_DIR, m_DataDir.path() + "/kstars"));
+    qputenv("XDG_DATA_DIRS", QFile::encodeName(m_DataDir.path()));
+
+    QString writableDir = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/kstars/";
+    QVERIFY(QDir().mkpath(writableDir));
+    m_CacheFile    = writableDir + "mars.vsop.bin";
+    m_OverrideFile = writableDir + "mars.L0.vsop";
+
+    // Start without a cache, from the installed text files
+    QFile::remove(m_CacheFile);
+    QFile::remove(m_OverrideFile);
+}
+
+void TestKSPlanet::cleanupTestCase()
+{
+    QFile::remove(m_CacheFile);
+    QFile::remove(m_OverrideFile);
+}
+
+void TestKSPlanet::testCacheParity()
+{
+    // Each manager loads a planet once, so two of them parse the text files and read the cache in turn
+    VSOPPlanet::OrbitDataManager parsed;
+    const VSOPPlanet::OrbitDataColl *text = parsed.orbitData("mars");
+    QVERIFY(text != nullptr);
+    QVERIFY(QFile::exists(m_CacheFile));
+
+    VSOPPlanet::OrbitDataManager mapped;
+    const VSOPPlanet::OrbitDataColl *cache = mapped.orbitData("mars");
+    QVERIFY(cache != nullptr);
+    QVERIFY(cache != text);
+
+    compareSeries(text->Lon, cache->Lon);
+    compareSeries(text->Lat, cache->Lat);
+    compareSeries(text->Dst, cache->Dst);
+}
+
+void TestKSPlanet::testCacheInvalidation()
+{
+    int installedTerms;
+    {
+        VSOPPlanet::OrbitDataManager odm;
+        const VSOPPlanet::OrbitDataColl *data = odm.orbitData("mars");
+        QVERIFY(data != nullptr);
+        installedTerms = data->Lon[0].size();
+    }
+    QVERIFY(installedTerms > 3);
+
+    // A text file in the user directory takes precedence over the installed one, the cache must follow it
+    QFile override(m_OverrideFile);
+    QVERIFY(override.open(QIODevice::WriteOnly | QIODevice::Text));
+    override.write("6.20347711583 0.0 0.0\n0.186563681 5.05037100303 3340.6124266998\n"
+                   "0.01108216792 5.40099836958 6681.2248533996\n");
+    override.close();
+
+    {
+        VSOPPlanet::OrbitDataManager odm;
+        const VSOPPlanet::OrbitDataColl *data = odm.orbitData("mars");
+        QVERIFY(data != nullptr);
+        QCOMPARE(data->Lon[0].size(), 3);
+        QCOMPARE(data->Lon[0].C[2], 6681.2248533996);
+    }
+
+    // And back to the installed file once the override is gone
+    QVERIFY(QFile::remove(m_OverrideFile));
+
+    {
+        VSOPPlanet::OrbitDataManager odm;
+        const VSOPPlanet::OrbitDataColl *data = odm.orbitData("mars");
+        QVERIFY(data != nullptr);
+        QCOMPARE(data->Lon[0].size(), installedTerms);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestKSPlanet)
@@ -0,0 +1,54 @@
+/***************************************************************************
+                    test_ksplanet.h  -  KStars Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_KSPLANET_H
+#define TEST_KSPLANET_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+#include <QTemporaryDir>
+
+/**
+ * @class TestKSPlanet
+ * @short Checks that the binary cache of the VSOP87 series gives the same positions as the text files,
+ * and that it is replaced when the text files change
+ */
+
+class TestKSPlanet : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestKSPlanet();
+    ~TestKSPlanet();
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testCacheParity();
+    void testCacheInvalidation();
+
+  private:
+    // Directory pointing to the data files of the source tree
+    QTemporaryDir m_DataDir;
+    // Binary cache of Mars, and the text file overriding the installed one in testCacheInvalidation()
+    QString m_CacheFile;
+    QString m_OverrideFile;
+};
+
+#endif
@@ -0,0 +1,132 @@
+/***************************************************************************
+                 test_satellite.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Sat 14 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_satellite.h"
+#include "auxiliary/geolocation.h"
+#include "time/kstarsdatetime.h"
+
+namespace
+{
+// A near-Earth orbit (ISS) and a deep space, 12 hour resonant orbit (Molniya)
+const char *const tle[][3] = {
+    { "ISS (ZARYA)", "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927",
+      "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537" },
+    { "MOLNIYA 2-14", "1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0   813",
+      "2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656" }
+};
+
+const double startJD = 2454730.0;
+}
+
+TestSatellite::TestSatellite() : QObject(), m_Geo(new GeoLocation(dms(-71.06), dms(42.36)))
+{
+}
+
+TestSatellite::~TestSatellite()
+{
+}
+
+void TestSatellite::makeSatellites(int count)
+{
+    m_Satellites.clear();
+    for (int i = 0; i < count; ++i)
+    {
+        const char *const *t = tle[i % 2];
+        m_Satellites.emplace_back(new Satellite(t[0], t[1], t[2]));
+    }
+}
+
+void TestSatellite::testUpdatePositions()
+{
+    makeSatellites(500);
+    std::vector<std::unique_ptr<Satellite>> serial;
+    for (const auto &sat : m_Satellites)
+        serial.emplace_back(sat->clone());
+
+    std::vector<Satellite *> sats;
+    for (const auto &sat : m_Satellites)
+        sats.push_back(sat.get());
+    std::vector<int> rc(sats.size());
+
+    for (int step = 0; step < 5; ++step)
+    {
+        double jd = startJD + step / 1440.0;
+        KStarsDateTime dt(jd);
+        Satellite::Context context = Satellite::makeContext(jd, m_Geo.get(), m_Geo->GSTtoLST(dt.gst()), -20.0);
+
+        Satellite::updatePositions(sats.data(), rc.data(), int(sats.size()), context);
+
+        for (size_t i = 0; i < sats.size(); ++i)
+        {
+            QCOMPARE(rc[i], serial[i]->updatePos(context));
+            QCOMPARE(sats[i]->ra().Degrees(), serial[i]->ra().Degrees());
+            QCOMPARE(sats[i]->dec().Degrees(), serial[i]->dec().Degrees());
+            QCOMPARE(sats[i]->alt().Degrees(), serial[i]->alt().Degrees());
+            QCOMPARE(sats[i]->range(), serial[i]->range());
+            QCOMPARE(sats[i]->isVisible(), serial[i]->isVisible());
+        }
+    }
+}
+
+void TestSatellite::benchmarkPropagation_data()
+{
+    QTest::addColumn<int>("satellites");
+    QTest::addColumn<int>("steps");
+    QTest::addColumn<bool>("parallel");
+
+    QTest::newRow("1000 satellites x 60 steps, serial") << 1000 << 60 << false;
+    QTest::newRow("1000 satellites x 60 steps, parallel") << 1000 << 60 << true;
+    QTest::newRow("5000 satellites x 60 steps, serial") << 5000 << 60 << false;
+    QTest::newRow("5000 satellites x 60 steps, parallel") << 5000 << 60 << true;
+}
+
+void TestSatellite::benchmarkPropagation()
+{
+    QFETCH(int, satellites);
+    QFETCH(int, steps);
+    QFETCH(bool, parallel);
+
+    makeSatellites(satellites);
+    std::vector<Satellite *> sats;
+    for (const auto &sat : m_Satellites)
+        sats.push_back(sat.get());
+    std::vector<int> rc(sats.size());
+
+    // One context per step, as SatellitesComponent::update() builds once per frame of a time-lapse
+    std::vector<Satellite::Context> contexts;
+    for (int step = 0; step < steps; ++step)
+    {
+        double jd = startJD + step * 10.0 / 1440.0;
+        KStarsDateTime dt(jd);
+        contexts.push_back(Satellite::makeContext(jd, m_Geo.get(), m_Geo->GSTtoLST(dt.gst()), -20.0));
+    }
+
+    QBENCHMARK
+    {
+        for (const Satellite::Context &context : contexts)
+        {
+            if (parallel)
+                Satellite::updatePositions(sats.data(), rc.data(), int(sats.size()), context);
+            else
+                for (size_t i = 0; i < sats.size(); ++i)
+                    rc[i] = sats[i]->updatePos(context);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestSatellite)
@@ -0,0 +1,58 @@
+/***************************************************************************
+                 test_satellite.h  -  KStars Planetarium
+                             -------------------
+    begin                : Sat 14 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_SATELLITE_H
+#define TEST_SATELLITE_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "skyobjects/satellite.h"
+
+#include <memory>
+#include <vector>
+
+class GeoLocation;
+
+/**
+ * @class TestSatellite
+ * @short Checks that satellites propagated in parallel match the serial propagation, and benchmarks both
+ */
+
+class TestSatellite : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestSatellite();
+    ~TestSatellite();
+
+  private slots:
+    void testUpdatePositions();
+
+    void benchmarkPropagation_data();
+    void benchmarkPropagation();
+
+  private:
+    /** @short Fill m_Satellites with count satellites, cycling through a few near-Earth and deep space orbits */
+    void makeSatellites(int count);
+
+    std::vector<std::unique_ptr<Satellite>> m_Satellites;
+    std::unique_ptr<GeoLocation> m_Geo;
+};
+
+#endif
@@ -0,0 +1,190 @@
+/***************************************************************************
+                test_skypointbatch.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : Sat 14 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/* Project Includes */
+#include "test_skypointbatch.h"
+#include "ksnumbers.h"
+#include "skyobjects/skypointbatch.h"
+#include "time/kstarsdatetime.h"
+#include "auxiliary/dms.h"
+
+#include <random>
+
+namespace
+{
+// The batch path applies nutation as an exact rotation, while SkyPoint::nutate() uses a first order
+// approximation away from the poles. Both agree to a few milliarcseconds.
+constexpr double arcsecTolerance = 0.1;
+
+double separation(const dms &ra1, const dms &dec1, const dms &ra2, const dms &dec2)
+{
+    SkyPoint p1(ra1, dec1), p2(ra2, dec2);
+    return p1.angularDistanceTo(&p2).Degrees() * 3600.0;
+}
+}
+
+TestSkyPointBatch::TestSkyPointBatch() : QObject(), m_LST(dms("17:43:54", false)), m_Lat(dms("37:30:00", true))
+{
+}
+
+void TestSkyPointBatch::makePoints(int count)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> ra(0.0, 360.0);
+    std::uniform_real_distribution<double> sinDec(-std::sin(79.0 * dms::DegToRad), std::sin(79.0 * dms::DegToRad));
+
+    m_Points.clear();
+    for (int i = 0; i < count; ++i)
+        m_Points.emplace_back(new SkyPoint(dms(ra(generator)), dms(std::asin(sinDec(generator)) / dms::DegToRad)));
+}
+
+void TestSkyPointBatch::testUpdateCoords()
+{
+    makePoints(1000);
+    KSNumbers num(KStarsDateTime::epochToJd(2017.8));
+    SkyPointBatch batch(&num, &m_LST, &m_Lat);
+
+    std::vector<std::unique_ptr<SkyPoint>> scalar;
+    for (auto &p : m_Points)
+    {
+        scalar.emplace_back(new SkyPoint(*p));
+        scalar.back()->updateCoordsNow(&num);
+    }
+    batch.updateCoords(m_Points, true);
+
+    for (size_t i = 0; i < m_Points.size(); ++i)
+    {
+        const SkyPoint &b = *m_Points[i], &s = *scalar[i];
+        QVERIFY(separation(b.ra(), b.dec(), s.ra(), s.dec()) < arcsecTolerance);
+        QCOMPARE(b.getLastPrecessJD(), s.getLastPrecessJD());
+        // The cached sines and cosines must match the angles
+        QVERIFY(fabs(b.ra().sin() - std::sin(b.ra().radians())) < 1e-12);
+        QVERIFY(fabs(b.dec().cos() - std::cos(b.dec().radians())) < 1e-12);
+    }
+
+    // Points that are up to date must be left alone
+    SkyPoint *p = m_Points.front().get();
+    p->setRA(dms(0.0));
+    batch.updateCoords(&p, 1);
+    QCOMPARE(p->ra().Degrees(), 0.0);
+}
+
+void TestSkyPointBatch::testEquatorialToHorizontal()
+{
+    makePoints(1000);
+    SkyPointBatch batch(&m_LST, &m_Lat);
+
+    std::vector<std::unique_ptr<SkyPoint>> scalar;
+    for (auto &p : m_Points)
+    {
+        scalar.emplace_back(new SkyPoint(*p));
+        scalar.back()->EquatorialToHorizontal(&m_LST, &m_Lat);
+    }
+    batch.EquatorialToHorizontal(m_Points);
+
+    for (size_t i = 0; i < m_Points.size(); ++i)
+    {
+        const SkyPoint &b = *m_Points[i], &s = *scalar[i];
+        QVERIFY(separation(b.az(), b.alt(), s.az(), s.alt()) < arcsecTolerance);
+        QVERIFY(b.az().Degrees() >= 0.0 && b.az().Degrees() < 360.0);
+    }
+}
+
+void TestSkyPointBatch::testArrays()
+{
+    makePoints(100);
+    KSNumbers num(KStarsDateTime::epochToJd(2017.8));
+    SkyPointBatch batch(&num, &m_LST, &m_Lat);
+
+    const int n = int(m_Points.size());
+    std::vector<double> ra0(n), dec0(n), ra(n), dec(n), alt(n), az(n);
+    for (int i = 0; i < n; ++i)
+    {
+        ra0[i]  = m_Points[i]->ra0().radians();
+        dec0[i] = m_Points[i]->dec0().radians();
+    }
+    batch.apparentCoords(ra0.data(), dec0.data(), ra.data(), dec.data(), n);
+    batch.toHorizontal(ra.data(), dec.data(), alt.data(), az.data(), n);
+
+    for (int i = 0; i < n; ++i)
+    {
+        SkyPoint &p = *m_Points[i];
+        p.updateCoordsNow(&num);
+        p.EquatorialToHorizontal(&m_LST, &m_Lat);
+
+        dms r, d, a, z;
+        r.setRadians(ra[i]);
+        d.setRadians(dec[i]);
+        a.setRadians(alt[i]);
+        z.setRadians(az[i]);
+        QVERIFY(separation(r, d, p.ra(), p.dec()) < arcsecTolerance);
+        QVERIFY(separation(z, a, p.az(), p.alt()) < arcsecTolerance);
+    }
+}
+
+void TestSkyPointBatch::benchmarkUpdateCoords_data()
+{
+    QTest::addColumn<bool>("useBatch");
+    QTest::newRow("scalar") << false;
+    QTest::newRow("batch") << true;
+}
+
+void TestSkyPointBatch::benchmarkUpdateCoords()
+{
+    QFETCH(bool, useBatch);
+    makePoints(10000);
+    KSNumbers num(KStarsDateTime::epochToJd(2017.8));
+
+    QBENCHMARK
+    {
+        if (useBatch)
+        {
+            SkyPointBatch(&num, &m_LST, &m_Lat).updateCoords(m_Points, true);
+        }
+        else
+        {
+            for (auto &p : m_Points)
+                p->updateCoordsNow(&num);
+        }
+    }
+}
+
+void TestSkyPointBatch::benchmarkEquatorialToHorizontal_data()
+{
+    benchmarkUpdateCoords_data();
+}
+
+void TestSkyPointBatch::benchmarkEquatorialToHorizontal()
+{
+    QFETCH(bool, useBatch);
+    makePoints(10000);
+
+    QBENCHMARK
+    {
+        if (useBatch)
+        {
+            SkyPointBatch(&m_LST, &m_Lat).EquatorialToHorizontal(m_Points);
+        }
+        else
+        {
+            for (auto &p : m_Points)
+                p->EquatorialToHorizontal(&m_LST, &m_Lat);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestSkyPointBatch)
@@ -0,0 +1,61 @@
+/***************************************************************************
+                 test_skypointbatch.h  -  KStars Planetarium
+                             -------------------
+    begin                : Sat 14 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEST_SKYPOINTBATCH_H
+#define TEST_SKYPOINTBATCH_H
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include "skyobjects/skypoint.h"
+
+#include <memory>
+#include <vector>
+
+/**
+ * @class TestSkyPointBatch
+ * @short Checks SkyPointBatch against the scalar SkyPoint conversions, and benchmarks both
+ */
+
+class TestSkyPointBatch : public QObject
+{
+    Q_OBJECT
+
+  public:
+    TestSkyPointBatch();
+    ~TestSkyPointBatch(){};
+
+  private slots:
+    void testUpdateCoords();
+    void testEquatorialToHorizontal();
+    void testArrays();
+
+    void benchmarkUpdateCoords_data();
+    void benchmarkUpdateCoords();
+    void benchmarkEquatorialToHorizontal_data();
+    void benchmarkEquatorialToHorizontal();
+
+  private:
+    /** @short Fill m_Points with points spread uniformly over the sky, avoiding the poles */
+    void makePoints(int count);
+
+    std::vector<std::unique_ptr<SkyPoint>> m_Points;
+    CachingDms m_LST;
+    CachingDms m_Lat;
+};
+
+#endif
@@ -25,9 +25,111 @@
 #include "deepskyobject.h"
 #include "skycomponent.h"
 
+#include <QHash>
 #include <QSqlTableModel>
 #include <QSqlRecord>
 #include <QSqlQuery>
+#include <QVector>
+
+#include <cmath>
+
+namespace
+{
+// Tolerances of CatalogDB::FindFuzzyEntry()
+const double PositionFuzz  = 0.0016;
+const double MagnitudeFuzz = 0.1;
+}
+
+/**
+ * Positions of the DSO table in a grid of PositionFuzz wide cells, so that all the
+ * candidates of a fuzzy match are in the 3x3 cells around the entry.
+ **/
+class CatalogDB::BulkImport
+{
+  public:
+    explicit BulkImport(QSqlDatabase &db) : add_dso(db), add_od(db), add_od_auto(db)
+    {
+        add_dso.prepare("INSERT INTO DSO (RA, Dec, Type, Magnitude, PositionAngle,"
+                        " MajorAxis, MinorAxis, Flux) VALUES (:RA, :Dec, :Type,"
+                        " :Magnitude, :PositionAngle, :MajorAxis, :MinorAxis,"
+                        " :Flux)");
+        add_od.prepare("INSERT INTO ObjectDesignation (id_Catalog, UID_DSO, LongName"
+                       ", IDNumber) VALUES (:catid, :rowuid, :longname, :id)");
+        add_od_auto.prepare("INSERT INTO ObjectDesignation (id_Catalog, UID_DSO, LongName"
+                            ", IDNumber) VALUES (:catid, :rowuid, :longname,"
+                            "(SELECT MAX(ISNULL(IDNumber,1))+1 FROM ObjectDesignation WHERE id_Catalog = :catid) )");
+
+        QSqlQuery existing(db);
+        existing.setForwardOnly(true);
+        if (existing.exec("SELECT UID, RA, Dec, Magnitude FROM DSO"))
+        {
+            while (existing.next())
+            {
+                // Rows without a magnitude never match
+                if (existing.value(3).isNull())
+                    continue;
+                insert(existing.value(0).toInt(), existing.value(1).toDouble(), existing.value(2).toDouble(),
+                       existing.value(3).toDouble());
+            }
+        }
+        else
+            qWarning() << existing.lastError();
+    }
+
+    /**
+     * @return the smallest UID within the fuzz of FindFuzzyEntry(), or -1 if none
+     **/
+    int find(double ra, double dec, double magnitude) const
+    {
+        int returnval    = -1;
+        const qint64 col = cell(ra), row = cell(dec);
+
+        for (qint64 r = row - 1; r <= row + 1; ++r)
+        {
+            for (qint64 c = col - 1; c <= col + 1; ++c)
+            {
+                auto entries = grid.constFind(key(c, r));
+                if (entries == grid.constEnd())
+                    continue;
+
+                for (const Entry &entry : entries.value())
+                {
+                    if (fabs(entry.ra - ra) <= PositionFuzz && fabs(entry.dec - dec) <= PositionFuzz &&
+                        fabs(entry.magnitude - magnitude) <= MagnitudeFuzz &&
+                        (returnval == -1 || entry.uid < returnval))
+                        returnval = entry.uid;
+                }
+            }
+        }
+
+        return returnval;
+    }
+
+    void insert(int uid, double ra, double dec, double magnitude)
+    {
+        Entry entry = { uid, ra, dec, magnitude };
+        grid[key(cell(ra), cell(dec))].append(entry);
+    }
+
+    QSqlQuery add_dso;
+    QSqlQuery add_od;
+    QSqlQuery add_od_auto;
+
+  private:
+    struct Entry
+    {
+        int uid;
+        double ra;
+        double dec;
+        double magnitude;
+    };
+
+    static qint64 cell(double degrees) { return static_cast<qint64>(floor(degrees / PositionFuzz)); }
+    // Rows of declinations are within +/- 2^19
+    static qint64 key(qint64 col, qint64 row) { return (col << 20) + row; }
+
+    QHash<qint64, QVector<Entry>> grid;
+};
 
 bool CatalogDB::Initialize()
 {
@@ -299,7 +401,33 @@ bool CatalogDB::AddEntry(const CatalogEntryData &catalog_entry, int catid)
     return retVal;
 }
 
-bool CatalogDB::_AddEntry(const CatalogEntryData &catalog_entry, int catid)
+int CatalogDB::AddEntries(const QList<CatalogEntryData> &catalog_entries, int catid)
+{
+    if (!skydb_.open())
+    {
+        qWarning() << "Failed to open database to add catalog entries!";
+        qWarning() << LastError();
+        return 0;
+    }
+
+    int added = 0;
+    skydb_.transaction();
+    {
+        BulkImport import(skydb_);
+
+        foreach (const CatalogEntryData &catalog_entry, catalog_entries)
+        {
+            if (_AddEntry(catalog_entry, catid, import))
+                added++;
+        }
+    }
+    skydb_.commit();
+    skydb_.close();
+
+    return added;
+}
+
+bool CatalogDB::IsValidEntry(const CatalogEntryData &catalog_entry, int catid)
 {
     // Verification step
     // If RA, Dec are Null, it denotes an invalid object and should not be written
@@ -315,6 +443,64 @@ bool CatalogDB::_AddEntry(const CatalogEntryData &catalog_entry, int catid)
                  << " Long Name: " << catalog_entry.long_name;
         return false;
     }
+    return true;
+}
+
+bool CatalogDB::_AddEntry(const CatalogEntryData &catalog_entry, int catid, BulkImport &import)
+{
+    if (!IsValidEntry(catalog_entry, catid))
+        return false;
+
+    // Fuzzy Match or Create New Entry
+    int rowuid = import.find(catalog_entry.ra, catalog_entry.dec, catalog_entry.magnitude);
+
+    if (rowuid == -1) //i.e. No fuzzy match found. Proceed to add new entry
+    {
+        QSqlQuery &add_query = import.add_dso;
+        add_query.bindValue(":RA", catalog_entry.ra);
+        add_query.bindValue(":Dec", catalog_entry.dec);
+        add_query.bindValue(":Type", catalog_entry.type);
+        add_query.bindValue(":Magnitude", catalog_entry.magnitude);
+        add_query.bindValue(":PositionAngle", catalog_entry.position_angle);
+        add_query.bindValue(":MajorAxis", catalog_entry.major_axis);
+        add_query.bindValue(":MinorAxis", catalog_entry.minor_axis);
+        add_query.bindValue(":Flux", catalog_entry.flux);
+        if (!add_query.exec())
+        {
+            qWarning() << "Custom Catalog Insert Query FAILED!";
+            qWarning() << add_query.lastQuery() << endl;
+            qWarning() << add_query.lastError() << endl;
+            return false;
+        }
+
+        // Find UID of the Row just added, later entries of the import may match it
+        rowuid = add_query.lastInsertId().toInt();
+        import.insert(rowuid, catalog_entry.ra, catalog_entry.dec, catalog_entry.magnitude);
+    }
+
+    // Add in Object Designation
+    QSqlQuery &add_od = (catalog_entry.ID >= 0) ? import.add_od : import.add_od_auto;
+    if (catalog_entry.ID >= 0)
+        add_od.bindValue(":id", catalog_entry.ID);
+    add_od.bindValue(":catid", catid);
+    add_od.bindValue(":rowuid", rowuid);
+    add_od.bindValue(":longname", catalog_entry.long_name);
+    if (!add_od.exec())
+    {
+        qWarning() << "Query exec failed:";
+        qWarning() << add_od.lastQuery();
+        qWarning() << skydb_.lastError();
+        return false;
+    }
+
+    return true;
+}
+
+bool CatalogDB::_AddEntry(const CatalogEntryData &catalog_entry, int catid)
+{
+    if (!IsValidEntry(catalog_entry, catid))
+        return false;
+
     // Part 1: Adding in DSO table
     // I will not use QSQLTableModel as I need to execute a query to find
     // out the lastInsertId
@@ -480,9 +666,7 @@ bool CatalogDB::AddCatalogContents(const QString &fname)
 
         int catid = FindCatalog(catalog_name);
 
-        skydb_.open();
-        skydb_.transaction();
-
+        QList<CatalogEntryData> catalog_entries;
         QHash<QString, QVariant> row_content;
         while (catalog_text_parser.HasNextRow())
         {
@@ -505,11 +689,10 @@ bool CatalogDB::AddCatalogContents(const QString &fname)
             catalog_entry.minor_axis     = row_content["Mn"].toFloat();
             catalog_entry.flux           = row_content["Flux"].toFloat();
 
-            _AddEntry(catalog_entry, catid);
+            catalog_entries.append(catalog_entry);
         }
 
-        skydb_.commit();
-        skydb_.close();
+        AddEntries(catalog_entries, catid);
     }
     return true;
 }
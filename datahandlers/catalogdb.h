@@ -152,6 +152,21 @@ class CatalogDB
      **/
     bool AddEntry(const CatalogEntryData &catalog_entry, int catid);
 
+    /**
+     * @brief Used to add many cross referenced entries into the database at once
+     *
+     * All entries are added in a single transaction, with prepared queries that are reused.
+     * Entries are matched against the DSO table and against each other with an in-memory
+     * index of the positions, instead of a query per entry.
+     *
+     * @note This public method opens and closes the database.
+     *
+     * @param catalog_entries Data structures with entry details
+     * @param catid Category ID in the database
+     * @return number of entries added
+     **/
+    int AddEntries(const QList<CatalogEntryData> &catalog_entries, int catid);
+
     /**
      * @brief Returns database ID of the required catalog.
      * Returns -1 if not found.
@@ -170,6 +185,28 @@ class CatalogDB
     void AddCatalog(const CatalogData &catalog_data);
 
   private:
+    /**
+     * @brief Prepared queries and position index used by AddEntries()
+     **/
+    class BulkImport;
+
+    /**
+     * @brief Checks the catalog ID and the coordinates of an entry before it is written
+     *
+     * @return false if the entry must not be added
+     **/
+    static bool IsValidEntry(const CatalogEntryData &catalog_entry, int catid);
+
+    /**
+     * @brief Used to add a cross referenced entry within AddEntries()
+     *
+     * @param catalog_entry Data structure with entry details
+     * @param catid Category ID in the database
+     * @param import Queries and index of the current import
+     * @return false if adding was unsuccessful
+     **/
+    bool _AddEntry(const CatalogEntryData &catalog_entry, int catid, BulkImport &import);
+
     /**
      * @brief Used to add a cross referenced entry into the database
      *
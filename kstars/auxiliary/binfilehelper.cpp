@@ -21,6 +21,7 @@
 #include "byteorder.h"
 #include "auxiliary/kspaths.h"
 
+#include <QFile>
 #include <QStandardPaths>
 
 class BinFileHelper;
@@ -28,6 +29,9 @@ class BinFileHelper;
 BinFileHelper::BinFileHelper()
 {
     fileHandle = nullptr;
+    mappedFile = nullptr;
+    mappedData = nullptr;
+    mappedSize = 0;
     init();
 }
 
@@ -41,6 +45,7 @@ BinFileHelper::~BinFileHelper()
 
 void BinFileHelper::init()
 {
+    unmapFile();
     if (fileHandle)
         fclose(fileHandle);
 
@@ -89,6 +94,7 @@ FILE *BinFileHelper::openFile(const QString &fileName)
         errnum = ERR_FILEOPEN;
         return nullptr;
     }
+    filePath = FilePath;
     return fileHandle;
 }
 
@@ -280,10 +286,51 @@ bool BinFileHelper::readHeader()
 
 void BinFileHelper::closeFile()
 {
+    unmapFile();
     fclose(fileHandle);
     fileHandle = nullptr;
 }
 
+bool BinFileHelper::mapFile()
+{
+    if (mappedData)
+        return true;
+    if (!fileHandle || filePath.isEmpty())
+        return false;
+
+    mappedFile = new QFile(filePath);
+    if (mappedFile->open(QIODevice::ReadOnly) && mappedFile->size() > 0)
+    {
+        mappedSize = mappedFile->size();
+        mappedData = mappedFile->map(0, mappedSize);
+    }
+
+    if (!mappedData)
+    {
+        // Not fatal, the caller falls back to reading through the FILE handle
+        delete mappedFile;
+        mappedFile = nullptr;
+        mappedSize = 0;
+        return false;
+    }
+
+    return true;
+}
+
+void BinFileHelper::unmapFile()
+{
+    if (mappedFile)
+    {
+        if (mappedData)
+            mappedFile->unmap(mappedData);
+        mappedFile->close();
+        delete mappedFile;
+    }
+    mappedFile = nullptr;
+    mappedData = nullptr;
+    mappedSize = 0;
+}
+
 int BinFileHelper::getErrorNumber()
 {
     int err = errnum;
@@ -24,6 +24,7 @@
 
 #include <cstdio>
 
+class QFile;
 class QString;
 
 /**
@@ -90,6 +91,42 @@ class BinFileHelper
 
     void closeFile();
 
+    /**
+         *@short  Map the whole of the currently open file into memory
+         *
+         *Once mapped, records can be accessed through getRecordPointer() as plain pointer
+         *arithmetic, without seeking or reading through the shared FILE handle. The mapping is
+         *released by unmapFile() or closeFile(). The FILE handle stays open and usable.
+         *@note   Records are returned as they are on disk, so callers must still honor getByteSwap()
+         *@return True if the file is mapped, false if mapping is not possible (eg. no file open)
+         */
+    bool mapFile();
+
+    /**
+         *@short  Release the memory mapping of the file, if any
+         */
+    void unmapFile();
+
+    /**
+         *@short  Check whether the file has been mapped into memory using mapFile()
+         */
+    inline bool isMapped() const { return mappedData != nullptr; }
+
+    /**
+         *@short  Returns a pointer to the mapped file contents at the given offset
+         *@param  offset  Offset in bytes from the beginning of the file
+         *@return Pointer into the mapping, or nullptr if the file is not mapped or the offset is out of range
+         */
+    inline const char *getRecordPointer(quint32 offset) const
+    {
+        return ((mappedData && offset < mappedSize) ? reinterpret_cast<const char *>(mappedData) + offset : nullptr);
+    }
+
+    /**
+         *@short  Returns the size of the mapped region in bytes, or zero if the file is not mapped
+         */
+    inline qint64 getMappedSize() const { return (mappedData ? mappedSize : 0); }
+
     /**
          *@short   Get error number
          *@return  A number corresponding to the error
@@ -270,6 +307,10 @@ class BinFileHelper
     void init();
 
     FILE *fileHandle;                   // Handle to the file.
+    QString filePath;                   // Full path of the currently open file
+    QFile *mappedFile;                  // File object owning the memory mapping, if any
+    uchar *mappedData;                  // Start of the memory mapping, nullptr if the file is not mapped
+    qint64 mappedSize;                  // Size of the memory mapping in bytes
     QVector<unsigned long> indexOffset; // Stores offsets corresponding to each index table entry
     QVector<unsigned int> indexCount;   // Stores number of records under each index table entry
     bool indexUpdated;                  // True if the data from the index, and associated properties have been updated
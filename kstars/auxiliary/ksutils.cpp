@@ -22,8 +22,10 @@
 #include "starobject.h"
 #include "Options.h"
 
+#include <QDebug>
 #include <QFile>
 #include <QProcessEnvironment>
+#include <QSaveFile>
 #include <QtNumeric>
 #include <QUrl>
 #include <QStandardPaths>
@@ -52,6 +54,17 @@ bool openDataFile(QFile &file, const QString &s)
     return false;
 }
 
+bool saveFile(const QString &fileName, const QByteArray &contents)
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(contents) != contents.size() || !file.commit())
+    {
+        qWarning() << "Could not write file" << fileName << file.errorString();
+        return false;
+    }
+    return true;
+}
+
 QString getDSSURL(const SkyPoint *const p)
 {
     const DeepSkyObject *dso = 0;
@@ -66,6 +66,15 @@ namespace KSUtils
  */
 bool openDataFile(QFile &file, const QString &filename);
 
+/** Write contents to the file named fileName through a QSaveFile, which replaces the file only once all of
+ *contents is written. A file being read or mapped is never seen partially written. A warning is logged on failure.
+ *@short Replace a file at once.
+ *@param fileName The name of the file.
+ *@param contents The data the file holds afterwards.
+ *@returns bool Returns true if the file was written.
+ */
+bool saveFile(const QString &fileName, const QByteArray &contents);
+
 /** Clamp value into range.
  *  @p x  value to clamp.
  *  @p min  minimal allowed value.
@@ -24,7 +24,10 @@
 #include "skyobjects/deepskyobject.h"
 #include "skycomponents/starcomponent.h"
 #include "skycomponents/syncedcatalogcomponent.h"
+#include "skycomponents/asteroidscomponent.h"
 #include "skycomponents/skymapcomposite.h"
+#include "skycomponents/skyobjectindex.h"
+#include "skycomponents/solarsystemcomposite.h"
 #include "tools/nameresolver.h"
 #include "skyobjectlistmodel.h"
 
@@ -34,6 +37,59 @@
 #include <QStringListModel>
 #include <QTimer>
 
+namespace
+{
+// Objects taken from the name index when looking for the first item to select
+const int PrefixMatchLimit = 100;
+
+// Types of the objects listed with a filter, or an empty list for all of them
+QList<int> listedTypes(int filter)
+{
+    switch (filter)
+    {
+        case 1: //Stars
+            return { SkyObject::STAR, SkyObject::CATALOG_STAR };
+        case 2: //Solar system
+            return { SkyObject::PLANET, SkyObject::COMET, SkyObject::ASTEROID, SkyObject::MOON };
+        case 3: //Open Clusters
+            return { SkyObject::OPEN_CLUSTER };
+        case 4: //Globular Clusters
+            return { SkyObject::GLOBULAR_CLUSTER };
+        case 5: //Gaseous nebulae
+            return { SkyObject::GASEOUS_NEBULA };
+        case 6: //Planetary nebula
+            return { SkyObject::PLANETARY_NEBULA };
+        case 7: //Galaxies
+            return { SkyObject::GALAXY };
+        case 8: //Comets
+            return { SkyObject::COMET };
+        case 9: //Asteroids
+            return { SkyObject::ASTEROID };
+        case 10: //Constellations
+            return { SkyObject::CONSTELLATION };
+        case 11: //Supernovae
+            return { SkyObject::SUPERNOVA };
+        case 12: //Satellites
+            return { SkyObject::SATELLITE };
+        default: // All object types
+            return QList<int>();
+    }
+}
+
+// Name of obj starting with prefix, as listed
+QString prefixName(const SkyObject *obj, const QString &prefix)
+{
+    if (!obj->name().startsWith(prefix, Qt::CaseInsensitive))
+    {
+        if (obj->longname().startsWith(prefix, Qt::CaseInsensitive))
+            return obj->longname();
+        if (obj->name2().startsWith(prefix, Qt::CaseInsensitive))
+            return obj->name2();
+    }
+    return obj->name();
+}
+}
+
 FindDialogUI::FindDialogUI(QWidget *parent) : QFrame(parent)
 {
     setupUi(this);
@@ -181,70 +237,20 @@ void FindDialog::initSelection()
 
 void FindDialog::filterByType()
 {
-    KStarsData *data = KStarsData::Instance();
+    SkyMapComposite *composite = KStarsData::Instance()->skyComposite();
+    QList<int> types           = listedTypes(ui->FilterType->currentIndex());
+    if (types.isEmpty())
+        types = composite->objectLists().keys();
 
-    switch (ui->FilterType->currentIndex())
-    {
-        case 0: // All object types
-        {
-            QVector<QPair<QString, const SkyObject *>> allObjects;
-            foreach (int type, data->skyComposite()->objectLists().keys())
-            {
-                allObjects.append(data->skyComposite()->objectLists(SkyObject::TYPE(type)));
-            }
-            fModel->setSkyObjectsList(allObjects);
-            break;
-        }
-        case 1: //Stars
-        {
-            QVector<QPair<QString, const SkyObject *>> starObjects;
-            starObjects.append(data->skyComposite()->objectLists(SkyObject::STAR));
-            starObjects.append(data->skyComposite()->objectLists(SkyObject::CATALOG_STAR));
-            fModel->setSkyObjectsList(starObjects);
-            break;
-        }
-        case 2: //Solar system
-        {
-            QVector<QPair<QString, const SkyObject *>> ssObjects;
-            ssObjects.append(data->skyComposite()->objectLists(SkyObject::PLANET));
-            ssObjects.append(data->skyComposite()->objectLists(SkyObject::COMET));
-            ssObjects.append(data->skyComposite()->objectLists(SkyObject::ASTEROID));
-            ssObjects.append(data->skyComposite()->objectLists(SkyObject::MOON));
+    QVector<QPair<QString, const SkyObject *>> objects;
+    for (int type : types)
+        objects.append(composite->objectLists(type));
 
-            fModel->setSkyObjectsList(ssObjects);
-            break;
-        }
-        case 3: //Open Clusters
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::OPEN_CLUSTER));
-            break;
-        case 4: //Globular Clusters
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::GLOBULAR_CLUSTER));
-            break;
-        case 5: //Gaseous nebulae
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::GASEOUS_NEBULA));
-            break;
-        case 6: //Planetary nebula
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::PLANETARY_NEBULA));
-            break;
-        case 7: //Galaxies
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::GALAXY));
-            break;
-        case 8: //Comets
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::COMET));
-            break;
-        case 9: //Asteroids
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::ASTEROID));
-            break;
-        case 10: //Constellations
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::CONSTELLATION));
-            break;
-        case 11: //Supernovae
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::SUPERNOVA));
-            break;
-        case 12: //Satellites
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::SATELLITE));
-            break;
-    }
+    // Faint asteroids are listed by name, and created once picked
+    if (types.contains(SkyObject::ASTEROID) && composite->solarSystemComposite())
+        objects.append(composite->solarSystemComposite()->asteroidsComponent()->uncreatedList());
+
+    fModel->setSkyObjectsList(objects);
 }
 
 void FindDialog::filterList()
@@ -255,28 +261,36 @@ void FindDialog::filterList()
     filterByType();
     initSelection();
 
-    //Select the first item in the list that begins with the filter string
+    //Select the first item in the list that begins with the filter string. The names are taken in order from the
+    //name index, rather than by matching every item of the list.
     if (!SearchText.isEmpty())
     {
-        QStringList mItems = fModel->filter(QRegExp('^' + SearchText, Qt::CaseInsensitive));
-        mItems.sort();
+        bool exactMatch                = false;
+        const QList<int> types         = listedTypes(ui->FilterType->currentIndex());
+        const QList<SkyObject *> found = KStarsData::Instance()->skyComposite()->objectIndex().findByPrefix(
+            SearchText, PrefixMatchLimit);
 
-        if (mItems.size())
+        for (const SkyObject *obj : found)
         {
-            QModelIndex qmi        = fModel->index(fModel->indexOf(mItems[0]));
-            QModelIndex selectItem = sortModel->mapFromSource(qmi);
+            // Not listed with the current filter
+            if (!types.isEmpty() && !types.contains(obj->type()))
+                continue;
 
-            if (selectItem.isValid())
-            {
-                ui->SearchList->selectionModel()->select(selectItem, QItemSelectionModel::ClearAndSelect);
-                ui->SearchList->scrollTo(selectItem);
-                ui->SearchList->setCurrentIndex(selectItem);
+            const QString name     = prefixName(obj, SearchText);
+            QModelIndex selectItem = sortModel->mapFromSource(fModel->index(fModel->indexOf(name)));
+            if (!selectItem.isValid())
+                continue;
 
-                okB->setEnabled(true);
-            }
+            ui->SearchList->selectionModel()->select(selectItem, QItemSelectionModel::ClearAndSelect);
+            ui->SearchList->scrollTo(selectItem);
+            ui->SearchList->setCurrentIndex(selectItem);
+
+            okB->setEnabled(true);
+            exactMatch = (name == SearchText);
+            break;
         }
-        ui->InternetSearchButton->setEnabled(!mItems.contains(
-            SearchText)); // Disable searching the internet when an exact match for SearchText exists in KStars
+        ui->InternetSearchButton->setEnabled(
+            !exactMatch); // Disable searching the internet when an exact match for SearchText exists in KStars
     }
     else
         ui->InternetSearchButton->setEnabled(false);
@@ -288,7 +302,15 @@ SkyObject *FindDialog::selectedObject() const
 {
     QModelIndex i = ui->SearchList->currentIndex();
     QVariant sObj = sortModel->data(sortModel->index(i.row(), 0), SkyObjectListModel::SkyObjectRole);
-    return (SkyObject *)sObj.value<void *>();
+    SkyObject *obj = (SkyObject *)sObj.value<void *>();
+
+    // A faint asteroid listed by name is created now
+    if (!obj && i.isValid())
+    {
+        const QString name = sortModel->data(sortModel->index(i.row(), 0)).toString();
+        obj                = KStarsData::Instance()->skyComposite()->findByName(name);
+    }
+    return obj;
 }
 
 void FindDialog::enqueueSearch()
@@ -343,6 +365,9 @@ void FindDialog::slotOk()
         filterList();
     }
     selObj = selectedObject();
+    // Names that are not listed, such as the genetive names of stars, before resolving them online
+    if (!selObj)
+        selObj = KStarsData::Instance()->skyComposite()->findByName(processSearchText());
     finishProcessing(selObj, Options::resolveNamesOnline());
 }
 
@@ -7,8 +7,12 @@
     version 2 of the License, or (at your option) any later version.
  */
 
+#include <QSet>
+#include <QtConcurrent>
 #include <QVariantMap>
 
+#include <algorithm>
+
 #include "darklibrary.h"
 #include "Options.h"
 
@@ -17,6 +21,7 @@
 #include "kstarsdata.h"
 #include "fitsviewer/fitsview.h"
 #include "fitsviewer/fitsdata.h"
+#include "fitsviewer/fitskernels.h"
 #include "auxiliary/ksuserdb.h"
 
 namespace Ekos
@@ -34,6 +39,9 @@ DarkLibrary *DarkLibrary::Instance()
 DarkLibrary::DarkLibrary(QObject *parent) : QObject(parent)
 {
     KStarsData::Instance()->userdb()->GetAllDarkFrames(darkFrames);
+    buildIndex();
+
+    connect(&darkStackWatcher, SIGNAL(finished()), this, SLOT(darkFramesCombined()));
 
     subtractParams.duration    = 0;
     subtractParams.offsetX     = 0;
@@ -47,70 +55,105 @@ DarkLibrary::DarkLibrary(QObject *parent) : QObject(parent)
 
 DarkLibrary::~DarkLibrary()
 {
-    qDeleteAll(darkFiles);
+    darkStackWatcher.waitForFinished();
+    qDeleteAll(darkStack);
 }
 
 void DarkLibrary::refreshFromDB()
 {
     KStarsData::Instance()->userdb()->GetAllDarkFrames(darkFrames);
+    buildIndex();
+
+    // Release the dark frames that were removed from the database
+    QSet<QString> filenames;
+    foreach (const QVariantMap &map, darkFrames)
+        filenames.insert(map["filename"].toString());
+
+    foreach (const QString &filename, darkFiles.keys())
+    {
+        if (filenames.contains(filename) == false)
+            darkFiles.remove(filename);
+    }
+}
+
+QString DarkLibrary::indexKey(const QString &ccd, int chip, int binX, int binY)
+{
+    return QString("%1/%2/%3x%4").arg(ccd).arg(chip).arg(binX).arg(binY);
+}
+
+void DarkLibrary::buildIndex()
+{
+    darkIndex.clear();
+
+    foreach (const QVariantMap &map, darkFrames)
+        indexDarkFrame(map);
+}
+
+void DarkLibrary::indexDarkFrame(const QVariantMap &map)
+{
+    DarkFrameInfo frame;
+    frame.filename    = map["filename"].toString();
+    frame.duration    = map["duration"].toDouble();
+    frame.temperature = map["temperature"].toDouble();
+    frame.timestamp   = QDateTime::fromString(map["timestamp"].toString(), Qt::ISODate);
+
+    QVector<DarkFrameInfo> &frames =
+        darkIndex[indexKey(map["ccd"].toString(), map["chip"].toInt(), map["binX"].toInt(), map["binY"].toInt())];
+
+    // Keep the frames sorted by duration, and frames of equal duration in database order
+    auto position = std::upper_bound(frames.begin(), frames.end(), frame.duration,
+                                     [](double duration, const DarkFrameInfo &other) { return duration < other.duration; });
+    frames.insert(position, frame);
 }
 
 FITSData *DarkLibrary::getDarkFrame(ISD::CCDChip *targetChip, double duration)
 {
-    foreach (QVariantMap map, darkFrames)
+    int binX, binY;
+    targetChip->getBinning(&binX, &binY);
+
+    // First check CCD name, chip and binning match
+    auto frames = darkIndex.find(indexKey(targetChip->getCCD()->getDeviceName(), static_cast<int>(targetChip->getType()),
+                                          binX, binY));
+    if (frames == darkIndex.end())
+        return nullptr;
+
+    double temperature = 0;
+    bool hasCooler     = targetChip->getCCD()->hasCooler();
+    if (hasCooler)
+        targetChip->getCCD()->getTemperature(&temperature);
+
+    // Then check for duration, only frames within 0.05 seconds are considered
+    // TODO make this value configurable
+    auto frame = std::lower_bound(frames->begin(), frames->end(), duration - 0.05,
+                                  [](const DarkFrameInfo &other, double value) { return other.duration < value; });
+
+    for (; frame != frames->end() && frame->duration <= duration + 0.05; ++frame)
     {
-        // First check CCD name matches
-        if (map["ccd"].toString() == targetChip->getCCD()->getDeviceName())
+        // Then check for temperature
+        if (hasCooler && fabs(frame->temperature - temperature) > Options::maxDarkTemperatureDiff())
+            continue;
+
+        // Finaly check if the duration is acceptable
+        if (frame->timestamp.daysTo(QDateTime::currentDateTime()) > Options::darkLibraryDuration())
+            continue;
+
+        QString filename = frame->filename;
+
+        if (darkFiles.contains(filename))
+            return darkFiles.object(filename);
+
+        // Finally we made it, let's put it in the cache
+        bool rc = loadDarkFile(filename);
+        if (rc)
+            return darkFiles.object(filename);
+        else
         {
-            // Then check we are on the correct chip
-            if (map["chip"].toInt() == static_cast<int>(targetChip->getType()))
-            {
-                int binX, binY;
-                targetChip->getBinning(&binX, &binY);
-
-                // Then check if binning is the same
-                if (map["binX"].toInt() == binX && map["binY"].toInt() == binY)
-                {
-                    // Then check for temperature
-                    if (targetChip->getCCD()->hasCooler())
-                    {
-                        double temperature = 0;
-                        targetChip->getCCD()->getTemperature(&temperature);
-                        // TODO make this configurable value, the threshold
-                        if (fabs(map["temperature"].toDouble() - temperature) > Options::maxDarkTemperatureDiff())
-                            continue;
-                    }
-
-                    // Then check for duration
-                    // TODO make this value configurable
-                    if (fabs(map["duration"].toDouble() - duration) > 0.05)
-                        continue;
-
-                    // Finaly check if the duration is acceptable
-                    QDateTime frameTime = QDateTime::fromString(map["timestamp"].toString(), Qt::ISODate);
-                    if (frameTime.daysTo(QDateTime::currentDateTime()) > Options::darkLibraryDuration())
-                        continue;
-
-                    QString filename = map["filename"].toString();
-
-                    if (darkFiles.contains(filename))
-                        return darkFiles[filename];
-
-                    // Finally we made it, let's put it in the hash
-                    bool rc = loadDarkFile(filename);
-                    if (rc)
-                        return darkFiles[filename];
-                    else
-                    {
-                        // Remove bad dark frame
-                        emit newLog(i18n("Removing bad dark frame file %1", filename));
-                        darkFiles.remove(filename);
-                        QFile::remove(filename);
-                        KStarsData::Instance()->userdb()->DeleteDarkFrame(filename);
-                        return nullptr;
-                    }
-                }
-            }
+            // Remove bad dark frame
+            emit newLog(i18n("Removing bad dark frame file %1", filename));
+            QFile::remove(filename);
+            KStarsData::Instance()->userdb()->DeleteDarkFrame(filename);
+            frames->erase(frame);
+            return nullptr;
         }
     }
 
@@ -124,7 +167,7 @@ bool DarkLibrary::loadDarkFile(const QString &filename)
     bool rc = darkData->loadFITS(filename);
 
     if (rc)
-        darkFiles[filename] = darkData;
+        cacheDarkFile(filename, darkData);
     else
     {
         emit newLog(i18n("Failed to load dark frame file %1", filename));
@@ -134,6 +177,16 @@ bool DarkLibrary::loadDarkFile(const QString &filename)
     return rc;
 }
 
+void DarkLibrary::cacheDarkFile(const QString &filename, FITSData *darkData)
+{
+    int cost = qMax(1, static_cast<int>(static_cast<qint64>(darkData->getSize()) * darkData->getNumOfChannels() *
+                                        darkData->getBytesPerPixel() / 1024));
+
+    // A dark frame larger than the whole cache is still kept, alone, until the next one is needed
+    darkFiles.setMaxCost(qMax(static_cast<int>(Options::darkCacheSize()) * 1024, cost));
+    darkFiles.insert(filename, darkData, cost);
+}
+
 bool DarkLibrary::saveDarkFile(FITSData *darkData)
 {
     // IS8601 contains colons but they are illegal under Windows OS, so replacing them with '-'
@@ -148,7 +201,7 @@ bool DarkLibrary::saveDarkFile(FITSData *darkData)
         return false;
     }
 
-    darkFiles[path] = darkData;
+    cacheDarkFile(path, darkData);
 
     QVariantMap map;
     int binX, binY;
@@ -166,6 +219,7 @@ bool DarkLibrary::saveDarkFile(FITSData *darkData)
     map["filename"]    = path;
 
     darkFrames.append(map);
+    indexDarkFrame(map);
 
     emit newLog(i18n("Dark frame saved to %1", path));
 
@@ -233,23 +287,17 @@ bool DarkLibrary::subtract(FITSData *darkData, FITSView *lightImage, FITSScale f
     int darkoffset = offsetX + offsetY * darkData->getWidth();
     int darkW      = darkData->getWidth();
 
-    int lightOffset = 0;
-    int lightW      = lightData->getWidth();
-    int lightH      = lightData->getHeight();
+    int lightW = lightData->getWidth();
+    int lightH = lightData->getHeight();
 
-    for (int i = 0; i < lightH; i++)
-    {
-        for (int j = 0; j < lightW; j++)
-        {
-            if (lightBuffer[j + lightOffset] > darkBuffer[j + darkoffset])
-                lightBuffer[j + lightOffset] -= darkBuffer[j + darkoffset];
-            else
-                lightBuffer[j + lightOffset] = 0;
-        }
-
-        lightOffset += lightW;
-        darkoffset += darkW;
-    }
+    // Rows are subtracted in parallel, each one with a branchless saturating kernel
+    FITSKernels::forEachBlock(lightH,
+                              [&](uint32_t begin, uint32_t end) {
+                                  for (uint32_t i = begin; i < end; i++)
+                                      FITSKernels::subtractSaturated(lightBuffer + i * lightW,
+                                                                     darkBuffer + darkoffset + i * darkW, lightW);
+                              },
+                              64);
 
     lightData->applyFilter(filter);
     if (filter == FITS_NONE)
@@ -331,25 +379,130 @@ void DarkLibrary::newFITS(IBLOB *bp)
 
     Q_ASSERT(subtractParams.targetChip);
 
-    disconnect(subtractParams.targetChip->getCCD(), SIGNAL(BLOBUpdated(IBLOB *)), this, SLOT(newFITS(IBLOB *)));
-
     FITSView *calibrationView = subtractParams.targetChip->getImageView(FITS_CALIBRATE);
-
-    emit newLog(i18n("Dark frame received."));
+    int count                 = qMax(1u, Options::darkFramesCount());
 
     FITSData *calibrationData = new FITSData();
 
     // Deep copy of the data
-    if (calibrationData->loadFITS(calibrationView->getImageData()->getFilename()))
+    if (calibrationData->loadFITS(calibrationView->getImageData()->getFilename()) == false)
+    {
+        disconnect(subtractParams.targetChip->getCCD(), SIGNAL(BLOBUpdated(IBLOB *)), this, SLOT(newFITS(IBLOB *)));
+        delete (calibrationData);
+        qDeleteAll(darkStack);
+        darkStack.clear();
+        emit darkFrameCompleted(false);
+        emit newLog(i18n("Warning: Cannot load calibration file %1", calibrationView->getImageData()->getFilename()));
+        return;
+    }
+
+    if (count == 1)
     {
+        disconnect(subtractParams.targetChip->getCCD(), SIGNAL(BLOBUpdated(IBLOB *)), this, SLOT(newFITS(IBLOB *)));
+
+        emit newLog(i18n("Dark frame received."));
+
         saveDarkFile(calibrationData);
         subtract(calibrationData, subtractParams.targetImage, subtractParams.targetChip->getCaptureFilter(),
                  subtractParams.offsetX, subtractParams.offsetY);
+        return;
     }
-    else
+
+    darkStack.append(calibrationData);
+    emit newLog(i18n("Dark frame %1 of %2 received.", darkStack.count(), count));
+
+    if (darkStack.count() < count)
     {
+        subtractParams.targetChip->capture(subtractParams.duration);
+        return;
+    }
+
+    disconnect(subtractParams.targetChip->getCCD(), SIGNAL(BLOBUpdated(IBLOB *)), this, SLOT(newFITS(IBLOB *)));
+
+    emit newLog(i18n("Combining %1 dark frames...", count));
+
+    darkStackWatcher.setFuture(QtConcurrent::run([this]() { return combineDarkFrames(); }));
+}
+
+void DarkLibrary::darkFramesCombined()
+{
+    FITSData *masterData = darkStack.takeFirst();
+    qDeleteAll(darkStack);
+    darkStack.clear();
+
+    if (darkStackWatcher.result() == false)
+    {
+        delete (masterData);
         emit darkFrameCompleted(false);
-        emit newLog(i18n("Warning: Cannot load calibration file %1", calibrationView->getImageData()->getFilename()));
+        emit newLog(i18n("Warning: Dark frames do not have the same size and type."));
+        return;
     }
+
+    emit newLog(i18n("Master dark frame ready."));
+
+    saveDarkFile(masterData);
+    subtract(masterData, subtractParams.targetImage, subtractParams.targetChip->getCaptureFilter(),
+             subtractParams.offsetX, subtractParams.offsetY);
+}
+
+bool DarkLibrary::combineDarkFrames()
+{
+    switch (darkStack.first()->getDataType())
+    {
+        case TBYTE:
+            return combineDarkFrames<uint8_t>();
+
+        case TSHORT:
+            return combineDarkFrames<int16_t>();
+
+        case TUSHORT:
+            return combineDarkFrames<uint16_t>();
+
+        case TLONG:
+            return combineDarkFrames<int32_t>();
+
+        case TULONG:
+            return combineDarkFrames<uint32_t>();
+
+        case TFLOAT:
+            return combineDarkFrames<float>();
+
+        case TLONGLONG:
+            return combineDarkFrames<int64_t>();
+
+        case TDOUBLE:
+            return combineDarkFrames<double>();
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+template <typename T>
+bool DarkLibrary::combineDarkFrames()
+{
+    FITSData *masterData = darkStack.first();
+    uint32_t samples     = masterData->getSize() * masterData->getNumOfChannels();
+
+    QVector<const T *> frames;
+    foreach (FITSData *darkData, darkStack)
+    {
+        if (darkData->getDataType() != masterData->getDataType() || darkData->getWidth() != masterData->getWidth() ||
+            darkData->getHeight() != masterData->getHeight() ||
+            darkData->getNumOfChannels() != masterData->getNumOfChannels())
+            return false;
+
+        frames.append(reinterpret_cast<const T *>(darkData->getImageBuffer()));
+    }
+
+    // The first frame is also an input, so the median goes to a separate buffer first
+    QVector<T> master(samples);
+    FITSKernels::median(frames, master.data(), samples);
+    std::copy(master.constBegin(), master.constEnd(), reinterpret_cast<T *>(masterData->getImageBuffer()));
+
+    masterData->calculateStats(true);
+    return true;
 }
 }
@@ -10,6 +10,9 @@
 #ifndef DARKLIBRARY_H
 #define DARKLIBRARY_H
 
+#include <QCache>
+#include <QDateTime>
+#include <QFutureWatcher>
 #include <QObject>
 #include "indi/indiccd.h"
 
@@ -18,7 +21,8 @@ namespace Ekos
 /**
  *@class DarkLibrary
  *@short Handles aquisition & loading of dark frames for cameras. If a suitable dark frame exists, it is loaded from disk, otherwise it gets captured and saved
- * for later use.
+ * for later use. When Options::darkFramesCount() is more than one, that many dark frames are captured and median-combined into a master dark.
+ * Loaded dark frames are kept in memory, up to Options::darkCacheSize() megabytes, and the least recently used are released first.
  *@author Jasem Mutlaq
  *@version 1.0
  */
@@ -47,19 +51,49 @@ class DarkLibrary : public QObject
          */
     void newFITS(IBLOB *bp);
 
+  private slots:
+    void darkFramesCombined();
+
   private:
     DarkLibrary(QObject *parent);
     ~DarkLibrary();
     static DarkLibrary *_DarkLibrary;
 
+    struct DarkFrameInfo
+    {
+        QString filename;
+        double duration;
+        double temperature;
+        QDateTime timestamp;
+    };
+
+    // Key of the dark frames of a camera chip at a given binning
+    static QString indexKey(const QString &ccd, int chip, int binX, int binY);
+    void buildIndex();
+    void indexDarkFrame(const QVariantMap &map);
+
     bool loadDarkFile(const QString &filename);
     bool saveDarkFile(FITSData *darkData);
+    // Takes ownership of darkData, which may release other dark frames
+    void cacheDarkFile(const QString &filename, FITSData *darkData);
 
     template <typename T>
     bool subtract(FITSData *darkData, FITSView *lightImage, FITSScale filter, uint16_t offsetX, uint16_t offsetY);
 
+    // Median of darkStack, stored in the first frame of the stack. Runs in a worker thread.
+    bool combineDarkFrames();
+    template <typename T>
+    bool combineDarkFrames();
+
     QList<QVariantMap> darkFrames;
-    QHash<QString, FITSData *> darkFiles;
+    // Dark frames for each indexKey(), sorted by duration
+    QHash<QString, QVector<DarkFrameInfo>> darkIndex;
+    // Loaded dark frames, with their size in KiB as cost
+    QCache<QString, FITSData> darkFiles;
+
+    // Dark frames captured so far for the master dark
+    QList<FITSData *> darkStack;
+    QFutureWatcher<bool> darkStackWatcher;
 
     struct
     {
@@ -2305,29 +2305,7 @@ void Guide::showFITSViewer()
 {
     FITSData *data = guideView->getImageData();
     if (data)
-    {
-        QUrl url = QUrl::fromLocalFile(data->getFilename());
-
-        if (fv.isNull())
-        {
-            if (Options::singleWindowCapturedFITS())
-                fv = KStars::Instance()->genericFITSViewer();
-            else
-            {
-                fv = new FITSViewer(Options::independentWindowFITS() ? nullptr : KStars::Instance());
-                KStars::Instance()->getFITSViewersList().append(fv);
-            }
-
-            fv->addFITS(&url);
-            FITSView *currentView = fv->getCurrentView();
-            if (currentView)
-                currentView->getImageData()->setAutoRemoveTemporaryFITS(false);
-        }
-        else
-            fv->updateFITS(&url, 0);
-
-        fv->show();
-    }
+        FITSViewer::showImageData(fv, data);
 }
 
 void Guide::setBLOBEnabled(bool enable)
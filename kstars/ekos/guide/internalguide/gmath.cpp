@@ -78,6 +78,8 @@ cgmath::cgmath() : QObject()
 
     ditherRate[0] = ditherRate[1] = -1;
 
+    imageGuideWorkspace = new ImageAutoGuiding::Workspace();
+
     // processing
     in_params.reset();
     out_params.reset();
@@ -100,10 +102,7 @@ cgmath::~cgmath()
     delete[] drift[GUIDE_RA];
     delete[] drift[GUIDE_DEC];
 
-    foreach (float *region, referenceRegions)
-        delete[] region;
-
-    referenceRegions.clear();
+    delete imageGuideWorkspace;
 }
 
 bool cgmath::setVideoParameters(int vid_wd, int vid_ht, int binX, int binY)
@@ -497,12 +496,8 @@ void cgmath::start(void)
     // Create reference Image
     if (imageGuideEnabled)
     {
-        foreach (float *region, referenceRegions)
-            delete[] region;
-
-        referenceRegions.clear();
-
-        referenceRegions = partitionImage();
+        if (loadRegions())
+            imageGuideWorkspace->setReference();
 
         reticle_pos = Vector(0, 0, 0);
     }
@@ -533,142 +528,80 @@ void cgmath::setLostStar(bool is_lost)
     lost_star = is_lost;
 }
 
-float *cgmath::createFloatImage() const
+bool cgmath::loadRegions() const
 {
     FITSData *imageData = guideView->getImageData();
 
-    // #1 Convert to float array
-    // We only process 1st plane if it is a color image
-    uint32_t imgSize = imageData->getSize();
-    float *imgFloat  = new float[imgSize];
-    if (imgFloat == nullptr)
-    {
-        qCritical() << "Not enough memory for float image array!";
-        return nullptr;
-    }
-
     switch (imageData->getDataType())
     {
         case TBYTE:
-        {
-            uint8_t *buffer = imageData->getImageBuffer();
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
+            return loadRegions<uint8_t>();
 
         case TSHORT:
-        {
-            int16_t *buffer = reinterpret_cast<int16_t *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
+            return loadRegions<int16_t>();
 
         case TUSHORT:
-        {
-            uint16_t *buffer = reinterpret_cast<uint16_t *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
+            return loadRegions<uint16_t>();
 
         case TLONG:
-        {
-            int32_t *buffer = reinterpret_cast<int32_t *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
+            return loadRegions<int32_t>();
 
         case TULONG:
-        {
-            uint32_t *buffer = reinterpret_cast<uint32_t *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
+            return loadRegions<uint32_t>();
 
         case TFLOAT:
-        {
-            float *buffer = reinterpret_cast<float *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
+            return loadRegions<float>();
 
         case TLONGLONG:
-        {
-            int64_t *buffer = reinterpret_cast<int64_t *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
+            return loadRegions<int64_t>();
 
         case TDOUBLE:
-        {
-            double *buffer = reinterpret_cast<double *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
+            return loadRegions<double>();
 
         default:
-            return nullptr;
+            return false;
     }
-
-    return imgFloat;
 }
 
-QVector<float *> cgmath::partitionImage() const
+template <typename T>
+bool cgmath::loadRegions() const
 {
-    QVector<float *> regions;
-
     FITSData *imageData = guideView->getImageData();
 
-    float *imgFloat = createFloatImage();
-
-    if (imgFloat == nullptr)
-        return regions;
-
+    // We only process 1st plane if it is a color image
+    const T *buffer       = reinterpret_cast<const T *>(imageData->getImageBuffer());
     const uint32_t width  = imageData->getWidth();
     const uint32_t height = imageData->getHeight();
 
-    uint8_t xRegions = floor(width / regionAxis);
-    uint8_t yRegions = floor(height / regionAxis);
     // Find number of regions to divide the image
-    //uint8_t regions =  xRegions * yRegions;
+    const uint32_t xRegions = width / regionAxis;
+    const uint32_t yRegions = height / regionAxis;
 
-    float *regionPtr = imgFloat;
+    if (buffer == nullptr || xRegions * yRegions == 0)
+        return false;
+
+    // Keeps the buffers, and the reference, as long as the layout does not change
+    imageGuideWorkspace->resize(regionAxis, xRegions * yRegions);
 
-    for (uint8_t i = 0; i < yRegions; i++)
+    for (uint32_t i = 0; i < yRegions; i++)
     {
-        for (uint8_t j = 0; j < xRegions; j++)
+        for (uint32_t j = 0; j < xRegions; j++)
         {
-            // Allocate space for one region
-            float *oneRegion = new float[regionAxis * regionAxis];
-            // Create points to region and current location of the source image in the desired region
-            float *oneRegionPtr = oneRegion, *imgFloatPtr = regionPtr + j * regionAxis;
+            // Convert to float straight into the region, line by line
+            float *region   = imageGuideWorkspace->region(i * xRegions + j);
+            const T *source = buffer + i * regionAxis * width + j * regionAxis;
 
-            // copy from image to region line by line
             for (uint32_t line = 0; line < regionAxis; line++)
             {
-                memcpy(oneRegionPtr, imgFloatPtr, regionAxis);
-                oneRegionPtr += regionAxis;
-                imgFloatPtr += width;
+                for (uint32_t k = 0; k < regionAxis; k++)
+                    region[k] = source[k];
+                region += regionAxis;
+                source += width;
             }
-
-            regions.append(oneRegion);
         }
-
-        // Move regionPtr block by (width * regionAxis) elements
-        regionPtr += width * regionAxis;
     }
 
-    // We're done with imgFloat
-    delete[] imgFloat;
-
-    return regions;
+    return true;
 }
 
 void cgmath::setRegionAxis(const uint32_t &value)
@@ -687,56 +620,44 @@ Vector cgmath::findLocalStarPosition(void) const
 
     if (imageGuideEnabled)
     {
-        float xshift = 0, yshift = 0;
-
         QVector<Vector> shifts;
         float xsum = 0, ysum = 0;
 
-        QVector<float *> imageParition = partitionImage();
-
-        if (imageParition.isEmpty())
+        if (!imageGuideWorkspace->hasReference())
         {
-            qWarning() << "Failed to partiion regions in image!";
+            qWarning() << "No reference regions for image guiding!";
             return Vector(-1, -1, -1);
         }
 
-        if (imageParition.count() != referenceRegions.count())
-        {
-            qWarning() << "Mismatch between reference regions #" << referenceRegions.count()
-                       << "and image parition regions #" << imageParition.count();
-            // Clear memory in case of mis-match
-            foreach (float *region, imageParition)
-            {
-                delete[] region;
-            }
+        const int regionCount = imageGuideWorkspace->count();
 
+        // A change of layout drops the reference
+        if (!loadRegions() || !imageGuideWorkspace->hasReference())
+        {
+            qWarning() << "Mismatch between reference regions #" << regionCount << "and image parition regions #"
+                       << imageGuideWorkspace->count();
             return Vector(-1, -1, -1);
         }
 
-        for (uint8_t i = 0; i < imageParition.count(); i++)
+        QVector<float> xshifts(regionCount), yshifts(regionCount);
+        imageGuideWorkspace->findShifts(xshifts.data(), yshifts.data());
+
+        for (int i = 0; i < regionCount; i++)
         {
-            ImageAutoGuiding::ImageAutoGuiding1(referenceRegions[i], imageParition[i], regionAxis, &xshift, &yshift);
-            Vector shift(xshift, yshift, -1);
+            Vector shift(xshifts[i], yshifts[i], -1);
             if (Options::guideLogging())
-                qDebug() << "Guide: Region #" << i << ": X-Shift=" << xshift << "Y-Shift=" << yshift;
+                qDebug() << "Guide: Region #" << i << ": X-Shift=" << xshifts[i] << "Y-Shift=" << yshifts[i];
 
-            xsum += xshift;
-            ysum += yshift;
+            xsum += xshifts[i];
+            ysum += yshifts[i];
             shifts.append(shift);
         }
 
-        // Delete partitions
-        foreach (float *region, imageParition)
-        {
-            delete[] region;
-        }
-        imageParition.clear();
-
-        float average_x = xsum / referenceRegions.count();
-        float average_y = ysum / referenceRegions.count();
+        float average_x = xsum / regionCount;
+        float average_y = ysum / regionCount;
 
-        float median_x = shifts[referenceRegions.count() / 2 - 1].x;
-        float median_y = shifts[referenceRegions.count() / 2 - 1].y;
+        float median_x = shifts[qMax(regionCount / 2 - 1, 0)].x;
+        float median_y = shifts[qMax(regionCount / 2 - 1, 0)].y;
 
         if (Options::guideLogging())
         {
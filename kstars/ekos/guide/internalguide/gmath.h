@@ -24,6 +24,7 @@
 
 #include "vect.h"
 #include "matr.h"
+#include "imageautoguiding.h"
 
 typedef struct
 {
@@ -227,13 +228,14 @@ class cgmath : public QObject
 
     // Image Guide
     bool imageGuideEnabled = false;
-    // Creates a new float image from the guideView image data. The returned image MUST be deleted later or memory will leak.
-    float *createFloatImage() const;
-    // Partition guideView image into NxN square regions each of size axis*axis. The returned vector contains pointers to
-    // the newly allocated square images. It MUST be deleted later by delete[] or memory will leak.
-    QVector<float *> partitionImage() const;
+    // Partition guideView image into NxN square regions each of size axis*axis, converted to float straight into the
+    // buffers of the workspace. Returns false if the image is empty or smaller than one region.
+    bool loadRegions() const;
+    template <typename T>
+    bool loadRegions() const;
     uint32_t regionAxis = 64;
-    QVector<float *> referenceRegions;
+    // Region buffers and reference spectra, kept from frame to frame
+    ImageAutoGuiding::Workspace *imageGuideWorkspace = nullptr;
 
     // dithering
     double ditherRate[2];
@@ -9,12 +9,16 @@
 
 #include "imageautoguiding.h"
 
+#include <QtConcurrent>
 #include <QtGlobal>
 
+#include <functional>
+
 #include <math.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define SWAP(a, b) \
     tempr = (a);   \
@@ -42,6 +46,8 @@ void rlft3NR(float ***data, float **speq, unsigned long nn1, unsigned long nn2,
 
 void ShiftEST(float ***testimage, float ***refimage, int n, float *xshift, float *yshift, int k);
 
+void ShiftFromSpectra(float ***testimage, float ***refimage, int n, float *xshift, float *yshift, int k);
+
 namespace ImageAutoGuiding
 {
 void ImageAutoGuiding1(float *ref, float *im, int n, float *xshift, float *yshift)
@@ -82,28 +88,96 @@ void ImageAutoGuiding1(float *ref, float *im, int n, float *xshift, float *yshif
     free_f3tensorSP(RefImage, 1, 1, 1, n, 1, n);
     free_f3tensorSP(TestImage, 1, 1, 1, n, 1, n);
 }
+
+Workspace::Workspace()
+{
+}
+
+Workspace::~Workspace()
+{
+    clear();
+}
+
+void Workspace::clear()
+{
+    for (Region &r : m_Regions)
+    {
+        free_f3tensorSP(r.reference, 1, 1, 1, m_Axis, 1, m_Axis);
+        free_f3tensorSP(r.image, 1, 1, 1, m_Axis, 1, m_Axis);
+        free_matrixSP(r.speq, 1, 1, 1, 2 * m_Axis);
+    }
+
+    m_Regions.clear();
+    m_HasReference = false;
+}
+
+void Workspace::resize(int n, int count)
+{
+    if (n == m_Axis && count == m_Regions.count())
+        return;
+
+    clear();
+
+    m_Axis = n;
+    m_Regions.resize(count);
+    for (Region &r : m_Regions)
+    {
+        r.reference = f3tensorSP(1, 1, 1, n, 1, n);
+        r.image     = f3tensorSP(1, 1, 1, n, 1, n);
+        r.speq      = matrixSP(1, 1, 1, 2 * n);
+    }
+}
+
+float *Workspace::region(int i)
+{
+    return &m_Regions[i].image[1][1][1];
+}
+
+void Workspace::setReference()
+{
+    const int n = m_Axis;
+
+    std::function<void(Region &)> transform = [n](Region &r) {
+        for (int ix = 1; ix <= 2 * n; ++ix)
+            r.speq[1][ix] = 0.0;
+        rlft3NR(r.image, r.speq, 1, n, n, 1);
+
+        // Keep the spectrum, the image buffer is refilled on every frame
+        memcpy(&r.reference[1][1][1], &r.image[1][1][1], n * n * sizeof(float));
+    };
+
+    QtConcurrent::blockingMap(m_Regions, transform);
+    m_HasReference = true;
+}
+
+void Workspace::findShifts(float *xshift, float *yshift)
+{
+    const int n = m_Axis;
+    QVector<int> indexes(m_Regions.count());
+    for (int i = 0; i < indexes.count(); i++)
+        indexes[i] = i;
+
+    std::function<void(int)> shift = [this, n, xshift, yshift](int i) {
+        Region &r = m_Regions[i];
+        for (int ix = 1; ix <= 2 * n; ++ix)
+            r.speq[1][ix] = 0.0;
+        rlft3NR(r.image, r.speq, 1, n, n, 1);
+        ShiftFromSpectra(r.image, r.reference, n, &xshift[i], &yshift[i], 1);
+    };
+
+    QtConcurrent::blockingMap(indexes, shift);
+}
 }
 
 // Calculates Image Shifts
 
 void ShiftEST(float ***testimage, float ***refimage, int n, float *xshift, float *yshift, int k)
 {
-    int ix, iy, nh, nhplusone;
-    double deltax, deltay, fx2sum, fy2sum, phifxsum, phifysum, fxfysum;
-    double fx, fy, ff, fn, re, im, testre, testim, rev, imv, phi;
-    double power, dem, f2, f2limit;
+    int ix;
     float **speq;
 
-    f2limit = FFITMAX * FFITMAX;
-
     speq = matrixSP(1, 1, 1, 2 * n);
 
-    nh        = n / 2;
-    nhplusone = nh + 1;
-
-    fn = ((float)n);
-    ff = 1.0 / fn;
-
     /* FFT of Reference */
 
     for (ix = 1; ix <= 2 * n; ++ix)
@@ -122,6 +196,28 @@ void ShiftEST(float ***testimage, float ***refimage, int n, float *xshift, float
 
     rlft3NR(testimage, speq, 1, n, n, 1);
 
+    free_matrixSP(speq, 1, 1, 1, 2 * n);
+
+    ShiftFromSpectra(testimage, refimage, n, xshift, yshift, k);
+}
+
+// Calculates Image Shifts from the spectra of both images
+
+void ShiftFromSpectra(float ***testimage, float ***refimage, int n, float *xshift, float *yshift, int k)
+{
+    int ix, iy, nh, nhplusone;
+    double deltax, deltay, fx2sum, fy2sum, phifxsum, phifysum, fxfysum;
+    double fx, fy, ff, fn, re, im, testre, testim, rev, imv, phi;
+    double power, dem, f2, f2limit;
+
+    f2limit = FFITMAX * FFITMAX;
+
+    nh        = n / 2;
+    nhplusone = nh + 1;
+
+    fn = ((float)n);
+    ff = 1.0 / fn;
+
     /* Solving for slopes  */
 
     fx2sum = 0.0;
@@ -196,8 +292,6 @@ void ShiftEST(float ***testimage, float ***refimage, int n, float *xshift, float
     deltax = (phifxsum * fy2sum - fxfysum * phifysum) / (dem * TWOPI);
     deltay = (phifysum * fx2sum - fxfysum * phifxsum) / (dem * TWOPI);
 
-    free_matrixSP(speq, 1, 1, 1, 2 * n);
-
     /* You can change the shift mapping here */
 
     *xshift = deltax;
@@ -7,6 +7,10 @@
     version 2 of the License, or (at your option) any later version.
  */
 
+#pragma once
+
+#include <QVector>
+
 // Robert Majewski
 
 // ImageAutoGuiding1 is self contained
@@ -23,4 +27,68 @@
 namespace ImageAutoGuiding
 {
 void ImageAutoGuiding1(float *ref, float *im, int n, float *xshift, float *yshift);
+
+/**
+ * @class Workspace
+ * @short Persistent buffers for guiding on many regions of the same frame
+ *
+ * ImageAutoGuiding1() allocates its FFT buffers and transforms the reference on every call. The workspace keeps
+ * the buffers of every region for as long as the region layout does not change, and caches the spectra of the
+ * reference regions, so that each frame only costs one FFT per region. Regions are processed in parallel.
+ *
+ * Usage: resize() for the region layout, fill region(i) for each region and call setReference(). For every
+ * following frame, fill region(i) again and call findShifts().
+ */
+class Workspace
+{
+  public:
+    Workspace();
+    ~Workspace();
+
+    /**
+     * @short Allocate buffers for count regions of n x n pixels
+     * Buffers are kept if the layout is unchanged, otherwise the reference is dropped.
+     * @param n Size of the regions, must be a power of 2
+     * @param count Number of regions
+     */
+    void resize(int n, int count);
+
+    /** @return the number of regions */
+    int count() const { return m_Regions.count(); }
+
+    /** @return true if setReference() was called since the last change of layout */
+    bool hasReference() const { return m_HasReference; }
+
+    /**
+     * @return the n x n input buffer of region i, row by row, to be filled before setReference() or findShifts().
+     * @note The buffer is transformed in place, so it must be filled again for every frame.
+     */
+    float *region(int i);
+
+    /**
+     * @short Transform all regions, and keep their spectra as the reference
+     */
+    void setReference();
+
+    /**
+     * @short Transform all regions, and estimate their shifts against the reference
+     * @param xshift Returns the x shift of each region, must have room for count() values
+     * @param yshift Returns the y shift of each region, must have room for count() values
+     */
+    void findShifts(float *xshift, float *yshift);
+
+  private:
+    struct Region
+    {
+        float ***reference { nullptr };
+        float ***image { nullptr };
+        float **speq { nullptr };
+    };
+
+    void clear();
+
+    int m_Axis { 0 };
+    bool m_HasReference { false };
+    QVector<Region> m_Regions;
+};
 }
@@ -0,0 +1,151 @@
+/*  Ekos Scheduler Night Ephemeris
+    Copyright (C) 2017 KStars Team <kstars-devel@kde.org>
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "nightephemeris.h"
+
+#include "geolocation.h"
+#include "ksmoon.h"
+#include "kssun.h"
+#include "skypoint.h"
+
+#include <QtGlobal>
+
+#include <cmath>
+
+namespace Ekos
+{
+const double NightEphemeris::SiderealRate = 1.00273790935;
+
+void NightEphemeris::reset(const KStarsDateTime &midnightUT, const GeoLocation *geo, KSMoon *moon)
+{
+    m_Moon       = moon;
+    m_Geo        = QSharedPointer<GeoLocation>(new GeoLocation(*geo));
+    m_MidnightUT = midnightUT;
+    m_Latitude   = geo->lat()->Degrees();
+    m_Longitude  = geo->lng()->Degrees();
+    m_LST0       = geo->GSTtoLST(midnightUT.gst()).Hours();
+    m_Valid      = true;
+
+    m_MoonFitted = false;
+    m_MoonCache.clear();
+    m_SunCache.clear();
+}
+
+bool NightEphemeris::covers(const KStarsDateTime &ut, const GeoLocation *geo) const
+{
+    if (!m_Valid || geo->lat()->Degrees() != m_Latitude || geo->lng()->Degrees() != m_Longitude)
+        return false;
+
+    double hours = hoursAfterMidnight(ut);
+    return hours >= 0 && hours <= SpanHours;
+}
+
+double NightEphemeris::hoursAfterMidnight(const KStarsDateTime &ut) const
+{
+    return static_cast<double>(ut.djd() - m_MidnightUT.djd()) * 24.0;
+}
+
+double NightEphemeris::lst(double hours) const
+{
+    return fmod(m_LST0 + hours * SiderealRate, 24.0);
+}
+
+bool NightEphemeris::fitMoon()
+{
+    if (m_MoonFitted)
+        return m_MoonCache.covers(m_MidnightUT.djd());
+    m_MoonFitted = true;
+
+    if (m_Moon == nullptr)
+        return false;
+
+    long double start = m_MidnightUT.djd();
+    long double stop  = start + SpanHours / 24.0;
+
+    KSSun sun;
+    return m_MoonCache.fit(*m_Moon, start, stop, m_Geo.data()) && m_SunCache.fit(sun, start, stop);
+}
+
+void NightEphemeris::moonAt(double hours, SkyPoint &position, double &illumination)
+{
+    illumination = 0;
+    if (!fitMoon())
+        return;
+
+    long double jd = m_MidnightUT.djd() + qBound(0.0, hours, double(SpanHours)) / 24.0;
+    m_MoonCache.position(jd, position);
+
+    CachingDms LST(lst(hours) * 15.0);
+    CachingDms lat(m_Latitude);
+    position.EquatorialToHorizontal(&LST, &lat);
+
+    // Same as KSMoon::illum(), with the Sun at the same time
+    double phase = (m_MoonCache.ecLong(jd) - m_SunCache.ecLong(jd)) * dms::DegToRad;
+    illumination = 0.5 * (1.0 - cos(phase));
+}
+
+QVector<NightEphemeris::Window> NightEphemeris::altitudeWindows(const SkyPoint &target, double minAltitude,
+                                                                double from, double to) const
+{
+    return solveAltitudeWindows(target.ra().Hours(), target.dec().Degrees(), m_Latitude, m_LST0, minAltitude, from,
+                                to);
+}
+
+QVector<NightEphemeris::Window> NightEphemeris::solveAltitudeWindows(double ra, double dec, double latitude,
+                                                                     double lst0, double minAltitude, double from,
+                                                                     double to)
+{
+    QVector<Window> windows;
+    if (to <= from)
+        return windows;
+
+    const double DegToRad = dms::DegToRad;
+    double sinLat = sin(latitude * DegToRad), cosLat = cos(latitude * DegToRad);
+    double sinDec = sin(dec * DegToRad), cosDec = cos(dec * DegToRad);
+    double sinAlt = sin(minAltitude * DegToRad);
+
+    double cosH0;
+    if (fabs(cosLat * cosDec) < 1e-12)
+        // At the pole, or for a point at the pole: the altitude never changes
+        cosH0 = (sinLat * sinDec > sinAlt) ? -2 : 2;
+    else
+        cosH0 = (sinAlt - sinLat * sinDec) / (cosLat * cosDec);
+
+    // Never rises above minAltitude
+    if (cosH0 >= 1)
+        return windows;
+
+    // Never sets below minAltitude
+    if (cosH0 <= -1)
+    {
+        windows.append(Window(from, to));
+        return windows;
+    }
+
+    // Half-width of the window, in solar hours
+    double halfWidth = acos(cosH0) / DegToRad / 15.0 / SiderealRate;
+    // Sidereal day, in solar hours
+    double day = 24.0 / SiderealRate;
+
+    // First transit after from, then step back to catch a window that is already open
+    double transit = fmod(ra - lst0, 24.0) / SiderealRate;
+    transit += ceil((from - transit) / day) * day;
+    transit -= day;
+
+    for (; transit - halfWidth < to; transit += day)
+    {
+        double rise = qMax(from, transit - halfWidth);
+        double set  = qMin(to, transit + halfWidth);
+        if (set > rise)
+            windows.append(Window(rise, set));
+    }
+
+    return windows;
+}
+}
@@ -0,0 +1,124 @@
+/*  Ekos Scheduler Night Ephemeris
+    Copyright (C) 2017 KStars Team <kstars-devel@kde.org>
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#pragma once
+
+#include "kstarsdatetime.h"
+#include "ksephemeriscache.h"
+
+#include <QPair>
+#include <QSharedPointer>
+#include <QVector>
+
+class GeoLocation;
+class KSMoon;
+class SkyPoint;
+
+namespace Ekos
+{
+/**
+ * @class NightEphemeris
+ * @short Moon positions and target visibility windows shared by all scheduler jobs
+ *
+ * Times are expressed in hours after a reference local midnight, the same way Scheduler::calculateAltitudeTime()
+ * walks through the night. The first time a job needs the Moon, the Moon and the Sun are fitted over the whole
+ * span by KSEphemerisCache, so evaluating many jobs costs about a hundred position computations per night,
+ * run in parallel, and none per job.
+ *
+ * Target altitude windows are solved analytically on the hour angle instead of being searched for.
+ */
+class NightEphemeris
+{
+  public:
+    /** Number of hours after the reference midnight that the cache spans */
+    static const int SpanHours = 48;
+
+    /** Sidereal hours elapsed per solar hour */
+    static const double SiderealRate;
+
+    /** An interval of hours after the reference midnight */
+    typedef QPair<double, double> Window;
+
+    NightEphemeris() {}
+
+    /**
+     * @short Start over for a new night or location
+     * @param midnightUT universal time of the reference local midnight
+     * @param geo observer location
+     * @param moon Moon object copied to compute the fit
+     */
+    void reset(const KStarsDateTime &midnightUT, const GeoLocation *geo, KSMoon *moon);
+
+    /** @return true if the cache was set up for this location and spans the given universal time */
+    bool covers(const KStarsDateTime &ut, const GeoLocation *geo) const;
+
+    /** @return universal time of the reference local midnight */
+    const KStarsDateTime &midnightUT() const { return m_MidnightUT; }
+
+    /** @return hours elapsed between the reference midnight and the given universal time */
+    double hoursAfterMidnight(const KStarsDateTime &ut) const;
+
+    /** @return the local sidereal time, in hours, at the given hours after the reference midnight */
+    double lst(double hours) const;
+
+    /**
+     * @short Topocentric position and illuminated fraction of the Moon
+     * @param hours hours after the reference midnight, within [0, SpanHours]
+     * @param position set to the RA/Dec and Alt/Az of the Moon
+     * @param illumination set to the illuminated fraction of the Moon, in [0, 1]
+     */
+    void moonAt(double hours, SkyPoint &position, double &illumination);
+
+    /**
+     * @short Intervals during which the target stays above an altitude
+     * @param target point whose ra() and dec() are used
+     * @param minAltitude altitude threshold, in degrees
+     * @param from start of the search, in hours after the reference midnight
+     * @param to end of the search, in hours after the reference midnight
+     * @return windows in increasing order, clipped to [from, to]
+     */
+    QVector<Window> altitudeWindows(const SkyPoint &target, double minAltitude, double from, double to) const;
+
+    /**
+     * @short Solve the altitude crossings of a fixed point for a given latitude
+     *
+     * The point is above minAltitude while its hour angle H satisfies
+     * cos(H) > (sin(minAltitude) - sin(lat) sin(dec)) / (cos(lat) cos(dec)).
+     *
+     * @param ra right ascension, in hours
+     * @param dec declination, in degrees
+     * @param latitude latitude of the observer, in degrees
+     * @param lst0 local sidereal time at hour 0, in hours
+     * @param minAltitude altitude threshold, in degrees
+     * @param from start of the search, in solar hours
+     * @param to end of the search, in solar hours
+     * @return windows in increasing order, clipped to [from, to]
+     */
+    static QVector<Window> solveAltitudeWindows(double ra, double dec, double latitude, double lst0,
+                                                double minAltitude, double from, double to);
+
+  private:
+    /** Fit the Moon and the Sun over the span if this was not done yet */
+    bool fitMoon();
+
+    KSMoon *m_Moon { nullptr };
+    QSharedPointer<GeoLocation> m_Geo;
+    KStarsDateTime m_MidnightUT;
+    double m_Latitude { 0 };
+    double m_Longitude { 0 };
+    // Local sidereal time at the reference midnight, in hours
+    double m_LST0 { 0 };
+    bool m_Valid { false };
+    bool m_MoonFitted { false };
+    // Topocentric Moon
+    KSEphemerisCache m_MoonCache;
+    // Geocentric Sun, for the phase of the Moon
+    KSEphemerisCache m_SunCache;
+};
+}
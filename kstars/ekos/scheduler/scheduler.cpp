@@ -1552,26 +1552,57 @@ bool Scheduler::calculateAltitudeTime(SchedulerJob *job, double minAltitude, dou
     QDateTime lt(KStarsData::Instance()->lt().date(), QTime());
     KStarsDateTime ut = geo->LTtoUT(lt);
 
+    // The ephemeris is shared by all jobs evaluated tonight
+    if (nightEphemeris.midnightUT() != ut || !nightEphemeris.covers(ut, geo))
+        nightEphemeris.reset(ut, geo, moon);
+
     SkyPoint target = job->getTargetCoords();
 
     QTime now       = KStarsData::Instance()->lt().time();
     double fraction = now.hour() + now.minute() / 60.0 + now.second() / 3600;
     double rawFrac  = 0;
 
-    for (double hour = fraction; hour < (fraction + 24); hour += 1.0 / 60.0)
-    {
-        KStarsDateTime myUT = ut.addSecs(hour * 3600.0);
+    // Dark periods of today and tomorrow, in hours after midnight
+    QVector<NightEphemeris::Window> nights;
+    nights << NightEphemeris::Window(0, Dawn * 24) << NightEphemeris::Window(Dusk * 24, 24 + Dawn * 24)
+           << NightEphemeris::Window(24 + Dusk * 24, 48);
 
-        rawFrac = (hour > 24 ? (hour - 24) : hour) / 24.0;
+    // Only the minutes where the target is above the minimum altitude at night are examined
+    const QVector<NightEphemeris::Window> windows =
+        nightEphemeris.altitudeWindows(target, minAltitude, fraction, fraction + 24);
 
-        if (rawFrac < Dawn || rawFrac > Dusk)
+    // The windows are solved analytically and may differ from the altitudes computed below by a fraction of a
+    // minute, so each is widened by a minute on both sides. The search still spans the next 24 hours only.
+    const double margin = 1.0 / 60.0;
+
+    for (const NightEphemeris::Window &window : windows)
+    {
+        double windowBegin = qMax(window.first - margin, fraction);
+        double windowEnd   = qMin(window.second + margin, fraction + 24);
+
+        for (const NightEphemeris::Window &night : nights)
         {
-            CachingDms LST = geo->GSTtoLST(myUT.gst());
-            target.EquatorialToHorizontal(&LST, geo->lat());
-            altitude = target.alt().Degrees();
+            double begin = qMax(windowBegin, night.first);
+            double end   = qMin(windowEnd, night.second);
 
-            if (altitude > minAltitude)
+            // Keep to the one-minute steps counted from the current time
+            for (double hour = fraction + ceil((begin - fraction) * 60.0) / 60.0; hour < end; hour += 1.0 / 60.0)
             {
+                KStarsDateTime myUT = ut.addSecs(hour * 3600.0);
+
+                rawFrac = (hour > 24 ? (hour - 24) : hour) / 24.0;
+
+                if (rawFrac >= Dawn && rawFrac <= Dusk)
+                    continue;
+
+                CachingDms LST = geo->GSTtoLST(myUT.gst());
+                target.EquatorialToHorizontal(&LST, geo->lat());
+                altitude = target.alt().Degrees();
+
+                // Minutes right at the edges of the window may round the other way
+                if (altitude <= minAltitude)
+                    continue;
+
                 QDateTime startTime = geo->UTtoLT(myUT);
 
                 if (rawFrac > earlyDawn && rawFrac < Dawn)
@@ -1582,7 +1613,8 @@ bool Scheduler::calculateAltitudeTime(SchedulerJob *job, double minAltitude, dou
                     return false;
                 }
 
-                if (minMoonAngle > 0 && getMoonSeparationScore(job, startTime) < 0)
+                double separation = 0;
+                if (minMoonAngle > 0 && calculateMoonSeparationScore(job, startTime, separation) < 0)
                     continue;
 
                 job->setStartupTime(startTime);
@@ -1845,6 +1877,16 @@ int16_t Scheduler::getAltitudeScore(SchedulerJob *job, QDateTime when)
     return score;
 }
 
+void Scheduler::findMoon(const QDateTime &when, SkyPoint &position, double &illumination)
+{
+    KStarsDateTime ut = geo->LTtoUT(when);
+
+    if (!nightEphemeris.covers(ut, geo))
+        nightEphemeris.reset(geo->LTtoUT(QDateTime(when.date(), QTime())), geo, moon);
+
+    nightEphemeris.moonAt(nightEphemeris.hoursAfterMidnight(ut), position, illumination);
+}
+
 double Scheduler::getCurrentMoonSeparation(SchedulerJob *job)
 {
     // Get target altitude given the time
@@ -1855,17 +1897,26 @@ double Scheduler::getCurrentMoonSeparation(SchedulerJob *job)
     CachingDms LST      = geo->GSTtoLST(myUT.gst());
     p.EquatorialToHorizontal(&LST, geo->lat());
 
-    // Update moon
-    ut = geo->LTtoUT(KStarsData::Instance()->lt());
-    KSNumbers ksnum(ut.djd());
-    LST = geo->GSTtoLST(ut.gst());
-    moon->updateCoords(&ksnum, true, geo->lat(), &LST, true);
+    // Moon position from the night ephemeris
+    SkyPoint moonPosition;
+    double illum = 0;
+    findMoon(KStarsData::Instance()->lt(), moonPosition, illum);
 
     // Moon/Sky separation p
-    return moon->angularDistanceTo(&p).Degrees();
+    return moonPosition.angularDistanceTo(&p).Degrees();
 }
 
 int16_t Scheduler::getMoonSeparationScore(SchedulerJob *job, QDateTime when)
+{
+    double separation = 0;
+    int16_t score     = calculateMoonSeparationScore(job, when, separation);
+
+    appendLogText(i18n("%1 Moon score %2 (separation %3).", job->getName(), score, separation));
+
+    return score;
+}
+
+int16_t Scheduler::calculateMoonSeparationScore(SchedulerJob *job, const QDateTime &when, double &separation)
 {
     int16_t score = 0;
 
@@ -1878,19 +1929,18 @@ int16_t Scheduler::getMoonSeparationScore(SchedulerJob *job, QDateTime when)
     p.EquatorialToHorizontal(&LST, geo->lat());
     double currentAlt = p.alt().Degrees();
 
-    // Update moon
-    ut = geo->LTtoUT(when);
-    KSNumbers ksnum(ut.djd());
-    LST = geo->GSTtoLST(ut.gst());
-    moon->updateCoords(&ksnum, true, geo->lat(), &LST, true);
+    // Moon position from the night ephemeris
+    SkyPoint moonPosition;
+    double illum = 0;
+    findMoon(when, moonPosition, illum);
 
-    double moonAltitude = moon->alt().Degrees();
+    double moonAltitude = moonPosition.alt().Degrees();
 
     // Lunar illumination %
-    double illum = moon->illum() * 100.0;
+    illum *= 100.0;
 
     // Moon/Sky separation p
-    double separation = moon->angularDistanceTo(&p).Degrees();
+    separation = moonPosition.angularDistanceTo(&p).Degrees();
 
     // Zenith distance of the moon
     double zMoon = (90 - moonAltitude);
@@ -1922,8 +1972,6 @@ int16_t Scheduler::getMoonSeparationScore(SchedulerJob *job, QDateTime when)
     // Limit to 0 to 20
     score /= 5.0;
 
-    appendLogText(i18n("%1 Moon score %2 (separation %3).", job->getName(), score, separation));
-
     return score;
 }
 
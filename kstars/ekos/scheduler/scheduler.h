@@ -21,6 +21,7 @@
 #include "schedulerjob.h"
 #include "auxiliary/QProgressIndicator.h"
 #include "ekos/align/align.h"
+#include "nightephemeris.h"
 
 class KSMoon;
 class GeoLocation;
@@ -356,6 +357,23 @@ class Scheduler : public QWidget, public Ui::Scheduler
          */
     int16_t getMoonSeparationScore(SchedulerJob *job, QDateTime when);
 
+    /**
+         * @brief calculateMoonSeparationScore Same as getMoonSeparationScore, without logging the result.
+         * @param job Target job
+         * @param when What time to check the moon separation?
+         * @param separation Set to the moon separation in degrees
+         * @return Moon separation score
+         */
+    int16_t calculateMoonSeparationScore(SchedulerJob *job, const QDateTime &when, double &separation);
+
+    /**
+         * @brief findMoon Get the moon position from the night ephemeris, which is updated if it does not cover the requested time.
+         * @param when Local time
+         * @param position Set to the moon RA/Dec and Alt/Az
+         * @param illumination Set to the illuminated fraction of the moon
+         */
+    void findMoon(const QDateTime &when, SkyPoint &position, double &illumination);
+
     /**
          * @brief calculateJobScore Calculate job dark sky score, altitude score, and moon separation scores and returns the sum.
          * @param job job to evaluate
@@ -567,6 +585,8 @@ class Scheduler : public QWidget, public Ui::Scheduler
     KSMoon *moon;     // Pointer to Moon object
     GeoLocation *geo; // Pointer to Geograpic locatoin
 
+    NightEphemeris nightEphemeris; // Moon positions shared by all jobs over the night
+
     uint16_t captureBatch; // How many repeated job batches did we complete thus far?
 
     QProcess scriptProcess; // Startup and Shutdown scripts process
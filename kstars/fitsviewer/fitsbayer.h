@@ -0,0 +1,295 @@
+/***************************************************************************
+                      fitsbayer.h  -  FITS Image
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include "bayer.h"
+#include "fitskernels.h"
+
+#include <QAtomicInt>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @short Debayering of a raw frame into planar RGB, in bands of rows processed in parallel
+ *
+ * The nearest neighbor and bilinear methods are computed here, one color plane at a time, in branch-free loops
+ * over the columns of the same color that compilers vectorize. The other methods run the dc1394 routines of bayer.c on each band plus a margin of
+ * rows above and below, so that the rows of a band come out the same as if the whole frame had been decoded at
+ * once. Their interleaved output is split into planes band by band.
+ *
+ * The Bayer offsets shift the pattern by one column or row, the frame itself is not shifted.
+ */
+namespace FITSBayer
+{
+/** Number of rows decoded by one task. Even, so that every band starts with the same pattern. */
+const int BandRows = 128;
+
+/** Rows decoded above and below a band for the dc1394 methods. Even, and wider than the largest window. */
+const int MarginRows = 4;
+
+/** @return the pattern of a frame whose first row and column are skipped as requested */
+inline dc1394color_filter_t shiftFilter(dc1394color_filter_t filter, int offsetX, int offsetY)
+{
+    // Patterns in the order of their 2x2 cells: RG/GB, GB/RG, GR/BG, BG/GR
+    static const dc1394color_filter_t swapColumns[4] = { DC1394_COLOR_FILTER_GRBG, DC1394_COLOR_FILTER_BGGR,
+                                                         DC1394_COLOR_FILTER_RGGB, DC1394_COLOR_FILTER_GBRG };
+    static const dc1394color_filter_t swapRows[4] = { DC1394_COLOR_FILTER_GBRG, DC1394_COLOR_FILTER_RGGB,
+                                                      DC1394_COLOR_FILTER_BGGR, DC1394_COLOR_FILTER_GRBG };
+
+    if (offsetX & 1)
+        filter = swapColumns[filter - DC1394_COLOR_FILTER_MIN];
+    if (offsetY & 1)
+        filter = swapRows[filter - DC1394_COLOR_FILTER_MIN];
+    return filter;
+}
+
+/**
+ * @short Colors of the 2x2 cell of a pattern
+ * @param filter pattern
+ * @param colors set to 0 for red, 1 for green and 2 for blue, at [row * 2 + column]
+ */
+inline void cellColors(dc1394color_filter_t filter, int colors[4])
+{
+    switch (filter)
+    {
+        case DC1394_COLOR_FILTER_RGGB:
+            colors[0] = 0, colors[1] = 1, colors[2] = 1, colors[3] = 2;
+            break;
+        case DC1394_COLOR_FILTER_GBRG:
+            colors[0] = 1, colors[1] = 2, colors[2] = 0, colors[3] = 1;
+            break;
+        case DC1394_COLOR_FILTER_GRBG:
+            colors[0] = 1, colors[1] = 0, colors[2] = 2, colors[3] = 1;
+            break;
+        default:
+            colors[0] = 2, colors[1] = 1, colors[2] = 1, colors[3] = 0;
+            break;
+    }
+}
+
+/**
+ * @short Nearest neighbor interpolation of rows [firstRow, lastRow), same as dc1394_bayer_NearestNeighbor()
+ *
+ * Each pixel takes its colors from the 2x2 cell it is the top left of. Green is taken from the right column.
+ * The pixels of the last row and column are set to zero.
+ */
+template <typename T>
+void nearestRows(const T *bayer, int width, int height, const int colors[4], T *planes[3], int firstRow,
+                 int lastRow)
+{
+    for (int y = firstRow; y < lastRow; y++)
+    {
+        const size_t offset = size_t(y) * width;
+        T *out[3]           = { planes[0] + offset, planes[1] + offset, planes[2] + offset };
+
+        if (y == height - 1 || width < 2)
+        {
+            for (int c = 0; c < 3; c++)
+                std::fill(out[c], out[c] + width, T(0));
+            continue;
+        }
+
+        for (int c = 0; c < 3; c++)
+            out[c][width - 1] = 0;
+
+        const T *row = bayer + offset;
+
+        // Columns of the same parity read the same pixel of their cell
+        for (int first = 0; first <= 1; first++)
+        {
+            const int *top = colors + (y & 1) * 2, *bottom = colors + ((y + 1) & 1) * 2;
+            const int cell[4] = { top[first & 1], top[(first + 1) & 1], bottom[first & 1], bottom[(first + 1) & 1] };
+            const int offsets[4] = { 0, 1, width, width + 1 };
+
+            for (int c = 0; c < 3; c++)
+            {
+                int source = 0;
+                if (c == 1)
+                    source = cell[1] == 1 ? 1 : width + 1;
+                else
+                    source = offsets[std::find(cell, cell + 4, c) - cell];
+
+                T *plane = out[c];
+                for (int x = first; x < width - 1; x += 2)
+                    plane[x] = row[x + source];
+            }
+        }
+    }
+}
+
+/**
+ * @short Bilinear interpolation of rows [firstRow, lastRow), same as dc1394_bayer_Bilinear()
+ *
+ * The pixels of the outer rows and columns are set to zero.
+ */
+template <typename T>
+void bilinearRows(const T *bayer, int width, int height, const int colors[4], T *planes[3], int firstRow,
+                  int lastRow)
+{
+    for (int y = firstRow; y < lastRow; y++)
+    {
+        const size_t offset = size_t(y) * width;
+        T *out[3]           = { planes[0] + offset, planes[1] + offset, planes[2] + offset };
+
+        if (y == 0 || y == height - 1 || width < 3)
+        {
+            for (int c = 0; c < 3; c++)
+                std::fill(out[c], out[c] + width, T(0));
+            continue;
+        }
+
+        for (int c = 0; c < 3; c++)
+            out[c][0] = out[c][width - 1] = 0;
+
+        const T *row  = bayer + offset;
+        const T *up   = row - width;
+        const T *down = row + width;
+
+        // Columns of the same color, starting at 1 then 2
+        for (int first = 1; first <= 2; first++)
+        {
+            const int color = colors[(y & 1) * 2 + (first & 1)];
+
+            if (color == 1)
+            {
+                // The color found on the left and right, and the one found above and below
+                const int across = colors[(y & 1) * 2 + ((first + 1) & 1)];
+                T *g = out[1], *h = out[across], *v = out[2 - across];
+
+                for (int x = first; x < width - 1; x += 2)
+                {
+                    g[x] = row[x];
+                    h[x] = (row[x - 1] + row[x + 1] + 1) >> 1;
+                    v[x] = (up[x] + down[x] + 1) >> 1;
+                }
+            }
+            else
+            {
+                T *own = out[color], *g = out[1], *other = out[2 - color];
+
+                for (int x = first; x < width - 1; x += 2)
+                {
+                    own[x]   = row[x];
+                    g[x]     = (up[x] + down[x] + row[x - 1] + row[x + 1] + 2) >> 2;
+                    other[x] = (up[x - 1] + up[x + 1] + down[x - 1] + down[x + 1] + 2) >> 2;
+                }
+            }
+        }
+    }
+}
+
+inline dc1394error_t decode(const uint8_t *bayer, uint8_t *rgb, int width, int height, dc1394color_filter_t filter,
+                            dc1394bayer_method_t method)
+{
+    return dc1394_bayer_decoding_8bit(bayer, rgb, width, height, filter, method);
+}
+
+inline dc1394error_t decode(const uint16_t *bayer, uint16_t *rgb, int width, int height,
+                            dc1394color_filter_t filter, dc1394bayer_method_t method)
+{
+    return dc1394_bayer_decoding_16bit(bayer, rgb, width, height, filter, method, 16);
+}
+
+/**
+ * @short Decode rows [firstRow, lastRow) with a dc1394 method, and split them into planes
+ * @param margin rows decoded above and below the band and then dropped
+ */
+template <typename T>
+dc1394error_t decodeRows(const T *bayer, int width, int height, dc1394color_filter_t filter,
+                         dc1394bayer_method_t method, T *planes[3], int firstRow, int lastRow, int margin)
+{
+    const int top = std::max(0, firstRow - margin), bottom = std::min(height, lastRow + margin);
+
+    // Some methods leave pixels of the borders as they are
+    std::vector<T> rgb(size_t(width) * (bottom - top) * 3, T(0));
+    dc1394error_t error = decode(bayer + size_t(top) * width, rgb.data(), width, bottom - top, filter, method);
+    if (error != DC1394_SUCCESS)
+        return error;
+
+    for (int y = firstRow; y < lastRow; y++)
+    {
+        const T *in         = rgb.data() + size_t(y - top) * width * 3;
+        const size_t offset = size_t(y) * width;
+        T *r = planes[0] + offset, *g = planes[1] + offset, *b = planes[2] + offset;
+
+        for (int x = 0; x < width; x++)
+        {
+            r[x] = in[x * 3];
+            g[x] = in[x * 3 + 1];
+            b[x] = in[x * 3 + 2];
+        }
+    }
+
+    return DC1394_SUCCESS;
+}
+
+/**
+ * @short Debayer a raw frame, in parallel
+ * @param bayer raw frame, 8 or 16 bit
+ * @param width width of the frame
+ * @param height height of the frame
+ * @param params method, pattern and offsets of the pattern
+ * @param rgb planar output, three times the size of the frame. It must not overlap the raw frame.
+ * @return DC1394_SUCCESS, or the error of the first band that failed
+ */
+template <typename T>
+dc1394error_t debayer(const T *bayer, int width, int height, const BayerParams &params, T *rgb)
+{
+    if (params.filter < DC1394_COLOR_FILTER_MIN || params.filter > DC1394_COLOR_FILTER_MAX)
+        return DC1394_INVALID_COLOR_FILTER;
+    if (params.method < DC1394_BAYER_METHOD_MIN || params.method > DC1394_BAYER_METHOD_MAX)
+        return DC1394_INVALID_BAYER_METHOD;
+
+    const dc1394color_filter_t filter = shiftFilter(params.filter, params.offsetX, params.offsetY);
+    const size_t size                 = size_t(width) * height;
+    T *planes[3]                      = { rgb, rgb + size, rgb + size * 2 };
+
+    // The downsampled output is not laid out by rows, and AHD keeps tables in static storage
+    if (params.method == DC1394_BAYER_METHOD_DOWNSAMPLE || params.method == DC1394_BAYER_METHOD_AHD)
+        return decodeRows(bayer, width, height, filter, params.method, planes, 0, height, 0);
+
+    int colors[4];
+    cellColors(filter, colors);
+
+    QAtomicInt error(DC1394_SUCCESS);
+
+    FITSKernels::forEachBlock(height,
+                              [&](uint32_t begin, uint32_t end) {
+                                  if (params.method == DC1394_BAYER_METHOD_NEAREST)
+                                  {
+                                      nearestRows(bayer, width, height, colors, planes, begin, end);
+                                      return;
+                                  }
+                                  if (params.method == DC1394_BAYER_METHOD_BILINEAR)
+                                  {
+                                      bilinearRows(bayer, width, height, colors, planes, begin, end);
+                                      return;
+                                  }
+
+                                  dc1394error_t e = decodeRows(bayer, width, height, filter, params.method, planes,
+                                                               begin, end, MarginRows);
+                                  if (e != DC1394_SUCCESS)
+                                      error.testAndSetRelaxed(DC1394_SUCCESS, e);
+                              },
+                              BandRows);
+
+    return static_cast<dc1394error_t>(error.load());
+}
+}
@@ -19,6 +19,9 @@
 
 #include "fitsdata.h"
 
+#include "fitsbayer.h"
+#include "fitskernels.h"
+#include "fitsstardetector.h"
 #include "auxiliary/ksnotification.h"
 #include "kstarsdata.h"
 #include "ksutils.h"
@@ -26,14 +29,20 @@
 #include "skymapcomposite.h"
 
 #include <QApplication>
+#include <QDir>
 #include <QImage>
+#include <QTemporaryFile>
+#include <QtConcurrent>
 
 #if !defined(KSTARS_LITE) && defined(HAVE_WCSLIB)
 #include <wcshdr.h>
 #include <wcsfix.h>
 #endif
 
+#include <cmath>
+#include <cstring>
 #include <float.h>
+#include <functional>
 
 #define ZOOM_DEFAULT   100.0
 #define ZOOM_MIN       10
@@ -51,16 +60,9 @@ const int MINIMUM_ROWS_PER_CENTER = 3;
 #define MINIMUM_EDGE_LIMIT 2
 #define SMALL_SCALE_SQUARE 256
 
-bool greaterThan(Edge *s1, Edge *s2)
-{
-    //return s1->width > s2->width;
-    return s1->sum > s2->sum;
-}
-
 FITSData::FITSData(FITSMode fitsMode)
 {
     channels      = 0;
-    wcs_coord     = nullptr;
     fptr          = nullptr;
     maxHFRStar    = nullptr;
     tempFile      = false;
@@ -81,48 +83,49 @@ FITSData::FITSData(FITSMode fitsMode)
 
 FITSData::~FITSData()
 {
-    int status = 0;
-
     clearImageBuffers();
 
     if (starCenters.count() > 0)
         qDeleteAll(starCenters);
 
-    delete[] wcs_coord;
-
     if (objList.count() > 0)
         qDeleteAll(objList);
 
+    closeFITS();
+}
+
+void FITSData::closeFITS()
+{
+    int status = 0;
+
     if (fptr)
     {
         fits_close_file(fptr, &status);
+        fptr = nullptr;
 
         if (tempFile && autoRemoveTemporaryFITS)
             QFile::remove(filename);
     }
+
+    memoryBuffer.clear();
+    memoryFile     = nullptr;
+    memoryFileSize = 0;
 }
 
 bool FITSData::loadFITS(const QString &inFilename, bool silent)
 {
-    int status = 0, anynull = 0;
-    long naxes[3];
+    int status = 0;
     char error_status[512];
     QString errMessage;
 
     qDeleteAll(starCenters);
     starCenters.clear();
 
-    if (fptr)
-    {
-        fits_close_file(fptr, &status);
-
-        if (tempFile && autoRemoveTemporaryFITS)
-            QFile::remove(filename);
-    }
+    closeFITS();
 
     filename = inFilename;
 
-    if (filename.startsWith("/tmp/") || filename.contains("/Temp"))
+    if (filename.startsWith("/tmp/") || filename.contains("/Temp") || filename.startsWith(QDir::tempPath() + '/'))
         tempFile = true;
     else
         tempFile = false;
@@ -139,6 +142,53 @@ bool FITSData::loadFITS(const QString &inFilename, bool silent)
         return false;
     }
 
+    return readFITS(silent);
+}
+
+bool FITSData::loadFITSBuffer(const QByteArray &buffer, const QString &inFilename, bool silent)
+{
+    int status = 0;
+    char error_status[512];
+    QString errMessage;
+
+    qDeleteAll(starCenters);
+    starCenters.clear();
+
+    closeFITS();
+
+    // The buffer may be on its way to disk, otherwise there is no file until saveFITS() is called
+    filename = inFilename;
+    tempFile = false;
+
+    // The file is opened read-only, so CFITSIO never writes to the shared buffer
+    memoryBuffer   = buffer;
+    memoryFile     = const_cast<char *>(memoryBuffer.constData());
+    memoryFileSize = memoryBuffer.size();
+
+    if (fits_open_memfile(&fptr, "memory.fits", READONLY, &memoryFile, &memoryFileSize, 0, nullptr, &status))
+    {
+        fits_report_error(stderr, status);
+        fits_get_errstatus(status, error_status);
+        errMessage = i18n("Could not open FITS buffer. Error %1", QString::fromUtf8(error_status));
+        if (silent == false)
+            KSNotification::error(errMessage, i18n("FITS Open"));
+        if (Options::fITSLogging())
+            qDebug() << errMessage;
+        fptr = nullptr;
+        closeFITS();
+        return false;
+    }
+
+    return readFITS(silent);
+}
+
+bool FITSData::readFITS(bool silent)
+{
+    int status = 0, anynull = 0;
+    long naxes[3];
+    char error_status[512];
+    QString errMessage;
+
     if (fits_get_img_param(fptr, 3, &(stats.bitpix), &(stats.ndim), naxes, &status))
     {
         fits_report_error(stderr, status);
@@ -270,6 +320,11 @@ bool FITSData::loadFITS(const QString &inFilename, bool silent)
     }
 
     WCSLoaded = false;
+#ifndef KSTARS_LITE
+#ifdef HAVE_WCSLIB
+    wcsGrid.clear();
+#endif
+#endif
 
     if (mode == FITS_NORMAL || mode == FITS_ALIGN)
         checkForWCS();
@@ -305,7 +360,23 @@ int FITSData::saveFITS(const QString &newFilename)
         // Remove first otherwise copy will fail below if file exists
         QFile::remove(finalFileName);
 
-        if (QFile::copy(filename, finalFileName) == false)
+        if (memoryBuffer.isEmpty() == false)
+        {
+            // Image was received in memory, write the original buffer
+            QFile file(finalFileName);
+            if (file.open(QIODevice::WriteOnly) == false || file.write(memoryBuffer) != memoryBuffer.size())
+            {
+                qCritical() << "FITS: Failed to write " << finalFileName;
+                fptr = nullptr;
+                return -1;
+            }
+            file.close();
+
+            memoryBuffer.clear();
+            memoryFile     = nullptr;
+            memoryFileSize = 0;
+        }
+        else if (QFile::copy(filename, finalFileName) == false)
         {
             qCritical() << "FITS: Failed to copy " << filename << " to " << finalFileName;
             fptr = nullptr;
@@ -363,6 +434,11 @@ int FITSData::saveFITS(const QString &newFilename)
 
     fptr = new_fptr;
 
+    // The image now lives in the new file
+    memoryBuffer.clear();
+    memoryFile     = nullptr;
+    memoryFileSize = 0;
+
     if (fits_movabs_hdu(fptr, 1, &exttype, &status))
     {
         fits_report_error(stderr, status);
@@ -457,42 +533,39 @@ void FITSData::clearImageBuffers()
 
 void FITSData::calculateStats(bool refresh)
 {
-    // Calculate min max
-    calculateMinMax(refresh);
-
-    // Get standard deviation and mean in one run
+    // Min, max, mean and standard deviation in one run
     switch (data_type)
     {
         case TBYTE:
-            runningAverageStdDev<uint8_t>();
+            calculateStats<uint8_t>(refresh);
             break;
 
         case TSHORT:
-            runningAverageStdDev<int16_t>();
+            calculateStats<int16_t>(refresh);
             break;
 
         case TUSHORT:
-            runningAverageStdDev<uint16_t>();
+            calculateStats<uint16_t>(refresh);
             break;
 
         case TLONG:
-            runningAverageStdDev<int32_t>();
+            calculateStats<int32_t>(refresh);
             break;
 
         case TULONG:
-            runningAverageStdDev<uint32_t>();
+            calculateStats<uint32_t>(refresh);
             break;
 
         case TFLOAT:
-            runningAverageStdDev<float>();
+            calculateStats<float>(refresh);
             break;
 
         case TLONGLONG:
-            runningAverageStdDev<int64_t>();
+            calculateStats<int64_t>(refresh);
             break;
 
         case TDOUBLE:
-            runningAverageStdDev<double>();
+            calculateStats<double>(refresh);
             break;
 
         default:
@@ -505,139 +578,54 @@ void FITSData::calculateStats(bool refresh)
         // Let's try to find star positions again after transformation
         starsSearched = false;
 }
-int FITSData::calculateMinMax(bool refresh)
-{
-    int status, nfound = 0;
-
-    status = 0;
-
-    if (fptr && refresh == false)
-    {
-        if (fits_read_key_dbl(fptr, "DATAMIN", &(stats.min[0]), nullptr, &status) == 0)
-            nfound++;
-
-        if (fits_read_key_dbl(fptr, "DATAMAX", &(stats.max[0]), nullptr, &status) == 0)
-            nfound++;
-
-        // If we found both keywords, no need to calculate them, unless they are both zeros
-        if (nfound == 2 && !(stats.min[0] == 0 && stats.max[0] == 0))
-            return 0;
-    }
-
-    stats.min[0] = 1.0E30;
-    stats.max[0] = -1.0E30;
-
-    stats.min[1] = 1.0E30;
-    stats.max[1] = -1.0E30;
-
-    stats.min[2] = 1.0E30;
-    stats.max[2] = -1.0E30;
-
-    switch (data_type)
-    {
-        case TBYTE:
-            calculateMinMax<uint8_t>();
-            break;
-
-        case TSHORT:
-            calculateMinMax<int16_t>();
-            break;
-
-        case TUSHORT:
-            calculateMinMax<uint16_t>();
-            break;
-
-        case TLONG:
-            calculateMinMax<int32_t>();
-            break;
 
-        case TULONG:
-            calculateMinMax<uint32_t>();
-            break;
-
-        case TFLOAT:
-            calculateMinMax<float>();
-            break;
+bool FITSData::readMinMax()
+{
+    int status = 0, nfound = 0;
 
-        case TLONGLONG:
-            calculateMinMax<int64_t>();
-            break;
+    if (fptr == nullptr)
+        return false;
 
-        case TDOUBLE:
-            calculateMinMax<double>();
-            break;
+    if (fits_read_key_dbl(fptr, "DATAMIN", &(stats.min[0]), nullptr, &status) == 0)
+        nfound++;
 
-        default:
-            break;
-    }
+    if (fits_read_key_dbl(fptr, "DATAMAX", &(stats.max[0]), nullptr, &status) == 0)
+        nfound++;
 
-    //qDebug() << "DATAMIN: " << stats.min << " - DATAMAX: " << stats.max;
-    return 0;
+    // If we found both keywords, no need to calculate them, unless they are both zeros
+    return (nfound == 2 && !(stats.min[0] == 0 && stats.max[0] == 0));
 }
 
 template <typename T>
-void FITSData::calculateMinMax()
+void FITSData::calculateStats(bool refresh)
 {
-    T *buffer = reinterpret_cast<T *>(imageBuffer);
+    const T *buffer = reinterpret_cast<T *>(imageBuffer);
+    uint32_t size   = stats.samples_per_channel;
 
-    if (channels == 1)
-    {
-        for (unsigned int i = 0; i < stats.samples_per_channel; i++)
-        {
-            if (buffer[i] < stats.min[0])
-                stats.min[0] = buffer[i];
-            else if (buffer[i] > stats.max[0])
-                stats.max[0] = buffer[i];
-        }
-    }
-    else
-    {
-        int g_offset = stats.samples_per_channel;
-        int b_offset = stats.samples_per_channel * 2;
-
-        for (unsigned int i = 0; i < stats.samples_per_channel; i++)
-        {
-            if (buffer[i] < stats.min[0])
-                stats.min[0] = buffer[i];
-            else if (buffer[i] > stats.max[0])
-                stats.max[0] = buffer[i];
-
-            if (buffer[i + g_offset] < stats.min[1])
-                stats.min[1] = buffer[i + g_offset];
-            else if (buffer[i + g_offset] > stats.max[1])
-                stats.max[1] = buffer[i + g_offset];
-
-            if (buffer[i + b_offset] < stats.min[2])
-                stats.min[2] = buffer[i + b_offset];
-            else if (buffer[i + b_offset] > stats.max[2])
-                stats.max[2] = buffer[i + b_offset];
-        }
-    }
-}
+    // The first channel gives the mean and standard deviation as well
+    FITSKernels::Statistics channelStats = FITSKernels::statistics(buffer, size);
 
-template <typename T>
-void FITSData::runningAverageStdDev()
-{
-    T *buffer = reinterpret_cast<T *>(imageBuffer);
+    stats.mean[0]   = channelStats.mean;
+    stats.stddev[0] = sqrt(channelStats.variance());
 
-    int m_n       = 2;
-    double m_oldM = 0, m_newM = 0, m_oldS = 0, m_newS = 0;
-    m_oldM = m_newM = buffer[0];
+    if (refresh == false && readMinMax())
+        return;
 
-    for (unsigned int i = 1; i < stats.samples_per_channel; i++)
+    for (int i = 0; i < 3; i++)
     {
-        m_newM = m_oldM + (buffer[i] - m_oldM) / m_n;
-        m_newS = m_oldS + (buffer[i] - m_oldM) * (buffer[i] - m_newM);
-
-        m_oldM = m_newM;
-        m_oldS = m_newS;
-        m_n++;
+        stats.min[i] = 1.0E30;
+        stats.max[i] = -1.0E30;
     }
 
-    double variance = m_newS / (m_n - 2);
+    stats.min[0] = channelStats.min;
+    stats.max[0] = channelStats.max;
 
-    stats.mean[0]   = m_newM;
-    stats.stddev[0] = sqrt(variance);
+    for (int i = 1; i < qMin(channels, 3); i++)
+    {
+        channelStats = FITSKernels::statistics(buffer + i * size, size);
+        stats.min[i] = channelStats.min;
+        stats.max[i] = channelStats.max;
+    }
 }
 
 void FITSData::setMinMax(double newMin, double newMax, uint8_t channel)
@@ -667,20 +655,7 @@ int FITSData::getFITSRecord(QString &recordList, int &nkeys)
 
 bool FITSData::checkCollision(Edge *s1, Edge *s2)
 {
-    int dis; //distance
-
-    int diff_x = s1->x - s2->x;
-    int diff_y = s1->y - s2->y;
-
-    dis = std::abs(sqrt(diff_x * diff_x + diff_y * diff_y));
-    dis -= s1->width / 2;
-    dis -= s2->width / 2;
-
-    if (dis <= 0) //collision
-        return true;
-
-    //no collision
-    return false;
+    return FITSStarDetector::collides(*s1, *s2);
 }
 
 int FITSData::findCannyStar(FITSData *data, const QRect &boundary)
@@ -1199,9 +1174,7 @@ void FITSData::findCentroid(const QRectF &boundary, int initStdDev, int minEdgeW
 template <typename T>
 void FITSData::findCentroid(const QRectF &boundary, int initStdDev, int minEdgeWidth)
 {
-    double threshold = 0, sum = 0, avg = 0, min = 0;
-    int starDiameter     = 0;
-    int pixVal           = 0;
+    double threshold = 0, min = 0;
     int minimumEdgeCount = MINIMUM_EDGE_LIMIT;
 
     T *buffer = reinterpret_cast<T *>(imageBuffer);
@@ -1214,7 +1187,7 @@ void FITSData::findCentroid(const QRectF &boundary, int initStdDev, int minEdgeW
 
     float dispersion_ratio = 1.5;
 
-    QList<Edge *> edges;
+    QVector<Edge> edges;
 
     if (JMIndex < DIFFUSE_THRESHOLD)
     {
@@ -1227,6 +1200,22 @@ void FITSData::findCentroid(const QRectF &boundary, int initStdDev, int minEdgeW
         minimumEdgeCount = 4;
     }
 
+    QRect area;
+
+    if (boundary.isNull())
+    {
+        if (mode == FITS_GUIDE || mode == FITS_FOCUS)
+        {
+            int subX = round(stats.width / 15.0);
+            int subY = round(stats.height / 15.0);
+            area     = QRect(subX, subY, stats.width - 2 * subX, stats.height - 2 * subY);
+        }
+        else
+            area = QRect(0, 0, stats.width, stats.height);
+    }
+    else
+        area = QRect(boundary.x(), boundary.y(), int(boundary.width()), int(boundary.height()));
+
     while (initStdDev >= 1)
     {
         minEdgeWidth--;
@@ -1266,99 +1255,15 @@ void FITSData::findCentroid(const QRectF &boundary, int initStdDev, int minEdgeW
 
         threshold -= min;
 
-        int subX, subY, subW, subH;
+        // Detect "edges" that are above threshold, in bands of rows scanned in parallel
+        FITSStarDetector::EdgeParameters parameters;
+        parameters.threshold       = threshold;
+        parameters.min             = min;
+        parameters.minEdgeWidth    = minEdgeWidth;
+        parameters.dispersionRatio = dispersion_ratio;
+        parameters.maxEdges        = MAX_EDGE_LIMIT;
 
-        if (boundary.isNull())
-        {
-            if (mode == FITS_GUIDE || mode == FITS_FOCUS)
-            {
-                subX = round(stats.width / 15.0);
-                subY = round(stats.height / 15.0);
-                subW = stats.width - subX;
-                subH = stats.height - subY;
-            }
-            else
-            {
-                subX = 0;
-                subY = 0;
-                subW = stats.width;
-                subH = stats.height;
-            }
-        }
-        else
-        {
-            subX = boundary.x();
-            subY = boundary.y();
-            subW = subX + boundary.width();
-            subH = subY + boundary.height();
-        }
-
-        // Detect "edges" that are above threshold
-        for (int i = subY; i < subH; i++)
-        {
-            starDiameter = 0;
-
-            for (int j = subX; j < subW; j++)
-            {
-                pixVal = buffer[j + (i * stats.width)] - min;
-
-                // If pixel value > threshold, let's get its weighted average
-                if (pixVal >= threshold)
-                {
-                    avg += j * pixVal;
-                    sum += pixVal;
-                    starDiameter++;
-                }
-                // Value < threshold but avg exists
-                else if (sum > 0)
-                {
-                    // We found a potential centroid edge
-                    if (starDiameter >= minEdgeWidth)
-                    {
-                        float center = avg / sum + 0.5;
-                        if (center > 0)
-                        {
-                            int i_center = floor(center);
-
-                            // Check if center is 10% or more brighter than edge, if not skip
-                            if (((buffer[i_center + (i * stats.width)] - min) /
-                                     (buffer[i_center + (i * stats.width) - starDiameter / 2] - min) >=
-                                 dispersion_ratio) &&
-                                ((buffer[i_center + (i * stats.width)] - min) /
-                                     (buffer[i_center + (i * stats.width) + starDiameter / 2] - min) >=
-                                 dispersion_ratio))
-                            {
-                                if (Options::fITSLogging())
-                                {
-                                    qDebug()
-                                        << "Edge center is " << buffer[i_center + (i * stats.width)] - min
-                                        << " Edge is " << buffer[i_center + (i * stats.width) - starDiameter / 2] - min
-                                        << " and ratio is "
-                                        << ((buffer[i_center + (i * stats.width)] - min) /
-                                            (buffer[i_center + (i * stats.width) - starDiameter / 2] - min))
-                                        << " located at X: " << center << " Y: " << i + 0.5;
-                                }
-
-                                Edge *newEdge = new Edge();
-
-                                newEdge->x       = center;
-                                newEdge->y       = i + 0.5;
-                                newEdge->scanned = 0;
-                                newEdge->val     = buffer[i_center + (i * stats.width)] - min;
-                                newEdge->width   = starDiameter;
-                                newEdge->HFR     = 0;
-                                newEdge->sum     = sum;
-
-                                edges.append(newEdge);
-                            }
-                        }
-                    }
-
-                    // Reset
-                    avg = sum = starDiameter = 0;
-                }
-            }
-        }
+        edges = FITSStarDetector::findEdges(buffer, stats.width, area, parameters);
 
         if (Options::fITSLogging())
             qDebug() << "Total number of edges found is: " << edges.count();
@@ -1375,170 +1280,68 @@ void FITSData::findCentroid(const QRectF &boundary, int initStdDev, int minEdgeW
             if (Options::fITSLogging())
                 qDebug() << "Too many edges, aborting... " << edges.count();
 
-            qDeleteAll(edges);
             return;
         }
 
         if (edges.count() >= minimumEdgeCount)
             break;
 
-        qDeleteAll(edges);
         edges.clear();
         initStdDev--;
     }
 
-    int cen_count = 0;
-    int cen_x     = 0;
-    int cen_y     = 0;
-    int cen_v     = 0;
-    int cen_w     = 0;
     int width_sum = 0;
 
-    // Let's sort edges, starting with widest
-    qSort(edges.begin(), edges.end(), greaterThan);
-
-    // Now, let's scan the edges and find the maximum centroid vertically
-    for (int i = 0; i < edges.count(); i++)
-    {
-        if (Options::fITSLogging())
-        {
-            qDebug() << "# " << i << " Edge at (" << edges[i]->x << "," << edges[i]->y << ") With a value of "
-                     << edges[i]->val << " and width of " << edges[i]->width << " pixels. with sum " << edges[i]->sum;
-        }
-
-        // If edge scanned already, skip
-        if (edges[i]->scanned == 1)
-        {
-            if (Options::fITSLogging())
-                qDebug() << "Skipping check for center " << i << " because it was already counted";
-            continue;
-        }
-
-        if (Options::fITSLogging())
-            qDebug() << "Invetigating edge # " << i << " now ...";
-
-        // Get X, Y, and Val of edge
-        cen_x = edges[i]->x;
-        cen_y = edges[i]->y;
-        cen_v = edges[i]->sum;
-        cen_w = edges[i]->width;
-
-        float avg_x = 0;
-        float avg_y = 0;
-
-        sum       = 0;
-        cen_count = 0;
-
-        // Now let's compare to other edges until we hit a maxima
-        for (int j = 0; j < edges.count(); j++)
-        {
-            if (edges[j]->scanned)
-                continue;
-
-            if (checkCollision(edges[j], edges[i]))
-            {
-                if (edges[j]->sum >= cen_v)
-                {
-                    cen_v = edges[j]->sum;
-                    cen_w = edges[j]->width;
-                }
-
-                edges[j]->scanned = 1;
-                cen_count++;
+    // Let's merge the edges, starting with widest, and find the maximum centroid vertically
+    QVector<FITSStarDetector::Center> centers = FITSStarDetector::clusterEdges(edges);
 
-                avg_x += edges[j]->x * edges[j]->val;
-                avg_y += edges[j]->y * edges[j]->val;
-                sum += edges[j]->val;
+    int cen_limit = (MINIMUM_ROWS_PER_CENTER - (MINIMUM_STDVAR - initStdDev));
 
-                continue;
-            }
-        }
-
-        int cen_limit = (MINIMUM_ROWS_PER_CENTER - (MINIMUM_STDVAR - initStdDev));
+    if (edges.count() < LOW_EDGE_CUTOFF_1)
+    {
+        if (edges.count() < LOW_EDGE_CUTOFF_2)
+            cen_limit = 1;
+        else
+            cen_limit = 2;
+    }
 
-        if (edges.count() < LOW_EDGE_CUTOFF_1)
-        {
-            if (edges.count() < LOW_EDGE_CUTOFF_2)
-                cen_limit = 1;
-            else
-                cen_limit = 2;
-        }
+    if (cen_limit < 1)
+        return;
 
+    for (const FITSStarDetector::Center &center : centers)
+    {
         if (Options::fITSLogging())
-            qDebug() << "center_count: " << cen_count << " and initstdDev= " << initStdDev << " and limit is "
+            qDebug() << "center_count: " << center.count << " and initstdDev= " << initStdDev << " and limit is "
                      << cen_limit;
 
-        if (cen_limit < 1)
-            continue;
-
         // If centroid count is within acceptable range
-        //if (cen_limit >= 2 && cen_count >= cen_limit)
-        if (cen_count >= cen_limit)
-        {
-            // We detected a centroid, let's init it
-            Edge *rCenter = new Edge();
-
-            rCenter->x = avg_x / sum;
-            rCenter->y = avg_y / sum;
-            width_sum += rCenter->width;
-            rCenter->width = cen_w;
-
-            if (Options::fITSLogging())
-                qDebug() << "Found a real center with number with (" << rCenter->x << "," << rCenter->y << ")";
-
-            // Calculate Total Flux From Center, Half Flux, Full Summation
-            double TF   = 0;
-            double HF   = 0;
-            double FSum = 0;
-
-            cen_x = (int)floor(rCenter->x);
-            cen_y = (int)floor(rCenter->y);
-
-            if (cen_x < 0 || cen_x > stats.width || cen_y < 0 || cen_y > stats.height)
-                continue;
-
-            // Complete sum along the radius
-            //for (int k=0; k < rCenter->width; k++)
-            for (int k = rCenter->width / 2; k >= -(rCenter->width / 2); k--)
-            {
-                FSum += buffer[cen_x - k + (cen_y * stats.width)] - min;
-                //qDebug() << image_buffer[cen_x-k+(cen_y*stats.width)] - min;
-            }
+        if (center.count < cen_limit)
+            continue;
 
-            // Half flux
-            HF = FSum / 2.0;
+        int cen_x = (int)floor(center.x);
+        int cen_y = (int)floor(center.y);
 
-            // Total flux starting from center
-            TF = buffer[cen_y * stats.width + cen_x] - min;
+        if (cen_x < 0 || cen_x > stats.width || cen_y < 0 || cen_y > stats.height)
+            continue;
 
-            int pixelCounter = 1;
+        // We detected a centroid, let's init it
+        Edge *rCenter = new Edge();
 
-            // Integrate flux along radius axis until we reach half flux
-            for (int k = 1; k < rCenter->width / 2; k++)
-            {
-                if (TF >= HF)
-                {
-                    if (Options::fITSLogging())
-                        qDebug() << "Stopping at TF " << TF << " after #" << k << " pixels.";
-                    break;
-                }
-
-                TF += buffer[cen_y * stats.width + cen_x + k] - min;
-                TF += buffer[cen_y * stats.width + cen_x - k] - min;
+        rCenter->x = center.x;
+        rCenter->y = center.y;
+        width_sum += rCenter->width;
+        rCenter->width = center.width;
 
-                pixelCounter++;
-            }
+        if (Options::fITSLogging())
+            qDebug() << "Found a real center with number with (" << rCenter->x << "," << rCenter->y << ")";
 
-            // Calculate weighted Half Flux Radius
-            rCenter->HFR = pixelCounter * (HF / TF);
-            // Store full flux
-            rCenter->val = FSum;
+        // Calculate Total Flux From Center, Half Flux, Full Summation
+        FITSStarDetector::halfFluxRadius(buffer, stats.width, min, *rCenter);
 
-            if (Options::fITSLogging())
-                qDebug() << "HFR for this center is " << rCenter->HFR << " pixels and the total flux is " << FSum;
+        if (Options::fITSLogging())
+            qDebug() << "HFR for this center is " << rCenter->HFR << " pixels and the total flux is " << rCenter->val;
 
-            starCenters.append(rCenter);
-        }
+        starCenters.append(rCenter);
     }
 
     if (starCenters.count() > 1 && mode != FITS_FOCUS)
@@ -1560,9 +1363,6 @@ void FITSData::findCentroid(const QRectF &boundary, int initStdDev, int minEdgeW
         //foreach(Edge *center, starCenters)
         //qDebug() << center->x << "," << center->y << "," << center->width << "," << center->val << endl;
     }
-
-    // Release memory
-    qDeleteAll(edges);
 }
 
 double FITSData::getHFR(HFRType type)
@@ -1629,16 +1429,13 @@ double FITSData::getHFR(int x, int y)
     return -1;
 }
 
-void FITSData::applyFilter(FITSScale type, uint8_t *image, float *min, float *max)
+void FITSData::getFilterBounds(FITSScale type, float *min, float *max)
 {
-    if (type == FITS_NONE)
-        return;
-
     float dataMin = stats.min[0], dataMax = stats.max[0];
 
-    if (min && *min != -1)
+    if (*min != -1)
         dataMin = *min;
-    if (max && *max != -1)
+    if (*max != -1)
         dataMax = *max;
 
     switch (type)
@@ -1675,70 +1472,85 @@ void FITSData::applyFilter(FITSScale type, uint8_t *image, float *min, float *ma
     switch (data_type)
     {
         case TBYTE:
-        {
             dataMin = dataMin < 0 ? 0 : dataMin;
             dataMax = dataMax > UINT8_MAX ? UINT8_MAX : dataMax;
-            applyFilter<uint8_t>(type, image, dataMin, dataMax);
-        }
-        break;
+            break;
 
         case TSHORT:
-        {
             dataMin = dataMin < INT16_MIN ? INT16_MIN : dataMin;
             dataMax = dataMax > INT16_MAX ? INT16_MAX : dataMax;
-            applyFilter<uint16_t>(type, image, dataMin, dataMax);
-        }
-
-        break;
+            break;
 
         case TUSHORT:
-        {
             dataMin = dataMin < 0 ? 0 : dataMin;
             dataMax = dataMax > UINT16_MAX ? UINT16_MAX : dataMax;
-            applyFilter<uint16_t>(type, image, dataMin, dataMax);
-        }
-        break;
+            break;
+
+        case TLONG:
+            dataMin = dataMin < INT_MIN ? INT_MIN : dataMin;
+            dataMax = dataMax > INT_MAX ? INT_MAX : dataMax;
+            break;
+
+        case TULONG:
+            dataMin = dataMin < 0 ? 0 : dataMin;
+            dataMax = dataMax > UINT_MAX ? UINT_MAX : dataMax;
+            break;
+
+        case TFLOAT:
+            dataMin = dataMin < FLT_MIN ? FLT_MIN : dataMin;
+            dataMax = dataMax > FLT_MAX ? FLT_MAX : dataMax;
+            break;
+
+        case TLONGLONG:
+            dataMin = dataMin < LLONG_MIN ? LLONG_MIN : dataMin;
+            dataMax = dataMax > LLONG_MAX ? LLONG_MAX : dataMax;
+            break;
+
+        case TDOUBLE:
+            dataMin = dataMin < DBL_MIN ? DBL_MIN : dataMin;
+            dataMax = dataMax > DBL_MAX ? DBL_MAX : dataMax;
+            break;
+
+        default:
+            break;
+    }
+
+    *min = dataMin;
+    *max = dataMax;
+}
+
+void FITSData::applyFilter(FITSScale type, uint8_t *image, float *min, float *max)
+{
+    if (type == FITS_NONE)
+        return;
+
+    float dataMin = min ? *min : -1, dataMax = max ? *max : -1;
+    getFilterBounds(type, &dataMin, &dataMax);
+
+    switch (data_type)
+    {
+        case TBYTE:
+            applyFilter<uint8_t>(type, image, dataMin, dataMax);
+            break;
 
+        case TSHORT:
+        case TUSHORT:
         case TLONG:
-        {
-            dataMin = dataMin < INT_MIN ? INT_MIN : dataMin;
-            dataMax = dataMax > INT_MAX ? INT_MAX : dataMax;
-            applyFilter<uint16_t>(type, image, dataMin, dataMax);
-        }
-        break;
-
         case TULONG:
-        {
-            dataMin = dataMin < 0 ? 0 : dataMin;
-            dataMax = dataMax > UINT_MAX ? UINT_MAX : dataMax;
             applyFilter<uint16_t>(type, image, dataMin, dataMax);
-        }
-        break;
+            break;
 
         case TFLOAT:
-        {
-            dataMin = dataMin < FLT_MIN ? FLT_MIN : dataMin;
-            dataMax = dataMax > FLT_MAX ? FLT_MAX : dataMax;
             applyFilter<float>(type, image, dataMin, dataMax);
-        }
-        break;
+            break;
 
         case TLONGLONG:
-        {
-            dataMin = dataMin < LLONG_MIN ? LLONG_MIN : dataMin;
-            dataMax = dataMax > LLONG_MAX ? LLONG_MAX : dataMax;
             applyFilter<long>(type, image, dataMin, dataMax);
-        }
-        break;
+            break;
 
         case TDOUBLE:
-        {
-            dataMin = dataMin < DBL_MIN ? DBL_MIN : dataMin;
-            dataMax = dataMax > DBL_MAX ? DBL_MAX : dataMax;
             applyFilter<double>(type, image, dataMin, dataMax);
-        }
-
-        break;
+            break;
 
         default:
             return;
@@ -1750,17 +1562,57 @@ void FITSData::applyFilter(FITSScale type, uint8_t *image, float *min, float *ma
         *max = dataMax;
 }
 
+namespace
+{
+// Per-pixel filters, applied by FITSKernels::transform()
+
 template <typename T>
-void FITSData::applyFilter(FITSScale type, uint8_t *targetImage, float image_min, float image_max)
+struct ClampFilter
 {
-    int offset = 0, row = 0;
-    double coeff   = 0;
-    bool calcStats = false;
+    T min, max;
+    T operator()(T value) const { return qBound(min, value, max); }
+};
+
+template <typename T>
+struct LogFilter
+{
+    T min, max;
+    double coeff;
+    T operator()(T value) const
+    {
+        return qBound(min, static_cast<T>(round(coeff * log(1 + qBound(min, value, max)))), max);
+    }
+};
 
-    T bufferVal = 0;
+template <typename T>
+struct ScaleFilter
+{
+    T min, max;
+    double coeff;
+    T operator()(T value) const { return qBound(min, static_cast<T>(round(coeff * value)), max); }
+};
+
+template <typename T>
+struct EqualizeFilter
+{
+    T min, max;
+    double coeff;
+    double binWidth;
+    const double *cumulativeFreq;
+    int size;
+    T operator()(T value) const
+    {
+        int bin = binWidth > 0 ? qBound(0, static_cast<int>((value - min) / binWidth), size - 1) : 0;
+        return qBound(min, static_cast<T>(round(coeff * cumulativeFreq[bin])), max);
+    }
+};
+}
 
-    // Intermediate value
-    double ival = 0;
+template <typename T>
+void FITSData::applyFilter(FITSScale type, uint8_t *targetImage, float image_min, float image_max)
+{
+    int offset = 0;
+    bool calcStats = false;
 
     T *image = nullptr;
 
@@ -1777,27 +1629,21 @@ void FITSData::applyFilter(FITSScale type, uint8_t *targetImage, float image_min
 
     T min = image_min, max = image_max;
 
-    int size  = stats.samples_per_channel;
-    int index = 0;
+    int size = stats.samples_per_channel;
+
+    // The point filters run in parallel over all channels, and return the statistics of the first channel
+    // computed in the same pass
+    uint32_t count      = size * channels;
+    uint32_t statsCount = calcStats ? size : 0;
+    FITSKernels::Statistics channelStats;
 
     switch (type)
     {
         case FITS_AUTO:
         case FITS_LINEAR:
         {
-            for (int i = 0; i < channels; i++)
-            {
-                offset = i * size;
-                for (int j = 0; j < height; j++)
-                {
-                    row = offset + j * width;
-                    for (int k = 0; k < width; k++)
-                    {
-                        index        = k + row;
-                        image[index] = qBound(min, image[index], max);
-                    }
-                }
-            }
+            ClampFilter<T> filter = { min, max };
+            FITSKernels::transform(image, count, 0, filter);
 
             if (calcStats)
             {
@@ -1809,57 +1655,15 @@ void FITSData::applyFilter(FITSScale type, uint8_t *targetImage, float image_min
 
         case FITS_LOG:
         {
-            coeff = max / log(1 + max);
-
-            for (int i = 0; i < channels; i++)
-            {
-                offset = i * size;
-                for (int j = 0; j < height; j++)
-                {
-                    row = offset + j * width;
-                    for (int k = 0; k < width; k++)
-                    {
-                        index        = k + row;
-                        ival         = coeff * log(1 + qBound(min, image[index], max));
-                        image[index] = qBound(min, static_cast<T>(round(ival)), max);
-                    }
-                }
-            }
-
-            if (calcStats)
-            {
-                stats.min[0] = min;
-                stats.max[0] = max;
-                runningAverageStdDev<T>();
-            }
+            LogFilter<T> filter = { min, max, max / log(1 + max) };
+            channelStats        = FITSKernels::transform(image, count, statsCount, filter);
         }
         break;
 
         case FITS_SQRT:
         {
-            coeff = max / sqrt(max);
-
-            for (int i = 0; i < channels; i++)
-            {
-                offset = i * size;
-                for (int j = 0; j < height; j++)
-                {
-                    row = offset + j * width;
-                    for (int k = 0; k < width; k++)
-                    {
-                        index        = k + row;
-                        ival         = coeff * image[index];
-                        image[index] = qBound(min, static_cast<T>(round(ival)), max);
-                    }
-                }
-            }
-
-            if (calcStats)
-            {
-                stats.min[0] = min;
-                stats.max[0] = max;
-                runningAverageStdDev<T>();
-            }
+            ScaleFilter<T> filter = { min, max, max / sqrt(max) };
+            channelStats          = FITSKernels::transform(image, count, statsCount, filter);
         }
         break;
 
@@ -1867,23 +1671,8 @@ void FITSData::applyFilter(FITSScale type, uint8_t *targetImage, float image_min
         case FITS_AUTO_STRETCH:
         case FITS_HIGH_CONTRAST:
         {
-            for (int i = 0; i < channels; i++)
-            {
-                offset = i * size;
-                for (int j = 0; j < height; j++)
-                {
-                    row = offset + j * width;
-                    for (int k = 0; k < width; k++)
-                        image[k + row] = qBound(min, image[k + row], max);
-                }
-            }
-
-            if (calcStats)
-            {
-                stats.min[0] = min;
-                stats.max[0] = max;
-                runningAverageStdDev<T>();
-            }
+            ClampFilter<T> filter = { min, max };
+            channelStats          = FITSKernels::transform(image, count, statsCount, filter);
         }
         break;
 
@@ -1894,28 +1683,12 @@ void FITSData::applyFilter(FITSScale type, uint8_t *targetImage, float image_min
                 return;
 
             QVector<double> cumulativeFreq = histogram->getCumulativeFrequency();
-            coeff                          = 255.0 / (height * width);
-
-            for (int i = 0; i < channels; i++)
-            {
-                offset = i * size;
-                for (int j = 0; j < height; j++)
-                {
-                    row = offset + j * width;
-                    for (int k = 0; k < width; k++)
-                    {
-                        index     = k + row;
-                        bufferVal = (image[index] - min) / histogram->getBinWidth();
-
-                        if (bufferVal >= cumulativeFreq.size())
-                            bufferVal = cumulativeFreq.size() - 1;
-
-                        ival = coeff * cumulativeFreq[bufferVal];
+            if (cumulativeFreq.isEmpty())
+                return;
 
-                        image[index] = qBound(min, static_cast<T>(round(ival)), max);
-                    }
-                }
-            }
+            EqualizeFilter<T> filter = { min, max, 255.0 / (height * width), histogram->getBinWidth(),
+                                         cumulativeFreq.constData(), cumulativeFreq.size() };
+            FITSKernels::transform(image, count, 0, filter);
 #endif
         }
             if (calcStats)
@@ -1924,27 +1697,9 @@ void FITSData::applyFilter(FITSScale type, uint8_t *targetImage, float image_min
 
         case FITS_HIGH_PASS:
         {
-            min = stats.mean[0];
-            for (int i = 0; i < channels; i++)
-            {
-                offset = i * size;
-                for (int j = 0; j < height; j++)
-                {
-                    row = offset + j * width;
-                    for (int k = 0; k < width; k++)
-                    {
-                        index        = k + row;
-                        image[index] = qBound(min, image[index], max);
-                    }
-                }
-            }
-
-            if (calcStats)
-            {
-                stats.min[0] = min;
-                stats.max[0] = max;
-                runningAverageStdDev<T>();
-            }
+            min                   = stats.mean[0];
+            ClampFilter<T> filter = { min, max };
+            channelStats          = FITSKernels::transform(image, count, statsCount, filter);
         }
         break;
 
@@ -1977,41 +1732,47 @@ void FITSData::applyFilter(FITSScale type, uint8_t *targetImage, float image_min
                 N = width + 2;
                 M = height + 2;
 
-                //   Move window through all elements of the image
-                for (int m = 1; m < M - 1; ++m)
-                    for (int n = 1; n < N - 1; ++n)
-                    {
-                        //   Pick up window elements
-                        int k = 0;
-                        float window[9];
-                        for (int j = m - 1; j < m + 2; ++j)
-                            for (int i = n - 1; i < n + 2; ++i)
-                                window[k++] = extension[j * N + i];
-                        //   Order elements (only half of them)
-                        for (int j = 0; j < 5; ++j)
+                //   Move window through all elements of the image, in parallel blocks of rows
+                FITSKernels::forEachBlock(M - 2, [&](uint32_t begin, uint32_t end) {
+                    for (int m = begin + 1; m < int(end) + 1; ++m)
+                        for (int n = 1; n < N - 1; ++n)
                         {
-                            //   Find position of minimum element
-                            int mine = j;
-                            for (int l = j + 1; l < 9; ++l)
-                                if (window[l] < window[mine])
-                                    mine = l;
-                            //   Put found minimum element in its place
-                            const float temp = window[j];
-                            window[j]        = window[mine];
-                            window[mine]     = temp;
+                            //   Pick up window elements
+                            int k = 0;
+                            float window[9];
+                            for (int j = m - 1; j < m + 2; ++j)
+                                for (int i = n - 1; i < n + 2; ++i)
+                                    window[k++] = extension[j * N + i];
+                            //   Order elements (only half of them)
+                            for (int j = 0; j < 5; ++j)
+                            {
+                                //   Find position of minimum element
+                                int mine = j;
+                                for (int l = j + 1; l < 9; ++l)
+                                    if (window[l] < window[mine])
+                                        mine = l;
+                                //   Put found minimum element in its place
+                                const float temp = window[j];
+                                window[j]        = window[mine];
+                                window[mine]     = temp;
+                            }
+                            //   Get result - the middle element
+                            image[(m - 1) * (N - 2) + n - 1 + offset] = window[4];
                         }
-                        //   Get result - the middle element
-                        image[(m - 1) * (N - 2) + n - 1 + offset] = window[4];
-                    }
+                }, 16);
             }
 
             //   Free memory
             delete[] extension;
 
             if (calcStats)
-                runningAverageStdDev<T>();
+            {
+                channelStats    = FITSKernels::statistics(image, size);
+                stats.mean[0]   = channelStats.mean;
+                stats.stddev[0] = sqrt(channelStats.variance());
+            }
         }
-        break;
+        return;
 
         case FITS_ROTATE_CW:
             rotFITS<T>(90, 0);
@@ -2038,6 +1799,15 @@ void FITSData::applyFilter(FITSScale type, uint8_t *targetImage, float image_min
             return;
             break;
     }
+
+    // Filters that computed the statistics of their output in the same pass
+    if (channelStats.count > 0)
+    {
+        stats.min[0]    = min;
+        stats.max[0]    = max;
+        stats.mean[0]   = channelStats.mean;
+        stats.stddev[0] = sqrt(channelStats.variance());
+    }
 }
 
 int FITSData::findStars(const QRectF &boundary, bool force)
@@ -2150,9 +1920,7 @@ bool FITSData::loadWCS()
     int status = 0;
     char *header;
     int nkeyrec, nreject, nwcs, stat[2];
-    double imgcrd[2], phi, pixcrd[2], theta, world[2];
-    int width  = getWidth();
-    int height = getHeight();
+    double imgcrd[2], phi = 0, pixcrd[2], theta = 0, world[2];
 
     if (fits_hdr2str(fptr, 1, nullptr, 0, &header, &nkeyrec, &status))
     {
@@ -2191,38 +1959,13 @@ bool FITSData::loadWCS()
         return false;
     }
 
-    delete[] wcs_coord;
-
-    wcs_coord = new wcs_point[width * height];
-
-    if (wcs_coord == nullptr)
-    {
-        lastError = "Not enough memory for WCS data!";
+    // Computing every pixel up front takes one wcsp2s call per pixel and 8 bytes per pixel, so sample a coarse
+    // grid instead. Plain TAN projections are then evaluated exactly, anything else with wcsp2s per pixel looked up.
+    if (!wcsGrid.build(wcs, getWidth(), getHeight(), lastError))
         return false;
-    }
-
-    wcs_point *p = wcs_coord;
-
-    for (int i = 0; i < height; i++)
-    {
-        for (int j = 0; j < width; j++)
-        {
-            pixcrd[0] = j;
-            pixcrd[1] = i;
 
-            if ((status = wcsp2s(wcs, 1, 2, &pixcrd[0], &imgcrd[0], &phi, &theta, &world[0], &stat[0])))
-            {
-                lastError = QString("wcsp2s error %1: %2.").arg(status).arg(wcs_errmsg[status]);
-            }
-            else
-            {
-                p->ra  = world[0];
-                p->dec = world[1];
-
-                p++;
-            }
-        }
-    }
+    if (Options::fITSLogging())
+        qDebug() << "WCS is evaluated" << (wcsGrid.isLinear() ? "analytically" : "with wcslib");
 
     findObjectsInImage(&world[0], phi, theta, &imgcrd[0], &pixcrd[0], &stat[0]);
 
@@ -2281,9 +2024,7 @@ bool FITSData::pixelToWCS(const QPointF &wcsPixelPoint, SkyPoint &wcsCoord)
 #ifndef KSTARS_LITE
 #ifdef HAVE_WCSLIB
 
-    int status = 0;
-    int stat[2];
-    double imgcrd[2], phi, pixcrd[2], theta, world[2];
+    double v[3];
 
     if (wcs == 0)
     {
@@ -2291,19 +2032,13 @@ bool FITSData::pixelToWCS(const QPointF &wcsPixelPoint, SkyPoint &wcsCoord)
         return false;
     }
 
-    pixcrd[0] = wcsPixelPoint.x();
-    pixcrd[1] = wcsPixelPoint.y();
-
-    if ((status = wcsp2s(wcs, 1, 2, &pixcrd[0], &imgcrd[0], &phi, &theta, &world[0], &stat[0])))
-    {
-        lastError = QString("wcsp2s error %1: %2.").arg(status).arg(wcs_errmsg[status]);
+    if (!wcsGrid.pixelToVector(wcsPixelPoint.x(), wcsPixelPoint.y(), v, lastError))
         return false;
-    }
-    else
-    {
-        wcsCoord.setRA0(world[0] / 15.0);
-        wcsCoord.setDec0(world[1]);
-    }
+
+    double ra, dec;
+    FITSWCSGrid::vectorToRADec(v, ra, dec);
+    wcsCoord.setRA0(ra / 15.0);
+    wcsCoord.setDec0(dec);
 
     return true;
 
@@ -2339,20 +2074,12 @@ void FITSData::findObjectsInImage(double world[], double phi, double theta, doub
 
     SkyMapComposite *map = KStarsData::Instance()->skyComposite();
 
-    wcs_point *wcs_coord = getWCSCoord();
-    if (wcs_coord)
+    SkyPoint p1, p2;
+    if (pixelToWCS(QPointF(0, 0), p1) && pixelToWCS(QPointF(width - 1, height - 1), p2))
     {
-        int size = width * height;
-
         objList.clear();
 
-        SkyPoint p1;
-        p1.setRA0(dms(wcs_coord[0].ra));
-        p1.setDec0(dms(wcs_coord[0].dec));
         p1.updateCoordsNow(num);
-        SkyPoint p2;
-        p2.setRA0(dms(wcs_coord[size - 1].ra));
-        p2.setDec0(dms(wcs_coord[size - 1].dec));
         p2.updateCoordsNow(num);
         QList<SkyObject *> list = map->findObjectsInArea(p1, p2);
 
@@ -2392,6 +2119,25 @@ void FITSData::findObjectsInImage(double world[], double phi, double theta, doub
 #endif
 #endif
 
+bool FITSData::getWCSRange(double &minRA, double &maxRA, double &minDec, double &maxDec)
+{
+#ifndef KSTARS_LITE
+#ifdef HAVE_WCSLIB
+    if (WCSLoaded == false)
+        return false;
+
+    wcsGrid.getRange(minRA, maxRA, minDec, maxDec);
+    return true;
+#endif
+#endif
+
+    Q_UNUSED(minRA)
+    Q_UNUSED(maxRA)
+    Q_UNUSED(minDec)
+    Q_UNUSED(maxDec)
+    return false;
+}
+
 QList<FITSSkyObject *> FITSData::getSkyObjects()
 {
     return objList;
@@ -3097,10 +2843,10 @@ bool FITSData::debayer()
     switch (data_type)
     {
         case TBYTE:
-            return debayer_8bit();
+            return debayer<uint8_t>();
 
         case TUSHORT:
-            return debayer_16bit();
+            return debayer<uint16_t>();
 
         default:
             return false;
@@ -3109,149 +2855,28 @@ bool FITSData::debayer()
     return false;
 }
 
-bool FITSData::debayer_8bit()
-{
-    dc1394error_t error_code;
-
-    int rgb_size               = stats.samples_per_channel * 3 * stats.bytesPerPixel;
-    uint8_t *destinationBuffer = new uint8_t[rgb_size];
-
-    if (destinationBuffer == nullptr)
-    {
-        KSNotification::error(i18n("Unable to allocate memory for temporary bayer buffer."), i18n("Debayer error"));
-        return false;
-    }
-
-    int ds1394_height      = stats.height;
-    uint8_t *dc1394_source = bayerBuffer;
-
-    if (debayerParams.offsetY == 1)
-    {
-        dc1394_source += stats.width;
-        ds1394_height--;
-    }
-
-    if (debayerParams.offsetX == 1)
-    {
-        dc1394_source++;
-    }
-
-    error_code = dc1394_bayer_decoding_8bit(dc1394_source, destinationBuffer, stats.width, ds1394_height,
-                                            debayerParams.filter, debayerParams.method);
-
-    if (error_code != DC1394_SUCCESS)
-    {
-        KSNotification::error(i18n("Debayer failed (%1)", error_code), i18n("Debayer error"));
-        channels = 1;
-        delete[] destinationBuffer;
-        return false;
-    }
-
-    if (channels == 1)
-    {
-        delete[] imageBuffer;
-        imageBuffer = new uint8_t[rgb_size];
-
-        if (imageBuffer == nullptr)
-        {
-            delete[] destinationBuffer;
-            KSNotification::error(i18n("Unable to allocate memory for temporary bayer buffer."), i18n("Debayer error"));
-            return false;
-        }
-    }
-
-    // Data in R1G1B1, we need to copy them into 3 layers for FITS
-
-    uint8_t *rBuff = imageBuffer;
-    uint8_t *gBuff = imageBuffer + (stats.width * stats.height);
-    uint8_t *bBuff = imageBuffer + (stats.width * stats.height * 2);
-
-    int imax = stats.samples_per_channel * 3 - 3;
-    for (int i = 0; i <= imax; i += 3)
-    {
-        *rBuff++ = destinationBuffer[i];
-        *gBuff++ = destinationBuffer[i + 1];
-        *bBuff++ = destinationBuffer[i + 2];
-    }
-
-    channels = 3;
-    delete[] destinationBuffer;
-    bayerBuffer = nullptr;
-    return true;
-}
-
-bool FITSData::debayer_16bit()
+template <typename T>
+bool FITSData::debayer()
 {
-    dc1394error_t error_code;
-
-    int rgb_size               = stats.samples_per_channel * 3 * stats.bytesPerPixel;
-    uint8_t *destinationBuffer = new uint8_t[rgb_size];
+    // The bands write planar RGB directly, so the raw frame is only read once and never interleaved
+    uint8_t *rgbBuffer = new uint8_t[stats.samples_per_channel * 3 * sizeof(T)];
 
-    uint16_t *buffer    = reinterpret_cast<uint16_t *>(bayerBuffer);
-    uint16_t *dstBuffer = reinterpret_cast<uint16_t *>(destinationBuffer);
-
-    if (destinationBuffer == nullptr)
-    {
-        KSNotification::error(i18n("Unable to allocate memory for temporary bayer buffer."), i18n("Debayer error"));
-        return false;
-    }
-
-    int ds1394_height       = stats.height;
-    uint16_t *dc1394_source = buffer;
-
-    if (debayerParams.offsetY == 1)
-    {
-        dc1394_source += stats.width;
-        ds1394_height--;
-    }
-
-    if (debayerParams.offsetX == 1)
-    {
-        dc1394_source++;
-    }
-
-    error_code = dc1394_bayer_decoding_16bit(dc1394_source, dstBuffer, stats.width, ds1394_height, debayerParams.filter,
-                                             debayerParams.method, 16);
+    dc1394error_t error_code = FITSBayer::debayer(reinterpret_cast<const T *>(bayerBuffer), stats.width,
+                                                  stats.height, debayerParams, reinterpret_cast<T *>(rgbBuffer));
 
     if (error_code != DC1394_SUCCESS)
     {
         KSNotification::error(i18n("Debayer failed (%1)", error_code), i18n("Debayer error"));
         channels = 1;
-        delete[] destinationBuffer;
+        delete[] rgbBuffer;
         return false;
     }
 
-    if (channels == 1)
-    {
-        delete[] imageBuffer;
-        imageBuffer = new uint8_t[rgb_size];
-
-        if (imageBuffer == nullptr)
-        {
-            delete[] destinationBuffer;
-            KSNotification::error(i18n("Unable to allocate memory for temporary bayer buffer."), i18n("Debayer error"));
-            return false;
-        }
-    }
-
-    buffer = reinterpret_cast<uint16_t *>(imageBuffer);
-
-    // Data in R1G1B1, we need to copy them into 3 layers for FITS
-
-    uint16_t *rBuff = buffer;
-    uint16_t *gBuff = buffer + (stats.width * stats.height);
-    uint16_t *bBuff = buffer + (stats.width * stats.height * 2);
-
-    int imax = stats.samples_per_channel * 3 - 3;
-    for (int i = 0; i <= imax; i += 3)
-    {
-        *rBuff++ = dstBuffer[i];
-        *gBuff++ = dstBuffer[i + 1];
-        *bBuff++ = dstBuffer[i + 2];
-    }
+    // bayerBuffer points to the first channel of imageBuffer
+    delete[] imageBuffer;
+    imageBuffer = rgbBuffer;
 
-    channels = 3;
-    delete[] destinationBuffer;
+    channels    = 3;
     bayerBuffer = nullptr;
     return true;
 }
@@ -3512,6 +3137,23 @@ QString FITSData::getLastError() const
     return lastError;
 }
 
+QString FITSData::saveTemporaryFITS() const
+{
+    if (memoryBuffer.isEmpty())
+        return QString();
+
+    QTemporaryFile tmpFile(QDir::tempPath() + "/fitsXXXXXX");
+    tmpFile.setAutoRemove(false);
+    if (tmpFile.open() == false || tmpFile.write(memoryBuffer) != memoryBuffer.size())
+    {
+        qCritical() << "FITS: Failed to write temporary file " << tmpFile.fileName();
+        tmpFile.remove();
+        return QString();
+    }
+
+    return tmpFile.fileName();
+}
+
 bool FITSData::getAutoRemoveTemporaryFITS() const
 {
     return autoRemoveTemporaryFITS;
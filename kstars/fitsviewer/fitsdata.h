@@ -24,6 +24,7 @@
 #include "bayer.h"
 #include "dms.h"
 #include "fitscommon.h"
+#include "fitsstardetector.h"
 #include "skyobject.h"
 #include "skypoint.h"
 
@@ -34,15 +35,17 @@
 
 #include <fitsio.h>
 
+#include <QByteArray>
 #include <QRect>
 #include <QRectF>
+#include <QVector>
 
 #ifndef KSTARS_LITE
 #include "fitshistogram.h"
 
 #include <kxmlguiwindow.h>
 #ifdef HAVE_WCSLIB
-#include <wcs.h>
+#include "fitswcsgrid.h"
 #endif
 #endif
 
@@ -51,24 +54,6 @@
 
 class QProgressDialog;
 
-typedef struct
-{
-    float ra;
-    float dec;
-} wcs_point;
-
-class Edge
-{
-  public:
-    float x;
-    float y;
-    int val;
-    int scanned;
-    float width;
-    float HFR;
-    float sum;
-};
-
 class FITSSkyObject : public QObject
 {
     Q_OBJECT
@@ -96,8 +81,14 @@ class FITSData
 
     /* Loads FITS image, scales it, and displays it in the GUI */
     bool loadFITS(const QString &filename, bool silent = true);
+    /* Loads FITS image from a memory buffer, as received from a camera. The buffer is shared, not copied.
+       filename is the file the buffer is being written to, if any. Use saveFITS() to write it to disk otherwise. */
+    bool loadFITSBuffer(const QByteArray &buffer, const QString &filename = QString(), bool silent = true);
     /* Save FITS */
     int saveFITS(const QString &filename);
+    /* Write an image received in memory to a new temporary file, e.g. to open it in the FITS Viewer, which removes
+       the file once done. The image itself stays in memory. Returns the file name, or an empty string on failure. */
+    QString saveTemporaryFITS() const;
     /* Rescale image lineary from image_buffer, fit to window if desired */
     int rescale(FITSZoom type);
     /* Calculate stats */
@@ -186,12 +177,20 @@ class FITSData
     bool checkForWCS();
     // Does image have valid WCS?
     bool hasWCS() { return HasWCS; }
-    // Load WCS data
+    // Load WCS data. Only a coarse grid of coordinates is computed here, pixels are evaluated on demand.
     bool loadWCS();
     // Is WCS Image loaded?
     bool isWCSLoaded() { return WCSLoaded; }
 
-    wcs_point *getWCSCoord() { return wcs_coord; }
+    /**
+         * @brief getWCSRange Get the range of J2000 coordinates covered by the image.
+         * @param minRA Return minimum RA in degrees
+         * @param maxRA Return maximum RA in degrees
+         * @param minDec Return minimum declination in degrees
+         * @param maxDec Return maximum declination in degrees
+         * @return True if WCS is loaded, false otherwise.
+         */
+    bool getWCSRange(double &minRA, double &maxRA, double &minDec, double &maxDec);
 
     /**
          * @brief wcsToPixel Given J2000 (RA0,DE0) coordinates. Find in the image the corresponding pixel coordinates.
@@ -225,8 +224,6 @@ class FITSData
     // Debayer
     bool hasDebayer() { return HasDebayer; }
     bool debayer();
-    bool debayer_8bit();
-    bool debayer_16bit();
     void getBayerParams(BayerParams *param);
     void setBayerParams(BayerParams *param);
 
@@ -242,6 +239,8 @@ class FITSData
 
     // Filter
     void applyFilter(FITSScale type, uint8_t *image = nullptr, float *min = nullptr, float *max = nullptr);
+    // Range of values a filter clamps the data to. min and max are used instead of the data range unless -1.
+    void getFilterBounds(FITSScale type, float *min, float *max);
 
     // Rotation counter. We keep count to rotate WCS keywords on save
     int getRotCounter() const;
@@ -275,9 +274,14 @@ class FITSData
     QString getLastError() const;
 
   private:
+    // Read the image from the opened FITS file, shared by loadFITS() and loadFITSBuffer()
+    bool readFITS(bool silent);
+    // Close the current FITS file, remove it if it is temporary, and release the memory buffer
+    void closeFITS();
     void rotWCSFITS(int angle, int mirror);
     bool checkCollision(Edge *s1, Edge *s2);
-    int calculateMinMax(bool refresh = false);
+    // Read DATAMIN and DATAMAX from the header. Returns false if they are missing or unusable.
+    bool readMinMax();
     bool checkDebayer();
     void readWCSKeys();
 
@@ -299,11 +303,9 @@ class FITSData
     template <typename T>
     int findOneStar(const QRectF &boundary);
 
+    /* Calculate min, max, average & standard deviation in a single parallel pass, see FITSKernels */
     template <typename T>
-    void calculateMinMax();
-    /* Calculate running average & standard deviation using Welford’s method for computing variance */
-    template <typename T>
-    void runningAverageStdDev();
+    void calculateStats(bool refresh);
 
     // Sobel detector by Gonzalo Exequiel Pedone
     template <typename T>
@@ -324,6 +326,11 @@ class FITSData
 #endif
     fitsfile *fptr; // Pointer to CFITSIO FITS file struct
 
+    // In-memory FITS file opened by loadFITSBuffer(). CFITSIO keeps pointers to the address and size.
+    QByteArray memoryBuffer;
+    void *memoryFile   = nullptr;
+    size_t memoryFileSize = 0;
+
     int data_type;                  // FITS image data type (TBYTE, TUSHORT, TINT, TFLOAT, TLONG, TDOUBLE)
     int channels;                   // Number of channels
     uint8_t *imageBuffer = nullptr; // Generic data image buffer
@@ -342,8 +349,13 @@ class FITSData
     int flipHCounter; // How many times the image was flipped horizontally?
     int flipVCounter; // How many times the image was flipped vertically?
 
-    wcs_point *wcs_coord;      // Pointer to WCS coordinate data, if any.
     struct wcsprm *wcs = 0;    // WCS Struct
+
+#ifndef KSTARS_LITE
+#ifdef HAVE_WCSLIB
+    FITSWCSGrid wcsGrid; // Evaluates the pixel coordinates, set up by loadWCS()
+#endif
+#endif
     QList<Edge *> starCenters; // All the stars we detected, if any.
     Edge *maxHFRStar;          // The biggest fattest star in the image.
 
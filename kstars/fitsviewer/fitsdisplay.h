@@ -0,0 +1,236 @@
+/***************************************************************************
+                     fitsdisplay.h  -  FITS Image
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include "fitskernels.h"
+
+#include <QImage>
+#include <QVector>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/**
+ * @short Conversion of FITS data to the 8 bit image shown by FITSView, and the reduced copies used to draw it
+ *
+ * Rows are converted in bands processed in parallel. 8 and 16 bit samples go through a lookup table of the
+ * stretch, so a new stretch costs one table and a single pass over the data, without copying it.
+ *
+ * The pyramid holds the displayed image halved again and again. A zoomed out view is drawn from the smallest
+ * level that is still larger than the view, so it reads about as many pixels as are shown.
+ */
+namespace FITSDisplay
+{
+/** Number of rows converted by one task */
+const int BandRows = 32;
+
+/**
+ * @struct Stretch
+ * Linear mapping of sample values to 8 bit levels.
+ */
+struct Stretch
+{
+    /** Values mapped to 0 and 255 */
+    double min { 0 };
+    double max { 0 };
+    /** Samples are clamped to [min, max] first, as FITSData::applyFilter() does for FITS_AUTO_STRETCH */
+    bool clamp { false };
+};
+
+/**
+ * @short Level of a single sample, as FITSView::rescale() computed it
+ */
+template <typename T>
+class LinearStretch
+{
+  public:
+    explicit LinearStretch(const Stretch &s)
+        : m_Scale(255. / (s.max - s.min)), m_Zero((-s.min) * (255. / (s.max - s.min))),
+          m_Low(s.clamp ? static_cast<T>(s.min) : std::numeric_limits<T>::lowest()),
+          m_High(s.clamp ? static_cast<T>(s.max) : std::numeric_limits<T>::max())
+    {
+    }
+
+    inline uint8_t operator()(T value) const
+    {
+        double val = qBound(m_Low, value, m_High) * m_Scale + m_Zero;
+        return static_cast<uint8_t>(qBound(0.0, val, 255.0));
+    }
+
+  private:
+    double m_Scale;
+    double m_Zero;
+    T m_Low;
+    T m_High;
+};
+
+template <typename T, typename Map>
+void renderRows(const T *buffer, int channels, const Map &map, uchar *bits, int bytesPerLine, int width, int height,
+                int firstRow, int lastRow)
+{
+    const uint32_t size = uint32_t(width) * height;
+
+    for (int j = firstRow; j < lastRow; j++)
+    {
+        const T *row = buffer + uint32_t(j) * width;
+
+        if (channels == 1)
+        {
+            uchar *scanLine = bits + j * bytesPerLine;
+            for (int i = 0; i < width; i++)
+                scanLine[i] = map(row[i]);
+        }
+        else
+        {
+            QRgb *scanLine = reinterpret_cast<QRgb *>(bits + j * bytesPerLine);
+            for (int i = 0; i < width; i++)
+                scanLine[i] = qRgb(map(row[i]), map(row[i + size]), map(row[i + size * 2]));
+        }
+    }
+}
+
+template <typename T, typename Map>
+void render(const T *buffer, int channels, const Map &map, QImage &image)
+{
+    const int width = image.width(), height = image.height();
+    // Detached here, once, so that the tasks only write to the pixels
+    uchar *bits            = image.bits();
+    const int bytesPerLine = image.bytesPerLine();
+
+    FITSKernels::forEachBlock(height,
+                              [&](uint32_t begin, uint32_t end) {
+                                  renderRows(buffer, channels, map, bits, bytesPerLine, width, height, begin, end);
+                              },
+                              BandRows);
+}
+
+template <typename T>
+void render(const T *buffer, int channels, const Stretch &stretch, QImage &image, std::false_type)
+{
+    render(buffer, channels, LinearStretch<T>(stretch), image);
+}
+
+template <typename T>
+void render(const T *buffer, int channels, const Stretch &stretch, QImage &image, std::true_type)
+{
+    render(buffer, channels, FITSKernels::LookupTable<T, uint8_t>(LinearStretch<T>(stretch)), image);
+}
+
+/**
+ * @short Convert the samples to the displayed image, in parallel
+ * @param buffer Samples, one plane per channel
+ * @param channels 1 for an Indexed8 image, 3 for an RGB32 image
+ * @param stretch Mapping of the samples to 8 bit levels
+ * @param image Image of the same size as the data, written in place
+ */
+template <typename T>
+void render(const T *buffer, int channels, const Stretch &stretch, QImage &image)
+{
+    typedef std::integral_constant<bool, std::is_integral<T>::value && sizeof(T) <= 2> UseTable;
+    render(buffer, channels, stretch, image, UseTable());
+}
+
+/**
+ * @short Half the size of an 8 bit or 32 bit image, each pixel the mean of a 2x2 block, computed in parallel
+ */
+inline QImage halve(const QImage &image)
+{
+    QImage half(qMax(1, image.width() / 2), qMax(1, image.height() / 2), image.format());
+    half.setColorTable(image.colorTable());
+
+    const int bpp     = image.depth() / 8;
+    const int lastRow = image.height() - 1, lastColumn = image.width() - 1;
+    const uchar *in   = image.constBits();
+    const int inLine  = image.bytesPerLine();
+    uchar *out        = half.bits();
+    const int outLine = half.bytesPerLine();
+    const int width   = half.width();
+
+    FITSKernels::forEachBlock(half.height(),
+                              [&](uint32_t begin, uint32_t end) {
+                                  for (uint32_t j = begin; j < end; j++)
+                                  {
+                                      // A single row or column is repeated
+                                      const uchar *top    = in + qMin<int>(2 * j, lastRow) * inLine;
+                                      const uchar *bottom = in + qMin<int>(2 * j + 1, lastRow) * inLine;
+                                      uchar *row          = out + j * outLine;
+
+                                      for (int i = 0; i < width; i++)
+                                      {
+                                          const int left  = 2 * i * bpp;
+                                          const int right = qMin(2 * i + 1, lastColumn) * bpp;
+                                          for (int c = 0; c < bpp; c++)
+                                              row[i * bpp + c] = (top[left + c] + top[right + c] +
+                                                                  bottom[left + c] + bottom[right + c] + 2) / 4;
+                                      }
+                                  }
+                              },
+                              BandRows);
+
+    return half;
+}
+
+/**
+ * @short Reduced copies of the displayed image
+ *
+ * The image itself is not stored, so writing to it does not copy it. Levels are built again when its pixels
+ * change.
+ */
+class Pyramid
+{
+  public:
+    /** Levels stop once the longest side is smaller than this, in pixels */
+    static const int MinimumSize = 128;
+
+    /** @short Build the levels of image */
+    void build(const QImage &image)
+    {
+        m_Levels.clear();
+        const QImage *previous = &image;
+        while (qMax(previous->width(), previous->height()) / 2 >= MinimumSize)
+        {
+            m_Levels.append(halve(*previous));
+            previous = &m_Levels.last();
+        }
+    }
+
+    void clear() { m_Levels.clear(); }
+
+    /** @return number of levels, without the image */
+    int levels() const { return m_Levels.size(); }
+
+    /**
+     * @param image Image the levels were built from
+     * @param scale Ratio of the drawn size to the size of the image
+     * @return the smallest level that is at least scale times the size of image, or image itself
+     */
+    const QImage &level(const QImage &image, double scale) const
+    {
+        if (scale >= 1 || scale <= 0 || m_Levels.isEmpty())
+            return image;
+
+        int k = qMin<int>(floor(log2(1.0 / scale)), m_Levels.size());
+        return k > 0 ? m_Levels[k - 1] : image;
+    }
+
+  private:
+    QVector<QImage> m_Levels;
+};
+}
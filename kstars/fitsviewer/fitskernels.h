@@ -0,0 +1,269 @@
+/***************************************************************************
+                     fitskernels.h  -  FITS Image
+                             -------------------
+    begin                : Sat 14 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QtConcurrent>
+#include <QVector>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @short Multithreaded pixel kernels used by FITSData
+ *
+ * Images are cut into blocks of samples that are processed in parallel on the global thread pool. Statistics
+ * of the blocks are merged with Chan's formula, so the results do not depend on how the work was split.
+ * Per-pixel functions of 8 and 16 bit data are evaluated once per possible value, into a lookup table.
+ */
+namespace FITSKernels
+{
+/** Number of samples processed by one task. Small enough for a block to stay in the L2 cache. */
+const uint32_t BlockSize = 1 << 16;
+
+/**
+ * @struct Statistics
+ * Minimum, maximum, mean and spread of a set of samples.
+ */
+struct Statistics
+{
+    double min { 1.0E30 };
+    double max { -1.0E30 };
+    double count { 0 };
+    double mean { 0 };
+    // Sum of the squared differences from the mean
+    double m2 { 0 };
+
+    /** @return the sample variance, as computed by Welford's method */
+    double variance() const { return count > 1 ? m2 / (count - 1) : 0; }
+
+    /** @short Add the statistics of another, disjoint set of samples */
+    void merge(const Statistics &other)
+    {
+        if (other.count == 0)
+            return;
+        if (count == 0)
+        {
+            *this = other;
+            return;
+        }
+
+        double total = count + other.count;
+        double delta = other.mean - mean;
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * count * other.count / total;
+        count = total;
+        min   = std::min(min, other.min);
+        max   = std::max(max, other.max);
+    }
+};
+
+/**
+ * @short Statistics of a block of samples, in a single vectorized pass
+ */
+template <typename T>
+Statistics blockStatistics(const T *data, uint32_t count)
+{
+    typedef Eigen::Array<T, Eigen::Dynamic, 1> Samples;
+    typedef Eigen::Array<double, Eigen::Dynamic, 1, Eigen::ColMajor, 256, 1> Chunk;
+
+    Statistics s;
+    if (count == 0)
+        return s;
+
+    // Sums are taken relative to the first sample, which keeps them accurate for data with a large offset
+    const double pivot = data[0];
+    double sum = 0, sumSquares = 0;
+    T low = data[0], high = data[0];
+
+    for (uint32_t start = 0; start < count; start += 256)
+    {
+        const int n = std::min<uint32_t>(256, count - start);
+        Eigen::Map<const Samples> samples(data + start, n);
+        Chunk d = samples.template cast<double>() - pivot;
+
+        sum += d.sum();
+        sumSquares += d.square().sum();
+        low  = std::min(low, samples.minCoeff());
+        high = std::max(high, samples.maxCoeff());
+    }
+
+    s.min   = low;
+    s.max   = high;
+    s.count = count;
+    s.mean  = pivot + sum / count;
+    s.m2    = std::max(0.0, sumSquares - sum * sum / count);
+    return s;
+}
+
+/**
+ * @short Run fn(begin, end) on consecutive ranges of [0, count), in parallel
+ * @param count Number of items
+ * @param fn Function to call for each range
+ * @param blockSize Number of items in each range
+ */
+template <typename Function>
+void forEachBlock(uint32_t count, const Function &fn, uint32_t blockSize = BlockSize)
+{
+    QVector<uint32_t> blocks;
+    for (uint32_t begin = 0; begin < count; begin += blockSize)
+        blocks.append(begin);
+
+    std::function<void(uint32_t)> run = [&](uint32_t begin) { fn(begin, std::min(begin + blockSize, count)); };
+    QtConcurrent::blockingMap(blocks, run);
+}
+
+/**
+ * @short Statistics of count samples, computed in parallel
+ */
+template <typename T>
+Statistics statistics(const T *data, uint32_t count)
+{
+    QVector<Statistics> partial((count + BlockSize - 1) / BlockSize);
+    Statistics *out = partial.data();
+
+    forEachBlock(count, [&](uint32_t begin, uint32_t end) {
+        out[begin / BlockSize] = blockStatistics(data + begin, end - begin);
+    });
+
+    // Merged in order, so that the result is reproducible
+    Statistics s;
+    for (const Statistics &p : partial)
+        s.merge(p);
+    return s;
+}
+
+/**
+ * @short Lookup table for a function of 8 or 16 bit samples, returning values of type R
+ */
+template <typename T, typename R = T>
+class LookupTable
+{
+  public:
+    template <typename Op>
+    explicit LookupTable(const Op &op)
+    {
+        m_Table.resize(int(std::numeric_limits<T>::max()) - int(std::numeric_limits<T>::min()) + 1);
+        for (int i = 0; i < m_Table.size(); i++)
+            m_Table[i] = op(static_cast<T>(i + std::numeric_limits<T>::min()));
+        m_Data = m_Table.constData();
+    }
+
+    inline R operator()(T value) const { return m_Data[int(value) - std::numeric_limits<T>::min()]; }
+
+  private:
+    QVector<R> m_Table;
+    const R *m_Data { nullptr };
+};
+
+template <typename T, typename Op>
+Statistics transform(T *data, uint32_t count, uint32_t statsCount, const Op &op, std::false_type)
+{
+    QVector<Statistics> partial((count + BlockSize - 1) / BlockSize);
+    Statistics *out = partial.data();
+
+    forEachBlock(count, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+            data[i] = op(data[i]);
+        // The block is still in the cache
+        if (begin < statsCount)
+            out[begin / BlockSize] = blockStatistics(data + begin, std::min(end, statsCount) - begin);
+    });
+
+    Statistics s;
+    for (const Statistics &p : partial)
+        s.merge(p);
+    return s;
+}
+
+template <typename T, typename Op>
+Statistics transform(T *data, uint32_t count, uint32_t statsCount, const Op &op, std::true_type)
+{
+    return transform(data, count, statsCount, LookupTable<T>(op), std::false_type());
+}
+
+/**
+ * @short Replace every sample by op(sample), in parallel
+ * @param data Samples to transform in place
+ * @param count Number of samples
+ * @param statsCount Number of samples, from the start, to compute the statistics of after the transformation
+ * @param op Function of a single sample
+ * @return statistics of the first statsCount transformed samples
+ */
+template <typename T, typename Op>
+Statistics transform(T *data, uint32_t count, uint32_t statsCount, const Op &op)
+{
+    // Images have many more pixels than 8 or 16 bit data has values
+    typedef std::integral_constant<bool, std::is_integral<T>::value && sizeof(T) <= 2> UseTable;
+    return transform(data, count, statsCount, op, UseTable());
+}
+
+/**
+ * @short data = max(data, dark) - dark, which clips the result at zero without a branch
+ * @param data Samples to subtract from, in place
+ * @param dark Samples to subtract
+ * @param count Number of samples
+ */
+template <typename T>
+void subtractSaturated(T *data, const T *dark, uint32_t count)
+{
+    // A plain loop, which compilers turn into packed max and subtract instructions for every type
+    for (uint32_t i = 0; i < count; i++)
+        data[i] = std::max(data[i], dark[i]) - dark[i];
+}
+
+/**
+ * @short Median of several frames, pixel by pixel, computed in parallel
+ * @param frames Samples of each frame
+ * @param out Median of the frames, must not be one of them
+ * @param count Number of samples in each frame
+ */
+template <typename T>
+void median(const QVector<const T *> &frames, T *out, uint32_t count)
+{
+    const int n = frames.size();
+    if (n == 0)
+        return;
+
+    forEachBlock(count, [&](uint32_t begin, uint32_t end) {
+        std::vector<T> values(n);
+        for (uint32_t i = begin; i < end; i++)
+        {
+            for (int k = 0; k < n; k++)
+                values[k] = frames[k][i];
+
+            std::nth_element(values.begin(), values.begin() + n / 2, values.end());
+            T upper = values[n / 2];
+
+            if (n % 2)
+                out[i] = upper;
+            else
+            {
+                // Mean of the two middle values
+                T lower = *std::max_element(values.begin(), values.begin() + n / 2);
+                out[i]  = static_cast<T>(lower + (static_cast<double>(upper) - lower) / 2);
+            }
+        }
+    });
+}
+}
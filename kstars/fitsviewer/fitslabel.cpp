@@ -11,6 +11,8 @@
 #include <config-kstars.h>
 
 #include <QCursor>
+#include <QPainter>
+#include <QPaintEvent>
 #include <QToolTip>
 #include <QDebug>
 
@@ -56,6 +58,12 @@ void FITSLabel::setSize(double w, double h)
     size   = w * h;
 }
 
+void FITSLabel::paintEvent(QPaintEvent *e)
+{
+    QPainter painter(this);
+    view->drawFrame(&painter, e->rect());
+}
+
 bool FITSLabel::getMouseButtonDown()
 {
     return mouseButtonDown;
@@ -162,17 +170,12 @@ void FITSLabel::mouseMoveEvent(QMouseEvent *e)
 
     if (view_data->hasWCS() && view->getMouseMode() != FITSView::selectMouse)
     {
-        int index = x + y * width;
-
-        wcs_point *wcs_coord = view_data->getWCSCoord();
+        SkyPoint wcsCoord;
 
-        if (wcs_coord)
+        if (view_data->isWCSLoaded() && view_data->pixelToWCS(QPointF(x, y), wcsCoord))
         {
-            if (index > size)
-                return;
-
-            ra.setD(wcs_coord[index].ra);
-            dec.setD(wcs_coord[index].dec);
+            ra  = wcsCoord.ra0();
+            dec = wcsCoord.dec0();
 
             emit newStatus(QString("%1 , %2").arg(ra.toHMSString()).arg(dec.toDMSString()), FITS_WCS);
         }
@@ -226,24 +229,24 @@ void FITSLabel::mousePressEvent(QMouseEvent *e)
         FITSData *view_data = view->getImageData();
         if (view_data->hasWCS())
         {
-            wcs_point *wcs_coord = view_data->getWCSCoord();
-            if (wcs_coord)
-            {
-                double x, y;
-                x = round(e->x() / scale);
-                y = round(e->y() / scale);
+            double x, y;
+            x = round(e->x() / scale);
+            y = round(e->y() / scale);
 
-                x         = KSUtils::clamp(x, 1.0, width);
-                y         = KSUtils::clamp(y, 1.0, height);
-                int index = x + y * width;
+            x = KSUtils::clamp(x, 1.0, width);
+            y = KSUtils::clamp(y, 1.0, height);
+
+            SkyPoint wcsCoord;
+            if (view_data->isWCSLoaded() && view_data->pixelToWCS(QPointF(x, y), wcsCoord))
+            {
                 if (KMessageBox::Continue == KMessageBox::warningContinueCancel(
                                                  nullptr,
-                                                 "Slewing to Coordinates: \nRA: " + dms(wcs_coord[index].ra).toHMSString() +
-                                                     "\nDec: " + dms(wcs_coord[index].dec).toDMSString(),
+                                                 "Slewing to Coordinates: \nRA: " + wcsCoord.ra0().toHMSString() +
+                                                     "\nDec: " + wcsCoord.dec0().toDMSString(),
                                                  i18n("Continue Slew"), KStandardGuiItem::cont(),
                                                  KStandardGuiItem::cancel(), "continue_slew_warning"))
                 {
-                    centerTelescope(wcs_coord[index].ra / 15.0, wcs_coord[index].dec);
+                    centerTelescope(wcsCoord.ra0().Hours(), wcsCoord.dec0().Degrees());
                     view->setMouseMode(view->lastMouseMode);
                     view->updateScopeButton();
                 }
@@ -43,6 +43,7 @@ class FITSLabel : public QLabel
     virtual void mousePressEvent(QMouseEvent *e);
     virtual void mouseReleaseEvent(QMouseEvent *e);
     virtual void mouseDoubleClickEvent(QMouseEvent *e);
+    virtual void paintEvent(QPaintEvent *e);
 
   private:
     bool mouseButtonDown = false;
@@ -0,0 +1,323 @@
+/***************************************************************************
+                  fitsstardetector.h  -  FITS Image
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QAtomicInt>
+#include <QRect>
+#include <QtConcurrent>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+
+class Edge
+{
+  public:
+    float x;
+    float y;
+    int val;
+    int scanned;
+    float width;
+    float HFR;
+    float sum;
+};
+
+/**
+ * @short Star detection steps of FITSData::findCentroid()
+ *
+ * Rows are scanned for runs of pixels above a threshold, the "edges" of stars, in bands of rows processed in
+ * parallel. Edges are kept by value in a flat array, in row order, so the result does not depend on the bands.
+ * Edges of a star that spans several bands are merged when the edges are clustered into centers.
+ */
+namespace FITSStarDetector
+{
+/** Number of rows scanned by one task */
+const int BandRows = 32;
+
+/**
+ * @struct EdgeParameters
+ * Thresholds used to accept an edge.
+ */
+struct EdgeParameters
+{
+    /** Minimum value of a pixel of the edge, after min is subtracted */
+    double threshold { 0 };
+    /** Value subtracted from every pixel */
+    double min { 0 };
+    /** Minimum number of pixels of an edge */
+    int minEdgeWidth { 3 };
+    /** Minimum ratio between the center and both ends of an edge */
+    double dispersionRatio { 1.5 };
+    /** Scanning stops once this many edges were found */
+    int maxEdges { 10000 };
+};
+
+/**
+ * @struct Center
+ * Edges that collide with the brightest of them, merged into a star candidate.
+ */
+struct Center
+{
+    /** Centroid, weighted by the value of the edges */
+    float x { 0 };
+    float y { 0 };
+    /** Width of the edge with the largest sum */
+    int width { 0 };
+    /** Number of edges merged */
+    int count { 0 };
+};
+
+template <typename T>
+void scanRows(const T *buffer, int width, const QRect &area, int firstRow, int lastRow, const EdgeParameters &p,
+              QVector<Edge> &edges)
+{
+    for (int i = firstRow; i < lastRow; i++)
+    {
+        const T *row = buffer + i * width;
+        double avg = 0, sum = 0;
+        int starDiameter = 0;
+
+        for (int j = area.left(); j <= area.right(); j++)
+        {
+            int pixVal = row[j] - p.min;
+
+            // If pixel value > threshold, let's get its weighted average
+            if (pixVal >= p.threshold)
+            {
+                avg += j * pixVal;
+                sum += pixVal;
+                starDiameter++;
+            }
+            // Value < threshold but avg exists
+            else if (sum > 0)
+            {
+                // We found a potential centroid edge
+                float center = avg / sum + 0.5;
+                if (starDiameter >= p.minEdgeWidth && center > 0)
+                {
+                    int i_center = floor(center);
+                    double peak  = row[i_center] - p.min;
+
+                    // Check if center is brighter enough than both ends of the edge, if not skip
+                    if (peak / (row[i_center - starDiameter / 2] - p.min) >= p.dispersionRatio &&
+                        peak / (row[i_center + starDiameter / 2] - p.min) >= p.dispersionRatio)
+                    {
+                        Edge edge;
+                        edge.x       = center;
+                        edge.y       = i + 0.5;
+                        edge.scanned = 0;
+                        edge.val     = peak;
+                        edge.width   = starDiameter;
+                        edge.HFR     = 0;
+                        edge.sum     = sum;
+                        edges.append(edge);
+                    }
+                }
+
+                // Reset
+                avg = sum = starDiameter = 0;
+            }
+        }
+    }
+}
+
+/**
+ * @short Find the edges of the stars within area, in parallel
+ * @param buffer first channel of the image
+ * @param width width of the image
+ * @param area pixels to scan
+ * @param p thresholds of the edges
+ * @return the edges, ordered by row then column. If p.maxEdges edges or more are returned, the scan was aborted.
+ */
+template <typename T>
+QVector<Edge> findEdges(const T *buffer, int width, const QRect &area, const EdgeParameters &p)
+{
+    QVector<int> bands;
+    for (int row = area.top(); row <= area.bottom(); row += BandRows)
+        bands.append(row);
+
+    QVector<QVector<Edge>> bandEdges(bands.size());
+    QVector<Edge> *out = bandEdges.data();
+    QAtomicInt total;
+
+    std::function<void(int)> scan = [&](int row) {
+        // Too many edges, the result will be discarded anyway
+        if (total.load() >= p.maxEdges)
+            return;
+        QVector<Edge> &edges = out[(row - area.top()) / BandRows];
+        scanRows(buffer, width, area, row, std::min(row + BandRows, area.bottom() + 1), p, edges);
+        total.fetchAndAddRelaxed(edges.size());
+    };
+    QtConcurrent::blockingMap(bands, scan);
+
+    QVector<Edge> edges;
+    edges.reserve(total.load());
+    for (const QVector<Edge> &e : bandEdges)
+        edges += e;
+    return edges;
+}
+
+/** @return true if two edges overlap, same as FITSData::checkCollision() */
+inline bool collides(const Edge &s1, const Edge &s2)
+{
+    int diff_x = s1.x - s2.x;
+    int diff_y = s1.y - s2.y;
+
+    int dis = std::abs(sqrt(diff_x * diff_x + diff_y * diff_y));
+    dis -= s1.width / 2;
+    dis -= s2.width / 2;
+
+    return dis <= 0;
+}
+
+/**
+ * @short Merge the edges into star candidates
+ *
+ * Edges are taken by decreasing sum, and each one that was not merged yet collects all the edges that collide
+ * with it. Two edges can only collide if their rows are less than the widest edge plus two apart, so only
+ * those rows are searched.
+ *
+ * @param edges edges returned by findEdges(). They are sorted and flagged as scanned.
+ * @return one center for each edge that was not merged into another one
+ */
+inline QVector<Center> clusterEdges(QVector<Edge> &edges)
+{
+    QVector<Center> centers;
+    if (edges.isEmpty())
+        return centers;
+
+    // Starting with the largest sum. A stable sort keeps ties in row order.
+    std::stable_sort(edges.begin(), edges.end(), [](const Edge &s1, const Edge &s2) { return s1.sum > s2.sum; });
+
+    float maxWidth = 0;
+    int firstRow = edges[0].y, lastRow = edges[0].y;
+    for (const Edge &edge : edges)
+    {
+        maxWidth = std::max(maxWidth, edge.width);
+        firstRow = std::min(firstRow, int(edge.y));
+        lastRow  = std::max(lastRow, int(edge.y));
+    }
+    const int reach = int(maxWidth) + 2;
+
+    // Indices of the edges in each row, in increasing order
+    QVector<QVector<int>> rows(lastRow - firstRow + 1);
+    for (int i = 0; i < edges.size(); i++)
+        rows[int(edges[i].y) - firstRow].append(i);
+
+    QVector<int> candidates;
+    for (int i = 0; i < edges.size(); i++)
+    {
+        if (edges[i].scanned)
+            continue;
+
+        const Edge &edge = edges[i];
+        int cen_v = edge.sum;
+        int cen_w = edge.width;
+        int row   = int(edge.y) - firstRow;
+
+        candidates.clear();
+        for (int r = std::max(0, row - reach); r <= std::min(rows.size() - 1, row + reach); r++)
+            candidates += rows[r];
+        // Edges are merged in the same order as a scan of the whole array
+        std::sort(candidates.begin(), candidates.end());
+
+        float avg_x = 0, avg_y = 0;
+        double sum = 0;
+        int count = 0;
+
+        for (int j : candidates)
+        {
+            Edge &other = edges[j];
+            if (other.scanned || collides(other, edge) == false)
+                continue;
+
+            if (other.sum >= cen_v)
+            {
+                cen_v = other.sum;
+                cen_w = other.width;
+            }
+
+            other.scanned = 1;
+            count++;
+
+            avg_x += other.x * other.val;
+            avg_y += other.y * other.val;
+            sum += other.val;
+        }
+
+        Center center;
+        center.x     = avg_x / sum;
+        center.y     = avg_y / sum;
+        center.width = cen_w;
+        center.count = count;
+        centers.append(center);
+    }
+
+    return centers;
+}
+
+/**
+ * @short Measure the half flux radius of a star along its central row
+ * @param buffer first channel of the image
+ * @param width width of the image
+ * @param min value subtracted from every pixel
+ * @param star star whose x, y and width are set. Its HFR and val (total flux) are updated.
+ * @return the number of pixels integrated from the center
+ */
+template <typename T>
+int halfFluxRadius(const T *buffer, int width, double min, Edge &star)
+{
+    int cen_x = (int)floor(star.x);
+    int cen_y = (int)floor(star.y);
+    const T *row = buffer + cen_y * width;
+
+    // Complete sum along the radius
+    double FSum = 0;
+    for (int k = star.width / 2; k >= -(star.width / 2); k--)
+        FSum += row[cen_x - k] - min;
+
+    // Half flux
+    double HF = FSum / 2.0;
+
+    // Total flux starting from center
+    double TF = row[cen_x] - min;
+
+    int pixelCounter = 1;
+
+    // Integrate flux along radius axis until we reach half flux
+    for (int k = 1; k < star.width / 2; k++)
+    {
+        if (TF >= HF)
+            break;
+
+        TF += row[cen_x + k] - min;
+        TF += row[cen_x - k] - min;
+
+        pixelCounter++;
+    }
+
+    // Calculate weighted Half Flux Radius
+    star.HFR = pixelCounter * (HF / TF);
+    // Store full flux
+    star.val = FSum;
+
+    return pixelCounter;
+}
+}
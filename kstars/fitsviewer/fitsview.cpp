@@ -191,6 +191,16 @@ void FITSView::resizeEvent(QResizeEvent *event)
 }*/
 
 bool FITSView::loadFITS(const QString &inFilename, bool silent)
+{
+    return loadFITSData([&](FITSData *data) { return data->loadFITS(inFilename, silent); });
+}
+
+bool FITSView::loadFITSBuffer(const QByteArray &buffer, const QString &inFilename, bool silent)
+{
+    return loadFITSData([&](FITSData *data) { return data->loadFITSBuffer(buffer, inFilename, silent); });
+}
+
+bool FITSView::loadFITSData(const std::function<bool(FITSData *)> &load)
 {
     if (floatingToolBar)
         floatingToolBar->setVisible(true);
@@ -231,7 +241,7 @@ bool FITSView::loadFITS(const QString &inFilename, bool silent)
         qApp->processEvents();
     }
 
-    if (imageData->loadFITS(inFilename, silent) == false)
+    if (load(imageData) == false)
         return false;
 
     if (mode == FITS_NORMAL)
@@ -391,35 +401,26 @@ void FITSView::leaveEvent(QEvent *)
 template <typename T>
 int FITSView::rescale(FITSZoom type)
 {
-    double val = 0;
-    double bscale, bzero;
     double min, max;
-    bool displayBuffer = false;
 
     if (display_image == nullptr)
         return -1;
 
-    uint8_t *image_buffer = imageData->getImageBuffer();
-
-    uint32_t size = imageData->getSize();
-    int BBP       = imageData->getBytesPerPixel();
+    FITSDisplay::Stretch stretch;
 
     filter = filterStack.last();
 
     if (Options::autoStretch() && (filter == FITS_NONE || (filter >= FITS_ROTATE_CW && filter <= FITS_FLIP_V)))
     {
-        image_buffer = new uint8_t[imageData->getSize() * imageData->getNumOfChannels() * BBP];
-        memcpy(image_buffer, imageData->getImageBuffer(), imageData->getSize() * imageData->getNumOfChannels() * BBP);
-
-        displayBuffer = true;
-
+        // The samples are clamped while they are converted, instead of filtering a copy of the whole buffer
         float data_min = -1;
         float data_max = -1;
 
-        imageData->applyFilter(FITS_AUTO_STRETCH, image_buffer, &data_min, &data_max);
+        imageData->getFilterBounds(FITS_AUTO_STRETCH, &data_min, &data_max);
 
-        min = data_min;
-        max = data_max;
+        min           = data_min;
+        max           = data_max;
+        stretch.clamp = true;
     }
     else
     {
@@ -427,7 +428,7 @@ int FITSView::rescale(FITSZoom type)
         imageData->getMinMax(&min, &max);
     }
 
-    T *buffer = reinterpret_cast<T *>(image_buffer);
+    const T *buffer = reinterpret_cast<const T *>(imageData->getImageBuffer());
 
     if (min == max)
     {
@@ -436,9 +437,6 @@ int FITSView::rescale(FITSZoom type)
     }
     else
     {
-        bscale = 255. / (max - min);
-        bzero  = (-min) * (255. / (max - min));
-
         if (image_height != imageData->getHeight() || image_width != imageData->getWidth())
         {
             image_width  = imageData->getWidth();
@@ -454,45 +452,13 @@ int FITSView::rescale(FITSZoom type)
         currentWidth  = display_image->width();
         currentHeight = display_image->height();
 
-        if (imageData->getNumOfChannels() == 1)
-        {
-            /* Fill in pixel values using indexed map, linear scale */
-            for (int j = 0; j < image_height; j++)
-            {
-                unsigned char *scanLine = display_image->scanLine(j);
-
-                for (int i = 0; i < image_width; i++)
-                {
-                    val         = buffer[j * image_width + i] * bscale + bzero;
-                    scanLine[i] = qBound(0.0, val, 255.0);
-                }
-            }
-        }
-        else
-        {
-            double rval = 0, gval = 0, bval = 0;
-            QRgb value;
-            /* Fill in pixel values using indexed map, linear scale */
-            for (int j = 0; j < image_height; j++)
-            {
-                QRgb *scanLine = reinterpret_cast<QRgb *>((display_image->scanLine(j)));
-
-                for (int i = 0; i < image_width; i++)
-                {
-                    rval = buffer[j * image_width + i];
-                    gval = buffer[j * image_width + i + size];
-                    bval = buffer[j * image_width + i + size * 2];
+        stretch.min = min;
+        stretch.max = max;
 
-                    value = qRgb(rval * bscale + bzero, gval * bscale + bzero, bval * bscale + bzero);
-
-                    scanLine[i] = value;
-                }
-            }
-        }
+        FITSDisplay::render(buffer, imageData->getNumOfChannels(), stretch, *display_image);
     }
 
-    if (displayBuffer)
-        delete[] image_buffer;
+    displayPyramid.build(*display_image);
 
     switch (type)
     {
@@ -610,27 +576,35 @@ void FITSView::ZoomToFit()
 
 void FITSView::updateFrame()
 {
-    QPixmap displayPixmap;
-    bool ok = false;
-
     if (display_image == nullptr)
         return;
 
-    if (currentZoom != ZOOM_DEFAULT)
-        ok = displayPixmap.convertFromImage(
-            display_image->scaled(currentWidth, currentHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-    else
-        ok = displayPixmap.convertFromImage(*display_image);
+    // Only the visible part of the frame is drawn, by drawFrame()
+    image_frame->resize(currentWidth, currentHeight);
+    image_frame->update();
+}
 
-    if (ok == false)
+void FITSView::drawFrame(QPainter *painter, const QRect &area)
+{
+    if (display_image == nullptr || currentWidth == 0 || currentHeight == 0)
         return;
 
-    QPainter painter(&displayPixmap);
+    const QImage &image = displayPyramid.level(*display_image, currentZoom / ZOOM_DEFAULT);
 
-    drawOverlay(&painter);
+    // Part of the level under the area, with a margin for the smooth transformation
+    double scaleX = image.width() / static_cast<double>(currentWidth);
+    double scaleY = image.height() / static_cast<double>(currentHeight);
+    QRectF source(area.x() * scaleX, area.y() * scaleY, area.width() * scaleX, area.height() * scaleY);
+    QRect tile = source.toAlignedRect().adjusted(-1, -1, 1, 1).intersected(image.rect());
 
-    image_frame->setPixmap(displayPixmap);
-    image_frame->resize(currentWidth, currentHeight);
+    if (tile.isEmpty())
+        return;
+
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, currentZoom != ZOOM_DEFAULT);
+    // Only the tile is converted to the format of the painter
+    painter->drawImage(QRectF(area), image.copy(tile), source.translated(-tile.topLeft()));
+
+    drawOverlay(painter);
 }
 
 void FITSView::ZoomDefault()
@@ -856,28 +830,9 @@ void FITSView::drawEQGrid(QPainter *painter)
 
     if (imageData->hasWCS())
     {
-        wcs_point *wcs_coord = imageData->getWCSCoord();
-        if (wcs_coord)
+        double maxRA, minRA, maxDec, minDec;
+        if (imageData->getWCSRange(minRA, maxRA, minDec, maxDec))
         {
-            int size      = image_width * image_height;
-            double maxRA  = -1000;
-            double minRA  = 1000;
-            double maxDec = -1000;
-            double minDec = 1000;
-
-            for (int i = 0; i < (size); i++)
-            {
-                double ra  = wcs_coord[i].ra;
-                double dec = wcs_coord[i].dec;
-                if (ra > maxRA)
-                    maxRA = ra;
-                if (ra < minRA)
-                    minRA = ra;
-                if (dec > maxDec)
-                    maxDec = dec;
-                if (dec < minDec)
-                    minDec = dec;
-            }
             int minDecMinutes = (int)(minDec * 12); //This will force the Dec Scale to 5 arc minutes in the loop
             int maxDecMinutes = (int)(maxDec * 12);
 
@@ -1365,6 +1320,7 @@ void FITSView::initDisplayImage()
 {
     delete display_image;
     display_image = nullptr;
+    displayPyramid.clear();
 
     if (imageData->getNumOfChannels() == 1)
     {
@@ -40,6 +40,9 @@
 
 #include "dms.h"
 #include "fitsdata.h"
+#include "fitsdisplay.h"
+
+#include <functional>
 
 #define MINIMUM_PIXEL_RANGE 5
 #define MINIMUM_STDVAR      5
@@ -55,6 +58,8 @@ class FITSView : public QScrollArea
 
     /* Loads FITS image, scales it, and displays it in the GUI */
     bool loadFITS(const QString &filename, bool silent = true);
+    /* Same as loadFITS, from a FITS file held in memory */
+    bool loadFITSBuffer(const QByteArray &buffer, const QString &filename = QString(), bool silent = true);
     /* Save FITS */
     int saveFITS(const QString &filename);
     /* Rescale image lineary from image_buffer, fit to window if desired */
@@ -93,6 +98,8 @@ class FITSView : public QScrollArea
     bool imageHasWCS();
 
     void updateFrame();
+    // Draw the part of the zoomed frame within area, and the overlay. Called by the label when it is painted.
+    void drawFrame(QPainter *painter, const QRect &area);
 
     bool isTelescopeActive();
 
@@ -172,6 +179,9 @@ class FITSView : public QScrollArea
     //void handleWCSCompletion();
 
   private:
+    /* Replace the image data with a new FITSData filled by load, and display it */
+    bool loadFITSData(const std::function<bool(FITSData *)> &load);
+
     QLabel *noImageLabel = new QLabel();
     QPixmap noImage;
 
@@ -198,6 +208,7 @@ class FITSView : public QScrollArea
 
     int data_type;         /* FITS data type when opened */
     QImage *display_image; /* FITS image that is displayed in the GUI */
+    FITSDisplay::Pyramid displayPyramid; /* Reduced copies of display_image, drawn when zoomed out */
     FITSHistogram *histogram;
 
     double maxPixel, minPixel;
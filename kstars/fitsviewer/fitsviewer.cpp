@@ -424,6 +424,51 @@ int FITSViewer::addFITS(const QUrl *imageName, FITSMode mode, FITSScale filter,
     return (fitsID++);
 }
 
+bool FITSViewer::showImageData(QPointer<FITSViewer> &viewer, FITSData *data)
+{
+    QString filename = data->getFilename();
+    bool temporary   = filename.isEmpty();
+    if (temporary)
+    {
+        filename = data->saveTemporaryFITS();
+        if (filename.isEmpty())
+            return false;
+    }
+
+    QUrl url    = QUrl::fromLocalFile(filename);
+    int fitsUID = 0;
+
+    if (viewer.isNull())
+    {
+        if (Options::singleWindowCapturedFITS())
+            viewer = KStars::Instance()->genericFITSViewer();
+        else
+        {
+            viewer = new FITSViewer(Options::independentWindowFITS() ? nullptr : KStars::Instance());
+            KStars::Instance()->getFITSViewersList().append(viewer);
+        }
+
+        fitsUID = viewer->addFITS(&url);
+    }
+    else if (viewer->updateFITS(&url, 0) == false)
+        fitsUID = -1;
+
+    if (fitsUID < 0)
+    {
+        if (temporary)
+            QFile::remove(filename);
+        return false;
+    }
+
+    // Files written by the module itself are left alone
+    FITSView *view = viewer->getView(fitsUID);
+    if (view)
+        view->getImageData()->setAutoRemoveTemporaryFITS(temporary);
+
+    viewer->show();
+    return true;
+}
+
 bool FITSViewer::removeFITS(int fitsUID)
 {
     FITSTab *tab = fitsMap.value(fitsUID);
@@ -22,6 +22,7 @@
 
 #include <QList>
 #include <QMap>
+#include <QPointer>
 
 #include <QDialog>
 #include <QUrl>
@@ -45,6 +46,7 @@ class QUndoGroup;
 class QTabWidget;
 class QUrl;
 
+class FITSData;
 class FITSView;
 class FITSTab;
 class FITSDebayer;
@@ -69,6 +71,15 @@ class FITSViewer : public KXmlGuiWindow
                 const QString &previewText = QString(), bool silent = true);
 
     bool updateFITS(const QUrl *imageName, int fitsUID, FITSScale filter = FITS_NONE, bool silent = true);
+
+    /**
+     * @short Show the image of an Ekos module in the module's FITS Viewer, which is created on first use.
+     * An image received in memory is written to a temporary file, removed once the viewer is done with it.
+     * @param viewer FITS Viewer of the module
+     * @param data Image to show
+     * @return false if the image could not be shown
+     */
+    static bool showImageData(QPointer<FITSViewer> &viewer, FITSData *data);
     bool removeFITS(int fitsUID);
 
     void toggleMarkStars(bool enable) { markStars = enable; }
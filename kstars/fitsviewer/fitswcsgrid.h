@@ -0,0 +1,278 @@
+/***************************************************************************
+                     fitswcsgrid.h  -  FITS Image
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include "dms.h"
+
+#include <QString>
+#include <QVector>
+
+#include <wcs.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/**
+ * @class FITSWCSGrid
+ * @short Conversion of the pixels of a FITS image to J2000 coordinates, used by FITSData
+ *
+ * The WCS is sampled on a grid of pixels in a single wcsp2s call, which gives the range of coordinates covered by
+ * the image. Plain TAN projections are then evaluated exactly through the CD matrix and the inverse gnomonic
+ * projection, anything else with wcsp2s for each pixel.
+ *
+ * Grid points that wcsp2s cannot convert are marked invalid rather than failing the whole image. The pixels of a
+ * grid cell with an invalid corner are always converted with wcsp2s.
+ */
+class FITSWCSGrid
+{
+  public:
+    /** Distance between two points of the grid, in pixels */
+    static const int GridStep = 32;
+
+    /**
+     * @short Sample wcs over an image of the given size
+     * @param wcs WCS set up by wcsset(), which must outlive the grid
+     * @param error Reason of the failure, if any
+     * @return false if no point of the grid could be converted
+     */
+    bool build(wcsprm *wcs, int width, int height, QString &error)
+    {
+        clear();
+        m_Wcs    = wcs;
+        m_Width  = width;
+        m_Height = height;
+
+        // The last row and column of the grid always fall on the image edges
+        m_GridWidth  = (width - 1 + GridStep - 1) / GridStep + 1;
+        m_GridHeight = (height - 1 + GridStep - 1) / GridStep + 1;
+        int size     = m_GridWidth * m_GridHeight;
+
+        QVector<double> pixcrd(size * 2), imgcrd(size * 2), world(size * 2), phi(size), theta(size);
+        QVector<int> stat(size);
+
+        for (int i = 0; i < m_GridHeight; i++)
+        {
+            for (int j = 0; j < m_GridWidth; j++)
+            {
+                pixcrd[(i * m_GridWidth + j) * 2]     = gridX(j);
+                pixcrd[(i * m_GridWidth + j) * 2 + 1] = gridY(i);
+            }
+        }
+
+        // A single call for all the grid points. Points it cannot convert are flagged in stat.
+        int status = wcsp2s(wcs, size, 2, pixcrd.data(), imgcrd.data(), phi.data(), theta.data(), world.data(),
+                            stat.data());
+        if (status && status != WCSERR_BAD_PIX)
+        {
+            error = QString("wcsp2s error %1: %2.").arg(status).arg(wcs_errmsg[status]);
+            clear();
+            return false;
+        }
+
+        m_Grid.resize(size * 3);
+        m_Valid.fill(true, size);
+        m_Range[0] = m_Range[2] = 1000;
+        m_Range[1] = m_Range[3] = -1000;
+
+        int nValid = 0;
+        for (int i = 0; i < size; i++)
+        {
+            if (status && stat[i])
+            {
+                m_Valid[i] = false;
+                continue;
+            }
+
+            double ra = world[i * 2], dec = world[i * 2 + 1];
+            toVector(ra, dec, &m_Grid[i * 3]);
+            nValid++;
+
+            m_Range[0] = std::min(m_Range[0], ra);
+            m_Range[1] = std::max(m_Range[1], ra);
+            m_Range[2] = std::min(m_Range[2], dec);
+            m_Range[3] = std::max(m_Range[3], dec);
+        }
+
+        if (nValid == 0)
+        {
+            error = QString("wcsp2s error %1: %2.").arg(status).arg(wcs_errmsg[status]);
+            clear();
+            return false;
+        }
+
+        m_Linear = checkLinear();
+        return true;
+    }
+
+    void clear()
+    {
+        m_Wcs    = nullptr;
+        m_Linear = false;
+        m_Grid.clear();
+        m_Valid.clear();
+        m_GridWidth = m_GridHeight = 0;
+    }
+
+    /** @return true if the pixels are evaluated analytically, as a plain TAN projection */
+    bool isLinear() const { return m_Linear; }
+
+    /** @return the range of J2000 coordinates of the valid grid points, in degrees */
+    void getRange(double &minRA, double &maxRA, double &minDec, double &maxDec) const
+    {
+        minRA  = m_Range[0];
+        maxRA  = m_Range[1];
+        minDec = m_Range[2];
+        maxDec = m_Range[3];
+    }
+
+    /**
+     * @short Convert a pixel to a J2000 unit vector, analytically or with wcslib
+     * @param error Reason of the failure, if any
+     */
+    bool pixelToVector(double x, double y, double v[3], QString &error) const
+    {
+        if (m_Linear && isCellValid(x, y))
+        {
+            linearToVector(x, y, v);
+            return true;
+        }
+
+        return wcsToVector(x, y, v, error);
+    }
+
+    /** @short Convert a pixel to a J2000 unit vector with wcslib, whatever the projection */
+    bool wcsToVector(double x, double y, double v[3], QString &error) const
+    {
+        int stat[1];
+        double imgcrd[2], phi, pixcrd[2] = { x, y }, theta, world[2];
+
+        int status = wcsp2s(m_Wcs, 1, 2, &pixcrd[0], &imgcrd[0], &phi, &theta, &world[0], &stat[0]);
+        if (status)
+        {
+            error = QString("wcsp2s error %1: %2.").arg(status).arg(wcs_errmsg[status]);
+            return false;
+        }
+
+        toVector(world[0], world[1], v);
+        return true;
+    }
+
+    /** @short Convert a J2000 unit vector to RA and Dec in degrees */
+    static void vectorToRADec(const double v[3], double &ra, double &dec)
+    {
+        ra = atan2(v[1], v[0]) / dms::DegToRad;
+        if (ra < 0)
+            ra += 360.0;
+        dec = atan2(v[2], hypot(v[0], v[1])) / dms::DegToRad;
+    }
+
+  private:
+    double gridX(int j) const { return std::min(j * GridStep, m_Width - 1); }
+    double gridY(int i) const { return std::min(i * GridStep, m_Height - 1); }
+
+    static void toVector(double ra, double dec, double v[3])
+    {
+        double sinRA, cosRA, sinDec, cosDec;
+        dms(ra).SinCos(sinRA, cosRA);
+        dms(dec).SinCos(sinDec, cosDec);
+        v[0] = cosDec * cosRA;
+        v[1] = cosDec * sinRA;
+        v[2] = sinDec;
+    }
+
+    /** @return true if the four grid points around the pixel were converted */
+    bool isCellValid(double x, double y) const
+    {
+        int j  = std::max(0, std::min(int(x) / GridStep, m_GridWidth - 1));
+        int i  = std::max(0, std::min(int(y) / GridStep, m_GridHeight - 1));
+        int j1 = std::min(j + 1, m_GridWidth - 1);
+        int i1 = std::min(i + 1, m_GridHeight - 1);
+        return m_Valid[i * m_GridWidth + j] && m_Valid[i * m_GridWidth + j1] && m_Valid[i1 * m_GridWidth + j] &&
+               m_Valid[i1 * m_GridWidth + j1];
+    }
+
+    void linearToVector(double x, double y, double v[3]) const
+    {
+        // Intermediate world coordinates through the CD matrix, then the inverse gnomonic projection
+        const double *m = m_Wcs->lin.piximg;
+        double dx = x - m_Wcs->crpix[0], dy = y - m_Wcs->crpix[1];
+        double xi   = (m[0] * dx + m[1] * dy) * dms::DegToRad;
+        double eta  = (m[2] * dx + m[3] * dy) * dms::DegToRad;
+        double norm = 1.0 / sqrt(1.0 + xi * xi + eta * eta);
+        for (int k = 0; k < 3; k++)
+            v[k] = (m_Center[k] + xi * m_East[k] + eta * m_North[k]) * norm;
+    }
+
+    // Check whether the WCS is a plain TAN projection that can be evaluated analytically
+    bool checkLinear()
+    {
+        if (m_Wcs->naxis != 2 || m_Wcs->lng != 0 || m_Wcs->lat != 1 || strncmp(m_Wcs->cel.prj.code, "TAN", 3) != 0)
+            return false;
+
+        double sinRA, cosRA, sinDec, cosDec;
+        dms(m_Wcs->crval[0]).SinCos(sinRA, cosRA);
+        dms(m_Wcs->crval[1]).SinCos(sinDec, cosDec);
+
+        m_Center[0] = cosDec * cosRA;
+        m_Center[1] = cosDec * sinRA;
+        m_Center[2] = sinDec;
+        m_East[0]   = -sinRA;
+        m_East[1]   = cosRA;
+        m_East[2]   = 0;
+        m_North[0]  = -sinDec * cosRA;
+        m_North[1]  = -sinDec * sinRA;
+        m_North[2]  = cosDec;
+
+        // Distortion terms, a non-default pole or a shifted fiducial point all make the analytic inverse wrong.
+        // Rather than testing for each of them, check it against wcslib on the valid grid points: 0.01 arcseconds.
+        const double tolerance = 0.01 / 3600.0 * dms::DegToRad;
+        for (int i = 0; i < m_GridHeight; i++)
+        {
+            for (int j = 0; j < m_GridWidth; j++)
+            {
+                if (!m_Valid[i * m_GridWidth + j])
+                    continue;
+
+                double v[3];
+                const double *g = m_Grid.constData() + (i * m_GridWidth + j) * 3;
+                linearToVector(gridX(j), gridY(i), v);
+                if (std::abs(v[0] - g[0]) > tolerance || std::abs(v[1] - g[1]) > tolerance ||
+                    std::abs(v[2] - g[2]) > tolerance)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    wcsprm *m_Wcs { nullptr };
+    int m_Width { 0 };
+    int m_Height { 0 };
+
+    // J2000 unit vectors (x, y, z) sampled every GridStep pixels, and whether wcsp2s could convert them
+    QVector<double> m_Grid;
+    QVector<bool> m_Valid;
+    int m_GridWidth { 0 };
+    int m_GridHeight { 0 };
+    double m_Range[4] = { 0, 0, 0, 0 }; // minRA, maxRA, minDec, maxDec in degrees
+
+    // Plain TAN projections: tangent point and directions of increasing RA and Dec there
+    bool m_Linear { false };
+    double m_Center[3], m_East[3], m_North[3];
+};
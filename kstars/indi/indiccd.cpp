@@ -14,6 +14,8 @@
 #include <KMessageBox>
 #include <QStatusBar>
 #include <QImageReader>
+#include <QtConcurrent>
+#include <QFutureWatcher>
 #include <KNotifications/KNotification>
 
 #include <basedevice.h>
@@ -849,6 +851,9 @@ CCD::CCD(GDInterface *iPtr) : DeviceDecorator(iPtr)
 
 CCD::~CCD()
 {
+    // The last batch capture is on disk before the device goes away
+    fitsWriteFuture.waitForFinished();
+
 #ifdef HAVE_CFITSIO
     delete (fv);
 #endif
@@ -1268,6 +1273,20 @@ void CCD::processBLOB(IBLOB *bp)
     int nr, n = 0;
     QTemporaryFile tmpFile(QDir::tempPath() + "/fitsXXXXXX");
 
+    // Guide and focus frames are never written to disk, and batch captures are written in the background.
+    // Both are loaded straight from the received buffer.
+    bool fitsInMemory = BType == BLOB_FITS &&
+                        (targetChip->getCaptureMode() == FITS_GUIDE || targetChip->getCaptureMode() == FITS_FOCUS);
+    bool fitsInBackground =
+        BType == BLOB_FITS && targetChip->isBatchMode() && targetChip->getCaptureMode() == FITS_NORMAL;
+    QByteArray fitsBuffer;
+
+    if (fitsInMemory || fitsInBackground)
+    {
+        fitsBuffer = QByteArray(static_cast<char *>(bp->blob), bp->size);
+        addFITSKeywords(fitsBuffer);
+    }
+
     //if (currentDir.endsWith('/'))
     //currentDir.truncate(currentDir.size()-1);
 
@@ -1278,10 +1297,12 @@ void CCD::processBLOB(IBLOB *bp)
     if (filename.endsWith('/') == false)
         filename.append('/');
 
+    if (fitsInMemory)
+        filename.clear();
     // Create temporary name if ANY of the following conditions are met:
     // 1. file is preview or batch mode is not enabled
     // 2. file type is not FITS_NORMAL (focus, guide..etc)
-    if (targetChip->isBatchMode() == false || targetChip->getCaptureMode() != FITS_NORMAL)
+    else if (targetChip->isBatchMode() == false || targetChip->getCaptureMode() != FITS_NORMAL)
     {
         //tmpFile.setPrefix("fits");
         tmpFile.setAutoRemove(false);
@@ -1319,23 +1340,32 @@ void CCD::processBLOB(IBLOB *bp)
             filename += seqPrefix + (seqPrefix.isEmpty() ? "" : "_") +
                         QString("%1.%2").arg(QString().sprintf("%03d", nextSequenceID)).arg(QString(fmt));
 
-        QFile fits_temp_file(filename);
-        if (!fits_temp_file.open(QIODevice::WriteOnly))
+        if (fitsInBackground)
         {
-            qDebug() << "ISD:CCD Error: Unable to open " << fits_temp_file.fileName() << endl;
-            emit BLOBUpdated(nullptr);
-            return;
+            // One capture is written at a time, the previous one is checked by its own watcher
+            fitsWriteFuture.waitForFinished();
+            fitsWriteFuture = QtConcurrent::run(&CCD::writeBLOBFile, filename, fitsBuffer);
         }
+        else
+        {
+            QFile fits_temp_file(filename);
+            if (!fits_temp_file.open(QIODevice::WriteOnly))
+            {
+                qDebug() << "ISD:CCD Error: Unable to open " << fits_temp_file.fileName() << endl;
+                emit BLOBUpdated(nullptr);
+                return;
+            }
 
-        QDataStream out(&fits_temp_file);
+            QDataStream out(&fits_temp_file);
 
-        for (nr = 0; nr < (int)bp->size; nr += n)
-            n = out.writeRawData(static_cast<char *>(bp->blob) + nr, bp->size - nr);
+            for (nr = 0; nr < (int)bp->size; nr += n)
+                n = out.writeRawData(static_cast<char *>(bp->blob) + nr, bp->size - nr);
 
-        fits_temp_file.close();
+            fits_temp_file.close();
+        }
     }
 
-    if (BType == BLOB_FITS)
+    if (BType == BLOB_FITS && fitsBuffer.isEmpty())
         addFITSKeywords(filename);
 
     // store file name
@@ -1492,30 +1522,16 @@ void CCD::processBLOB(IBLOB *bp)
                 if (previewView)
                 {
                     previewView->setFilter(captureFilter);
-                    bool imageLoad = previewView->loadFITS(filename, true);
+                    bool imageLoad = fitsBuffer.isEmpty() ? previewView->loadFITS(filename, true) :
+                                                            previewView->loadFITSBuffer(fitsBuffer, filename, true);
                     if (imageLoad)
                         previewView->updateFrame();
                 }
                 if (Options::useFITSViewerInCapture() || !targetChip->isBatchMode())
                 {
-                    if (normalTabID == -1 || Options::singlePreviewFITS() == false)
-                        tabRC = fv->addFITS(&fileURL, FITS_NORMAL, captureFilter, previewTitle);
-                    else if (fv->updateFITS(&fileURL, normalTabID, captureFilter) == false)
-                    {
-                        fv->removeFITS(normalTabID);
-                        tabRC = fv->addFITS(&fileURL, FITS_NORMAL, captureFilter, previewTitle);
-                    }
-                    else
-                        tabRC = normalTabID;
-
-                    if (tabRC >= 0)
-                    {
-                        normalTabID = tabRC;
-                        targetChip->setImageView(fv->getView(normalTabID), FITS_NORMAL);
-
-                        emit newImage(fv->getView(normalTabID)->getDisplayImage(), targetChip);
-                    }
-                    else
+                    // The FITS Viewer opens the file, so a capture written in the background is shown once it
+                    // is on disk, see the watcher below
+                    if (fitsInBackground == false && addNormalFITS(targetChip, fileURL, captureFilter, previewTitle) == false)
                     {
                         // If opening file fails, we treat it the same as exposure failure and recapture again if possible
                         emit newExposureValue(targetChip, 0, IPS_ALERT);
@@ -1565,7 +1581,7 @@ void CCD::processBLOB(IBLOB *bp)
                     if (focusView)
                     {
                         focusView->setFilter(captureFilter);
-                        bool imageLoad = focusView->loadFITS(filename, true);
+                        bool imageLoad = focusView->loadFITSBuffer(fitsBuffer, QString(), true);
                         if (imageLoad)
                         {
                             //focusView->rescale(ZOOM_FIT_WINDOW);
@@ -1610,7 +1626,7 @@ void CCD::processBLOB(IBLOB *bp)
                     if (guideView)
                     {
                         guideView->setFilter(captureFilter);
-                        bool imageLoad = guideView->loadFITS(filename, true);
+                        bool imageLoad = guideView->loadFITSBuffer(fitsBuffer, QString(), true);
                         if (imageLoad)
                         {
                             //guideView->rescale(ZOOM_FIT_WINDOW);
@@ -1700,7 +1716,7 @@ void CCD::processBLOB(IBLOB *bp)
                 break;
         }
 
-        if (Options::useFITSViewerInCapture() || !targetChip->isBatchMode())
+        if ((Options::useFITSViewerInCapture() || !targetChip->isBatchMode()) && fitsInBackground == false)
         {
             if (targetChip->getCaptureMode() == FITS_NORMAL || targetChip->getCaptureMode() == FITS_CALIBRATE)
                 fv->show();
@@ -1708,9 +1724,77 @@ void CCD::processBLOB(IBLOB *bp)
     }
 #endif
 
+    // The file named in aux2 is used as soon as the BLOB is updated, by the post-capture script for instance.
+    // A capture written in the background is only handed over once it is on disk, without blocking until then.
+    if (fitsInBackground)
+    {
+        FITSScale captureFilter = targetChip->getCaptureFilter();
+        bool showFITS           = Options::useFITSViewerInCapture();
+
+        QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+        connect(watcher, &QFutureWatcher<bool>::finished, this, [=]() {
+            watcher->deleteLater();
+
+            if (watcher->result() == false)
+            {
+                KStars::Instance()->statusBar()->showMessage(i18n("Unable to write %1", filename), 0);
+                emit newExposureValue(targetChip, 0, IPS_ALERT);
+                return;
+            }
+
+#ifdef HAVE_CFITSIO
+            if (showFITS && fv.isNull() == false)
+            {
+                if (addNormalFITS(targetChip, QUrl::fromLocalFile(filename), captureFilter, QString()) == false)
+                {
+                    emit newExposureValue(targetChip, 0, IPS_ALERT);
+                    return;
+                }
+                fv->show();
+            }
+#endif
+
+            // Another BLOB may have been received in the meantime
+            strncpy(BLOBFilename, filename.toLatin1(), MAXINDIFILENAME);
+            BType    = BLOB_FITS;
+            bp->aux1 = &BType;
+            bp->aux2 = BLOBFilename;
+
+            emit BLOBUpdated(bp);
+        });
+        watcher->setFuture(fitsWriteFuture);
+        return;
+    }
+
     emit BLOBUpdated(bp);
 }
 
+#ifdef HAVE_CFITSIO
+bool CCD::addNormalFITS(CCDChip *targetChip, const QUrl &fileURL, FITSScale captureFilter, const QString &previewTitle)
+{
+    int tabRC = -1;
+
+    if (normalTabID == -1 || Options::singlePreviewFITS() == false)
+        tabRC = fv->addFITS(&fileURL, FITS_NORMAL, captureFilter, previewTitle);
+    else if (fv->updateFITS(&fileURL, normalTabID, captureFilter) == false)
+    {
+        fv->removeFITS(normalTabID);
+        tabRC = fv->addFITS(&fileURL, FITS_NORMAL, captureFilter, previewTitle);
+    }
+    else
+        tabRC = normalTabID;
+
+    if (tabRC < 0)
+        return false;
+
+    normalTabID = tabRC;
+    targetChip->setImageView(fv->getView(normalTabID), FITS_NORMAL);
+
+    emit newImage(fv->getView(normalTabID)->getDisplayImage(), targetChip);
+    return true;
+}
+#endif
+
 void CCD::addFITSKeywords(QString filename)
 {
 #ifdef HAVE_CFITSIO
@@ -1742,6 +1826,67 @@ void CCD::addFITSKeywords(QString filename)
 #endif
 }
 
+void CCD::addFITSKeywords(QByteArray &buffer)
+{
+#ifdef HAVE_CFITSIO
+    int status = 0, hdus = 0;
+    LONGLONG headStart = 0, dataStart = 0, dataEnd = 0;
+
+    if (filter.isEmpty() == false)
+    {
+        QString key_comment("Filter name");
+        filter.replace(" ", "_");
+
+        // CFITSIO may have to grow the header, so it gets a copy it can reallocate
+        size_t size  = buffer.size();
+        void *memory = malloc(size);
+        memcpy(memory, buffer.constData(), size);
+
+        fitsfile *fptr = nullptr;
+
+        if (fits_open_memfile(&fptr, "blob.fits", READWRITE, &memory, &size, 2880, realloc, &status))
+        {
+            fits_report_error(stderr, status);
+            free(memory);
+            return;
+        }
+
+        // The end of the last HDU is the new size of the file
+        if (fits_update_key_str(fptr, "FILTER", filter.toLatin1().data(), key_comment.toLatin1().data(), &status) ||
+            fits_get_num_hdus(fptr, &hdus, &status) || fits_movabs_hdu(fptr, hdus, nullptr, &status) ||
+            fits_get_hduaddrll(fptr, &headStart, &dataStart, &dataEnd, &status))
+        {
+            fits_report_error(stderr, status);
+            status = 0;
+            fits_close_file(fptr, &status);
+            free(memory);
+            return;
+        }
+
+        fits_close_file(fptr, &status);
+
+        buffer = QByteArray(static_cast<char *>(memory), qMin(static_cast<size_t>(dataEnd), size));
+        free(memory);
+
+        filter = "";
+    }
+#endif
+}
+
+bool CCD::writeBLOBFile(const QString &filename, const QByteArray &buffer)
+{
+    QFile file(filename);
+
+    if (file.open(QIODevice::WriteOnly) == false || file.write(buffer) != buffer.size())
+    {
+        qCritical() << "ISD:CCD Error: Unable to write " << filename;
+        return false;
+    }
+
+    file.close();
+    return true;
+}
+
 CCD::TransferFormat CCD::getTargetTransferFormat() const
 {
     return targetTransferFormat;
@@ -12,6 +12,7 @@
 
 #include "indistd.h"
 
+#include <QFuture>
 #include <QStringList>
 #include <QPointer>
 
@@ -238,6 +239,10 @@ class CCD : public DeviceDecorator
 
   private:
     void addFITSKeywords(QString filename);
+    void addFITSKeywords(QByteArray &buffer);
+    static bool writeBLOBFile(const QString &filename, const QByteArray &buffer);
+    /** Show a FITS_NORMAL capture in the FITS Viewer. @return false if it could not be opened */
+    bool addNormalFITS(CCDChip *targetChip, const QUrl &fileURL, FITSScale captureFilter, const QString &previewTitle);
     QString filter;
 
     bool ISOMode;
@@ -256,6 +261,8 @@ class CCD : public DeviceDecorator
     CCDChip *primaryChip, *guideChip;
     TransferFormat transferFormat, targetTransferFormat;
     TelescopeType telescopeType = TELESCOPE_PRIMARY;
+    // Background write of the last batch capture, handed over by a QFutureWatcher once it is finished
+    QFuture<bool> fitsWriteFuture;
 
     // Gain, since it is spread among different vector properties, let's try to find the property itself.
     INumber *gainN = nullptr;
@@ -0,0 +1,259 @@
+/*  SER Video Recorder
+    Copyright (C) 2017 KStars Team <kstars-devel@kde.org>
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#include "serrecorder.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QMutexLocker>
+#include <QThread>
+
+#include <cstring>
+
+namespace
+{
+// SER ticks between 0001-01-01 and 1970-01-01
+const qint64 UnixEpochTicks = Q_INT64_C(621355968000000000);
+// Offset of the FrameCount field in the header
+const int FrameCountOffset = 38;
+const int TextSize         = 40;
+
+void writeText(QDataStream &stream, const QString &text)
+{
+    QByteArray latin = text.toLatin1().left(TextSize);
+    latin.append(QByteArray(TextSize - latin.size(), '\0'));
+    stream.writeRawData(latin.constData(), TextSize);
+}
+}
+
+FrameRing::FrameRing(int slots, int frameSize)
+    : m_Buffer(size_t(slots) * frameSize), m_Timestamps(slots), m_FrameSize(frameSize)
+{
+}
+
+uchar *FrameRing::acquire()
+{
+    QMutexLocker locker(&m_Mutex);
+
+    if (m_Closed || m_Count == m_Timestamps.size())
+    {
+        m_Dropped++;
+        return nullptr;
+    }
+
+    // The slot at the head is not published, so the consumer does not read it
+    return m_Buffer.data() + size_t(m_Head) * m_FrameSize;
+}
+
+void FrameRing::commit(qint64 timestamp)
+{
+    QMutexLocker locker(&m_Mutex);
+
+    m_Timestamps[m_Head] = timestamp;
+    m_Head               = (m_Head + 1) % m_Timestamps.size();
+    m_Count++;
+    m_Published.wakeOne();
+}
+
+const uchar *FrameRing::next(qint64 *timestamp)
+{
+    QMutexLocker locker(&m_Mutex);
+
+    while (m_Count == 0 && !m_Closed)
+        m_Published.wait(&m_Mutex);
+
+    if (m_Count == 0)
+        return nullptr;
+
+    *timestamp = m_Timestamps[m_Tail];
+    return m_Buffer.data() + size_t(m_Tail) * m_FrameSize;
+}
+
+void FrameRing::release()
+{
+    QMutexLocker locker(&m_Mutex);
+
+    m_Tail = (m_Tail + 1) % m_Timestamps.size();
+    m_Count--;
+}
+
+void FrameRing::close()
+{
+    QMutexLocker locker(&m_Mutex);
+
+    m_Closed = true;
+    m_Published.wakeAll();
+}
+
+int FrameRing::dropped() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Dropped;
+}
+
+class SERRecorder::Writer : public QThread
+{
+  public:
+    explicit Writer(SERRecorder *recorder) : m_Recorder(recorder) {}
+
+  protected:
+    void run() override { m_Recorder->write(); }
+
+  private:
+    SERRecorder *m_Recorder;
+};
+
+SERRecorder::SERRecorder()
+{
+}
+
+SERRecorder::~SERRecorder()
+{
+    stop();
+}
+
+bool SERRecorder::start(const QString &filename, const Format &format, const QString &observer,
+                        const QString &instrument, const QString &telescope)
+{
+    stop();
+
+    if (format.bytesPerFrame() <= 0)
+        return false;
+
+    m_File.setFileName(filename);
+    if (!m_File.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "Failed to create SER file" << filename << ":" << m_File.errorString();
+        return false;
+    }
+
+    QByteArray head = header(format, 0, QDateTime::currentDateTime(), observer, instrument, telescope);
+    if (m_File.write(head) != head.size())
+    {
+        qWarning() << "Failed to write SER header to" << filename << ":" << m_File.errorString();
+        m_File.close();
+        return false;
+    }
+
+    m_Format     = format;
+    m_Queued     = 0;
+    m_Dropped    = 0;
+    m_WriteError = false;
+    m_Timestamps.clear();
+
+    m_Ring.reset(new FrameRing(qBound(4, RingMemory / format.bytesPerFrame(), 256), format.bytesPerFrame()));
+    m_Writer.reset(new Writer(this));
+    m_Writer->start();
+
+    return true;
+}
+
+bool SERRecorder::addFrame(const void *data, int size)
+{
+    if (m_Ring.isNull() || size != m_Format.bytesPerFrame())
+        return false;
+
+    uchar *slot = m_Ring->acquire();
+    if (slot == nullptr)
+        return false;
+
+    memcpy(slot, data, size);
+    m_Ring->commit(toSERTime(QDateTime::currentDateTimeUtc()));
+    m_Queued++;
+    return true;
+}
+
+void SERRecorder::write()
+{
+    qint64 timestamp = 0;
+    const uchar *frame = nullptr;
+
+    // Frames are still taken from the ring after an error, so that the producer never waits
+    while ((frame = m_Ring->next(&timestamp)) != nullptr)
+    {
+        if (!m_WriteError)
+        {
+            if (m_File.write(reinterpret_cast<const char *>(frame), m_Ring->frameSize()) == m_Ring->frameSize())
+                m_Timestamps.append(timestamp);
+            else
+                m_WriteError = true;
+        }
+        m_Ring->release();
+    }
+}
+
+void SERRecorder::stop()
+{
+    if (m_Ring.isNull())
+        return;
+
+    m_Ring->close();
+    m_Writer->wait();
+
+    if (m_WriteError)
+        qWarning() << "Failed to write SER frames to" << m_File.fileName() << ":" << m_File.errorString();
+
+    // The header was written with no frames
+    QByteArray count;
+    QDataStream countStream(&count, QIODevice::WriteOnly);
+    countStream.setByteOrder(QDataStream::LittleEndian);
+    countStream << qint32(m_Timestamps.size());
+
+    QByteArray trailer;
+    QDataStream trailerStream(&trailer, QIODevice::WriteOnly);
+    trailerStream.setByteOrder(QDataStream::LittleEndian);
+    for (qint64 timestamp : m_Timestamps)
+        trailerStream << timestamp;
+
+    // Frames that failed to be written are cut off
+    m_File.resize(HeaderSize + qint64(m_Timestamps.size()) * m_Format.bytesPerFrame());
+    m_File.seek(m_File.size());
+    m_File.write(trailer);
+    m_File.seek(FrameCountOffset);
+    m_File.write(count);
+    m_File.close();
+
+    m_Dropped = m_Ring->dropped();
+    m_Writer.reset();
+    m_Ring.reset();
+}
+
+int SERRecorder::framesDropped() const
+{
+    return m_Ring.isNull() ? m_Dropped : m_Ring->dropped();
+}
+
+QByteArray SERRecorder::header(const Format &format, int frameCount, const QDateTime &start,
+                               const QString &observer, const QString &instrument, const QString &telescope)
+{
+    QByteArray head;
+    QDataStream stream(&head, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    stream.writeRawData("LUCAM-RECORDER", 14);
+    // LuID
+    stream << qint32(0);
+    stream << qint32(format.colorID);
+    // 16 bit samples are written in the byte order of the stream, little endian. Readers take 0 as little endian,
+    // contrary to the specification.
+    stream << qint32(0);
+    stream << qint32(format.width) << qint32(format.height) << qint32(format.bitDepth) << qint32(frameCount);
+    writeText(stream, observer);
+    writeText(stream, instrument);
+    writeText(stream, telescope);
+    stream << toSERTime(start) << toSERTime(start.toUTC());
+
+    return head;
+}
+
+qint64 SERRecorder::toSERTime(const QDateTime &dateTime)
+{
+    qint64 msecs = dateTime.toMSecsSinceEpoch() + qint64(dateTime.offsetFromUtc()) * 1000;
+    return UnixEpochTicks + msecs * 10000;
+}
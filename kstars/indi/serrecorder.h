@@ -0,0 +1,170 @@
+/*  SER Video Recorder
+    Copyright (C) 2017 KStars Team <kstars-devel@kde.org>
+
+    This application is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either
+    version 2 of the License, or (at your option) any later version.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QMutex>
+#include <QScopedPointer>
+#include <QString>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <vector>
+
+/**
+ * @class FrameRing
+ * @short Fixed number of frame slots handed over from one producer thread to one consumer thread
+ *
+ * The slots are allocated once. The producer copies a frame straight into a free slot and publishes it, the
+ * consumer reads it in place and releases the slot, so a frame is copied only once on its way to the file. When
+ * all slots are taken the frame is dropped and counted rather than waited for.
+ */
+class FrameRing
+{
+  public:
+    FrameRing(int slots, int frameSize);
+
+    /** @return a free slot of frameSize() bytes, or nullptr if the consumer is behind and the frame is dropped */
+    uchar *acquire();
+
+    /** @short Publish the slot returned by the last acquire() */
+    void commit(qint64 timestamp);
+
+    /**
+     * @short Wait for the oldest published frame
+     * @param timestamp set to the timestamp the frame was committed with
+     * @return the frame, valid until release(), or nullptr once the ring is closed and empty
+     */
+    const uchar *next(qint64 *timestamp);
+
+    /** @short Give the frame returned by next() back to the producer */
+    void release();
+
+    /** @short Wake the consumer up once the published frames are read */
+    void close();
+
+    int slots() const { return m_Timestamps.size(); }
+    int frameSize() const { return m_FrameSize; }
+    int dropped() const;
+
+  private:
+    std::vector<uchar> m_Buffer;
+    QVector<qint64> m_Timestamps;
+    int m_FrameSize { 0 };
+    // Slot written by the producer, and oldest published slot
+    int m_Head { 0 };
+    int m_Tail { 0 };
+    int m_Count { 0 };
+    int m_Dropped { 0 };
+    bool m_Closed { false };
+    mutable QMutex m_Mutex;
+    QWaitCondition m_Published;
+};
+
+/**
+ * @class SERRecorder
+ * @short Records raw stream frames to a SER file on this computer
+ *
+ * Frames are queued by addFrame() on the thread receiving the stream and written by a thread of the recorder.
+ * The frame count of the header is set and the trailer of UTC timestamps appended when the recording stops.
+ *
+ * See http://www.grischa-hahn.homepage.t-online.de/astro/ser/ for the format.
+ */
+class SERRecorder
+{
+  public:
+    /** Values of the ColorID field */
+    typedef enum {
+        SER_MONO       = 0,
+        SER_BAYER_RGGB = 8,
+        SER_BAYER_GRBG = 9,
+        SER_BAYER_GBRG = 10,
+        SER_BAYER_BGGR = 11,
+        SER_RGB        = 100,
+        SER_BGR        = 101
+    } ColorID;
+
+    struct Format
+    {
+        int width { 0 };
+        int height { 0 };
+        ColorID colorID { SER_MONO };
+        /** Bits per sample, 8 or 16 */
+        int bitDepth { 8 };
+
+        int bytesPerFrame() const
+        {
+            return width * height * (colorID >= SER_RGB ? 3 : 1) * (bitDepth > 8 ? 2 : 1);
+        }
+    };
+
+    /** Size of the SER header, in bytes */
+    static const int HeaderSize = 178;
+
+    /** Memory of the frame ring, in bytes */
+    static const int RingMemory = 256 * 1024 * 1024;
+
+    SERRecorder();
+    ~SERRecorder();
+
+    /**
+     * @short Create the file and start the writer
+     * @param filename path of the SER file
+     * @param format geometry and sample format of every frame
+     * @param observer observer, instrument and telescope stored in the header, truncated to 40 characters
+     * @return false if the file cannot be created
+     */
+    bool start(const QString &filename, const Format &format, const QString &observer = QString(),
+               const QString &instrument = QString(), const QString &telescope = QString());
+
+    /**
+     * @short Queue a frame, copying it once
+     * @return false if the frame does not have the size of the format, or if it was dropped
+     */
+    bool addFrame(const void *data, int size);
+
+    /** @short Write the queued frames, finish the file and close it */
+    void stop();
+
+    bool isRecording() const { return !m_Ring.isNull(); }
+    const Format &format() const { return m_Format; }
+    QString filename() const { return m_File.fileName(); }
+
+    /** @return number of frames queued since start() */
+    int framesQueued() const { return m_Queued; }
+    /** @return number of frames dropped since start() because the writer was behind */
+    int framesDropped() const;
+
+    /** @return the SER header of a recording of frameCount frames started at start */
+    static QByteArray header(const Format &format, int frameCount, const QDateTime &start,
+                             const QString &observer = QString(), const QString &instrument = QString(),
+                             const QString &telescope = QString());
+
+    /** @return time in SER units: ticks of 100 ns since 0001-01-01 00:00, in the time zone of dateTime */
+    static qint64 toSERTime(const QDateTime &dateTime);
+
+  private:
+    class Writer;
+
+    /** @short Body of the writer thread */
+    void write();
+
+    Format m_Format;
+    QFile m_File;
+    QScopedPointer<FrameRing> m_Ring;
+    QScopedPointer<Writer> m_Writer;
+    // UTC timestamps of the frames written, for the trailer
+    QVector<qint64> m_Timestamps;
+    int m_Queued { 0 };
+    int m_Dropped { 0 };
+    bool m_WriteError { false };
+};
@@ -12,12 +12,14 @@
 #include <KMessageBox>
 #include <KLocalizedString>
 
+#include <QDateTime>
 #include <QLocale>
 #include <QDebug>
 #include <QPushButton>
 #include <QFileDialog>
 #include <QRgb>
 #include <QSocketNotifier>
+#include <QTimer>
 #include <QImage>
 #include <QPainter>
 #include <QDir>
@@ -141,6 +143,9 @@ void StreamWG::enableStream(bool enable)
     else
     {
         processStream = false;
+        // No more frames will come to the local recording
+        if (isRecording && recordLocally)
+            toggleRecord();
         instFPS->setText("--");
         avgFPS->setText("--");
         hide();
@@ -168,7 +173,7 @@ void StreamWG::setSize(int wd, int ht)
 
 void StreamWG::updateRecordStatus(bool enabled)
 {
-    if ((enabled && isRecording) || (!enabled && !isRecording))
+    if ((enabled && isRecording) || (!enabled && !isRecording) || recordLocally)
         return;
 
     isRecording = enabled;
@@ -193,7 +198,10 @@ void StreamWG::toggleRecord()
         isRecording = false;
         recordB->setToolTip(i18n("Start recording"));
 
-        currentCCD->stopRecording();
+        if (recordLocally)
+            stopLocalRecording();
+        else
+            currentCCD->stopRecording();
     }
     else
     {
@@ -201,7 +209,14 @@ void StreamWG::toggleRecord()
         // Save config in INDI so the filename and directory templates are reloaded next time
         currentCCD->setConfig(SAVE_CONFIG);
 
-        if (options->recordUntilStoppedR->isChecked())
+        recordLocally = options->recordLocallyC->isChecked();
+
+        // The file is created when the next frame tells its format
+        if (recordLocally)
+        {
+            isRecording = processStream;
+        }
+        else if (options->recordUntilStoppedR->isChecked())
         {
             isRecording = currentCCD->startRecording();
         }
@@ -224,10 +239,115 @@ void StreamWG::toggleRecord()
 
 void StreamWG::newFrame(IBLOB *bp)
 {
+    if (isRecording && recordLocally)
+    {
+        QString error;
+        if (!recorder.isRecording() && !startLocalRecording(bp, error))
+        {
+            toggleRecord();
+            // Shown once this frame is handled, frames keep arriving while the message is open
+            QTimer::singleShot(0, this, [this, error]() { KMessageBox::sorry(this, error, i18n("Local Recording")); });
+        }
+        else
+        {
+            recorder.addFrame(bp->blob, bp->size);
+
+            if ((options->recordDurationR->isChecked() &&
+                 recordTimer.elapsed() >= options->durationSpin->value() * 1000) ||
+                (options->recordFramesR->isChecked() && recorder.framesQueued() >= options->framesSpin->value()))
+                toggleRecord();
+        }
+    }
+
     bool rc = videoFrame->newFrame(bp);
 
-    if (rc == false)
-        qWarning() << "Failed to load video frame.";
+    if (rc == false && !frameFailed)
+        qWarning() << "Failed to load video frame of" << bp->size << "bytes, format" << bp->format;
+    frameFailed = !rc;
+}
+
+QString StreamWG::localRecordPath() const
+{
+    QDateTime now = QDateTime::currentDateTime();
+    QString filename = options->recordFilenameEdit->text(), directory = options->recordDirectoryEdit->text();
+
+    for (QString *text : { &filename, &directory })
+    {
+        text->replace("_D_", now.toString("yyyy-MM-dd"));
+        text->replace("_H_", now.toString("hh-mm-ss"));
+        text->replace("_T_", now.toString("yyyy-MM-ddThh-mm-ss"));
+        // The filter is not known here
+        text->replace("_F_", "");
+    }
+
+    if (!filename.endsWith(".ser", Qt::CaseInsensitive))
+        filename += ".ser";
+
+    QDir().mkpath(directory);
+    return QDir(directory).filePath(filename);
+}
+
+bool StreamWG::startLocalRecording(IBLOB *bp, QString &error)
+{
+    QString format(bp->format);
+    format.remove(".");
+    format.remove("stream_");
+
+    if (QImageReader::supportedImageFormats().contains(format.toLatin1()) || streamWidth <= 0 || streamHeight <= 0)
+    {
+        error = i18n("Local recording needs a raw stream, the stream format is %1.", format);
+        return false;
+    }
+
+    SERRecorder::Format serFormat;
+    serFormat.width  = streamWidth;
+    serFormat.height = streamHeight;
+
+    // 8 or 16 bit samples, one or three per pixel
+    switch (bp->size / (streamWidth * streamHeight))
+    {
+        case 1:
+            break;
+        case 2:
+            serFormat.bitDepth = 16;
+            break;
+        case 3:
+            serFormat.colorID = SERRecorder::SER_RGB;
+            break;
+        case 6:
+            serFormat.colorID  = SERRecorder::SER_RGB;
+            serFormat.bitDepth = 16;
+            break;
+        default:
+            break;
+    }
+
+    if (bp->size != serFormat.bytesPerFrame())
+    {
+        error = i18n("Local recording does not support frames of %1 bytes.", bp->size);
+        return false;
+    }
+
+    const QString path = localRecordPath();
+    if (!recorder.start(path, serFormat, QString(), currentCCD->getDeviceName()))
+    {
+        error = i18n("Could not create the recording file %1.", path);
+        return false;
+    }
+
+    recordTimer.start();
+    return true;
+}
+
+void StreamWG::stopLocalRecording()
+{
+    if (!recorder.isRecording())
+        return;
+
+    recorder.stop();
+
+    qDebug() << "Recorded" << recorder.framesQueued() << "frames to" << recorder.filename() << ","
+             << recorder.framesDropped() << "dropped.";
 }
 
 void StreamWG::resetFrame()
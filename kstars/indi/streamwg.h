@@ -18,6 +18,7 @@
 #include <QCloseEvent>
 #include <QVector>
 #include <QColor>
+#include <QElapsedTimer>
 #include <QIcon>
 #include <QImage>
 
@@ -27,6 +28,7 @@
 #include "ui_recordingoptions.h"
 
 #include "indi/indiccd.h"
+#include "indi/serrecorder.h"
 
 class RecordOptions : public QDialog, public Ui::recordingOptions
 {
@@ -80,6 +82,15 @@ class StreamWG : public QDialog, public Ui::streamForm
     void hidden();
 
   private:
+    /** @return path of the SER file recorded on this computer, with the patterns of the options replaced */
+    QString localRecordPath() const;
+    /**
+     * @short Start the local recording with the format of the first frame
+     * @param error set to the reason the recording could not start
+     */
+    bool startLocalRecording(IBLOB *bp, QString &error);
+    void stopLocalRecording();
+
     bool processStream;
     int streamWidth, streamHeight;
     bool colorFrame, isRecording;
@@ -87,6 +98,14 @@ class StreamWG : public QDialog, public Ui::streamForm
     ISD::CCD *currentCCD;
 
     RecordOptions *options;
+
+    // Recording of the received stream on this computer, started by the first frame after the record button
+    SERRecorder recorder;
+    bool recordLocally { false };
+    QElapsedTimer recordTimer;
+
+    // The last frame could not be shown, only the first of a run of such frames is reported
+    bool frameFailed { false };
 };
 
 #endif
@@ -8,13 +8,19 @@
 
 */
 
+#include <QDebug>
+#include <QGuiApplication>
 #include <QImageReader>
 #include <QPainter>
 #include <QRubberBand>
+#include <QScreen>
+#include <QTimer>
 
 #include "videowg.h"
 #include "Options.h"
 
+#include <cstring>
+
 VideoWG::VideoWG(QWidget *parent) : QLabel(parent)
 {
     streamImage = new QImage();
@@ -23,6 +29,16 @@ VideoWG::VideoWG(QWidget *parent) : QLabel(parent)
 
     for (int i = 0; i < 256; i++)
         grayTable[i] = qRgb(i, i, i);
+
+    // Frames are shown no faster than the screen refreshes
+    double refreshRate = 60;
+    if (QGuiApplication::primaryScreen() != nullptr)
+        refreshRate = qBound(1.0, QGuiApplication::primaryScreen()->refreshRate(), 60.0);
+    displayInterval = 1000 / refreshRate;
+
+    displayTimer = new QTimer(this);
+    displayTimer->setSingleShot(true);
+    connect(displayTimer, SIGNAL(timeout()), this, SLOT(displayFrame()));
 }
 
 VideoWG::~VideoWG()
@@ -38,31 +54,90 @@ bool VideoWG::newFrame(IBLOB *bp)
     QString format(bp->format);
     format.remove(".");
     format.remove("stream_");
-    bool rc = false;
+
+    const uint32_t size = static_cast<uint32_t>(bp->size);
 
     if (QImageReader::supportedImageFormats().contains(format.toLatin1()))
-        rc = streamImage->loadFromData(static_cast<uchar *>(bp->blob), bp->size);
-    else if (static_cast<uint32_t>(bp->size) > totalBaseCount)
+        pendingFormat = format.toLatin1();
+    else if (totalBaseCount > 0 && size % totalBaseCount == 0 && isRawPixelSize(size / totalBaseCount))
+        pendingFormat.clear();
+    else
+        return false;
+
+    // The buffer keeps its allocation from one frame to the next
+    pendingFrame.resize(bp->size);
+    memcpy(pendingFrame.data(), bp->blob, bp->size);
+
+    if (!displayTimer->isActive())
     {
-        delete (streamImage);
-        streamImage = new QImage(static_cast<uchar *>(bp->blob), streamW, streamH, QImage::Format_RGB888);
-        rc          = !streamImage->isNull();
+        qint64 elapsed = lastDisplay.isValid() ? lastDisplay.elapsed() : displayInterval;
+        displayTimer->start(qMax<qint64>(0, displayInterval - elapsed));
     }
-    else if (static_cast<uint32_t>(bp->size) == totalBaseCount)
+
+    return true;
+}
+
+void VideoWG::displayFrame()
+{
+    bool rc = false;
+
+    if (!pendingFormat.isEmpty())
+        rc = streamImage->loadFromData(pendingFrame, pendingFormat.constData());
+    else
     {
-        delete (streamImage);
-        streamImage = new QImage(static_cast<uchar *>(bp->blob), streamW, streamH, QImage::Format_Indexed8);
-        streamImage->setColorTable(grayTable);
+        // 8 or 16 bit samples, one or three per pixel. 16 bit samples are shown by their high byte.
+        const uint32_t frameSize         = static_cast<uint32_t>(pendingFrame.size());
+        const int pixelSize              = frameSize / qMax<uint32_t>(totalBaseCount, 1);
+        const bool color                 = pixelSize == 3 || pixelSize == 6;
+        const bool wide                  = pixelSize == 2 || pixelSize == 6;
+        const QImage::Format imageFormat = color ? QImage::Format_RGB888 : QImage::Format_Indexed8;
+        const int lineSize               = streamW * pixelSize;
+
+        // The stream size changed after the frame was received
+        if (!isRawPixelSize(pixelSize) || pendingFrame.size() < lineSize * streamH)
+            return;
+
+        // Allocated again only when the stream size or format changes
+        if (streamImage->width() != streamW || streamImage->height() != streamH ||
+            streamImage->format() != imageFormat)
+        {
+            *streamImage = QImage(streamW, streamH, imageFormat);
+            if (!color)
+                streamImage->setColorTable(grayTable);
+        }
+
+        for (int j = 0; j < streamH; j++)
+        {
+            const char *line = pendingFrame.constData() + j * lineSize;
+            if (wide)
+            {
+                const quint16 *samples = reinterpret_cast<const quint16 *>(line);
+                uchar *pixels          = streamImage->scanLine(j);
+                for (int k = 0; k < lineSize / 2; k++)
+                    pixels[k] = samples[k] >> 8;
+            }
+            else
+                memcpy(streamImage->scanLine(j), line, lineSize);
+        }
+
         rc = !streamImage->isNull();
     }
 
-    if (rc)
+    lastDisplay.start();
+
+    if (rc == false)
     {
-        kPix = QPixmap::fromImage(streamImage->scaled(size(), Qt::KeepAspectRatio));
-        setPixmap(kPix);
+        qWarning() << "Failed to decode video frame.";
+        return;
     }
 
-    return rc;
+    kPix = QPixmap::fromImage(streamImage->scaled(size(), Qt::KeepAspectRatio));
+    setPixmap(kPix);
+}
+
+bool VideoWG::isRawPixelSize(uint32_t pixelSize)
+{
+    return pixelSize == 1 || pixelSize == 2 || pixelSize == 3 || pixelSize == 6;
 }
 
 bool VideoWG::save(const QString &filename, const char *format)
@@ -11,6 +11,8 @@
 #ifndef VIDEOWG_H_
 #define VIDEOWG_H_
 
+#include <QByteArray>
+#include <QElapsedTimer>
 #include <QPixmap>
 #include <QPaintEvent>
 #include <QVector>
@@ -21,7 +23,15 @@
 #include <indidevapi.h>
 
 class QRubberBand;
-
+class QTimer;
+
+/**
+ * @class VideoWG
+ * @short Shows the frames of a video stream
+ *
+ * Frames may arrive much faster than the screen refreshes. Each one is copied to a pending buffer, and only the
+ * latest is decoded and scaled, at most once per screen refresh.
+ */
 class VideoWG : public QLabel
 {
     Q_OBJECT
@@ -30,6 +40,10 @@ class VideoWG : public QLabel
     VideoWG(QWidget *parent = 0);
     ~VideoWG();
 
+    /**
+     * @return false if the frame is neither an image format nor a raw frame of the stream size, with 8 or 16 bit
+     * samples, mono or RGB
+     */
     bool newFrame(IBLOB *bp);
 
     bool save(const QString &filename, const char *format);
@@ -45,7 +59,13 @@ class VideoWG : public QLabel
   signals:
     void newSelection(QRect);
 
+  private slots:
+    void displayFrame();
+
   private:
+    /** @return true if raw frames of pixelSize bytes per pixel are shown */
+    static bool isRawPixelSize(uint32_t pixelSize);
+
     uint16_t streamW        = -1;
     uint16_t streamH        = -1;
     uint32_t totalBaseCount = 0;
@@ -53,6 +73,14 @@ class VideoWG : public QLabel
     QImage *streamImage;
     QPixmap kPix;
 
+    // Latest frame received, and its image format, empty for a raw frame
+    QByteArray pendingFrame;
+    QByteArray pendingFormat;
+    QTimer *displayTimer = nullptr;
+    QElapsedTimer lastDisplay;
+    // Minimum time between two frames shown, in milliseconds
+    int displayInterval = 0;
+
     QRubberBand *rubberBand = nullptr;
     QPoint origin;
 };
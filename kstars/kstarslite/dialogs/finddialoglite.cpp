@@ -26,6 +26,7 @@
 #include "deepskyobject.h"
 
 #include "solarsystemcomposite.h"
+#include "asteroidscomponent.h"
 //Resolver
 #include "tools/nameresolver.h"
 #include "skycomponents/syncedcatalogcomponent.h"
@@ -83,6 +84,7 @@ void FindDialogLite::filterByType(uint typeIndex)
             {
                 allObjects.append(data->skyComposite()->objectLists(SkyObject::TYPE(type)));
             }
+            allObjects.append(data->skyComposite()->solarSystemComposite()->asteroidsComponent()->uncreatedList());
             fModel->setSkyObjectsList(allObjects);
             break;
         }
@@ -100,6 +102,7 @@ void FindDialogLite::filterByType(uint typeIndex)
             ssObjects.append(data->skyComposite()->objectLists(SkyObject::PLANET));
             ssObjects.append(data->skyComposite()->objectLists(SkyObject::COMET));
             ssObjects.append(data->skyComposite()->objectLists(SkyObject::ASTEROID));
+            ssObjects.append(data->skyComposite()->solarSystemComposite()->asteroidsComponent()->uncreatedList());
             ssObjects.append(data->skyComposite()->objectLists(SkyObject::MOON));
 
             fModel->setSkyObjectsList(ssObjects);
@@ -124,8 +127,13 @@ void FindDialogLite::filterByType(uint typeIndex)
             fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::COMET));
             break;
         case 9: //Asteroids
-            fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::ASTEROID));
+        {
+            QVector<QPair<QString, const SkyObject *>> asteroids;
+            asteroids.append(data->skyComposite()->objectLists(SkyObject::ASTEROID));
+            asteroids.append(data->skyComposite()->solarSystemComposite()->asteroidsComponent()->uncreatedList());
+            fModel->setSkyObjectsList(asteroids);
             break;
+        }
         case 10: //Constellations
             fModel->setSkyObjectsList(data->skyComposite()->objectLists(SkyObject::CONSTELLATION));
             break;
@@ -151,6 +159,11 @@ void FindDialogLite::selectObject(int index)
 {
     QVariant sObj     = m_sortModel->data(m_sortModel->index(index, 0), SkyObjectListModel::SkyObjectRole);
     SkyObject *skyObj = (SkyObject *)sObj.value<void *>();
+
+    // A faint asteroid listed by name is created now
+    if (!skyObj)
+        skyObj = KStarsData::Instance()->skyComposite()->findByName(
+            m_sortModel->data(m_sortModel->index(index, 0)).toString());
     SkyMapLite::Instance()->slotSelectObject(skyObj);
 }
 
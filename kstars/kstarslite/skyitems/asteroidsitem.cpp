@@ -57,6 +57,10 @@ void AsteroidsItem::recreateList()
 
 void AsteroidsItem::update()
 {
+    // Faint asteroids are created on demand, eg. when searched for by name
+    if (childCount() != m_asteroidsList.size())
+        recreateList();
+
     QSGNode *n = firstChild();
     while (n != 0)
     {
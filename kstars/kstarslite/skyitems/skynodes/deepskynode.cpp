@@ -105,6 +105,7 @@ void DeepSkyNode::update(bool drawImage, bool drawLabel, QPointF pos)
 
     if (drawImage && Options::zoomFactor() > 5. * MINZOOM)
     {
+        // The image is empty while it is decoded, SkyMapLite updates the nodes again once it is
         if (!(m_dso->image().isNull()))
         {
             if (!m_objImg)
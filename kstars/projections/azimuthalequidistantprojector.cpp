@@ -23,6 +23,20 @@
 
 #include "azimuthalequidistantprojector.h"
 
+namespace
+{
+// projectionK(), as a functor that projectBatch() can inline
+struct AzimuthalEquidistantK
+{
+    double operator()(double x) const
+    {
+        double crad = acos(x);
+        // This handles the 0/0 case. The limit of x / sin(x) is 1 as x -> 0.
+        return ((crad != 0) ? crad / sin(crad) : 1);
+    }
+};
+}
+
 AzimuthalEquidistantProjector::AzimuthalEquidistantProjector(const ViewParams &p) : Projector(p)
 {
     updateClipPoly();
@@ -40,11 +54,16 @@ double AzimuthalEquidistantProjector::radius() const
 
 double AzimuthalEquidistantProjector::projectionK(double x) const
 {
-    double crad = acos(x);
-    return ((crad != 0) ? crad / sin(crad) : 1); // This handles the 0/0 case. The limit of x / sin(x) is 1 as x -> 0.
+    return AzimuthalEquidistantK()(x);
 }
 
 double AzimuthalEquidistantProjector::projectionL(double x) const
 {
     return x;
 }
+
+void AzimuthalEquidistantProjector::toScreenBatch(const double *lon, const double *lat, int n, Vector2f *screen,
+                                                  bool *visible, bool oRefract) const
+{
+    projectBatch(lon, lat, n, screen, visible, oRefract, AzimuthalEquidistantK());
+}
@@ -36,6 +36,8 @@ class AzimuthalEquidistantProjector : public Projector
     double radius() const Q_DECL_OVERRIDE;
     double projectionK(double x) const Q_DECL_OVERRIDE;
     double projectionL(double x) const Q_DECL_OVERRIDE;
+    void toScreenBatch(const double *lon, const double *lat, int n, Vector2f *screen, bool *visible,
+                       bool oRefract = true) const Q_DECL_OVERRIDE;
 };
 
 #endif // AZIMUTHALEQUIDISTANTPROJECTOR_H
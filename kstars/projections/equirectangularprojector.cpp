@@ -71,6 +71,28 @@ Vector2f EquirectangularProjector::toScreenVec(const SkyPoint *o, bool oRefract,
     return p;
 }
 
+void EquirectangularProjector::toScreenBatch(const double *lon, const double *lat, int n, Vector2f *screen,
+                                             bool *visible, bool oRefract) const
+{
+    // Same as toScreenVec(), which is linear in the coordinates
+    const bool refract = oRefract && m_vp.useRefraction && m_vp.useAltAz;
+    const double lon0  = m_vp.useAltAz ? m_vp.focus->az().radians() : m_vp.focus->ra().radians();
+    const double lat0  = m_vp.useAltAz ? m_vp.focus->alt().radians() : m_vp.focus->dec().radians();
+
+    for (int i = 0; i < n; ++i)
+    {
+        double Y = lat[i];
+        if (refract)
+            Y = SkyPoint::refract(Y / dms::DegToRad) * dms::DegToRad; //account for atmospheric refraction
+        double dX = m_vp.useAltAz ? lon0 - lon[i] : lon[i] - lon0;
+        dX        = KSUtils::reduceAngle(dX, -dms::PI, dms::PI);
+
+        screen[i] = Vector2f(0.5 * m_vp.width - m_vp.zoomFactor * dX, 0.5 * m_vp.height - m_vp.zoomFactor * (Y - lat0));
+        if (visible)
+            visible[i] = (screen[i][0] > 0 && screen[i][0] < m_vp.width);
+    }
+}
+
 SkyPoint EquirectangularProjector::fromScreen(const QPointF &p, dms *LST, const dms *lat) const
 {
     SkyPoint result;
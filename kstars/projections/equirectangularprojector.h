@@ -36,6 +36,8 @@ class EquirectangularProjector : public Projector
     double radius() const Q_DECL_OVERRIDE;
     bool unusablePoint(const QPointF &p) const Q_DECL_OVERRIDE;
     Vector2f toScreenVec(const SkyPoint *o, bool oRefract = true, bool *onVisibleHemisphere = 0) const Q_DECL_OVERRIDE;
+    void toScreenBatch(const double *lon, const double *lat, int n, Vector2f *screen, bool *visible,
+                       bool oRefract = true) const Q_DECL_OVERRIDE;
     SkyPoint fromScreen(const QPointF &p, dms *LST, const dms *lat) const Q_DECL_OVERRIDE;
     QVector<Vector2f> groundPoly(SkyPoint *labelpoint = 0, bool *drawLabel = 0) const Q_DECL_OVERRIDE;
     void updateClipPoly() Q_DECL_OVERRIDE;
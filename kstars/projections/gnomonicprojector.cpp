@@ -19,6 +19,18 @@
 
 #include "gnomonicprojector.h"
 
+namespace
+{
+// projectionK(), as a functor that projectBatch() can inline
+struct GnomonicK
+{
+    double operator()(double x) const
+    {
+        return 1.0 / x;
+    }
+};
+}
+
 GnomonicProjector::GnomonicProjector(const ViewParams &p) : Projector(p)
 {
     updateClipPoly();
@@ -36,7 +48,7 @@ double GnomonicProjector::radius() const
 
 double GnomonicProjector::projectionK(double x) const
 {
-    return 1.0 / x;
+    return GnomonicK()(x);
 }
 
 double GnomonicProjector::projectionL(double x) const
@@ -44,6 +56,12 @@ double GnomonicProjector::projectionL(double x) const
     return atan(x);
 }
 
+void GnomonicProjector::toScreenBatch(const double *lon, const double *lat, int n, Vector2f *screen, bool *visible,
+                                      bool oRefract) const
+{
+    projectBatch(lon, lat, n, screen, visible, oRefract, GnomonicK());
+}
+
 double GnomonicProjector::cosMaxFieldAngle() const
 {
     //Don't let things approach infty.
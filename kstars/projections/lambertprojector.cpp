@@ -19,6 +19,18 @@
 
 #include "lambertprojector.h"
 
+namespace
+{
+// projectionK(), as a functor that projectBatch() can inline
+struct LambertK
+{
+    double operator()(double x) const
+    {
+        return sqrt(2.0 / (1.0 + x));
+    }
+};
+}
+
 LambertProjector::LambertProjector(const ViewParams &p) : Projector(p)
 {
     updateClipPoly();
@@ -36,10 +48,16 @@ double LambertProjector::radius() const
 
 double LambertProjector::projectionK(double x) const
 {
-    return sqrt(2.0 / (1.0 + x));
+    return LambertK()(x);
 }
 
 double LambertProjector::projectionL(double x) const
 {
     return 2.0 * asin(0.5 * x);
 }
+
+void LambertProjector::toScreenBatch(const double *lon, const double *lat, int n, Vector2f *screen, bool *visible,
+                                     bool oRefract) const
+{
+    projectBatch(lon, lat, n, screen, visible, oRefract, LambertK());
+}
@@ -19,6 +19,15 @@
 
 #include "orthographicprojector.h"
 
+namespace
+{
+// projectionK(), as a functor that projectBatch() can inline
+struct OrthographicK
+{
+    double operator()(double) const { return 1.0; }
+};
+}
+
 OrthographicProjector::OrthographicProjector(const ViewParams &p) : Projector(p)
 {
     updateClipPoly();
@@ -36,11 +45,16 @@ double OrthographicProjector::radius() const
 
 double OrthographicProjector::projectionK(double x) const
 {
-    Q_UNUSED(x);
-    return 1.0;
+    return OrthographicK()(x);
 }
 
 double OrthographicProjector::projectionL(double x) const
 {
     return asin(x);
 }
+
+void OrthographicProjector::toScreenBatch(const double *lon, const double *lat, int n, Vector2f *screen, bool *visible,
+                                          bool oRefract) const
+{
+    projectBatch(lon, lat, n, screen, visible, oRefract, OrthographicK());
+}
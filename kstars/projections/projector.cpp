@@ -109,6 +109,31 @@ QPointF Projector::toScreen(const SkyPoint *o, bool oRefract, bool *onVisibleHem
     return KSUtils::vecToPoint(toScreenVec(o, oRefract, onVisibleHemisphere));
 }
 
+void Projector::toScreenBatch(const double *lon, const double *lat, int n, Vector2f *screen, bool *visible,
+                              bool oRefract) const
+{
+    // Generic version for projections that do not provide their own loop
+    projectBatch(lon, lat, n, screen, visible, oRefract, [this](double c) { return projectionK(c); });
+}
+
+void Projector::pointsToScreen(SkyPoint *const *points, int n, Vector2f *screen, bool *visible, bool oRefract) const
+{
+    const int chunkSize = 64;
+    double lon[chunkSize], lat[chunkSize];
+
+    for (int start = 0; start < n; start += chunkSize)
+    {
+        const int count = qMin(chunkSize, n - start);
+        for (int i = 0; i < count; ++i)
+        {
+            const SkyPoint *p = points[start + i];
+            lon[i]            = m_vp.useAltAz ? p->az().radians() : p->ra().radians();
+            lat[i]            = m_vp.useAltAz ? p->alt().radians() : p->dec().radians();
+        }
+        toScreenBatch(lon, lat, count, screen + start, visible ? visible + start : nullptr, oRefract);
+    }
+}
+
 bool Projector::onScreen(const QPointF &p) const
 {
     return (0 <= p.x() && p.x() <= m_vp.width && 0 <= p.y() && p.y() <= m_vp.height);
@@ -40,6 +40,7 @@
 
 #include <QPointF>
 
+#include <algorithm>
 #include <cstddef>
 #include <cmath>
 
@@ -79,6 +80,9 @@ class Projector
     /** Update cached values for projector */
     void setViewParams(const ViewParams &p);
 
+    /** @return the ViewParams this projector was set up with */
+    inline const ViewParams &viewParams() const { return m_vp; }
+
     enum Projection
     {
         Lambert,
@@ -138,6 +142,30 @@ class Projector
      */
     QPointF toScreen(const SkyPoint *o, bool oRefract = true, bool *onVisibleHemisphere = 0) const;
 
+    /**
+     * @short Batch version of toScreenVec() for packed coordinates
+     *
+     * Projects @p n points given by their horizontal coordinates if the projector uses Alt/Az, and by
+     * their equatorial coordinates otherwise. Each projection reimplements this with its own inlined
+     * inner loop (see projectBatch()), so there is no virtual call and no SkyPoint access per point.
+     *
+     * @param lon azimuths or right ascensions, in radians
+     * @param lat unrefracted altitudes or declinations, in radians
+     * @param n number of points
+     * @param screen output screen pixel coordinates, @p n entries
+     * @param visible output flags telling whether each point is on the visible part of the
+     *   Celestial Sphere, @p n entries. May be null.
+     * @param oRefract true = use Options::useRefraction() value, false = do not use refraction.
+     */
+    virtual void toScreenBatch(const double *lon, const double *lat, int n, Vector2f *screen, bool *visible,
+                               bool oRefract = true) const;
+
+    /**
+     * @short Project an array of SkyPoints with toScreenBatch()
+     * @see toScreenBatch()
+     */
+    void pointsToScreen(SkyPoint *const *points, int n, Vector2f *screen, bool *visible, bool oRefract = true) const;
+
     /**
      * @short Determine RA, Dec coordinates of the pixel at (dx, dy), which are the
      * screen pixel coordinate offsets from the center of the Sky pixmap.
@@ -276,6 +304,15 @@ class Projector
      */
     virtual double cosMaxFieldAngle() const { return 0; }
 
+    /**
+     * The shared inner loop of toScreenBatch(). It does the same computation as toScreenVec() on
+     * chunks of points, with @p k standing in for projectionK().
+     * @param k functor returning projectionK(c) for the cosine c of the angular distance from the focus
+     */
+    template <typename ProjectionK>
+    void projectBatch(const double *lon, const double *lat, int n, Vector2f *screen, bool *visible, bool oRefract,
+                      ProjectionK k) const;
+
     /**
      * Helper function for drawing ground.
      * @return the point with Alt = 0, az = @p az
@@ -294,3 +331,73 @@ class Projector
     double m_xrange { 0 };
     bool m_isPoleVisible { false };
 };
+
+template <typename ProjectionK>
+void Projector::projectBatch(const double *lon, const double *lat, int n, Vector2f *screen, bool *visible,
+                             bool oRefract, ProjectionK k) const
+{
+    // Chunks live on the stack, so that the loop never allocates
+    const int chunkSize = 64;
+    typedef Array<double, Dynamic, 1, ColMajor, chunkSize, 1> Chunk;
+
+    const bool refract  = oRefract && m_vp.useRefraction && m_vp.useAltAz;
+    const double lon0   = m_vp.useAltAz ? m_vp.focus->az().radians() : m_vp.focus->ra().radians();
+    const double cosMax = cosMaxFieldAngle();
+    const double origX  = m_vp.width / 2;
+    const double origY  = m_vp.height / 2;
+    const double zoom   = m_vp.zoomFactor;
+#ifdef KSTARS_LITE
+    double sinT = 0, cosT = 1;
+    double skyRotation = SkyMapLite::Instance()->getSkyRotation();
+    if (skyRotation != 0)
+        dms(skyRotation).SinCos(sinT, cosT);
+#endif
+
+    for (int start = 0; start < n; start += chunkSize)
+    {
+        const int count = std::min(chunkSize, n - start);
+        Map<const ArrayXd> inLon(lon + start, count), inLat(lat + start, count);
+
+        Chunk Y(count);
+        if (refract)
+        {
+            for (int i = 0; i < count; ++i)
+                Y[i] = SkyPoint::refract(inLat[i] / dms::DegToRad) * dms::DegToRad; //account for atmospheric refraction
+        }
+        else
+            Y = inLat;
+
+        // The azimuth increases in the opposite direction of the RA on screen
+        Chunk dX = m_vp.useAltAz ? Chunk(lon0 - inLon) : Chunk(inLon - lon0);
+
+        Chunk sinY = Y.sin(), cosY = Y.cos();
+        Chunk sindX = dX.sin(), cosdX = dX.cos();
+        Chunk c     = m_sinY0 * sinY + m_cosY0 * cosY * cosdX;
+        Chunk K     = c.unaryExpr(k);
+        Chunk x     = origX - zoom * K * cosY * sindX;
+        Chunk y     = origY - zoom * K * (m_cosY0 * sinY - m_sinY0 * cosY * cosdX);
+
+        for (int i = 0; i < count; ++i)
+        {
+            if (!(std::isfinite(Y[i]) && std::isfinite(dX[i])))
+            {
+                screen[start + i] = Vector2f(0, 0);
+                if (visible)
+                    visible[start + i] = false;
+                continue;
+            }
+            if (visible)
+                visible[start + i] = (c[i] > cosMax);
+#ifdef KSTARS_LITE
+            if (skyRotation != 0)
+            {
+                double newX       = origX + (x[i] - origX) * cosT - (y[i] - origY) * sinT;
+                double newY       = origY + (x[i] - origX) * sinT + (y[i] - origY) * cosT;
+                screen[start + i] = Vector2f(newX, newY);
+                continue;
+            }
+#endif
+            screen[start + i] = Vector2f(x[i], y[i]);
+        }
+    }
+}
@@ -19,6 +19,18 @@
 
 #include "stereographicprojector.h"
 
+namespace
+{
+// projectionK(), as a functor that projectBatch() can inline
+struct StereographicK
+{
+    double operator()(double x) const
+    {
+        return 2.0 / (1.0 + x);
+    }
+};
+}
+
 StereographicProjector::StereographicProjector(const ViewParams &p) : Projector(p)
 {
     updateClipPoly();
@@ -36,10 +48,16 @@ double StereographicProjector::radius() const
 
 double StereographicProjector::projectionK(double x) const
 {
-    return 2.0 / (1.0 + x);
+    return StereographicK()(x);
 }
 
 double StereographicProjector::projectionL(double x) const
 {
     return 2.0 * atan2(x, 2.0);
 }
+
+void StereographicProjector::toScreenBatch(const double *lon, const double *lat, int n, Vector2f *screen, bool *visible,
+                                           bool oRefract) const
+{
+    projectBatch(lon, lat, n, screen, visible, oRefract, StereographicK());
+}
@@ -15,7 +15,9 @@
  *                                                                         *
  ***************************************************************************/
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <QDebug>
 #include <QStandardPaths>
 #include <QHttpMultiPart>
@@ -29,6 +31,7 @@
 #include "projections/projector.h"
 #include "solarsystemcomposite.h"
 #include "skycomponent.h"
+#include "skyobjectindex.h"
 #include "skylabeler.h"
 #ifndef KSTARS_LITE
 #include "skymap.h"
@@ -43,7 +46,94 @@
 #include "auxiliary/kspaths.h"
 #include "auxiliary/ksnotification.h"
 
-AsteroidsComponent::AsteroidsComponent(SolarSystemComposite *parent) : SolarSystemListComponent(parent)
+namespace
+{
+// Fields of asteroids.dat, see loadData()
+enum Field
+{
+    FullName,
+    EpochMJD,
+    Perihelion,
+    SemiMajorAxis,
+    Eccentricity,
+    Inclination,
+    ArgPerihelion,
+    AscendingNode,
+    MeanAnomaly,
+    PerihelionTime,
+    OrbitID,
+    AbsoluteMagnitude,
+    Slope,
+    NEO,
+    CometM1,
+    CometM2,
+    Diameter,
+    Extent,
+    Albedo,
+    RotationPeriod,
+    Period,
+    EarthMOID,
+    OrbitClass
+};
+
+OrbitalElementStore::Sequence asteroidSequence()
+{
+    OrbitalElementStore::Sequence sequence;
+    sequence.append(qMakePair(QString("full name"), KSParser::D_QSTRING));
+    sequence.append(qMakePair(QString("epoch_mjd"), KSParser::D_INT));
+    sequence.append(qMakePair(QString("q"), KSParser::D_DOUBLE));
+    sequence.append(qMakePair(QString("a"), KSParser::D_DOUBLE));
+    sequence.append(qMakePair(QString("e"), KSParser::D_DOUBLE));
+    sequence.append(qMakePair(QString("i"), KSParser::D_DOUBLE));
+    sequence.append(qMakePair(QString("w"), KSParser::D_DOUBLE));
+    sequence.append(qMakePair(QString("om"), KSParser::D_DOUBLE));
+    sequence.append(qMakePair(QString("ma"), KSParser::D_DOUBLE));
+    sequence.append(qMakePair(QString("tp_calc"), KSParser::D_SKIP));
+    sequence.append(qMakePair(QString("orbit_id"), KSParser::D_QSTRING));
+    sequence.append(qMakePair(QString("H"), KSParser::D_DOUBLE));
+    sequence.append(qMakePair(QString("G"), KSParser::D_DOUBLE));
+    sequence.append(qMakePair(QString("neo"), KSParser::D_QSTRING));
+    sequence.append(qMakePair(QString("tp_calc"), KSParser::D_SKIP));
+    sequence.append(qMakePair(QString("M2"), KSParser::D_SKIP));
+    sequence.append(qMakePair(QString("diameter"), KSParser::D_FLOAT));
+    sequence.append(qMakePair(QString("extent"), KSParser::D_QSTRING));
+    sequence.append(qMakePair(QString("albedo"), KSParser::D_FLOAT));
+    sequence.append(qMakePair(QString("rot_period"), KSParser::D_FLOAT));
+    sequence.append(qMakePair(QString("per_y"), KSParser::D_FLOAT));
+    sequence.append(qMakePair(QString("moid"), KSParser::D_DOUBLE));
+    sequence.append(qMakePair(QString("class"), KSParser::D_QSTRING));
+    return sequence;
+}
+
+// Aphelion distance of the Earth, in AU
+const double EarthAphelion = 1.0167;
+
+// Name of an asteroid without its number, as the text after the first space of the full name
+QByteArray shortName(const QByteArray &fullName)
+{
+    QByteArray name = fullName.trimmed();
+    int space       = name.indexOf(' ');
+    return space < 0 ? QByteArray() : name.mid(space + 1);
+}
+
+// Name an asteroid is listed under, given the name of its row
+QString listedName(const QString &name)
+{
+    //JM temporary hack to avoid Europa,Io, and Asterope duplication
+    if (name == "Europa" || name == "Io" || name == "Asterope")
+        return name + i18n(" (Asteroid)");
+    return name;
+}
+
+// Order of names ignoring the case of ASCII letters
+bool nameLessThan(const QByteArray &n1, const QByteArray &n2)
+{
+    return qstricmp(n1.constData(), n2.constData()) < 0;
+}
+}
+
+AsteroidsComponent::AsteroidsComponent(SolarSystemComposite *parent)
+    : SolarSystemListComponent(parent), m_Elements(asteroidSequence())
 {
     loadData();
 }
@@ -85,16 +175,11 @@ bool AsteroidsComponent::selected()
  * @li 21 orbital period [float]
  * @li 22 earth minimum orbit intersection distance [double]
  * @li 23 orbit classification [string]
+ *
+ * The file is read through an OrbitalElementStore, from its binary cache when it is up to date.
  */
 void AsteroidsComponent::loadData()
 {
-    QString name, full_name, orbit_id, orbit_class, dimensions;
-    int mJD;
-    double q, a, e, dble_i, dble_w, dble_N, dble_M, H, G, earth_moid;
-    long double JD;
-    float diameter, albedo, rot_period, period;
-    bool neo;
-
     emitProgressText(i18n("Loading asteroids"));
 
     // Clear lists
@@ -103,104 +188,204 @@ void AsteroidsComponent::loadData()
 
     objectLists(SkyObject::ASTEROID).clear();
     objectNames(SkyObject::ASTEROID).clear();
+    objectIndex().remove(this);
 
-    QList<QPair<QString, KSParser::DataTypes>> sequence;
-    sequence.append(qMakePair(QString("full name"), KSParser::D_QSTRING));
-    sequence.append(qMakePair(QString("epoch_mjd"), KSParser::D_INT));
-    sequence.append(qMakePair(QString("q"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("a"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("e"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("i"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("w"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("om"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("ma"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("tp_calc"), KSParser::D_SKIP));
-    sequence.append(qMakePair(QString("orbit_id"), KSParser::D_QSTRING));
-    sequence.append(qMakePair(QString("H"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("G"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("neo"), KSParser::D_QSTRING));
-    sequence.append(qMakePair(QString("tp_calc"), KSParser::D_SKIP));
-    sequence.append(qMakePair(QString("M2"), KSParser::D_SKIP));
-    sequence.append(qMakePair(QString("diameter"), KSParser::D_FLOAT));
-    sequence.append(qMakePair(QString("extent"), KSParser::D_QSTRING));
-    sequence.append(qMakePair(QString("albedo"), KSParser::D_FLOAT));
-    sequence.append(qMakePair(QString("rot_period"), KSParser::D_FLOAT));
-    sequence.append(qMakePair(QString("per_y"), KSParser::D_FLOAT));
-    sequence.append(qMakePair(QString("moid"), KSParser::D_DOUBLE));
-    sequence.append(qMakePair(QString("class"), KSParser::D_QSTRING));
+    m_NameIndex.clear();
+    m_UncreatedList.clear();
 
-    //QString file_name = KSPaths::locate( QStandardPaths::DataLocation,  );
     QString file_name = KSPaths::locate(QStandardPaths::GenericDataLocation, QString("asteroids.dat"));
-    KSParser asteroid_parser(file_name, '#', sequence);
+    m_Elements.load(file_name, KSPaths::writableLocation(QStandardPaths::GenericDataLocation) + "asteroids.bin");
+
+    m_Created.fill(false, m_Elements.size());
+    m_CreatedLimit = -std::numeric_limits<double>::infinity();
+    // Names are listed for the asteroids that are not created as well, findByName() creates them
+    objectNames(SkyObject::ASTEROID) = listedNames(m_Elements);
+    createAsteroids(Options::magLimitAsteroid());
+}
+
+QStringList AsteroidsComponent::listedNames(const OrbitalElementStore &elements)
+{
+    QStringList names;
+    names.reserve(elements.size());
+    for (int row = 0; row < elements.size(); row++)
+        names.append(listedName(QString::fromUtf8(shortName(elements.rawText(row, FullName)))));
+    return names;
+}
+
+double AsteroidsComponent::brightestMagnitude(double H, double q)
+{
+    if (q <= EarthAphelion)
+        return -std::numeric_limits<double>::infinity();
+
+    // The phase term only makes the asteroid fainter
+    return H + 5 * log10(q * (q - EarthAphelion));
+}
+
+void AsteroidsComponent::createAsteroids(double magLimit)
+{
+    m_CreatedLimit = magLimit;
+    if (m_Elements.size() == 0)
+        return;
+
+    const double *H = m_Elements.numbers(AbsoluteMagnitude);
+    const double *q = m_Elements.numbers(Perihelion);
+
+    for (int row = 0; row < m_Elements.size(); row++)
+    {
+        // An asteroid without an absolute magnitude may be bright
+        if (!m_Created[row] && !(brightestMagnitude(H[row], q[row]) > magLimit))
+            createAsteroid(row);
+    }
+}
+
+KSAsteroid *AsteroidsComponent::createAsteroid(int row)
+{
+    QString full_name = m_Elements.text(row, FullName).trimmed();
+    int catN          = full_name.section(' ', 0, 0).toInt();
+    QString name      = listedName(full_name.section(' ', 1, -1));
+
+    long double JD = m_Elements.number(row, EpochMJD) + 2400000.5;
+    double a       = m_Elements.number(row, SemiMajorAxis);
+    double e       = m_Elements.number(row, Eccentricity);
+    dms i(m_Elements.number(row, Inclination));
+    dms w(m_Elements.number(row, ArgPerihelion));
+    dms N(m_Elements.number(row, AscendingNode));
+    dms M(m_Elements.number(row, MeanAnomaly));
+    double H       = m_Elements.number(row, AbsoluteMagnitude);
+    double G       = m_Elements.number(row, Slope);
+    float diameter = m_Elements.number(row, Diameter);
+
+    KSAsteroid *new_asteroid = nullptr;
+
+    // JM: Hack since asteroid file (Generated by JPL) is missing important Pluto data
+    // I emailed JPL and this hack will be removed once they update the data!
+    if (name == "Pluto")
+    {
+        diameter     = 2368;
+        new_asteroid = new KSAsteroid(catN, name, "pluto", JD, a, e, i, w, N, M, H, G);
+    }
+    else
+        new_asteroid = new KSAsteroid(catN, name, QString(), JD, a, e, i, w, N, M, H, G);
+
+    new_asteroid->setPerihelion(m_Elements.number(row, Perihelion));
+    new_asteroid->setOrbitID(m_Elements.text(row, OrbitID));
+    new_asteroid->setNEO(m_Elements.rawText(row, NEO) == "Y");
+    new_asteroid->setDiameter(diameter);
+    new_asteroid->setDimensions(m_Elements.text(row, Extent));
+    new_asteroid->setAlbedo(m_Elements.number(row, Albedo));
+    new_asteroid->setRotationPeriod(m_Elements.number(row, RotationPeriod));
+    new_asteroid->setPeriod(m_Elements.number(row, Period));
+    new_asteroid->setEarthMOID(m_Elements.number(row, EarthMOID));
+    new_asteroid->setOrbitClass(m_Elements.text(row, OrbitClass));
+    new_asteroid->setPhysicalSize(diameter);
+    //new_asteroid->setAngularSize(0.005);
+
+    m_Created[row] = true;
+    m_UncreatedList.clear();
+    m_ObjectList.append(new_asteroid);
+    objectLists(SkyObject::ASTEROID).append(QPair<QString, const SkyObject *>(name, new_asteroid));
+    objectIndex().add(new_asteroid, this);
+
+    return new_asteroid;
+}
+
+void AsteroidsComponent::updateSolarSystemBodies(KSNumbers *num)
+{
+    // The faint limit was raised since the asteroids were created
+    if (selected() && Options::magLimitAsteroid() > m_CreatedLimit)
+        createAsteroids(Options::magLimitAsteroid());
+
+    SolarSystemListComponent::updateSolarSystemBodies(num);
+}
+
+int AsteroidsComponent::findRow(const QString &name)
+{
+    if (m_NameIndex.isEmpty() && m_Elements.size() > 0)
+    {
+        QVector<QByteArray> names(m_Elements.size());
+        m_NameIndex.resize(m_Elements.size());
+        for (int row = 0; row < m_Elements.size(); row++)
+        {
+            names[row]       = shortName(m_Elements.rawText(row, FullName));
+            m_NameIndex[row] = row;
+        }
+
+        std::sort(m_NameIndex.begin(), m_NameIndex.end(),
+                  [&names](int r1, int r2) { return nameLessThan(names[r1], names[r2]); });
+    }
+
+    const QByteArray key = name.toUtf8();
+    auto rowName         = [this](int row) { return shortName(m_Elements.rawText(row, FullName)); };
+    auto row             = std::lower_bound(m_NameIndex.constBegin(), m_NameIndex.constEnd(), key,
+                                [&rowName](int r, const QByteArray &k) { return nameLessThan(rowName(r), k); });
+
+    // Names equal but for the case of ASCII letters, compared again as QString
+    for (; row != m_NameIndex.constEnd() && !nameLessThan(key, rowName(*row)); ++row)
+    {
+        if (QString::compare(QString::fromUtf8(rowName(*row)), name, Qt::CaseInsensitive) == 0)
+            return *row;
+    }
+
+    return -1;
+}
+
+SkyObject *AsteroidsComponent::findByName(const QString &name)
+{
+    SkyObject *o = SolarSystemListComponent::findByName(name);
+    if (o != nullptr)
+        return o;
+
+    return createByName(name);
+}
+
+SkyObject *AsteroidsComponent::createByName(const QString &name)
+{
+    int row = findRow(name);
+    if (row < 0 && name.endsWith(i18n(" (Asteroid)")))
+        row = findRow(name.left(name.size() - i18n(" (Asteroid)").size()));
+    if (row < 0 || m_Created[row])
+        return nullptr;
+
+    // Too faint to have been created, its position is computed now
+    KSAsteroid *asteroid = createAsteroid(row);
+    KStarsData *data     = KStarsData::Instance();
+    asteroid->findPosition(data->updateNum(), data->geo()->lat(), data->lst(), earth());
+    asteroid->EquatorialToHorizontal(data->lst(), data->geo()->lat());
+
+    return asteroid;
+}
+
+void AsteroidsComponent::createToMag(double magLimit)
+{
+    if (magLimit <= m_CreatedLimit)
+        return;
+
+    int count = m_ObjectList.size();
+    createAsteroids(magLimit);
 
-    QHash<QString, QVariant> row_content;
-    while (asteroid_parser.HasNextRow())
+    KStarsData *data = KStarsData::Instance();
+    for (int i = count; i < m_ObjectList.size(); i++)
     {
-        row_content = asteroid_parser.ReadNextRow();
-        full_name   = row_content["full name"].toString();
-        full_name   = full_name.trimmed();
-        int catN    = full_name.section(' ', 0, 0).toInt();
-
-        name = full_name.section(' ', 1, -1);
-
-        //JM temporary hack to avoid Europa,Io, and Asterope duplication
-        if (name == "Europa" || name == "Io" || name == "Asterope")
-            name += i18n(" (Asteroid)");
-
-        mJD         = row_content["epoch_mjd"].toInt();
-        q           = row_content["q"].toDouble();
-        a           = row_content["a"].toDouble();
-        e           = row_content["e"].toDouble();
-        dble_i      = row_content["i"].toDouble();
-        dble_w      = row_content["w"].toDouble();
-        dble_N      = row_content["om"].toDouble();
-        dble_M      = row_content["ma"].toDouble();
-        orbit_id    = row_content["orbit_id"].toString();
-        H           = row_content["H"].toDouble();
-        G           = row_content["G"].toDouble();
-        neo         = row_content["neo"].toString() == "Y";
-        diameter    = row_content["diameter"].toFloat();
-        dimensions  = row_content["extent"].toString();
-        albedo      = row_content["albedo"].toFloat();
-        rot_period  = row_content["rot_period"].toFloat();
-        period      = row_content["per_y"].toFloat();
-        earth_moid  = row_content["moid"].toDouble();
-        orbit_class = row_content["class"].toString();
-
-        JD = static_cast<double>(mJD) + 2400000.5;
-
-        KSAsteroid *new_asteroid = nullptr;
-
-        // JM: Hack since asteroid file (Generated by JPL) is missing important Pluto data
-        // I emailed JPL and this hack will be removed once they update the data!
-        if (name == "Pluto")
+        KSAsteroid *asteroid = static_cast<KSAsteroid *>(m_ObjectList[i]);
+        asteroid->findPosition(data->updateNum(), data->geo()->lat(), data->lst(), earth());
+        asteroid->EquatorialToHorizontal(data->lst(), data->geo()->lat());
+    }
+}
+
+const QVector<QPair<QString, const SkyObject *>> &AsteroidsComponent::uncreatedList()
+{
+    if (m_UncreatedList.isEmpty())
+    {
+        for (int row = 0; row < m_Elements.size(); row++)
         {
-            diameter = 2368;
-            new_asteroid =
-                new KSAsteroid(catN, name, "pluto", JD, a, e, dms(dble_i), dms(dble_w), dms(dble_N), dms(dble_M), H, G);
+            if (m_Created[row])
+                continue;
+
+            const QString name = listedName(QString::fromUtf8(shortName(m_Elements.rawText(row, FullName))));
+            m_UncreatedList.append(QPair<QString, const SkyObject *>(name, nullptr));
         }
-        else
-            new_asteroid = new KSAsteroid(catN, name, QString(), JD, a, e, dms(dble_i), dms(dble_w), dms(dble_N),
-                                          dms(dble_M), H, G);
-
-        new_asteroid->setPerihelion(q);
-        new_asteroid->setOrbitID(orbit_id);
-        new_asteroid->setNEO(neo);
-        new_asteroid->setDiameter(diameter);
-        new_asteroid->setDimensions(dimensions);
-        new_asteroid->setAlbedo(albedo);
-        new_asteroid->setRotationPeriod(rot_period);
-        new_asteroid->setPeriod(period);
-        new_asteroid->setEarthMOID(earth_moid);
-        new_asteroid->setOrbitClass(orbit_class);
-        new_asteroid->setPhysicalSize(diameter);
-        //new_asteroid->setAngularSize(0.005);
-
-        m_ObjectList.append(new_asteroid);
-        // Add name to the list of object names
-        objectNames(SkyObject::ASTEROID).append(name);
-        objectLists(SkyObject::ASTEROID).append(QPair<QString, const SkyObject *>(name, new_asteroid));
     }
+    return m_UncreatedList;
 }
 
 void AsteroidsComponent::draw(SkyPainter *skyp)
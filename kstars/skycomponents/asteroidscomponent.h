@@ -19,17 +19,26 @@
 #define ASTEROIDSCOMPONENT_H
 
 #include <QList>
+#include <QPair>
 #include <QPointer>
+#include <QVector>
 
 #include "solarsystemlistcomponent.h"
-#include "ksparser.h"
+#include "orbitalelementstore.h"
 #include "typedef.h"
 
 class FileDownloader;
+class KSAsteroid;
 
 /** @class AsteroidsComponent
  * Represents the asteroids on the sky map.
  *
+ * The orbital elements of all the asteroids of the data file are held in an OrbitalElementStore. A KSAsteroid is
+ * created only for an asteroid that may be brighter than the faint limit, when it is searched for by name, or when
+ * a list asks for fainter asteroids with createToMag(). objectNames(SkyObject::ASTEROID) holds the names of all the
+ * asteroids, while objectLists(SkyObject::ASTEROID) and asteroids() only hold the ones created. The names of the
+ * others are listed by uncreatedList().
+ *
  * @author Thomas Kabelmann
  * @version 0.1
  */
@@ -47,6 +56,43 @@ class AsteroidsComponent : public QObject, public SolarSystemListComponent
     void draw(SkyPainter *skyp) Q_DECL_OVERRIDE;
     bool selected() Q_DECL_OVERRIDE;
     SkyObject *objectNearest(SkyPoint *p, double &maxrad) Q_DECL_OVERRIDE;
+    SkyObject *findByName(const QString &name) Q_DECL_OVERRIDE;
+    void updateSolarSystemBodies(KSNumbers *num) Q_DECL_OVERRIDE;
+
+    /**
+     * @short Create the asteroid named name, if it was too faint to be created with the others
+     * @return the new asteroid, or nullptr if there is no such asteroid or it exists already
+     */
+    SkyObject *createByName(const QString &name);
+
+    /**
+     * @return the names of the asteroids that were not created, each without an object. Lists of names, such as the
+     * one of the Find dialog, add them to objectLists(SkyObject::ASTEROID) and create the asteroid picked with
+     * createByName().
+     */
+    const QVector<QPair<QString, const SkyObject *>> &uncreatedList();
+
+    /**
+     * @short Create the asteroids that may be brighter than magLimit, for lists that go fainter than the sky map
+     *
+     * The positions of the new asteroids are computed for the current time.
+     * @param magLimit faint limit, +infinity to create all the asteroids
+     */
+    void createToMag(double magLimit);
+
+    /** @return the names all the asteroids of elements are listed under, in the order of the rows */
+    static QStringList listedNames(const OrbitalElementStore &elements);
+
+    /**
+     * @short Lowest magnitude an asteroid can reach as seen from the Earth
+     *
+     * The magnitude is at least H + 5 log10(r * delta), and outside the orbit of the Earth r * delta is smallest
+     * at perihelion. An asteroid whose perihelion is not outside the aphelion of the Earth may come arbitrarily
+     * close, its bound is -infinity.
+     * @param H absolute magnitude
+     * @param q perihelion distance, in AU
+     */
+    static double brightestMagnitude(double H, double q);
 
     void updateDataFile();
 
@@ -58,7 +104,25 @@ class AsteroidsComponent : public QObject, public SolarSystemListComponent
 
   private:
     void loadData();
+
+    /** @short Create the asteroids not created yet whose brightest magnitude is within magLimit */
+    void createAsteroids(double magLimit);
+    KSAsteroid *createAsteroid(int row);
+
+    /** @return row of the asteroid named name, or -1 */
+    int findRow(const QString &name);
+
     FileDownloader *downloadJob;
+
+    OrbitalElementStore m_Elements;
+    // Rows for which a KSAsteroid exists
+    QVector<bool> m_Created;
+    // Faint limit the asteroids were created for
+    double m_CreatedLimit { 0 };
+    // Rows sorted by name, built on the first search for an asteroid that was not created
+    QVector<int> m_NameIndex;
+    // Names of the rows not created, built when asked for after an asteroid was created
+    QVector<QPair<QString, const SkyObject *>> m_UncreatedList;
 };
 
 #endif
@@ -36,9 +36,27 @@
 #include "skymap.h"
 #endif
 #include "skypainter.h"
+#include "skymesh.h"
+#include "deepskylist.h"
+#include "htmesh/MeshIterator.h"
 #include "skyobjects/starobject.h"
 #include "skyobjects/deepskyobject.h"
+#include "skyobjects/skypointbatch.h"
 #include "catalogdb.h"
+#include "skyobjectindex.h"
+
+#include <algorithm>
+
+namespace
+{
+// Catalog stars of unknown magnitude are sorted first, so that the first star too faint ends a trixel
+bool starDrawOrder(const StarObject *s1, const StarObject *s2)
+{
+    if (DeepSkyList::isUnknownMag(s1->mag()))
+        return !DeepSkyList::isUnknownMag(s2->mag());
+    return !DeepSkyList::isUnknownMag(s2->mag()) && s1->mag() < s2->mag();
+}
+}
 
 QStringList CatalogComponent::m_Columns =
     QString("ID RA Dc Tp Nm Mg Flux Mj Mn PA Ig").split(' ', QString::SkipEmptyParts);
@@ -47,12 +65,16 @@ CatalogComponent::CatalogComponent(SkyComposite *parent, const QString &catname,
                                    bool callLoadData)
     : ListComponent(parent), m_catName(catname), m_Showerrs(showerrs), m_ccIndex(index)
 {
+    m_skyMesh = SkyMesh::Instance();
     if (callLoadData)
         loadData();
 }
 
 CatalogComponent::~CatalogComponent()
 {
+    qDeleteAll(m_DeepSkyIndex);
+    m_DeepSkyIndex.clear();
+
     // EH? WHY IS THIS EMPTY? -- AS
 
     // FIXME: Check this and implement it properly when you're not as
@@ -117,6 +139,7 @@ void CatalogComponent::_loadData(bool includeCatalogDesignation)
     {
         SkyObject *obj = m_ObjectList[iter];
         Q_ASSERT(obj);
+        objectIndex().add(obj, this);
         if (obj->type() <= SkyObject::TYPE_UNKNOWN)
         {
             QVector<QPair<QString, const SkyObject *>> &objects = objectLists(obj->type());
@@ -160,6 +183,10 @@ void CatalogComponent::_loadData(bool includeCatalogDesignation)
     foreach (QStringList list, objectNames())
         list.removeDuplicates();
 
+    for (SkyObject *obj : m_ObjectList)
+        appendIndex(obj, false);
+    sortIndex();
+
     CatalogData loaded_catalog_data;
     KStarsData::Instance()->catalogdb()->GetCatalogData(m_catName, loaded_catalog_data);
     m_catPrefix   = loaded_catalog_data.prefix;
@@ -210,41 +237,126 @@ void CatalogComponent::update(KSNumbers *)
     }
 }
 
+void CatalogComponent::appendIndex(SkyObject *obj, bool sort)
+{
+    Trixel trixel = m_skyMesh->index(obj);
+
+    if (obj->type() == SkyObject::STAR)
+    {
+        m_StarIndex[trixel].append(static_cast<StarObject *>(obj));
+        if (sort)
+            std::stable_sort(m_StarIndex[trixel].begin(), m_StarIndex[trixel].end(), starDrawOrder);
+        return;
+    }
+
+    DeepSkyList *dsList = m_DeepSkyIndex.value(trixel);
+    if (dsList == 0)
+    {
+        dsList = new DeepSkyList();
+        m_DeepSkyIndex.insert(trixel, dsList);
+    }
+    dsList->append(static_cast<DeepSkyObject *>(obj));
+    if (sort)
+        dsList->sort();
+}
+
+void CatalogComponent::sortIndex()
+{
+    for (DeepSkyList *dsList : m_DeepSkyIndex)
+        dsList->sort();
+    for (auto it = m_StarIndex.begin(); it != m_StarIndex.end(); ++it)
+        std::stable_sort(it->begin(), it->end(), starDrawOrder);
+}
+
 void CatalogComponent::draw(SkyPainter *skyp)
 {
     if (!selected())
         return;
 
+    KStarsData *data   = KStarsData::Instance();
+    UpdateID currentID = data->updateID();
+
     skyp->setBrush(Qt::NoBrush);
     skyp->setPen(QColor(m_catColor));
 
-    // Check if the coordinates have been updated
-    if (updateID != KStarsData::Instance()->updateID())
-        update(0);
-
-    //Draw Custom Catalog objects
-    // FIXME: Improve using HTM!
-    foreach (SkyObject *obj, m_ObjectList)
+    // Same magnitude limit as the deep-sky catalogs, adjusted for the zoom level. Objects of unknown magnitude
+    // are always drawn.
+    double maglim = Options::magLimitDrawDeepSky();
+    double lgmin  = log10(MINZOOM);
+    double lgmax  = log10(MAXZOOM);
+    double lgz    = log10(Options::zoomFactor());
+    if (lgz <= 0.75 * lgmax)
+        maglim -= (Options::magLimitDrawDeepSky() - Options::magLimitDrawDeepSkyZoomOut()) * (0.75 * lgmax - lgz) /
+                  (0.75 * lgmax - lgmin);
+
+    // Only the objects of the visible trixels are read, and those out of date are updated together
+    MeshIterator region(m_skyMesh, DRAW_BUF);
+    const SkyPointBatch batch(data->updateNum(), data->lst(), data->geo()->lat());
+    QVector<SkyPoint *> staleObjects;
+    QVector<DeepSkyObject *> drawnObjects;
+    QVector<StarObject *> drawnStars;
+
+    while (region.hasNext())
     {
-        if (obj->type() == 0)
+        Trixel trixel = region.next();
+
+        drawnObjects.clear();
+        if (DeepSkyList *dsList = m_DeepSkyIndex.value(trixel))
+            dsList->select(maglim, true, drawnObjects);
+
+        drawnStars.clear();
+        auto starList = m_StarIndex.constFind(trixel);
+        if (starList != m_StarIndex.constEnd())
         {
-            StarObject *starobj = static_cast<StarObject *>(obj);
-            // FIXME SKYPAINTER
-            skyp->drawPointSource(starobj, starobj->mag(), starobj->spchar());
+            for (StarObject *star : *starList)
+            {
+                if (!(star->mag() < maglim || DeepSkyList::isUnknownMag(star->mag())))
+                    break;
+                drawnStars.append(star);
+            }
         }
-        else
+
+        if (drawnObjects.isEmpty() && drawnStars.isEmpty())
+            continue;
+
+        staleObjects.clear();
+        for (DeepSkyObject *obj : drawnObjects)
         {
-            // FIXME: this PA calc is totally different from the one that was
-            // in DeepSkyComponent which is now in SkyPainter .... O_o
-            //      --hdevalence
-            // PA for Deep-Sky objects is 90 + PA because major axis is
-            // horizontal at PA=0
-            // double pa = 90. + map->findPA( dso, o.x(), o.y() );
-            //
-            // ^ Not sure if above is still valid -- asimha 2016/08/16
-            DeepSkyObject *dso = static_cast<DeepSkyObject *>(obj);
-            skyp->drawDeepSkyObject(dso, true);
+            if (obj->updateID != currentID)
+            {
+                obj->updateID = currentID;
+                staleObjects.append(obj);
+            }
+        }
+        if (!staleObjects.isEmpty())
+        {
+            batch.updateCoords(staleObjects.constData(), staleObjects.size());
+            batch.EquatorialToHorizontal(staleObjects.constData(), staleObjects.size());
         }
+
+        // Stars may override updateCoords() for proper motion, they are updated one by one
+        for (StarObject *star : drawnStars)
+        {
+            if (star->updateID != currentID)
+            {
+                star->updateID = currentID;
+                if (star->updateNumID != data->updateNumID())
+                    star->updateCoords(data->updateNum());
+                star->EquatorialToHorizontal(data->lst(), data->geo()->lat());
+            }
+            skyp->drawPointSource(star, star->mag(), star->spchar());
+        }
+
+        // FIXME: this PA calc is totally different from the one that was
+        // in DeepSkyComponent which is now in SkyPainter .... O_o
+        //      --hdevalence
+        // PA for Deep-Sky objects is 90 + PA because major axis is
+        // horizontal at PA=0
+        // double pa = 90. + map->findPA( dso, o.x(), o.y() );
+        //
+        // ^ Not sure if above is still valid -- asimha 2016/08/16
+        for (DeepSkyObject *obj : drawnObjects)
+            skyp->drawDeepSkyObject(obj, true);
     }
 }
 
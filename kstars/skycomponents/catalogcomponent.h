@@ -21,6 +21,13 @@
 #include "listcomponent.h"
 #include "Options.h"
 
+#include <QHash>
+#include <QVector>
+
+class DeepSkyList;
+class SkyMesh;
+class StarObject;
+
 struct stat;
 
 /**
@@ -96,6 +103,15 @@ class CatalogComponent : public ListComponent
     /** @short Load data into custom catalog */
     virtual void _loadData(bool includeCatalogDesignation);
 
+    /**
+     * @short Add obj to the trixel index that draw() walks
+     * @param sort true to sort the objects of the trixel at once, false if sortIndex() is called later
+     */
+    void appendIndex(SkyObject *obj, bool sort);
+
+    /** @short Sort the objects of every trixel by magnitude */
+    void sortIndex();
+
     // FIXME: There seems to be no way to remove catalogs from the program. -- asimha
 
     QString m_catName, m_catPrefix, m_catColor, m_catFluxFreq, m_catFluxUnit;
@@ -104,6 +120,11 @@ class CatalogComponent : public ListComponent
     int m_ccIndex;
     quint32 updateID;
 
+    SkyMesh *m_skyMesh { nullptr };
+    // Objects of the catalog per trixel, by magnitude
+    QHash<int, DeepSkyList *> m_DeepSkyIndex;
+    QHash<int, QVector<StarObject *>> m_StarIndex;
+
     static QStringList m_Columns;
 };
 
@@ -42,6 +42,37 @@
 #include "auxiliary/filedownloader.h"
 #include "kspaths.h"
 #include "ksutils.h"
+#include "orbitalelementstore.h"
+#include "skyobjectindex.h"
+
+namespace
+{
+// Fields of comets.dat, see loadData()
+enum Field
+{
+    FullName,
+    EpochMJD,
+    Perihelion,
+    Eccentricity,
+    Inclination,
+    ArgPerihelion,
+    AscendingNode,
+    PerihelionTime,
+    OrbitID,
+    NEO,
+    TotalMagnitude,
+    NuclearMagnitude,
+    Diameter,
+    Extent,
+    Albedo,
+    RotationPeriod,
+    Period,
+    EarthMOID,
+    OrbitClass,
+    TotalSlope,
+    NuclearSlope
+};
+}
 
 CometsComponent::CometsComponent(SolarSystemComposite *parent) : SolarSystemListComponent(parent)
 {
@@ -88,13 +119,6 @@ bool CometsComponent::selected()
  */
 void CometsComponent::loadData()
 {
-    QString name, orbit_id, orbit_class, dimensions;
-    bool neo;
-    int mJD;
-    double q, e, dble_i, dble_w, dble_N, Tp, earth_moid;
-    long double JD;
-    float M1, M2, K1, K2, diameter, albedo, rot_period, period;
-
     emitProgressText(i18n("Loading comets"));
 
     qDeleteAll(m_ObjectList);
@@ -102,8 +126,9 @@ void CometsComponent::loadData()
 
     objectNames(SkyObject::COMET).clear();
     objectLists(SkyObject::COMET).clear();
+    objectIndex().remove(this);
 
-    QList<QPair<QString, KSParser::DataTypes>> sequence;
+    OrbitalElementStore::Sequence sequence;
     sequence.append(qMakePair(QString("full name"), KSParser::D_QSTRING));
     sequence.append(qMakePair(QString("epoch_mjd"), KSParser::D_INT));
     sequence.append(qMakePair(QString("q"), KSParser::D_DOUBLE));
@@ -123,67 +148,47 @@ void CometsComponent::loadData()
     sequence.append(qMakePair(QString("per_y"), KSParser::D_FLOAT));
     sequence.append(qMakePair(QString("moid"), KSParser::D_DOUBLE));
     sequence.append(qMakePair(QString("class"), KSParser::D_QSTRING));
-    sequence.append(qMakePair(QString("H"), KSParser::D_SKIP));
-    sequence.append(qMakePair(QString("G"), KSParser::D_SKIP));
+    // K1 and K2
+    sequence.append(qMakePair(QString("H"), KSParser::D_FLOAT));
+    sequence.append(qMakePair(QString("G"), KSParser::D_FLOAT));
 
     QString file_name = KSPaths::locate(QStandardPaths::GenericDataLocation, QString("comets.dat"));
-    KSParser cometParser(file_name, '#', sequence);
+    OrbitalElementStore elements(sequence);
+    elements.load(file_name, KSPaths::writableLocation(QStandardPaths::GenericDataLocation) + "comets.bin");
 
-    QHash<QString, QVariant> row_content;
-    while (cometParser.HasNextRow())
+    for (int row = 0; row < elements.size(); row++)
     {
-        KSComet *com = 0;
-        row_content  = cometParser.ReadNextRow();
-        name         = row_content["full name"].toString();
-        name         = name.trimmed();
-        mJD          = row_content["epoch_mjd"].toInt();
-        q            = row_content["q"].toDouble();
-        e            = row_content["e"].toDouble();
-        dble_i       = row_content["i"].toDouble();
-        dble_w       = row_content["w"].toDouble();
-        dble_N       = row_content["om"].toDouble();
-        Tp           = row_content["tp_calc"].toDouble();
-        orbit_id     = row_content["orbit_id"].toString();
-        neo          = row_content["neo"] == "Y";
-
-        if (row_content["M1"].toFloat() == 0.0)
-            M1 = 101.0;
-        else
-            M1 = row_content["M1"].toFloat();
+        QString name   = elements.text(row, FullName).trimmed();
+        long double JD = elements.number(row, EpochMJD) + 2400000.5;
+        float M1       = elements.number(row, TotalMagnitude);
+        float M2       = elements.number(row, NuclearMagnitude);
 
-        if (row_content["M2"].toFloat() == 0.0)
+        if (M1 == 0.0)
+            M1 = 101.0;
+        if (M2 == 0.0)
             M2 = 101.0;
-        else
-            M2 = row_content["M2"].toFloat();
-
-        diameter    = row_content["diameter"].toFloat();
-        dimensions  = row_content["extent"].toString();
-        albedo      = row_content["albedo"].toFloat();
-        rot_period  = row_content["rot_period"].toFloat();
-        period      = row_content["per_y"].toFloat();
-        earth_moid  = row_content["moid"].toDouble();
-        orbit_class = row_content["class"].toString();
-        K1          = row_content["H"].toFloat();
-        K2          = row_content["G"].toFloat();
-
-        JD = static_cast<double>(mJD) + 2400000.5;
-
-        com = new KSComet(name, QString(), JD, q, e, dms(dble_i), dms(dble_w), dms(dble_N), Tp, M1, M2, K1, K2);
-        com->setOrbitID(orbit_id);
-        com->setNEO(neo);
-        com->setDiameter(diameter);
-        com->setDimensions(dimensions);
-        com->setAlbedo(albedo);
-        com->setRotationPeriod(rot_period);
-        com->setPeriod(period);
-        com->setEarthMOID(earth_moid);
-        com->setOrbitClass(orbit_class);
+
+        KSComet *com = new KSComet(name, QString(), JD, elements.number(row, Perihelion),
+                                   elements.number(row, Eccentricity), dms(elements.number(row, Inclination)),
+                                   dms(elements.number(row, ArgPerihelion)), dms(elements.number(row, AscendingNode)),
+                                   elements.number(row, PerihelionTime), M1, M2, elements.number(row, TotalSlope),
+                                   elements.number(row, NuclearSlope));
+        com->setOrbitID(elements.text(row, OrbitID));
+        com->setNEO(elements.rawText(row, NEO) == "Y");
+        com->setDiameter(elements.number(row, Diameter));
+        com->setDimensions(elements.text(row, Extent));
+        com->setAlbedo(elements.number(row, Albedo));
+        com->setRotationPeriod(elements.number(row, RotationPeriod));
+        com->setPeriod(elements.number(row, Period));
+        com->setEarthMOID(elements.number(row, EarthMOID));
+        com->setOrbitClass(elements.text(row, OrbitClass));
         com->setAngularSize(0.005);
         m_ObjectList.append(com);
 
         // Add *short* name to the list of object names
         objectNames(SkyObject::COMET).append(com->name());
         objectLists(SkyObject::COMET).append(QPair<QString, const SkyObject *>(com->name(), com));
+        objectIndex().add(com, this);
     }
 }
 
@@ -118,6 +118,16 @@ void ConstellationArtComponent::showList()
     }
 }
 
+bool ConstellationArtComponent::hasImage(const QString &fileName) const
+{
+    for (const ConstellationsArt *art : m_ConstList)
+    {
+        if (art->getImageFileName() == fileName)
+            return true;
+    }
+    return false;
+}
+
 void ConstellationArtComponent::draw(SkyPainter *skyp)
 {
     Q_UNUSED(skyp)
@@ -57,6 +57,9 @@ class ConstellationArtComponent : public SkyComponent
 
     void draw(SkyPainter *skyp) Q_DECL_OVERRIDE;
 
+    /** @return true if fileName is the image of one of the constellations */
+    bool hasImage(const QString &fileName) const;
+
     QList<ConstellationsArt *> m_ConstList;
 
   private:
@@ -29,6 +29,7 @@
 
 #include "ksfilereader.h"
 #include "skylabeler.h"
+#include "skyobjectindex.h"
 #include "projections/projector.h"
 
 ConstellationNamesComponent::ConstellationNamesComponent(SkyComposite *parent, CultureList *cultures)
@@ -103,6 +104,7 @@ void ConstellationNamesComponent::loadData(CultureList *cultures)
             //Add name to the list of object names
             objectNames(SkyObject::CONSTELLATION).append(name);
             objectLists(SkyObject::CONSTELLATION).append(QPair<QString, const SkyObject *>(name, o));
+            objectIndex().add(o, this);
         }
     }
 }
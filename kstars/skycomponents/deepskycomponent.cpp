@@ -26,10 +26,12 @@
 #include "skymap.h"
 #endif
 #include "skymesh.h"
+#include "skyobjectindex.h"
 #include "skypainter.h"
 #include "htmesh/MeshIterator.h"
 #include "projections/projector.h"
 #include "skyobjects/deepskyobject.h"
+#include "skyobjects/skypointbatch.h"
 
 DeepSkyComponent::DeepSkyComponent(SkyComposite *parent) : SkyComponent(parent)
 {
@@ -324,6 +326,7 @@ void DeepSkyComponent::loadData()
                 nameHash[longname.toLower()] = o;
             if (!name2.isEmpty())
                 nameHash[name2.toLower()] = o;
+            objectIndex().add(o, this);
         }
 
         Trixel trixel = m_skyMesh->index(o);
@@ -373,6 +376,12 @@ void DeepSkyComponent::loadData()
         deep_sky_parser.ShowProgress();
     }
 
+    for (DeepSkyIndex *dsIndex : { &m_MessierIndex, &m_NGCIndex, &m_ICIndex, &m_OtherIndex })
+    {
+        for (DeepSkyList *dsList : *dsIndex)
+            dsList->sort();
+    }
+
     foreach (QStringList list, objectNames())
         list.removeDuplicates();
 }
@@ -472,8 +481,7 @@ void DeepSkyComponent::drawDeepSkyCatalog(SkyPainter *skyp, bool drawObject, Dee
     const Projector *proj = map->projector();
     KStarsData *data      = KStarsData::Instance();
 
-    UpdateID updateID    = data->updateID();
-    UpdateID updateNumID = data->updateNumID();
+    UpdateID updateID = data->updateID();
 
     skyp->setPen(data->colorScheme()->colorNamed(colorString));
     skyp->setBrush(Qt::NoBrush);
@@ -501,44 +509,43 @@ void DeepSkyComponent::drawDeepSkyCatalog(SkyPainter *skyp, bool drawObject, Dee
     //DrawID drawID = m_skyMesh->drawID();
     MeshIterator region(m_skyMesh, DRAW_BUF);
 
+    // Objects whose coordinates are out of date are updated together, one trixel at a time
+    const SkyPointBatch batch(data->updateNum(), data->lst(), data->geo()->lat());
+    QVector<SkyPoint *> staleObjects;
+    QVector<DeepSkyObject *> drawnObjects;
+
     while (region.hasNext())
     {
         Trixel trixel       = region.next();
         DeepSkyList *dsList = dsIndex->value(trixel);
         if (dsList == 0)
             continue;
-        for (int j = 0; j < dsList->size(); j++)
-        {
-            DeepSkyObject *obj = dsList->at(j);
 
-            //if ( obj->drawID == drawID ) continue;  // only draw each line once
-            //obj->drawID = drawID;
+        // Only the objects to be drawn are read, and updated if need be
+        drawnObjects.clear();
+        dsList->select(maglim, showUnknownMagObjects, Options::zoomFactor(), drawnObjects);
 
+        staleObjects.clear();
+        for (DeepSkyObject *obj : drawnObjects)
+        {
             if (obj->updateID != updateID)
             {
                 obj->updateID = updateID;
-                if (obj->updateNumID != updateNumID)
-                {
-                    obj->updateCoords(data->updateNum());
-                }
-                obj->EquatorialToHorizontal(data->lst(), data->geo()->lat());
+                staleObjects.append(obj);
             }
+        }
+        if (!staleObjects.isEmpty())
+        {
+            batch.updateCoords(staleObjects.constData(), staleObjects.size());
+            batch.EquatorialToHorizontal(staleObjects.constData(), staleObjects.size());
+        }
 
-            float mag  = obj->mag();
-            float size = obj->a() * dms::PI * Options::zoomFactor() / 10800.0;
-
-            //only draw objects if flags set, it's bigger than 1 pixel (unless
-            //zoom > 2000.), and it's brighter than maglim (unless mag is
-            //undefined (=99.9)
-            bool sizeCriterion = (size > 1.0 || Options::zoomFactor() > 2000.);
-            bool magCriterion  = (mag < (float)maglim) || (showUnknownMagObjects && (std::isnan(mag) || mag > 36.0));
-            if (sizeCriterion && magCriterion)
-            {
-                bool drawn = skyp->drawDeepSkyObject(obj, drawImage);
-                if (drawn && !(m_hideLabels || mag > labelMagLim))
-                    addLabel(proj->toScreen(obj), obj);
-                //FIXME: find a better way to do above
-            }
+        for (DeepSkyObject *obj : drawnObjects)
+        {
+            bool drawn = skyp->drawDeepSkyObject(obj, drawImage);
+            if (drawn && !(m_hideLabels || obj->mag() > labelMagLim))
+                addLabel(proj->toScreen(obj), obj);
+            //FIXME: find a better way to do above
         }
     }
 #else
@@ -600,7 +607,7 @@ void DeepSkyComponent::objectsInArea(QList<SkyObject *> &list, const SkyRegion &
         if (m_DeepSkyIndex.contains(trixel))
         {
             DeepSkyList *dsoList = m_DeepSkyIndex.value(trixel);
-            for (DeepSkyList::iterator dsit = dsoList->begin(); dsit != dsoList->end(); ++dsit)
+            for (DeepSkyList::const_iterator dsit = dsoList->begin(); dsit != dsoList->end(); ++dsit)
                 list.append(*dsit);
         }
     }
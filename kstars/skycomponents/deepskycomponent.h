@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "deepskylist.h"
 #include "skycomponent.h"
 #include "skylabel.h"
 
@@ -36,7 +37,6 @@ class SkyPoint;
 // conventions with StarComponent
 #define MAX_LINENUMBER_MAG 90
 
-typedef QVector<DeepSkyObject *> DeepSkyList;
 typedef QHash<int, DeepSkyList *> DeepSkyIndex;
 
 /**
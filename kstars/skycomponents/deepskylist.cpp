@@ -0,0 +1,91 @@
+/***************************************************************************
+                     deepskylist.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "deepskylist.h"
+
+#include "dms.h"
+#include "skyobjects/deepskyobject.h"
+
+#include <algorithm>
+#include <cmath>
+
+bool DeepSkyList::isUnknownMag(float mag)
+{
+    return std::isnan(mag) || mag > 36.0;
+}
+
+void DeepSkyList::append(DeepSkyObject *obj)
+{
+    m_Objects.append(obj);
+}
+
+void DeepSkyList::sort()
+{
+    std::stable_sort(m_Objects.begin(), m_Objects.end(), [](const DeepSkyObject *o1, const DeepSkyObject *o2) {
+        if (isUnknownMag(o2->mag()))
+            return !isUnknownMag(o1->mag());
+        return !isUnknownMag(o1->mag()) && o1->mag() < o2->mag();
+    });
+
+    m_Mags.resize(m_Objects.size());
+    m_MajorAxes.resize(m_Objects.size());
+    m_KnownMags = 0;
+
+    for (int i = 0; i < m_Objects.size(); i++)
+    {
+        m_Mags[i]      = m_Objects[i]->mag();
+        m_MajorAxes[i] = m_Objects[i]->a();
+        if (!isUnknownMag(m_Mags[i]))
+            m_KnownMags++;
+    }
+}
+
+void DeepSkyList::select(float maglim, bool showUnknownMags, double zoom, QVector<DeepSkyObject *> &list) const
+{
+    Q_ASSERT(m_Mags.size() == m_Objects.size());
+
+    const bool anySize = zoom > 2000.;
+    auto appendIfLarge = [&](int i) {
+        float size = m_MajorAxes[i] * dms::PI * zoom / 10800.0;
+        if (anySize || size > 1.0)
+            list.append(m_Objects[i]);
+    };
+
+    // The objects of known magnitude are sorted, so the first one too faint ends them
+    for (int i = 0; i < m_KnownMags && m_Mags[i] < maglim; i++)
+        appendIfLarge(i);
+
+    if (showUnknownMags)
+    {
+        for (int i = m_KnownMags; i < m_Objects.size(); i++)
+            appendIfLarge(i);
+    }
+}
+
+void DeepSkyList::select(float maglim, bool showUnknownMags, QVector<DeepSkyObject *> &list) const
+{
+    Q_ASSERT(m_Mags.size() == m_Objects.size());
+
+    for (int i = 0; i < m_KnownMags && m_Mags[i] < maglim; i++)
+        list.append(m_Objects[i]);
+
+    if (showUnknownMags)
+    {
+        for (int i = m_KnownMags; i < m_Objects.size(); i++)
+            list.append(m_Objects[i]);
+    }
+}
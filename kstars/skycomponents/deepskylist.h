@@ -0,0 +1,70 @@
+/***************************************************************************
+                      deepskylist.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QVector>
+
+class DeepSkyObject;
+
+/**
+ * @class DeepSkyList
+ * @short The deep-sky objects of a catalog in one trixel, brightest first
+ *
+ * The magnitudes and major axes of the objects are copied into arrays of their own, in the same order, so that
+ * the objects too faint or too small to be drawn are passed over without reading them. Objects of unknown
+ * magnitude come last.
+ */
+class DeepSkyList
+{
+  public:
+    typedef QVector<DeepSkyObject *>::const_iterator const_iterator;
+
+    /** @short Append obj, sort() is to be called once all the objects are appended */
+    void append(DeepSkyObject *obj);
+
+    /** @short Sort the objects by magnitude */
+    void sort();
+
+    /**
+     * @short Append to list the objects brighter than maglim and larger than a pixel at zoom, or all the objects
+     * of the magnitude range if zoom is larger than 2000
+     * @param showUnknownMags true to also append the objects of unknown magnitude
+     */
+    void select(float maglim, bool showUnknownMags, double zoom, QVector<DeepSkyObject *> &list) const;
+
+    /**
+     * @short Append to list the objects brighter than maglim, whatever their size
+     * @param showUnknownMags true to also append the objects of unknown magnitude
+     */
+    void select(float maglim, bool showUnknownMags, QVector<DeepSkyObject *> &list) const;
+
+    int size() const { return m_Objects.size(); }
+    DeepSkyObject *at(int i) const { return m_Objects.at(i); }
+    const_iterator begin() const { return m_Objects.constBegin(); }
+    const_iterator end() const { return m_Objects.constEnd(); }
+
+    /** @return true if mag is not a magnitude, as the catalogs write unknown magnitudes */
+    static bool isUnknownMag(float mag);
+
+  private:
+    QVector<DeepSkyObject *> m_Objects;
+    QVector<float> m_Mags;
+    QVector<float> m_MajorAxes;
+    // Number of objects of known magnitude, at the start of the arrays
+    int m_KnownMags { 0 };
+};
@@ -26,17 +26,23 @@
 #include "skymesh.h"
 #include "skypainter.h"
 #include "starblock.h"
+#include "starblockloader.h"
 #include "starcomponent.h"
 #include "htmesh/MeshIterator.h"
 #include "projections/projector.h"
+#include "skyobjects/skypointbatch.h"
 
 #include <qplatformdefs.h>
 #include <QtConcurrent>
 
+#include <cstring>
+
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
+bool DeepStarComponent::m_SynchronousLoading = false;
+
 DeepStarComponent::DeepStarComponent(SkyComposite *parent, QString fileName, float trigMag, bool staticstars)
     : ListComponent(parent), m_reindexNum(J2000), triggerMag(trigMag), m_FaintMagnitude(-5.0), staticStars(staticstars),
       dataFileName(fileName)
@@ -45,11 +51,27 @@ DeepStarComponent::DeepStarComponent(SkyComposite *parent, QString fileName, flo
     openDataFile();
     if (staticStars)
         loadStaticStars();
+#ifndef KSTARS_LITE
+    // Dynamic stars are loaded in the background, but only if the catalog is memory-mapped: the loader must not
+    // share the seek position of the FILE handle with the GUI thread.
+    else if (fileOpened && starReader.isMapped())
+    {
+        m_loader.reset(new StarBlockLoader(this));
+        QObject::connect(m_loader.get(), &StarBlockLoader::blocksLoaded, m_loader.get(),
+                         []() {
+                             if (SkyMap::Instance())
+                                 SkyMap::Instance()->forceUpdate();
+                         },
+                         Qt::QueuedConnection);
+    }
+#endif
     qDebug() << "Loaded DSO catalog file: " << dataFileName;
 }
 
 DeepStarComponent::~DeepStarComponent()
 {
+    // Stop the loader before the StarBlockLists it fills go away
+    m_loader.reset();
     qDeleteAll(m_starBlockList);
     m_starBlockList.clear();
     if (fileOpened)
@@ -108,6 +130,13 @@ bool DeepStarComponent::loadStaticStars()
             << "WARNING: HTM Level in shallow star data file and HTM Level in m_skyMesh do not match. EXPECT TROUBLE"
             << endl;
 
+    // If the catalog is memory-mapped, copy the records straight out of the mapping instead of reading them one by
+    // one. Fall back to fread() if the mapping does not cover all the records we expect.
+    const char *record = starReader.getRecordPointer(QT_FTELL(dataFile));
+    if (record && (starReader.getMappedSize() - QT_FTELL(dataFile)) <
+                      qint64(starReader.getRecordCount() * recordSize))
+        record = nullptr;
+
     // JM 2012-12-05: Breaking into 2 loops instead of one previously with multiple IF checks for recordSize
     // While the CPU branch prediction might not suffer any penalities since the branch prediction after a few times
     // should always gets it right. It's better to do it this way to avoid any chances since the compiler might not optimize it.
@@ -127,7 +156,15 @@ bool DeepStarComponent::loadStaticStars()
 
             for (quint64 j = 0; j < records; ++j)
             {
-                bool fread_success = fread(&stardata, sizeof(starData), 1, dataFile);
+                bool fread_success = false;
+                if (record)
+                {
+                    memcpy(&stardata, record, sizeof(starData));
+                    record += sizeof(starData);
+                    fread_success = true;
+                }
+                else
+                    fread_success = fread(&stardata, sizeof(starData), 1, dataFile);
 
                 if (!fread_success)
                 {
@@ -144,7 +181,11 @@ bool DeepStarComponent::loadStaticStars()
 #ifdef KSTARS_LITE
                 star = &(SB->addStar(stardata)->star);
 #else
-                star = SB->addStar(stardata);
+                int index = SB->addStar(stardata);
+                // StarObjects are initialized on demand (see StarBlock::star()), except for those we index by HD number
+                if (index >= 0 && !stardata.HD)
+                    continue;
+                star = (index >= 0 ? SB->star(index) : nullptr);
 #endif
                 if (star)
                 {
@@ -179,7 +220,14 @@ bool DeepStarComponent::loadStaticStars()
             for (quint64 j = 0; j < records; ++j)
             {
                 bool fread_success = false;
-                fread_success      = fread(&deepstardata, sizeof(deepStarData), 1, dataFile);
+                if (record)
+                {
+                    memcpy(&deepstardata, record, sizeof(deepStarData));
+                    record += sizeof(deepStarData);
+                    fread_success = true;
+                }
+                else
+                    fread_success = fread(&deepstardata, sizeof(deepStarData), 1, dataFile);
 
                 if (!fread_success)
                 {
@@ -196,7 +244,10 @@ bool DeepStarComponent::loadStaticStars()
 #ifdef KSTARS_LITE
                 star = &(SB->addStar(stardata)->star);
 #else
-                star = SB->addStar(deepstardata);
+                // StarObjects are initialized on demand, see StarBlock::star()
+                if (SB->addStar(deepstardata) >= 0)
+                    continue;
+                star = nullptr;
 #endif
                 if (star)
                 {
@@ -243,6 +294,12 @@ void DeepStarComponent::update(KSNumbers *)
 void DeepStarComponent::draw(SkyPainter *skyp)
 {
 #ifndef KSTARS_LITE
+    t_dynamicLoad = 0;
+    t_updateCache = 0;
+    t_drawUnnamed = 0;
+
+    visibleStarCount = 0;
+
     if (!fileOpened)
         return;
 
@@ -257,9 +314,7 @@ void DeepStarComponent::draw(SkyPainter *skyp)
     StarObject::updateCoordsCpuTime = 0.;
     StarObject::starsUpdated        = 0;
 #endif
-    SkyMap *map       = SkyMap::Instance();
-    KStarsData *data  = KStarsData::Instance();
-    UpdateID updateID = data->updateID();
+    SkyMap *map = SkyMap::Instance();
 
     //FIXME_FOV -- maybe not clamp like that...
     float radius = map->projector()->fov();
@@ -306,13 +361,14 @@ void DeepStarComponent::draw(SkyPainter *skyp)
     QTime t;
     int nTrixels = 0;
 
-    t_dynamicLoad = 0;
-    t_updateCache = 0;
-    t_drawUnnamed = 0;
+    t.start();
 
-    visibleStarCount = 0;
+    // The background loader may be filling StarBlockLists or recycling blocks of the LRU cache
+    QMutexLocker locker(m_StarBlockFactory->mutex());
+    QVector<Trixel> pendingTrixels;
 
-    t.start();
+    KStarsData *data = KStarsData::Instance();
+    const SkyPointBatch batch(data->updateNum(), data->lst(), data->geo()->lat());
 
     // Mark used blocks in the LRU Cache. Not required for static stars
     if (!staticStars)
@@ -348,8 +404,14 @@ void DeepStarComponent::draw(SkyPainter *skyp)
         // TODO: Is there a better way? We may have to change the magnitude tolerance if the catalog changes
         // Static stars need not execute fillToMag
 
-        if (!staticStars && !m_starBlockList.at(currentRegion)->fillToMag(maglim) &&
-            maglim <= m_FaintMagnitude * (1 - 1.5 / 16))
+        // With a background loader, we only queue the trixel and draw what is resident now.
+        if (!staticStars && m_loader && !m_SynchronousLoading)
+        {
+            if (needsFill(currentRegion, maglim))
+                pendingTrixels.append(currentRegion);
+        }
+        else if (!staticStars && !m_starBlockList.at(currentRegion)->fillToMag(maglim) &&
+                 maglim <= m_FaintMagnitude * (1 - 1.5 / 16))
         {
             qDebug() << "SBL::fillToMag( " << maglim << " ) failed for trixel " << currentRegion << " !" << endl;
         }
@@ -359,15 +421,10 @@ void DeepStarComponent::draw(SkyPainter *skyp)
         //        qDebug() << "Drawing SBL for trixel " << currentRegion << ", SBL has "
         //                 <<  m_starBlockList[ currentRegion ]->getBlockCount() << " blocks" << endl;
 
-        // REMARK: The following should never carry state, except for const parameters like updateID and maglim
-        std::function<void(StarBlock *)> mapFunction = [&updateID, &maglim](StarBlock *myBlock) {
-            for (StarObject &star : myBlock->contents())
-            {
-                if (star.updateID != updateID)
-                    star.JITupdate();
-                if (star.mag() > maglim)
-                    break;
-            }
+        // REMARK: The following should never carry state, except for const parameters like maglim
+        // Each block brings its packed coordinates up to date in one go; no StarObject is touched.
+        std::function<void(StarBlock *)> mapFunction = [&maglim, &batch](StarBlock *myBlock) {
+            myBlock->updateCoords(myBlock->starsToMag(maglim), batch);
         };
 
         QtConcurrent::blockingMap(m_starBlockList.at(currentRegion)->contents(), mapFunction);
@@ -377,27 +434,26 @@ void DeepStarComponent::draw(SkyPainter *skyp)
             StarBlock *block = m_starBlockList.at(currentRegion)->block(i);
             //            qDebug() << "---> Drawing stars from block " << i << " of trixel " <<
             //                currentRegion << ". SB has " << block->getStarCount() << " stars" << endl;
-            for (int j = 0; j < block->getStarCount(); j++)
-            {
-                StarObject *curStar = block->star(j);
-
-                //                qDebug() << "We claim that he's from trixel " << currentRegion
-                //<< ", and indexStar says he's from " << m_skyMesh->indexStar( curStar );
-
-                float mag = curStar->mag();
-
-                if (mag > maglim)
-                    break;
-
-                if (skyp->drawPointSource(curStar, mag, curStar->spchar()))
-                    visibleStarCount++;
-            }
+            int nVisible = block->starsToMag(maglim);
+            // Stars are projected straight from the packed coordinates of their StarBlock
+            visibleStarCount += skyp->drawPointSources(block->raData(), block->decData(), block->altData(),
+                                                       block->azData(), block->magData(), block->spData(), nVisible);
+            if (nVisible < block->getStarCount())
+                break;
         }
 
         // DEBUG: Uncomment to identify problems with Star Block Factory / preservation of Magnitude Order in the LRU Cache
         //        verifySBLIntegrity();
         t_drawUnnamed += t.restart();
     }
+    locker.unlock();
+
+    if (m_loader && !m_SynchronousLoading)
+    {
+        requestTrixels(focus, radius, maglim, pendingTrixels);
+        t_dynamicLoad += t.restart();
+    }
+
     m_skyMesh->inDraw(false);
 #ifdef PROFILE_SINCOS
     trig_calls_here += dms::trig_function_calls;
@@ -463,6 +519,11 @@ bool DeepStarComponent::openDataFile()
         if (starReader.getByteSwap())
             MSpT = bswap_16(MSpT);
         fileOpened = true;
+
+        // Map the catalog into memory so that trixels can be filled by pointer arithmetic rather than by seeking
+        // and reading the shared file handle record by record.
+        if (!starReader.mapFile())
+            qDebug() << "Could not memory-map " << dataFileName << ", falling back to buffered reads.";
         qDebug() << "  Sky Mesh Size: " << m_skyMesh->size();
         for (long int i = 0; i < m_skyMesh->size(); i++)
         {
@@ -479,10 +540,68 @@ bool DeepStarComponent::openDataFile()
     return fileOpened;
 }
 
+bool DeepStarComponent::needsFill(Trixel trixel, float maglim)
+{
+    StarBlockList *sbl = m_starBlockList.at(trixel);
+    return (sbl->getFaintMag() < maglim &&
+            (unsigned long)sbl->getStarCount() < starReader.getRecordCount(trixel));
+}
+
+void DeepStarComponent::requestTrixels(SkyPoint *focus, float radius, float maglim, QVector<Trixel> &trixels)
+{
+    // Prefetch a ring around the current view, shifted a few frames ahead in the direction we are slewing in.
+    const double lookAheadFrames = 3.0;
+    const double ringFactor      = 1.25;
+
+    double dRA  = 0;
+    double dDec = 0;
+    if (m_lastFocusValid)
+    {
+        dRA = focus->ra().Degrees() - m_lastFocus.ra().Degrees();
+        if (dRA > 180.0)
+            dRA -= 360.0;
+        else if (dRA < -180.0)
+            dRA += 360.0;
+        dDec = focus->dec().Degrees() - m_lastFocus.dec().Degrees();
+    }
+    m_lastFocus      = *focus;
+    m_lastFocusValid = true;
+
+    double aheadDec = qBound(-90.0, focus->dec().Degrees() + lookAheadFrames * dDec, 90.0);
+    SkyPoint ahead(dms(focus->ra().Degrees() + lookAheadFrames * dRA).reduce(), dms(aheadDec));
+
+    m_skyMesh->aperture(&ahead, qMin(radius * ringFactor, 90.0) + 1.0, PREFETCH_BUF);
+    MeshIterator region(m_skyMesh, PREFETCH_BUF);
+
+    {
+        QMutexLocker locker(StarBlockFactory::Instance()->mutex());
+        while (region.hasNext())
+        {
+            Trixel trixel = region.next();
+            if (!trixels.contains(trixel) && needsFill(trixel, maglim))
+                trixels.append(trixel);
+        }
+    }
+
+    m_loader->request(trixels, maglim);
+}
+
+void DeepStarComponent::waitForLoading()
+{
+    if (m_loader)
+        m_loader->waitForFinished();
+}
+
 StarObject *DeepStarComponent::findByHDIndex(int HDnum)
 {
     // Currently, we only handle HD catalog indexes
-    return m_CatalogNumber.value(HDnum, nullptr); // TODO: Maybe, make this more general.
+    StarObject *star = m_CatalogNumber.value(HDnum, nullptr); // TODO: Maybe, make this more general.
+#ifndef KSTARS_LITE
+    // Stars are no longer JIT-updated while drawing, so bring this one up to date here
+    if (star && star->updateID != KStarsData::Instance()->updateID())
+        star->JITupdate();
+#endif
+    return star;
 }
 
 // This uses the main star index for looking up nearby stars but then
@@ -505,19 +624,22 @@ SkyObject *DeepStarComponent::objectNearest(SkyPoint *p, double &maxrad)
 
     MeshIterator region(m_skyMesh, OBJ_NEAREST_BUF);
 
+    QMutexLocker locker(StarBlockFactory::Instance()->mutex());
+#ifndef KSTARS_LITE
+    KStarsData *data = KStarsData::Instance();
+    const SkyPointBatch batch(data->updateNum(), data->lst(), data->geo()->lat());
+#endif
+
     while (region.hasNext())
     {
         Trixel currentRegion = region.next();
         for (int i = 0; i < m_starBlockList.at(currentRegion)->getBlockCount(); ++i)
         {
             StarBlock *block = m_starBlockList.at(currentRegion)->block(i);
+#ifdef KSTARS_LITE
             for (int j = 0; j < block->getStarCount(); ++j)
             {
-#ifdef KSTARS_LITE
                 StarObject *star = &(block->star(j)->star);
-#else
-                StarObject *star = block->star(j);
-#endif
                 if (!star)
                     continue;
                 if (star->mag() > m_zoomMagLimit)
@@ -530,6 +652,28 @@ SkyObject *DeepStarComponent::objectNearest(SkyPoint *p, double &maxrad)
                     maxrad = r;
                 }
             }
+#else
+            // Search the packed coordinates, and only initialize the StarObject of the winner
+            int nStars = block->starsToMag(m_zoomMagLimit);
+            int jBest  = -1;
+            SkyPoint candidate;
+            block->updateCoords(nStars, batch);
+            for (int j = 0; j < nStars; ++j)
+            {
+                block->position(j, candidate);
+                double r = candidate.angularDistanceTo(p).Degrees();
+                if (r < maxrad)
+                {
+                    jBest  = j;
+                    maxrad = r;
+                }
+            }
+            if (jBest >= 0)
+            {
+                oBest = block->star(jBest);
+                oBest->JITupdate();
+            }
+#endif
         }
     }
 
@@ -565,6 +709,12 @@ bool DeepStarComponent::starsInAperture(QList<StarObject *> &list, const SkyPoin
     if (maglim < -28)
         maglim = m_FaintMagnitude;
 
+    QMutexLocker locker(StarBlockFactory::Instance()->mutex());
+#ifndef KSTARS_LITE
+    KStarsData *data = KStarsData::Instance();
+    const SkyPointBatch batch(data->updateNum(), data->lst(), data->geo()->lat());
+#endif
+
     while (region.hasNext())
     {
         Trixel currentRegion = region.next();
@@ -575,18 +725,31 @@ bool DeepStarComponent::starsInAperture(QList<StarObject *> &list, const SkyPoin
         for (int i = 0; i < sbl->getBlockCount(); ++i)
         {
             StarBlock *block = sbl->block(i);
+#ifdef KSTARS_LITE
             for (int j = 0; j < block->getStarCount(); ++j)
             {
-#ifdef KSTARS_LITE
                 StarObject *star = &(block->star(j)->star);
-#else
-                StarObject *star = block->star(j);
-#endif
                 if (star->mag() > maglim)
                     break; // Stars are organized by magnitude, so this should work
                 if (star->angularDistanceTo(&center).Degrees() <= radius)
                     list.append(star);
             }
+#else
+            // Stars are organized by magnitude, so only the first nStars can be brighter than maglim
+            int nStars = block->starsToMag(maglim);
+            SkyPoint candidate;
+            block->updateCoords(nStars, batch);
+            for (int j = 0; j < nStars; ++j)
+            {
+                block->position(j, candidate);
+                if (candidate.angularDistanceTo(&center).Degrees() <= radius)
+                {
+                    StarObject *star = block->star(j);
+                    star->JITupdate();
+                    list.append(star);
+                }
+            }
+#endif
         }
     }
 
@@ -619,6 +782,8 @@ bool DeepStarComponent::verifySBLIntegrity()
 {
     float faintMag = -5.0;
     bool integrity = true;
+
+    QMutexLocker locker(StarBlockFactory::Instance()->mutex());
     for (Trixel trixel = 0; trixel < (unsigned int)m_skyMesh->size(); ++trixel)
     {
         for (int i = 0; i < m_starBlockList[trixel]->getBlockCount(); ++i)
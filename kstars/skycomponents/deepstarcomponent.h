@@ -32,11 +32,15 @@
 #include "starblockfactory.h"
 #include "skyobjects/deepstardata.h"
 #include "skyobjects/stardata.h"
+#include "skyobjects/skypoint.h"
+
+#include <memory>
 
 class SkyLabeler;
 class SkyMesh;
 class StarBlockFactory;
 class StarBlockList;
+class StarBlockLoader;
 class StarObject;
 
 class DeepStarComponent : public ListComponent
@@ -85,10 +89,45 @@ class DeepStarComponent : public ListComponent
 
     inline bool fileOpen() const { return fileOpened; }
 
+    /** @return time spent by the last draw() loading star blocks, in ms */
+    inline unsigned long dynamicLoadTime() const { return t_dynamicLoad; }
+
+    /** @return time spent by the last draw() marking the star blocks used in the LRU cache, in ms */
+    inline unsigned long updateCacheTime() const { return t_updateCache; }
+
+    /** @return time spent by the last draw() drawing the stars, in ms */
+    inline unsigned long drawUnnamedTime() const { return t_drawUnnamed; }
+
+    /** @return number of stars drawn by the last draw() */
+    inline unsigned long visibleStars() const { return visibleStarCount; }
+
     inline BinFileHelper *getStarReader() { return &starReader; }
 
+    /**
+     * @return the StarBlockList of the given trixel, or nullptr if the trixel is out of range
+     */
+    inline StarBlockList *starBlockList(Trixel trixel) const { return m_starBlockList.value(trixel, nullptr); }
+
     bool verifySBLIntegrity();
 
+    /**
+     * @short Load the star blocks of the drawn trixels on the calling thread, before drawing them
+     *
+     * draw() normally leaves the loading to the background loader and draws what is resident, so
+     * one-shot renders such as image export and printing set this to miss no stars.
+     */
+    static void setSynchronousLoading(bool synchronous) { m_SynchronousLoading = synchronous; }
+
+    /** @return true if draw() loads the star blocks it needs before drawing them */
+    static bool synchronousLoading() { return m_SynchronousLoading; }
+
+    /**
+     * @short Wait for the background loader to fill the trixels queued so far
+     *
+     * The sky map is only redrawn with the loaded stars once the event loop has run.
+     */
+    void waitForLoading();
+
     /**
      * @short Add to the given list, the stars from this component,
      * that lie within the specified circular aperture, and that are
@@ -113,6 +152,21 @@ class DeepStarComponent : public ListComponent
     static StarBlockFactory m_StarBlockFactory;
 
   private:
+    /**
+     * @short Queue the trixels of the current view that still need stars, plus those we are
+     * likely to need next, with the background loader
+     * @param focus Current focus of the sky map
+     * @param radius Radius of the current view in degrees
+     * @param maglim Magnitude limit to load stars to
+     * @param trixels Trixels of the current view that need filling. Prefetch trixels are appended.
+     */
+    void requestTrixels(SkyPoint *focus, float radius, float maglim, QVector<Trixel> &trixels);
+
+    /**
+     * @return true if the given trixel has stars on disk that are not yet loaded down to maglim
+     */
+    bool needsFill(Trixel trixel, float maglim);
+
     SkyMesh *m_skyMesh { nullptr };
     KSNumbers m_reindexNum;
 
@@ -139,4 +193,10 @@ class DeepStarComponent : public ListComponent
     starData stardata;
     BinFileHelper starReader;
     QString dataFileName;
+
+    // Background loading of dynamic stars. Only used when the catalog is memory-mapped.
+    std::unique_ptr<StarBlockLoader> m_loader;
+    SkyPoint m_lastFocus;
+    bool m_lastFocusValid { false };
+    static bool m_SynchronousLoading;
 };
@@ -40,6 +40,7 @@
 #include "skymap.h"
 #endif
 #include "skypainter.h"
+#include "skyobjects/skypointbatch.h"
 #include "htmesh/MeshIterator.h"
 
 LineListIndex::LineListIndex(SkyComposite *parent, const QString &name) : SkyComponent(parent), m_name(name)
@@ -154,20 +155,16 @@ void LineListIndex::JITupdate(LineList *lineList)
     lineList->updateID = data->updateID();
     SkyList *points    = lineList->points();
 
+    SkyPointBatch batch(data->lst(), data->geo()->lat());
+
     if (lineList->updateNumID != data->updateNumID())
     {
         lineList->updateNumID = data->updateNumID();
-        KSNumbers *num        = data->updateNum();
-        for (int i = 0; i < points->size(); i++)
-        {
-            points->at(i)->updateCoords(num);
-        }
+        batch.setEpoch(data->updateNum());
+        batch.updateCoords(*points);
     }
 
-    for (int i = 0; i < points->size(); i++)
-    {
-        points->at(i)->EquatorialToHorizontal(data->lst(), data->geo()->lat());
-    }
+    batch.EquatorialToHorizontal(*points);
 }
 
 // This is a callback used in draw() below
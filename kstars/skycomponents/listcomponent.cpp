@@ -20,6 +20,7 @@
 #include "kstarsdata.h"
 #ifndef KSTARS_LITE
 #include "skymap.h"
+#include "skyobjects/skypointbatch.h"
 #endif
 
 ListComponent::ListComponent(SkyComposite *parent) : SkyComponent(parent)
@@ -48,12 +49,13 @@ void ListComponent::update(KSNumbers *num)
     if (!selected())
         return;
     KStarsData *data = KStarsData::Instance();
-    foreach (SkyObject *o, m_ObjectList)
+    // updateCoords() is virtual, so only the conversion to horizontal coordinates is done in a batch
+    if (num)
     {
-        if (num)
+        foreach (SkyObject *o, m_ObjectList)
             o->updateCoords(num);
-        o->EquatorialToHorizontal(data->lst(), data->geo()->lat());
     }
+    SkyPointBatch(data->lst(), data->geo()->lat()).EquatorialToHorizontal(m_ObjectList);
 }
 
 SkyObject *ListComponent::findByName(const QString &name)
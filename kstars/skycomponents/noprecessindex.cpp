@@ -18,6 +18,7 @@
 #include "noprecessindex.h"
 #include "Options.h"
 #include "skyobjects/skypoint.h"
+#include "skyobjects/skypointbatch.h"
 #include "kstarsdata.h"
 #include "linelist.h"
 
@@ -30,9 +31,5 @@ void NoPrecessIndex::JITupdate(LineList *lineList)
 {
     KStarsData *data   = KStarsData::Instance();
     lineList->updateID = data->updateID();
-    SkyList *points    = lineList->points();
-    for (int i = 0; i < points->size(); i++)
-    {
-        points->at(i)->EquatorialToHorizontal(data->lst(), data->geo()->lat());
-    }
+    SkyPointBatch(data->lst(), data->geo()->lat()).EquatorialToHorizontal(*lineList->points());
 }
@@ -0,0 +1,345 @@
+/***************************************************************************
+                orbitalelementstore.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "orbitalelementstore.h"
+
+#include "ksutils.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+
+#include <cstring>
+
+namespace
+{
+// Header of the cache, followed by the fields that are not skipped, in the order of the sequence, in native byte
+// order. A number field is an array of doubles. A text field is an array of rows + 1 offsets, then the bytes of
+// its rows, padded to 8 bytes.
+const quint32 CacheMagic   = 0x4f524245; // "ORBE"
+const quint32 CacheVersion = 1;
+const char CommentChar     = '#';
+const char Delimiter       = ',';
+
+struct CacheHeader
+{
+    quint32 magic;
+    quint32 version;
+    // Size and modification time of the data file, in ms since the epoch
+    qint64 sourceSize;
+    qint64 sourceModified;
+    quint32 rows;
+    quint32 fields;
+    quint32 signature;
+    quint32 reserved;
+};
+
+qint64 padded(qint64 size)
+{
+    return (size + 7) & ~qint64(7);
+}
+}
+
+OrbitalElementStore::OrbitalElementStore(const Sequence &sequence)
+    : m_Sequence(sequence), m_Offsets(sequence.size(), -1), m_TextOffsets(sequence.size(), -1)
+{
+}
+
+OrbitalElementStore::~OrbitalElementStore()
+{
+    clear();
+}
+
+void OrbitalElementStore::clear()
+{
+    if (isMapped())
+        m_Cache.unmap(const_cast<uchar *>(m_Data));
+    m_Cache.close();
+    m_Image.clear();
+
+    m_Data = nullptr;
+    m_Rows = 0;
+    m_Offsets.fill(-1);
+    m_TextOffsets.fill(-1);
+}
+
+bool OrbitalElementStore::load(const QString &fileName, const QString &cacheName)
+{
+    clear();
+
+    QFileInfo info(fileName);
+    if (!info.isReadable())
+    {
+        qWarning() << "Unable to open file: " << fileName;
+        return false;
+    }
+
+    m_SourceSize     = info.size();
+    m_SourceModified = info.lastModified().toMSecsSinceEpoch();
+
+    if (readCache(cacheName))
+        return true;
+
+    QByteArray image;
+    if (!parse(fileName, image))
+        return false;
+
+    writeCache(cacheName, image);
+    if (readCache(cacheName))
+        return true;
+
+    // The cache could not be written, the columns are kept in memory
+    m_Image = image;
+    return setImage(reinterpret_cast<const uchar *>(m_Image.constData()), m_Image.size());
+}
+
+QByteArray OrbitalElementStore::rawText(int row, int field) const
+{
+    const quint32 *offsets = reinterpret_cast<const quint32 *>(m_Data + m_Offsets[field]);
+    const char *bytes      = reinterpret_cast<const char *>(m_Data + m_TextOffsets[field]);
+
+    return QByteArray::fromRawData(bytes + offsets[row], offsets[row + 1] - offsets[row]);
+}
+
+bool OrbitalElementStore::splitLine(const char *line, int length, QVector<QByteArray> &fields)
+{
+    fields.clear();
+
+    int pos = 0;
+    while (true)
+    {
+        if (pos < length && line[pos] == '"')
+        {
+            // A quoted field ends at the first quote followed by a delimiter or the end of the line
+            int end = pos + 1;
+            while (end < length && !(line[end] == '"' && (end + 1 == length || line[end + 1] == Delimiter)))
+                end++;
+
+            fields.append(QByteArray(line + pos + 1, end - pos - 1));
+            pos = end + 1;
+        }
+        else
+        {
+            const char *next = static_cast<const char *>(memchr(line + pos, Delimiter, length - pos));
+            int end          = next ? next - line : length;
+
+            fields.append(QByteArray(line + pos, end - pos));
+            pos = end;
+        }
+
+        if (pos >= length)
+            break;
+        // Skip the delimiter
+        pos++;
+        if (pos == length)
+        {
+            fields.append(QByteArray());
+            break;
+        }
+    }
+
+    return fields.size() > 1;
+}
+
+bool OrbitalElementStore::parse(const QString &fileName, QByteArray &image) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Unable to open file: " << fileName;
+        return false;
+    }
+
+    QByteArray contents;
+    const char *text = reinterpret_cast<const char *>(file.map(0, file.size()));
+    if (text == nullptr)
+    {
+        contents = file.readAll();
+        text     = contents.constData();
+    }
+    const qint64 size = file.size();
+
+    const int fieldCount = m_Sequence.size();
+    QVector<QVector<double>> numbers(fieldCount);
+    QVector<QVector<quint32>> offsets(fieldCount, QVector<quint32>(1, 0));
+    QVector<QByteArray> bytes(fieldCount);
+    QVector<QByteArray> fields;
+    int rows = 0;
+
+    for (qint64 start = 0; start < size;)
+    {
+        const char *newLine = static_cast<const char *>(memchr(text + start, '\n', size - start));
+        qint64 end          = newLine ? newLine - text : size;
+        const qint64 next   = end + 1;
+        if (end > start && text[end - 1] == '\r')
+            end--;
+
+        const char *line = text + start;
+        const int length = end - start;
+        start            = next;
+
+        // Incomplete rows are skipped, as KSParser does
+        if (length == 0 || line[0] == CommentChar || !splitLine(line, length, fields) || fields.size() != fieldCount)
+            continue;
+
+        for (int i = 0; i < fieldCount; i++)
+        {
+            bool ok = true;
+            double value = 0;
+
+            switch (m_Sequence[i].second)
+            {
+                case KSParser::D_SKIP:
+                    continue;
+                case KSParser::D_QSTRING:
+                    bytes[i].append(fields[i]);
+                    offsets[i].append(bytes[i].size());
+                    continue;
+                case KSParser::D_INT:
+                    value = fields[i].trimmed().toInt(&ok);
+                    break;
+                case KSParser::D_FLOAT:
+                    value = fields[i].trimmed().toFloat(&ok);
+                    break;
+                case KSParser::D_DOUBLE:
+                    value = fields[i].trimmed().toDouble(&ok);
+                    break;
+            }
+            numbers[i].append(ok ? value : 0);
+        }
+        rows++;
+    }
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(CacheHeader));
+    header.magic          = CacheMagic;
+    header.version        = CacheVersion;
+    header.sourceSize     = m_SourceSize;
+    header.sourceModified = m_SourceModified;
+    header.rows           = rows;
+    header.fields         = fieldCount;
+    header.signature      = signature();
+
+    image.clear();
+    image.append(reinterpret_cast<const char *>(&header), sizeof(CacheHeader));
+
+    for (int i = 0; i < fieldCount; i++)
+    {
+        switch (m_Sequence[i].second)
+        {
+            case KSParser::D_SKIP:
+                break;
+            case KSParser::D_QSTRING:
+                image.append(reinterpret_cast<const char *>(offsets[i].constData()), (rows + 1) * sizeof(quint32));
+                image.append(bytes[i]);
+                image.append(QByteArray(padded(image.size()) - image.size(), '\0'));
+                break;
+            default:
+                image.append(reinterpret_cast<const char *>(numbers[i].constData()), rows * sizeof(double));
+                break;
+        }
+    }
+
+    return true;
+}
+
+bool OrbitalElementStore::setImage(const uchar *image, qint64 size)
+{
+    if (size < qint64(sizeof(CacheHeader)))
+        return false;
+
+    CacheHeader header;
+    memcpy(&header, image, sizeof(CacheHeader));
+
+    if (header.magic != CacheMagic || header.version != CacheVersion || header.signature != signature() ||
+        header.fields != quint32(m_Sequence.size()) || header.sourceSize != m_SourceSize ||
+        header.sourceModified != m_SourceModified)
+        return false;
+
+    const qint64 rows = header.rows;
+    qint64 offset     = sizeof(CacheHeader);
+
+    for (int i = 0; i < m_Sequence.size(); i++)
+    {
+        switch (m_Sequence[i].second)
+        {
+            case KSParser::D_SKIP:
+                m_Offsets[i] = -1;
+                break;
+            case KSParser::D_QSTRING:
+            {
+                const qint64 textOffset = offset + (rows + 1) * qint64(sizeof(quint32));
+                if (textOffset > size)
+                    return false;
+
+                quint32 textSize = 0;
+                memcpy(&textSize, image + textOffset - sizeof(quint32), sizeof(quint32));
+
+                m_Offsets[i]     = offset;
+                m_TextOffsets[i] = textOffset;
+                offset           = padded(textOffset + textSize);
+                break;
+            }
+            default:
+                m_Offsets[i] = offset;
+                offset += rows * qint64(sizeof(double));
+                break;
+        }
+
+        if (offset > size)
+            return false;
+    }
+
+    if (offset != size)
+        return false;
+
+    m_Data = image;
+    m_Rows = rows;
+    return true;
+}
+
+bool OrbitalElementStore::readCache(const QString &cacheName)
+{
+    m_Cache.setFileName(cacheName);
+    if (!m_Cache.open(QIODevice::ReadOnly))
+        return false;
+
+    const uchar *data = m_Cache.map(0, m_Cache.size());
+    if (data == nullptr || !setImage(data, m_Cache.size()))
+    {
+        if (data != nullptr)
+            m_Cache.unmap(const_cast<uchar *>(data));
+        m_Cache.close();
+        return false;
+    }
+
+    return true;
+}
+
+void OrbitalElementStore::writeCache(const QString &cacheName, const QByteArray &image) const
+{
+    KSUtils::saveFile(cacheName, image);
+}
+
+quint32 OrbitalElementStore::signature() const
+{
+    QByteArray fields;
+    for (const QPair<QString, KSParser::DataTypes> &field : m_Sequence)
+        fields += field.first.toUtf8() + ':' + QByteArray::number(field.second) + ';';
+
+    return qChecksum(fields.constData(), fields.size());
+}
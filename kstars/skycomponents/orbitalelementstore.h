@@ -0,0 +1,109 @@
+/***************************************************************************
+                 orbitalelementstore.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include "ksparser.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+/**
+ * @class OrbitalElementStore
+ * @short Columns of a small body data file, kept in a binary cache that is mapped on later starts
+ *
+ * The CSV file is parsed once, with the rules of KSParser, into one array per column: numbers as doubles, text
+ * as UTF-8 bytes with the offset of each row. The arrays are written to a cache file, which is mapped and read in
+ * place for as long as the size and modification time of the CSV file stay the same.
+ *
+ * Components create their objects only for the rows they need, and a test over all the rows reads just the
+ * columns it uses.
+ */
+class OrbitalElementStore
+{
+  public:
+    typedef QList<QPair<QString, KSParser::DataTypes>> Sequence;
+
+    /** @param sequence names and types of the fields of a row, as for KSParser. D_SKIP fields are not stored. */
+    explicit OrbitalElementStore(const Sequence &sequence);
+
+    ~OrbitalElementStore();
+
+    /**
+     * @short Load the rows of a data file
+     * @param fileName CSV data file
+     * @param cacheName binary cache of the data file, written again if missing or out of date
+     * @return false if the data file cannot be read
+     */
+    bool load(const QString &fileName, const QString &cacheName);
+
+    void clear();
+
+    /** @return number of rows */
+    int size() const { return m_Rows; }
+
+    /** @return true if the columns are read from a mapped cache file */
+    bool isMapped() const { return m_Data != nullptr && m_Image.isEmpty(); }
+
+    /** @return the size() values of a D_INT, D_FLOAT or D_DOUBLE field, converted as KSParser does */
+    const double *numbers(int field) const
+    {
+        return reinterpret_cast<const double *>(m_Data + m_Offsets[field]);
+    }
+
+    double number(int row, int field) const { return numbers(field)[row]; }
+
+    /** @return the UTF-8 bytes of a D_QSTRING field, pointing into the store */
+    QByteArray rawText(int row, int field) const;
+
+    QString text(int row, int field) const { return QString::fromUtf8(rawText(row, field)); }
+
+  private:
+    /** @short Split a line in fields as KSParser::CombineQuoteParts() does */
+    static bool splitLine(const char *line, int length, QVector<QByteArray> &fields);
+
+    /** @short Parse the data file into the layout of the cache */
+    bool parse(const QString &fileName, QByteArray &image) const;
+
+    /** @short Point the columns to image, after checking that its size matches the header */
+    bool setImage(const uchar *image, qint64 size);
+
+    bool readCache(const QString &cacheName);
+    void writeCache(const QString &cacheName, const QByteArray &image) const;
+
+    /** @return checksum of the names and types of the fields */
+    quint32 signature() const;
+
+    Sequence m_Sequence;
+    // Source file the cache was built from
+    qint64 m_SourceSize { 0 };
+    qint64 m_SourceModified { 0 };
+
+    QFile m_Cache;
+    // Columns held in memory, when the cache file could not be mapped
+    QByteArray m_Image;
+    const uchar *m_Data { nullptr };
+    int m_Rows { 0 };
+    // Offset of the data of each field in the image, -1 for skipped fields. Text fields start with their row
+    // offsets, followed by the bytes at m_TextOffsets.
+    QVector<qint64> m_Offsets;
+    QVector<qint64> m_TextOffsets;
+};
@@ -36,6 +36,7 @@
 #include "solarsystemsinglecomponent.h"
 #include "solarsystemcomposite.h"
 #include "skylabeler.h"
+#include "skyobjectindex.h"
 #include "skypainter.h"
 
 #include "projections/projector.h"
@@ -58,6 +59,7 @@ PlanetMoonsComponent::PlanetMoonsComponent(SkyComposite *p, SolarSystemSingleCom
     {
         //        objectNames(SkyObject::MOON).append( pmoons->name(i) );
         //        objectLists(SkyObject::MOON).append( QPair<QString, const SkyObject*>(pmoons->name(i),pmoons->moon(i)) );
+        objectIndex().add(pmoons->moon(i), this);
     }
 }
 
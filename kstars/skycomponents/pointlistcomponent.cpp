@@ -19,6 +19,7 @@
 
 #include "kstarsdata.h"
 #include "skyobjects/skypoint.h"
+#include "skyobjects/skypointbatch.h"
 
 PointListComponent::PointListComponent(SkyComposite *parent) : SkyComponent(parent)
 {
@@ -34,12 +35,12 @@ void PointListComponent::update(KSNumbers *num)
         return;
 
     KStarsData *data = KStarsData::Instance();
+    SkyPointBatch batch(data->lst(), data->geo()->lat());
 
-    foreach (std::shared_ptr<SkyPoint> p, pointList())
+    if (num)
     {
-        if (num)
-            p->updateCoords(num);
-
-        p->EquatorialToHorizontal(data->lst(), data->geo()->lat());
+        batch.setEpoch(num);
+        batch.updateCoords(pointList());
     }
+    batch.EquatorialToHorizontal(pointList());
 }
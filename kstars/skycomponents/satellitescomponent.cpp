@@ -23,6 +23,7 @@
 #include "Options.h"
 #include "skylabeler.h"
 #include "skymap.h"
+#include "skyobjectindex.h"
 #include "skypainter.h"
 #include "skyobjects/satellite.h"
 
@@ -64,6 +65,7 @@ void SatellitesComponent::loadData()
 
     objectNames(SkyObject::SATELLITE).clear();
     objectLists(SkyObject::SATELLITE).clear();
+    objectIndex().remove(this);
 
     foreach (SatelliteGroup *group, m_groups)
     {
@@ -76,6 +78,7 @@ void SatellitesComponent::loadData()
                 objectNames(SkyObject::SATELLITE).append(sat->name());
                 objectLists(SkyObject::SATELLITE).append(QPair<QString, const SkyObject *>(sat->name(), sat));
                 nameHash[sat->name().toLower()] = sat;
+                objectIndex().add(sat, this, sat->name());
             }
         }
     }
@@ -92,9 +95,12 @@ void SatellitesComponent::update(KSNumbers *)
     if (!selected())
         return;
 
+    // The observer and the Sun are the same for every satellite
+    Satellite::Context context = Satellite::currentContext();
+
     foreach (SatelliteGroup *group, m_groups)
     {
-        group->updateSatellitesPos();
+        group->updateSatellitesPos(context);
     }
 }
 
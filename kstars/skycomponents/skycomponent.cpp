@@ -19,6 +19,7 @@
 
 #include "Options.h"
 #include "skycomposite.h"
+#include "skyobjectindex.h"
 #include "skyobjects/skyobject.h"
 
 SkyComponent::SkyComponent(SkyComposite *parent) : m_parent(parent)
@@ -77,6 +78,18 @@ QHash<int, QVector<QPair<QString, const SkyObject *>>> &SkyComponent::getObjectL
     return parent()->objectLists();
 }
 
+SkyObjectIndex &SkyComponent::getObjectIndex()
+{
+    if (!parent())
+    {
+        // Use a fake index if there is no parent object
+        static SkyObjectIndex temp;
+
+        return temp;
+    }
+    return parent()->objectIndex();
+}
+
 void SkyComponent::removeFromNames(const SkyObject *obj)
 {
     QStringList &names = getObjectNames()[obj->type()];
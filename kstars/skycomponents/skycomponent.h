@@ -25,6 +25,7 @@ class QString;
 class SkyObject;
 class SkyPoint;
 class SkyComposite;
+class SkyObjectIndex;
 class SkyPainter;
 
 /**
@@ -196,6 +197,9 @@ class SkyComponent
 
     inline QVector<QPair<QString, const SkyObject *>> &objectLists(int type) { return getObjectLists()[type]; }
 
+    /** @return the names SkyMapComposite::findByName() looks objects up in */
+    inline SkyObjectIndex &objectIndex() { return getObjectIndex(); }
+
   protected:
     void removeFromNames(const SkyObject *obj);
     void removeFromLists(const SkyObject *obj);
@@ -203,6 +207,7 @@ class SkyComponent
   private:
     virtual QHash<int, QStringList> &getObjectNames();
     virtual QHash<int, QVector<QPair<QString, const SkyObject *>>> &getObjectLists();
+    virtual SkyObjectIndex &getObjectIndex();
 
     // Disallow copying and assignment
     SkyComponent(const SkyComponent &);
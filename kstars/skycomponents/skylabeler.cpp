@@ -406,6 +406,47 @@ void SkyLabeler::draw(QPainter &p)
     //m_p.begin(&m_picture);
 }
 
+void SkyLabeler::flush(QPainter &p)
+{
+    QFont font = m_p.font();
+    QPen pen   = m_p.pen();
+    draw(p);
+
+    m_picture = QPicture();
+    m_p.begin(&m_picture);
+    //This works around BUG 10496 in Qt
+    m_p.drawPoint(0, 0);
+    m_p.drawPoint(m_proj->viewParams().width + 1, m_proj->viewParams().height + 1);
+    m_p.setFont(font);
+    m_p.setPen(pen);
+}
+
+LabelMarks SkyLabeler::saveMarks() const
+{
+    LabelMarks marks(qMin(screenRows.size(), m_maxY + 1));
+    for (int y = 0; y < marks.size(); y++)
+    {
+        const LabelRow *row = screenRows[y];
+        marks[y].reserve(row->size());
+        for (const LabelRun *run : *row)
+            marks[y].append(qMakePair(run->start, run->end));
+    }
+    return marks;
+}
+
+void SkyLabeler::restoreMarks(const LabelMarks &marks)
+{
+    int rows = qMin(marks.size(), qMin(screenRows.size(), m_maxY + 1));
+    for (int y = 0; y < rows; y++)
+    {
+        LabelRow *row = screenRows[y];
+        qDeleteAll(*row);
+        row->clear();
+        for (const QPair<int, int> &run : marks[y])
+            row->append(new LabelRun(run.first, run.second));
+    }
+}
+
 // We use Run Length Encoding to hold the information instead of an array of
 // chars.  This is both faster and smaller but the code is more complicated.
 //
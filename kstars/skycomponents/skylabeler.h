@@ -35,6 +35,7 @@ struct LabelRun;
 
 typedef QList<LabelRun *> LabelRow;
 typedef QVector<LabelRow *> ScreenRows;
+typedef QVector<QVector<QPair<int, int>>> LabelMarks;
 
 /**
  *@class SkyLabeler
@@ -174,6 +175,27 @@ class SkyLabeler
          */
     void draw(QPainter &p);
 
+    /**
+         * @short Draws the labels drawn so far using the given painter, the
+         * following labels are drawn by draw().  The marks of the labels
+         * drawn so far are kept.
+         * @param p the painter to draw labels with
+         */
+    void flush(QPainter &p);
+
+    /**
+         * @return the runs marked on the virtual screen so far, to be marked
+         * again by restoreMarks() when the labels are drawn from an image
+         */
+    LabelMarks saveMarks() const;
+
+    /**
+         * @short marks the runs of marks on the virtual screen, as if the
+         * labels they were saved after were drawn again.  To be called right
+         * after reset() with the same screen and zoom.
+         */
+    void restoreMarks(const LabelMarks &marks);
+
     //----- Font Setting -----//
 
     /**
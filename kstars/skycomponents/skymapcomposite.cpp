@@ -18,6 +18,7 @@
 #include "skymapcomposite.h"
 
 #include "artificialhorizoncomponent.h"
+#include "asteroidscomponent.h"
 #include "catalogcomponent.h"
 #include "constellationartcomponent.h"
 #include "constellationboundarylines.h"
@@ -57,6 +58,9 @@
 
 #include <QApplication>
 
+#include <algorithm>
+#include <limits>
+
 SkyMapComposite::SkyMapComposite(SkyComposite *parent) : SkyComposite(parent), m_reindexNum(J2000)
 {
     m_skyLabeler.reset(SkyLabeler::Instance());
@@ -239,8 +243,20 @@ void SkyMapComposite::updateMoons(KSNumbers *num )
 //should appear "behind" others should be drawn first.
 void SkyMapComposite::draw(SkyPainter *skyp)
 {
-    Q_UNUSED(skyp)
+    if (!beginDraw())
+        return;
+
+    drawReferenceLayer(skyp);
+    drawObjectLayer(skyp);
+
+    endDraw();
+}
+
+bool SkyMapComposite::beginDraw()
+{
 #ifndef KSTARS_LITE
+    lap(nullptr);
+
     SkyMap *map      = SkyMap::Instance();
     KStarsData *data = KStarsData::Instance();
 
@@ -265,7 +281,7 @@ void SkyMapComposite::draw(SkyPainter *skyp)
     if (m_skyMesh->inDraw())
     {
         printf("Warning: aborting concurrent SkyMapComposite::draw()\n");
-        return;
+        return false;
     }
 
     m_skyMesh->inDraw(true);
@@ -295,56 +311,103 @@ void SkyMapComposite::draw(SkyPainter *skyp)
             foreach (QSharedPointer<SkyObject> obj_clone, obsList)
             {
                 // Find the "original" obj
-                SkyObject *o = findByName(obj_clone->name()); // FIXME: This is sloww.... and can also fail!!!
+                SkyObject *o = findByName(obj_clone->name()); // FIXME: This can fail!!!
                 if (!o)
                     continue;
                 SkyLabeler::AddLabel(o, SkyLabeler::RUDE_LABEL);
             }
     }
 
+    lap("Setup");
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SkyMapComposite::drawReferenceLayer(SkyPainter *skyp)
+{
+    Q_UNUSED(skyp)
+#ifndef KSTARS_LITE
+    lap(nullptr);
+
     m_MilkyWay->draw(skyp);
+    lap("MilkyWay");
 
     m_EquatorialCoordinateGrid->draw(skyp);
+    lap("EquatorialCoordinateGrid");
     m_HorizontalCoordinateGrid->draw(skyp);
+    lap("HorizontalCoordinateGrid");
 
     //Draw constellation boundary lines only if we draw western constellations
     if (m_Cultures->current() == "Western")
     {
         m_CBoundLines->draw(skyp);
+        lap("ConstellationBoundaryLines");
         m_ConstellationArt->draw(skyp);
+        lap("ConstellationArt");
     }
     else if (m_Cultures->current() == "Inuit")
     {
         m_ConstellationArt->draw(skyp);
+        lap("ConstellationArt");
     }
 
     m_CLines->draw(skyp);
+    lap("ConstellationLines");
 
     m_Equator->draw(skyp);
+    lap("Equator");
 
     m_Ecliptic->draw(skyp);
+    lap("Ecliptic");
+#endif
+}
+
+void SkyMapComposite::drawObjectLayer(SkyPainter *skyp)
+{
+    Q_UNUSED(skyp)
+#ifndef KSTARS_LITE
+    SkyMap *map      = SkyMap::Instance();
+    KStarsData *data = KStarsData::Instance();
+
+    lap(nullptr);
 
     m_DeepSky->draw(skyp);
+    lap("DeepSky");
 
     m_CustomCatalogs->draw(skyp);
+    lap("CustomCatalogs");
     m_internetResolvedComponent->draw(skyp);
+    lap("InternetResolved");
     m_manualAdditionsComponent->draw(skyp);
+    lap("ManualAdditions");
 
     m_Stars->draw(skyp);
+    lap("Stars");
 
     m_SolarSystem->drawTrails(skyp);
+    lap("SolarSystemTrails");
     m_SolarSystem->draw(skyp);
+    lap("SolarSystem");
 
     m_Satellites->draw(skyp);
+    lap("Satellites");
 
     m_Supernovae->draw(skyp);
+    lap("Supernovae");
 
     map->drawObjectLabels(labelObjects());
+    lap("ObjectLabels");
 
     m_skyLabeler->drawQueuedLabels();
+    lap("QueuedLabels");
     m_CNames->draw(skyp);
+    lap("ConstellationNames");
     m_Stars->drawLabels();
+    lap("StarLabels");
     m_DeepSky->drawLabels();
+    lap("DeepSkyLabels");
 
     m_ObservingList->pen = QPen(QColor(data->colorScheme()->colorNamed("ObsListColor")), 1.);
     if (KStars::Instance() && !m_ObservingList->list)
@@ -354,17 +417,20 @@ void SkyMapComposite::draw(SkyPainter *skyp)
                 ->sessionList())); // Make sure we never delete the pointers in m_ObservingList->list!
     if (m_ObservingList)
         m_ObservingList->draw(skyp);
+    lap("ObservingList");
 
     m_Flags->draw(skyp);
+    lap("Flags");
 
     m_StarHopRouteList->pen = QPen(QColor(data->colorScheme()->colorNamed("StarHopRouteColor")), 1.);
     m_StarHopRouteList->draw(skyp);
+    lap("StarHopRoute");
 
     m_ArtificialHorizon->draw(skyp);
+    lap("ArtificialHorizon");
 
     m_Horizon->draw(skyp);
-
-    m_skyMesh->inDraw(false);
+    lap("Horizon");
 
 // DEBUG Edit. Keywords: Trixel boundaries. Currently works only in QPainter mode
 // -jbb uncomment these to see trixel outlines:
@@ -389,6 +455,51 @@ void SkyMapComposite::draw(SkyPainter *skyp)
 #endif
 }
 
+void SkyMapComposite::endDraw()
+{
+#ifndef KSTARS_LITE
+    m_skyMesh->inDraw(false);
+#endif
+}
+
+void SkyMapComposite::setDrawProfiling(bool enabled)
+{
+    m_ProfileDraw = enabled;
+    m_DrawTimes.clear();
+    // One slot per lap name, so that timing a draw does not allocate
+    if (enabled)
+        m_DrawTimes.reserve(32);
+}
+
+QHash<QString, qint64> SkyMapComposite::takeDrawTimes()
+{
+    QHash<QString, qint64> drawTimes;
+    for (QPair<const char *, qint64> &lapTime : m_DrawTimes)
+    {
+        if (lapTime.second > 0)
+            drawTimes.insert(QLatin1String(lapTime.first), lapTime.second);
+        lapTime.second = 0;
+    }
+    return drawTimes;
+}
+
+void SkyMapComposite::addLap(const char *component)
+{
+    if (component != nullptr && m_LapTimer.isValid())
+    {
+        const qint64 elapsed = m_LapTimer.nsecsElapsed();
+        auto it = std::find_if(m_DrawTimes.begin(), m_DrawTimes.end(),
+                               [component](const QPair<const char *, qint64> &lapTime) {
+                                   return qstrcmp(lapTime.first, component) == 0;
+                               });
+        if (it != m_DrawTimes.end())
+            it->second += elapsed;
+        else
+            m_DrawTimes.append(qMakePair(component, elapsed));
+    }
+    m_LapTimer.start();
+}
+
 //Select nearest object to the given skypoint, but give preference
 //to certain object types.
 //we multiply each object type's smallest angular distance by the
@@ -558,6 +669,11 @@ QHash<int, QVector<QPair<QString, const SkyObject *>>> &SkyMapComposite::getObje
     return m_ObjectLists;
 }
 
+SkyObjectIndex &SkyMapComposite::getObjectIndex()
+{
+    return m_ObjectIndex;
+}
+
 QList<SkyObject *> SkyMapComposite::findObjectsInArea(const SkyPoint &p1, const SkyPoint &p2)
 {
     const SkyRegion &region = m_skyMesh->skyRegion(p1, p2);
@@ -573,40 +689,48 @@ QList<SkyObject *> SkyMapComposite::findObjectsInArea(const SkyPoint &p1, const
 
 SkyObject *SkyMapComposite::findByName(const QString &name)
 {
-    //We search the children in an "intelligent" order (most-used
-    //object types first), in order to avoid wasting too much time
-    //looking for a match.  The most important part of this ordering
-    //is that stars should be last (because the stars list is so long)
-    SkyObject *o = 0;
-    o            = m_SolarSystem->findByName(name);
-    if (o)
-        return o;
-    o = m_DeepSky->findByName(name);
-    if (o)
-        return o;
-    o = m_CustomCatalogs->findByName(name);
-    if (o)
-        return o;
-    o = m_internetResolvedComponent->findByName(name);
-    if (o)
-        return o;
-    o = m_manualAdditionsComponent->findByName(name);
-    if (o)
-        return o;
-    o = m_CNames->findByName(name);
-    if (o)
-        return o;
-    o = m_Stars->findByName(name);
-    if (o)
-        return o;
-    o = m_Supernovae->findByName(name);
-    if (o)
-        return o;
-    o = m_Satellites->findByName(name);
+    SkyObject *o = nullptr;
+    int rank     = std::numeric_limits<int>::max();
+
+    // Of the objects with this name, the first one of the component searched first
+    const QVector<SkyObjectIndex::Entry> entries = m_ObjectIndex.find(name);
+    for (const SkyObjectIndex::Entry &entry : entries)
+    {
+        int r = searchRank(entry.owner);
+        if (r < rank)
+        {
+            o    = entry.object;
+            rank = r;
+        }
+    }
+
     if (o)
         return o;
 
-    return 0;
+    // Faint asteroids are created on demand, and then added to the index
+    if (m_SolarSystem && m_SolarSystem->asteroidsComponent())
+        return m_SolarSystem->asteroidsComponent()->createByName(name);
+
+    return nullptr;
+}
+
+int SkyMapComposite::searchRank(SkyComponent *component)
+{
+    while (component->parent() && component->parent() != this)
+        component = component->parent();
+
+    // The custom catalogs come third. They are children of this composite, though m_CustomCatalogs holds them.
+    const SkyComponent *order[] = { m_SolarSystem, m_DeepSky, nullptr, m_internetResolvedComponent,
+                                    m_manualAdditionsComponent, m_CNames, m_Stars, m_Supernovae, m_Satellites };
+    const int count = sizeof(order) / sizeof(order[0]);
+
+    for (int i = 0; i < count; i++)
+    {
+        if (order[i] != nullptr && order[i] == component)
+            return i;
+    }
+
+    return 2;
 }
 
 SkyObject *SkyMapComposite::findStarByGenetiveName(const QString name)
@@ -660,6 +784,7 @@ void SkyMapComposite::removeCustomCatalog(const QString &name)
 
         if (ccc->name() == name)
         {
+            m_ObjectIndex.remove(ccc);
             m_CustomCatalogs->removeComponent(ccc);
             return;
         }
@@ -677,6 +802,7 @@ void SkyMapComposite::reloadCLines()
     delete m_CLines;
     m_CLines = 0;
     m_CLines = new ConstellationLines(this, m_Cultures.get());
+    m_ReferenceLayerID++;
     SkyMapDrawAbstract::setDrawLock(false);
 #endif
 }
@@ -691,6 +817,7 @@ void SkyMapComposite::reloadCNames()
     //     m_CNames = new ConstellationNamesComponent( this, m_Cultures.get() );
     //     SkyMapDrawAbstract::setDrawLock( false );
     objectNames(SkyObject::CONSTELLATION).clear();
+    m_ObjectIndex.remove(m_CNames);
     delete m_CNames;
     m_CNames = new ConstellationNamesComponent(this, m_Cultures.get());
 }
@@ -703,6 +830,7 @@ void SkyMapComposite::reloadConstellationArt()
     delete m_ConstellationArt;
     m_ConstellationArt = 0;
     m_ConstellationArt = new ConstellationArtComponent(this, m_Cultures.get());
+    m_ReferenceLayerID++;
     SkyMapDrawAbstract::setDrawLock(false);
 #endif
 }
@@ -730,6 +858,10 @@ void SkyMapComposite::reloadDeepSky()
     // list really bad to delete and regenerate SkyObjects.
 
     SkyMapDrawAbstract::setDrawLock(true);
+    foreach (SkyComponent *sc, m_CustomCatalogs->components())
+        m_ObjectIndex.remove(sc);
+    m_ObjectIndex.remove(m_internetResolvedComponent);
+    m_ObjectIndex.remove(m_manualAdditionsComponent);
     m_CustomCatalogs.reset(new SkyComposite(this));
     delete m_internetResolvedComponent;
     addComponent(m_internetResolvedComponent = new SyncedCatalogComponent(this, m_internetResolvedCat, true, 0), 6);
@@ -884,6 +1016,7 @@ QString SkyMapComposite::getCultureName(int index)
 void SkyMapComposite::setCurrentCulture(QString culture)
 {
     m_Cultures->setCurrent(culture);
+    m_ReferenceLayerID++;
 }
 
 QString SkyMapComposite::currentCulture()
@@ -20,8 +20,12 @@
 #include "skycomposite.h"
 #include "ksnumbers.h"
 #include "skyobject.h"
+#include "skyobjectindex.h"
 
+#include <QElapsedTimer>
 #include <QList>
+#include <QPair>
+#include <QVector>
 
 #include <memory>
 
@@ -119,6 +123,41 @@ class SkyMapComposite : public QObject, public SkyComposite
      */
     void draw(SkyPainter *skyp) Q_DECL_OVERRIDE;
 
+    /**
+     * @short Prepare a draw cycle, draw() is made of beginDraw(), drawReferenceLayer(), drawObjectLayer() and
+     * endDraw()
+     *
+     * The reference layer may be drawn on a painter of its own, or not at all when an image of it is reused.
+     * @return false if a draw cycle is in progress already, in which case nothing is to be drawn
+     */
+    bool beginDraw();
+
+    /**
+     * @short Draw the Milky Way, the coordinate grids, the constellation boundaries, art and lines, the equator and
+     * the ecliptic, the parts of the sky map that only change with the view, the options and the culture
+     */
+    void drawReferenceLayer(SkyPainter *skyp);
+
+    /** @short Draw the objects, their labels, the flags, the target lists and the horizons */
+    void drawObjectLayer(SkyPainter *skyp);
+
+    void endDraw();
+
+    /**
+     * @return a number changed whenever the reference layer changes for another reason than a change of the view
+     * or of an option, such as a change of culture
+     */
+    quint32 referenceLayerID() const { return m_ReferenceLayerID; }
+
+    /** @short Measure the time each component takes to draw, or stop measuring. See takeDrawTimes() */
+    void setDrawProfiling(bool enabled);
+
+    /**
+     * @return the time spent drawing each component since the last call, in ns, by component. The setup of the
+     * draw cycle is counted as "Setup".
+     */
+    QHash<QString, qint64> takeDrawTimes();
+
     /**
      * @return the object nearest a given point in the sky.
      * @param p The point to find an object near
@@ -142,9 +181,12 @@ class SkyMapComposite : public QObject, public SkyComposite
      * a SkyObject whose name matches the argument.
      *
      * The objects' primary, secondary and long-form names will
-     * all be checked for a match.
-     * @note Overloaded from SkyComposite.  In this version, we search
-     * the most likely object classes first to be more efficient.
+     * all be checked for a match, as well as the genetive names of stars.
+     * @note Overloaded from SkyComposite.  In this version, the name is
+     * looked up in the index the components fill as they load. An object
+     * found in several components is taken from the first one of the solar
+     * system, deep sky objects, custom catalogs, constellation names, stars,
+     * supernovae and satellites.
      * @p name the name to be matched
      * @return a pointer to the SkyObject whose name matches
      * the argument, or a nullptr pointer if no match was found.
@@ -235,6 +277,18 @@ class SkyMapComposite : public QObject, public SkyComposite
   private:
     QHash<int, QStringList> &getObjectNames() Q_DECL_OVERRIDE;
     QHash<int, QVector<QPair<QString, const SkyObject *>>> &getObjectLists() Q_DECL_OVERRIDE;
+    SkyObjectIndex &getObjectIndex() Q_DECL_OVERRIDE;
+
+    /** @return order in which findByName() prefers the objects of component */
+    int searchRank(SkyComponent *component);
+
+    /** @short Count the time since the last lap as drawing component, or only restart the lap if it is nullptr */
+    inline void lap(const char *component)
+    {
+        if (m_ProfileDraw)
+            addLap(component);
+    }
+    void addLap(const char *component);
 
     std::unique_ptr<CultureList> m_Cultures;
     ConstellationBoundaryLines *m_CBoundLines { nullptr };
@@ -266,12 +320,19 @@ class SkyMapComposite : public QObject, public SkyComposite
     std::unique_ptr<SkyLabeler> m_skyLabeler;
 
     KSNumbers m_reindexNum;
+    quint32 m_ReferenceLayerID { 0 };
+
+    bool m_ProfileDraw { false };
+    QElapsedTimer m_LapTimer;
+    // Time of each lap name since the last takeDrawTimes(), names are string literals
+    QVector<QPair<const char *, qint64>> m_DrawTimes;
 
     QList<DeepStarComponent *> m_DeepStars;
 
     QList<SkyObject *> m_LabeledObjects;
     QHash<int, QStringList> m_ObjectNames;
     QHash<int, QVector<QPair<QString, const SkyObject *>>> m_ObjectLists;
+    SkyObjectIndex m_ObjectIndex;
     QHash<QString, QString> m_ConstellationNames;
     QString m_internetResolvedCat; // Holds the name of the internet resolved catalog
     QString m_manualAdditionsCat;
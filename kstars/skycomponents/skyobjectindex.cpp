@@ -0,0 +1,105 @@
+/***************************************************************************
+                   skyobjectindex.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "skyobjectindex.h"
+
+#include "skyobjects/skyobject.h"
+
+#include <QSet>
+
+#include <algorithm>
+
+void SkyObjectIndex::add(SkyObject *obj, SkyComponent *owner)
+{
+    add(obj, owner, obj->name());
+    add(obj, owner, obj->longname());
+    add(obj, owner, obj->name2());
+}
+
+void SkyObjectIndex::add(SkyObject *obj, SkyComponent *owner, const QString &name)
+{
+    if (name.isEmpty())
+        return;
+
+    QVector<Entry> &entries = m_Entries[key(name)];
+
+    // The names of an object, added one after the other, often differ only by case or are the same
+    if (!entries.isEmpty() && entries.last().object == obj && entries.last().owner == owner)
+        return;
+
+    if (entries.isEmpty())
+        m_SortedKeys.clear();
+    entries.append({ obj, owner });
+}
+
+void SkyObjectIndex::remove(const SkyComponent *owner)
+{
+    for (auto it = m_Entries.begin(); it != m_Entries.end();)
+    {
+        QVector<Entry> &entries = it.value();
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [owner](const Entry &entry) { return entry.owner == owner; }),
+                      entries.end());
+
+        if (entries.isEmpty())
+        {
+            it = m_Entries.erase(it);
+            m_SortedKeys.clear();
+        }
+        else
+            ++it;
+    }
+}
+
+void SkyObjectIndex::clear()
+{
+    m_Entries.clear();
+    m_SortedKeys.clear();
+}
+
+QList<SkyObject *> SkyObjectIndex::findByPrefix(const QString &prefix, int limit) const
+{
+    if (m_SortedKeys.isEmpty() && !m_Entries.isEmpty())
+    {
+        m_SortedKeys.reserve(m_Entries.size());
+        for (auto it = m_Entries.constBegin(); it != m_Entries.constEnd(); ++it)
+            m_SortedKeys.append(it.key());
+        std::sort(m_SortedKeys.begin(), m_SortedKeys.end());
+    }
+
+    const QString start = key(prefix);
+    QList<SkyObject *> objects;
+    QSet<const SkyObject *> found;
+
+    for (auto it = std::lower_bound(m_SortedKeys.constBegin(), m_SortedKeys.constEnd(), start);
+         it != m_SortedKeys.constEnd() && it->startsWith(start); ++it)
+    {
+        const QVector<Entry> entries = m_Entries.value(*it);
+        for (const Entry &entry : entries)
+        {
+            if (found.contains(entry.object))
+                continue;
+            if (limit >= 0 && objects.size() >= limit)
+                return objects;
+
+            found.insert(entry.object);
+            objects.append(entry.object);
+        }
+    }
+
+    return objects;
+}
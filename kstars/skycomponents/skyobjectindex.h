@@ -0,0 +1,79 @@
+/***************************************************************************
+                    skyobjectindex.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+class SkyComponent;
+class SkyObject;
+
+/**
+ * @class SkyObjectIndex
+ * @short Names of the objects of all the sky components, for lookups by name
+ *
+ * Components add their objects as they load them, under the name, long name and secondary name of each object
+ * and any other names they are known by, such as the genetive names of stars. Names are compared case folded,
+ * so an exact lookup is a single hash lookup. A sorted copy of the names is built on the first prefix search
+ * after a change.
+ *
+ * Each entry remembers the component that added it, which removes its entries before deleting its objects.
+ */
+class SkyObjectIndex
+{
+  public:
+    struct Entry
+    {
+        SkyObject *object;
+        SkyComponent *owner;
+    };
+
+    /** @short Add obj under its name, long name and secondary name */
+    void add(SkyObject *obj, SkyComponent *owner);
+
+    /** @short Add obj under name, ignored if empty */
+    void add(SkyObject *obj, SkyComponent *owner, const QString &name);
+
+    /** @short Remove the entries added by owner */
+    void remove(const SkyComponent *owner);
+
+    void clear();
+
+    /** @return the objects named name, ignoring case, in the order they were added */
+    QVector<Entry> find(const QString &name) const { return m_Entries.value(key(name)); }
+
+    /**
+     * @return the objects having a name that starts with prefix, ignoring case, in the order of their names. An
+     * object is returned once.
+     * @param limit largest number of objects returned, or -1 for all of them
+     */
+    QList<SkyObject *> findByPrefix(const QString &prefix, int limit = -1) const;
+
+    /** @return number of distinct names */
+    int size() const { return m_Entries.size(); }
+
+    /** @return name as it is compared */
+    static QString key(const QString &name) { return name.toCaseFolded(); }
+
+  private:
+    QHash<QString, QVector<Entry>> m_Entries;
+    // Keys of m_Entries, sorted, or empty until the next prefix search
+    mutable QVector<QString> m_SortedKeys;
+};
@@ -49,6 +49,8 @@ class SolarSystemListComponent : public ListComponent
   protected:
     void drawTrails(SkyPainter *skyp) Q_DECL_OVERRIDE;
 
+    KSPlanet *earth() const { return m_Earth; }
+
   private:
     KSPlanet *m_Earth;
 };
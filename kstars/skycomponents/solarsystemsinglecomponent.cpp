@@ -18,6 +18,7 @@
 #include "solarsystemsinglecomponent.h"
 #include "solarsystemcomposite.h"
 #include "skycomponent.h"
+#include "skyobjectindex.h"
 
 #include "dms.h"
 #include "kstarsdata.h"
@@ -51,6 +52,7 @@ SolarSystemSingleComponent::SolarSystemSingleComponent(SolarSystemComposite *par
         objectNames(m_Planet->type()).append(m_Planet->longname());
         objectLists(m_Planet->type()).append(QPair<QString, const SkyObject *>(m_Planet->longname(), m_Planet));
     }
+    objectIndex().add(m_Planet, this);
 }
 
 SolarSystemSingleComponent::~SolarSystemSingleComponent()
@@ -23,6 +23,17 @@
 #include "skyobjects/stardata.h"
 #include "skyobjects/deepstardata.h"
 
+#ifndef KSTARS_LITE
+#include "kstarsdata.h"
+#include "Options.h"
+#include "skyobjects/skypointbatch.h"
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cmath>
+#endif
+
 #ifdef KSTARS_LITE
 #include "skymaplite.h"
 #include "kstarslite/skyitems/skynodes/pointsourcenode.h"
@@ -46,9 +57,21 @@ StarBlock::StarBlock(int nstars)
 #ifdef KSTARS_LITE
       stars(nstars, StarNode())
 #else
-      stars(nstars, StarObject())
+      m_Capacity(nstars)
 #endif
 {
+#ifndef KSTARS_LITE
+    m_RA0.reserve(nstars);
+    m_Dec0.reserve(nstars);
+    m_PMRA.reserve(nstars);
+    m_PMDec.reserve(nstars);
+    m_Mag.reserve(nstars);
+    m_SpType.reserve(nstars);
+    m_RA.resize(nstars);
+    m_Dec.resize(nstars);
+    m_Alt.resize(nstars);
+    m_Az.resize(nstars);
+#endif
 }
 
 void StarBlock::reset()
@@ -60,12 +83,34 @@ void StarBlock::reset()
     faintMag  = -5.0;
     brightMag = 35.0;
     nStars    = 0;
+#ifndef KSTARS_LITE
+    m_StarData.clear();
+    m_DeepStarData.clear();
+    // Keep the StarObjects around for reuse, as pointers to them may still be held elsewhere
+    for (StarObject *star : m_Stars)
+        m_FreeStars.append(star);
+    m_Stars.clear();
+    m_RA0.clear();
+    m_Dec0.clear();
+    m_PMRA.clear();
+    m_PMDec.clear();
+    m_Mag.clear();
+    m_SpType.clear();
+    m_UpdateID        = 0;
+    m_UpdateNumID     = 0;
+    m_ApparentCount   = 0;
+    m_HorizontalCount = 0;
+#endif
 }
 
 StarBlock::~StarBlock()
 {
     if (parent)
         parent->releaseBlock(this);
+#ifndef KSTARS_LITE
+    qDeleteAll(m_Stars);
+    qDeleteAll(m_FreeStars);
+#endif
 }
 #ifdef KSTARS_LITE
 StarNode *StarBlock::addStar(const starData &data)
@@ -98,31 +143,180 @@ StarNode *StarBlock::addStar(const deepStarData &data)
     return &node;
 }
 #else
-StarObject *StarBlock::addStar(const starData &data)
+int StarBlock::addStar(const starData &data)
 {
     if (isFull())
-        return 0;
-    StarObject &star = stars[nStars++];
+        return -1;
 
-    star.init(&data);
-    if (star.mag() > faintMag)
-        faintMag = star.mag();
-    if (star.mag() < brightMag)
-        brightMag = star.mag();
-    return &star;
+    m_StarData.append(data);
+    m_Deep = false;
+    addPacked(StarObject::decode(&data));
+
+    return nStars - 1;
 }
 
-StarObject *StarBlock::addStar(const deepStarData &data)
+int StarBlock::addStar(const deepStarData &data)
 {
     if (isFull())
-        return 0;
-    StarObject &star = stars[nStars++];
+        return -1;
 
-    star.init(&data);
-    if (star.mag() > faintMag)
-        faintMag = star.mag();
-    if (star.mag() < brightMag)
-        brightMag = star.mag();
-    return &star;
+    m_DeepStarData.append(data);
+    m_Deep = true;
+    addPacked(StarObject::decode(&data));
+
+    return nStars - 1;
+}
+
+void StarBlock::addPacked(const StarObject::CatalogData &data)
+{
+    m_RA0.append(data.ra0 * 15.0 * dms::DegToRad);
+    m_Dec0.append(data.dec0 * dms::DegToRad);
+    m_PMRA.append(data.pmRA);
+    m_PMDec.append(data.pmDec);
+    m_Mag.append(data.mag);
+    m_SpType.append(data.spType);
+
+    if (data.mag > faintMag)
+        faintMag = data.mag;
+    if (data.mag < brightMag)
+        brightMag = data.mag;
+
+    ++nStars;
+}
+
+StarObject *StarBlock::star(int i)
+{
+    StarObject *star = m_Stars.value(i);
+    if (star)
+        return star;
+
+    star = (m_FreeStars.isEmpty() ? new StarObject : m_FreeStars.takeLast());
+    if (m_Deep)
+        star->init(&m_DeepStarData.at(i));
+    else
+        star->init(&m_StarData.at(i));
+    m_Stars.insert(i, star);
+    return star;
+}
+
+int StarBlock::starsToMag(float maglim) const
+{
+    // Stars within a block are sorted by magnitude
+    return std::upper_bound(m_Mag.constBegin(), m_Mag.constEnd(), maglim) - m_Mag.constBegin();
+}
+
+void StarBlock::position(int i, SkyPoint &p, bool equatorial) const
+{
+    dms angle;
+    angle.setRadians(m_Alt[i]);
+    p.setAlt(angle);
+    angle.setRadians(m_Az[i]);
+    p.setAz(angle);
+    if (equatorial)
+    {
+        angle.setRadians(m_RA[i]);
+        p.setRA(angle);
+        angle.setRadians(m_Dec[i]);
+        p.setDec(angle);
+    }
+}
+
+void StarBlock::updateCoords(int count, const SkyPointBatch &batch)
+{
+    KStarsData *data = KStarsData::Instance();
+
+    count = qMin(count, nStars);
+
+    if (m_UpdateNumID != data->updateNumID())
+    {
+        m_UpdateNumID = data->updateNumID();
+        // Same short-circuiting as in StarObject::JITupdate(): recompute apparent positions once per solar minute
+        if (Options::alwaysRecomputeCoordinates() || Options::useRelativistic() ||
+            std::abs(m_PrecessJD - data->updateNum()->getJD()) >= 0.00069444)
+        {
+            m_PrecessJD       = data->updateNum()->getJD();
+            m_ApparentCount   = 0;
+            m_HorizontalCount = 0;
+        }
+    }
+    if (m_UpdateID != data->updateID())
+    {
+        m_UpdateID        = data->updateID();
+        m_HorizontalCount = 0;
+    }
+
+    if (count > m_ApparentCount)
+    {
+        updateApparent(m_ApparentCount, count, batch);
+        m_ApparentCount = count;
+    }
+    if (count > m_HorizontalCount)
+    {
+        updateHorizontal(m_HorizontalCount, count, batch);
+        m_HorizontalCount = count;
+    }
+}
+
+namespace
+{
+typedef Eigen::Array<double, Eigen::Dynamic, 1, Eigen::ColMajor, SkyPointBatch::ChunkSize, 1> Chunk;
+typedef Eigen::Map<const Eigen::ArrayXd> ConstArrayMap;
+
+struct atan2Op
+{
+    double operator()(double y, double x) const { return std::atan2(y, x); }
+};
+}
+
+void StarBlock::updateApparent(int from, int to, const SkyPointBatch &batch)
+{
+    const KSNumbers *num = KStarsData::Instance()->updateNum();
+
+    // Everything that does not depend on the star is computed once per block
+    const double jm          = num->julianMillenia();
+    const double pmSign      = (jm < 0 ? -1.0 : 1.0);
+    const double arcsecToRad = dms::PI / (180.0 * 3600.0);
+
+    for (int start = from; start < to; start += SkyPointBatch::ChunkSize)
+    {
+        const int n = qMin(int(SkyPointBatch::ChunkSize), to - start);
+
+        ConstArrayMap ra0(m_RA0.constData() + start, n), dec0(m_Dec0.constData() + start, n);
+        ConstArrayMap pmRA(m_PMRA.constData() + start, n), pmDec(m_PMDec.constData() + start, n);
+
+        // Proper motion, as motion along a great circle (see StarObject::getIndexCoords()). Stars that
+        // moved by less than an arcsecond get dst = 0, which leaves them where they are.
+        Chunk pm      = (pmRA.square() + pmDec.square()).sqrt() * std::abs(jm);
+        Chunk dst     = (pm >= 1.0).select(pm * arcsecToRad, 0.0);
+        Chunk dir0    = (pmSign * pmRA).binaryExpr(pmSign * pmDec, atan2Op());
+        Chunk sinDst  = dst.sin(), cosDst = dst.cos();
+        Chunk sinDec0 = dec0.sin(), cosDec0 = dec0.cos();
+        Chunk sinLat1 = (sinDec0 * cosDst + cosDec0 * sinDst * dir0.cos()).max(-1.0).min(1.0);
+        Chunk y       = dir0.sin() * sinDst * cosDec0;
+        Chunk x       = cosDst - sinDec0 * sinLat1;
+        Chunk raPM    = ra0 + y.binaryExpr(x, atan2Op());
+        Chunk decPM   = sinLat1.asin();
+
+        // Precession, nutation and aberration
+        batch.apparentCoords(raPM.data(), decPM.data(), m_RA.data() + start, m_Dec.data() + start, n);
+    }
+
+    // Stars near the Sun need light bending. They are rare, so let StarObject handle them.
+    for (int i = from; i < to; ++i)
+    {
+        if (!batch.bendsLight(m_RA[i], m_Dec[i]))
+            continue;
+
+        StarObject *s = star(i);
+        s->JITupdate();
+        m_RA[i]  = s->ra().radians();
+        m_Dec[i] = s->dec().radians();
+    }
+}
+
+void StarBlock::updateHorizontal(int from, int to, const SkyPointBatch &batch)
+{
+    batch.toHorizontal(m_RA.constData() + from, m_Dec.constData() + from, m_Alt.data() + from, m_Az.data() + from,
+                       to - from);
 }
 #endif
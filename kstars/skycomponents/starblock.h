@@ -20,12 +20,21 @@
 
 #include "typedef.h"
 #include "starblocklist.h"
+#ifndef KSTARS_LITE
+#include "skyobjects/deepstardata.h"
+#include "skyobjects/stardata.h"
+#include "skyobjects/starobject.h"
+
+#include <QHash>
+#endif
 
 #include <QVector>
 
 class StarObject;
 class StarBlockList;
 class PointSourceNode;
+class SkyPoint;
+class SkyPointBatch;
 struct starData;
 struct deepStarData;
 
@@ -46,6 +55,12 @@ struct StarNode
  *@class StarBlock
  *Holds a block of stars and various peripheral variables to mark its place in data structures
  *
+ *On the desktop, the block keeps the catalog position, proper motion, magnitude and spectral class
+ *of its stars in packed parallel arrays, along with their apparent and horizontal coordinates.
+ *updateCoords() brings those up to date for a whole run of stars at once, which is all that is
+ *needed to draw them. A StarObject is only created for a star when star() is called, eg. when
+ *the star is picked or looked up by catalog number, so the block holds as many as were asked for.
+ *
  *@author  Akarsh Simha
  *@version 1.0
  */
@@ -56,8 +71,6 @@ class StarBlock
 // StarBlockEntry is the data type held by the StarBlock's QVector
 #ifdef KSTARS_LITE
     typedef StarNode StarBlockEntry;
-#else
-    typedef StarObject StarBlockEntry;
 #endif
 
     /** Constructor
@@ -80,9 +93,16 @@ class StarBlock
          *
          *@param  data    data to initialize star with.
          *@return pointer to star initialized with data. nullptr if block is full.
+         *@note   On the desktop, the index of the new star is returned instead (-1 if the block is full),
+         *        and the StarObject is only created once star() is called on that index.
          */
+#ifdef KSTARS_LITE
     StarBlockEntry *addStar(const starData &data);
     StarBlockEntry *addStar(const deepStarData &data);
+#else
+    int addStar(const starData &data);
+    int addStar(const deepStarData &data);
+#endif
 
     /**
          *@short Returns true if the StarBlock is full
@@ -100,7 +120,11 @@ class StarBlock
          *
          *@return The number of stars that this StarBlock can hold
          */
+#ifdef KSTARS_LITE
     inline int size() const { return stars.size(); }
+#else
+    inline int size() const { return m_Capacity; }
+#endif
 
     /**
          *@short  Return the i-th star in this StarBlock
@@ -108,14 +132,64 @@ class StarBlock
          *@param  Index of StarBlock to return
          *@return A pointer to the i-th StarObject
          */
+#ifdef KSTARS_LITE
     inline StarBlockEntry *star(int i) { return &stars[i]; }
+#else
+    /**
+         *@note   The StarObject is created on the first call for a given star, and stays valid until the
+         *        block is reset. It is then reused for another star.
+         */
+    StarObject *star(int i);
+
+    /**
+         *@short  Bring the apparent (RA, Dec) and horizontal (Alt, Az) coordinates of the first
+         *count stars up to date with the current KStarsData::updateNum(), LST and location.
+         *
+         *Proper motion is applied here, and the rest of the work is done by a SkyPointBatch. The few
+         *stars close to the Sun with relativistic corrections enabled fall back to StarObject::JITupdate().
+         *Stars that are already up to date are skipped, so this is cheap to call on every draw.
+         *@param  count  Number of stars to update, starting from the brightest
+         *@param  batch  Conversions for the current updateNum(), LST and location
+         */
+    void updateCoords(int count, const SkyPointBatch &batch);
+
+    /**
+         *@return the number of stars in this block that are not fainter than maglim
+         */
+    int starsToMag(float maglim) const;
+
+    /**
+         *@short  Copy the coordinates of the i-th star, as computed by updateCoords(), into a SkyPoint
+         *@param  i           Index of the star
+         *@param  p           SkyPoint to copy the coordinates into
+         *@param  equatorial  If false, only the horizontal coordinates are copied, which avoids trigonometry
+         */
+    void position(int i, SkyPoint &p, bool equatorial = true) const;
+
+    inline float mag(int i) const { return m_Mag[i]; }
+    inline char spchar(int i) const { return m_SpType[i]; }
+    inline double raRadians(int i) const { return m_RA[i]; }
+    inline double decRadians(int i) const { return m_Dec[i]; }
+    inline double altRadians(int i) const { return m_Alt[i]; }
+    inline double azRadians(int i) const { return m_Az[i]; }
 
+    /** Packed arrays for drawing a whole block at once, see SkyPainter::drawPointSources() */
+    inline const double *raData() const { return m_RA.constData(); }
+    inline const double *decData() const { return m_Dec.constData(); }
+    inline const double *altData() const { return m_Alt.constData(); }
+    inline const double *azData() const { return m_Az.constData(); }
+    inline const float *magData() const { return m_Mag.constData(); }
+    inline const char *spData() const { return m_SpType.constData(); }
+#endif
+
+#ifdef KSTARS_LITE
     /**
          *@return a reference to the internal container of this
          *@note This is bad -- is there a way of providing non-const access to the list's elements without allowing altering of the list alone?
          */
 
     inline QVector<StarBlockEntry> &contents() { return stars; }
+#endif
 
     // These methods are there because we might want to make faintMag and brightMag private at some point
     /**
@@ -157,8 +231,51 @@ class StarBlock
 
     /** Number of initialized stars in StarBlock. */
     int nStars;
+#ifdef KSTARS_LITE
     /** Array of stars. */
     QVector<StarBlockEntry> stars;
+#else
+    /** Number of stars this StarBlock can hold. */
+    int m_Capacity;
+
+    /**
+         *@short  Append the packed representation of a star
+         */
+    void addPacked(const StarObject::CatalogData &data);
+
+    /**
+         *@short  Compute apparent coordinates of stars [from, to)
+         */
+    void updateApparent(int from, int to, const SkyPointBatch &batch);
+
+    /**
+         *@short  Compute horizontal coordinates of stars [from, to)
+         */
+    void updateHorizontal(int from, int to, const SkyPointBatch &batch);
+
+    // Raw catalog records, used to initialize a StarObject when it is needed
+    QVector<starData> m_StarData;
+    QVector<deepStarData> m_DeepStarData;
+    bool m_Deep { false };
+    // StarObjects created by star(), by index, and those released by reset() for reuse
+    QHash<int, StarObject *> m_Stars;
+    QVector<StarObject *> m_FreeStars;
+
+    // Packed star data. Angles in radians, proper motions in milliarcseconds per year.
+    QVector<double> m_RA0, m_Dec0;
+    QVector<double> m_PMRA, m_PMDec;
+    QVector<float> m_Mag;
+    QVector<char> m_SpType;
+    QVector<double> m_RA, m_Dec;
+    QVector<double> m_Alt, m_Az;
+
+    // Bookkeeping for updateCoords()
+    UpdateID m_UpdateID { 0 };
+    UpdateID m_UpdateNumID { 0 };
+    long double m_PrecessJD { 0 };
+    int m_ApparentCount { 0 };
+    int m_HorizontalCount { 0 };
+#endif
 };
 
 #endif
@@ -34,7 +34,7 @@ StarBlockFactory *StarBlockFactory::Instance()
     return pInstance;
 }
 
-StarBlockFactory::StarBlockFactory()
+StarBlockFactory::StarBlockFactory() : m_Mutex(QMutex::Recursive)
 {
     first   = nullptr;
     last    = nullptr;
@@ -52,6 +52,8 @@ StarBlockFactory::~StarBlockFactory()
 
 StarBlock *StarBlockFactory::getBlock()
 {
+    QMutexLocker locker(&m_Mutex);
+
     StarBlock *freeBlock = nullptr;
 
     if (nBlocks < nCache)
@@ -91,6 +93,8 @@ StarBlock *StarBlockFactory::getBlock()
 
 bool StarBlockFactory::markFirst(StarBlock *block)
 {
+    QMutexLocker locker(&m_Mutex);
+
     if (!block)
         return false;
 
@@ -131,6 +135,8 @@ bool StarBlockFactory::markFirst(StarBlock *block)
 
 bool StarBlockFactory::markNext(StarBlock *after, StarBlock *block)
 {
+    QMutexLocker locker(&m_Mutex);
+
     //    fprintf(stderr, "markNext()!\n");
     if (!block || !after)
     {
@@ -243,6 +249,8 @@ bool StarBlockFactory::groupMove( StarBlock *start, const int nblocks ) {
 
 int StarBlockFactory::deleteBlocks(int nblocks)
 {
+    QMutexLocker locker(&m_Mutex);
+
     int i           = 0;
     StarBlock *temp = nullptr;
 
@@ -296,6 +304,8 @@ void StarBlockFactory::printStructure() const
 
 int StarBlockFactory::freeUnused()
 {
+    QMutexLocker locker(&m_Mutex);
+
     int i           = 0;
     StarBlock *temp = nullptr;
 
@@ -19,12 +19,18 @@
 
 #include "typedef.h"
 
+#include <QMutex>
+
 class StarBlock;
 
 /**
  * @class StarBlockFactory
  *
  * @short A factory that creates StarBlocks and recycles them in an LRU Cache
+ *
+ * The LRU cache is shared by all DeepStarComponents and may be used from the StarBlockLoader
+ * worker threads. All public methods lock mutex(); callers that need a consistent view of a
+ * StarBlockList over several calls (eg. fill, then draw) should hold mutex() themselves.
  * @author Akarsh Simha
  * @version 0.1
  */
@@ -94,6 +100,11 @@ class StarBlockFactory
      */
     void printStructure() const;
 
+    /**
+     * @short  Returns the (recursive) mutex guarding the LRU cache and the StarBlockLists that use it
+     */
+    inline QMutex *mutex() { return &m_Mutex; }
+
     quint32 drawID; // A number identifying the current draw cycle
 
   private:
@@ -114,6 +125,7 @@ class StarBlockFactory
     StarBlock *first, *last; // Pointers to the beginning and end of the linked list
     int nBlocks;             // Number of blocks we currently have in the cache
     int nCache;              // Number of blocks to start recycling cached blocks at
+    QMutex m_Mutex;          // Serializes access to the cache from the GUI and loader threads
 
     static StarBlockFactory *pInstance;
 };
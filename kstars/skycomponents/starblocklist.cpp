@@ -29,6 +29,8 @@
 
 #include <QDebug>
 
+#include <cstring>
+
 StarBlockList::StarBlockList(Trixel tr, DeepStarComponent *parent)
 {
     trixel       = tr;
@@ -114,7 +116,21 @@ bool StarBlockList::fillToMag(float maglim)
 
     Q_ASSERT(nBlocks == (unsigned int)blocks.size());
 
-    BinFileHelper::unsigned_KDE_fseek(dataFile, readOffset, SEEK_SET);
+    // If the catalog is mapped into memory, read the records straight out of the mapping. Otherwise, seek the
+    // shared file handle to where we left off.
+    const char *record = dSReader->getRecordPointer(readOffset);
+
+    if (record)
+    {
+        qint64 recordsLeft = (dSReader->getMappedSize() - readOffset) / dSReader->guessRecordSize();
+        if (qint64(dSReader->getRecordCount(trixelId) - nStars) > recordsLeft)
+        {
+            qWarning() << "ERROR: Trixel " << trixel << " extends beyond the end of the mapped catalog file";
+            return false;
+        }
+    }
+    else
+        BinFileHelper::unsigned_KDE_fseek(dataFile, readOffset, SEEK_SET);
 
     /*
     qDebug() << "Reading trixel" << trixel << ", id on disk =" << trixelId << ", currently nStars =" << nStars
@@ -146,7 +162,29 @@ bool StarBlockList::fillToMag(float maglim)
             ++nBlocks;
         }
         // TODO: Make this more general
-        if (dSReader->guessRecordSize() == 32)
+        if (record)
+        {
+            // Memory-mapped catalog: no seeking, just walk the mapping. memcpy() takes care of alignment.
+            if (dSReader->guessRecordSize() == 32)
+            {
+                memcpy(&stardata, record, sizeof(starData));
+                if (dSReader->getByteSwap())
+                    DeepStarComponent::byteSwap(&stardata);
+                record += sizeof(starData);
+                readOffset += sizeof(starData);
+                blocks[nBlocks - 1]->addStar(stardata);
+            }
+            else
+            {
+                memcpy(&deepstardata, record, sizeof(deepStarData));
+                if (dSReader->getByteSwap())
+                    DeepStarComponent::byteSwap(&deepstardata);
+                record += sizeof(deepStarData);
+                readOffset += sizeof(deepStarData);
+                blocks[nBlocks - 1]->addStar(deepstardata);
+            }
+        }
+        else if (dSReader->guessRecordSize() == 32)
         {
             ret = fread(&stardata, sizeof(starData), 1, dataFile);
             if (dSReader->getByteSwap())
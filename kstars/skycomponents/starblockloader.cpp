@@ -0,0 +1,106 @@
+/***************************************************************************
+                 starblockloader.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : Sat 14 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "starblockloader.h"
+
+#include "deepstarcomponent.h"
+#include "starblockfactory.h"
+#include "starblocklist.h"
+
+#include <QtConcurrent>
+
+StarBlockLoader::StarBlockLoader(DeepStarComponent *parent) : m_Parent(parent)
+{
+    m_Pool.setMaxThreadCount(1);
+}
+
+StarBlockLoader::~StarBlockLoader()
+{
+    cancel();
+}
+
+void StarBlockLoader::request(const QVector<Trixel> &trixels, float maglim)
+{
+    QMutexLocker locker(&m_QueueMutex);
+
+    m_Queue    = trixels;
+    m_MagLimit = maglim;
+
+    if (m_Queue.isEmpty() || m_Running)
+        return;
+
+    m_Running = true;
+    m_Future  = QtConcurrent::run(&m_Pool, this, &StarBlockLoader::run);
+}
+
+void StarBlockLoader::cancel()
+{
+    {
+        QMutexLocker locker(&m_QueueMutex);
+        m_Queue.clear();
+    }
+    m_Future.waitForFinished();
+}
+
+void StarBlockLoader::waitForFinished()
+{
+    // The worker only stops once the queue is empty, requests made in the meantime included
+    m_Future.waitForFinished();
+}
+
+bool StarBlockLoader::isBusy()
+{
+    QMutexLocker locker(&m_QueueMutex);
+    return m_Running;
+}
+
+void StarBlockLoader::run()
+{
+    StarBlockFactory *SBFactory = StarBlockFactory::Instance();
+    bool loaded                 = false;
+
+    forever
+    {
+        Trixel trixel;
+        float maglim;
+
+        {
+            QMutexLocker locker(&m_QueueMutex);
+            if (m_Queue.isEmpty())
+            {
+                // Cleared under the same lock request() checks, so no request can slip through
+                m_Running = false;
+                break;
+            }
+            trixel = m_Queue.takeFirst();
+            maglim = m_MagLimit;
+        }
+
+        QMutexLocker locker(SBFactory->mutex());
+        StarBlockList *sbl = m_Parent->starBlockList(trixel);
+        if (!sbl || sbl->getFaintMag() >= maglim)
+            continue;
+
+        long nStars = sbl->getStarCount();
+        sbl->fillToMag(maglim);
+        if (sbl->getStarCount() != nStars)
+            loaded = true;
+    }
+
+    if (loaded)
+        emit blocksLoaded();
+}
@@ -0,0 +1,104 @@
+/***************************************************************************
+                  starblockloader.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : Sat 14 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include "typedef.h"
+
+#include <QFuture>
+#include <QMutex>
+#include <QObject>
+#include <QThreadPool>
+#include <QVector>
+
+class DeepStarComponent;
+
+/**
+ * @class StarBlockLoader
+ * Fills the StarBlockLists of a DeepStarComponent on a worker thread.
+ *
+ * DeepStarComponent::draw() queues the trixels it is about to draw, followed by the trixels
+ * it expects to need next, and then draws whatever blocks are already resident. Every time the
+ * worker has drained the queue, blocksLoaded() is emitted so that the sky map can be redrawn.
+ *
+ * @note The worker holds StarBlockFactory::mutex() while it fills a trixel, so anyone who
+ * walks or modifies StarBlockLists while the loader may be running must hold it too.
+ *
+ * @version 0.1
+ */
+class StarBlockLoader : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit StarBlockLoader(DeepStarComponent *parent);
+
+    /**
+     * Destructor. Waits for the worker to finish the trixel it is currently filling.
+     */
+    virtual ~StarBlockLoader();
+
+    /**
+     * @short Replace the pending requests with a new set of trixels
+     *
+     * Trixels that were queued earlier but not filled yet are dropped, since the view has
+     * moved on. Trixels are filled in the order given.
+     *
+     * @param trixels Trixels to fill, most urgent first
+     * @param maglim Magnitude limit to fill the trixels to
+     */
+    void request(const QVector<Trixel> &trixels, float maglim);
+
+    /**
+     * @short Drop all pending requests and wait for the worker to become idle
+     */
+    void cancel();
+
+    /**
+     * @short Wait for the worker to fill the trixels queued so far
+     *
+     * blocksLoaded() is emitted before this returns, its queued connections are run by the event loop.
+     */
+    void waitForFinished();
+
+    /**
+     * @return true if there are requests that have not been served yet
+     */
+    bool isBusy();
+
+  signals:
+    /**
+     * Emitted from the worker thread once it has filled all queued trixels and at
+     * least one of them received new stars.
+     */
+    void blocksLoaded();
+
+  private:
+    /**
+     * @short Worker loop. Pops trixels off the queue until it is empty.
+     */
+    void run();
+
+    DeepStarComponent *m_Parent { nullptr };
+    QMutex m_QueueMutex;
+    QVector<Trixel> m_Queue;
+    float m_MagLimit { 0 };
+    bool m_Running { false };
+    // Private pool with a single thread, so the loader never competes with the JIT update map in draw()
+    QThreadPool m_Pool;
+    QFuture<void> m_Future;
+};
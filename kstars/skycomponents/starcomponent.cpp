@@ -26,6 +26,7 @@
 #include "skylabeler.h"
 #include "skymap.h"
 #include "skymesh.h"
+#include "skyobjectindex.h"
 #ifndef KSTARS_LITE
 #include "skyqpainter.h"
 #endif
@@ -34,6 +35,8 @@
 
 #include <qplatformdefs.h>
 
+#include <cstring>
+
 #ifdef _WIN32
 #include <windows.h>
 #endif
@@ -549,6 +552,8 @@ bool StarComponent::loadStaticData()
             }
 
             m_ObjectList.append(star);
+            objectIndex().add(star, this);
+            objectIndex().add(star, this, star->gname(false));
 
             m_starIndex->at(trixel)->append(star);
             double pm = star->pmMagnitude();
@@ -581,16 +586,14 @@ SkyObject *StarComponent::findStarByGenetiveName(const QString name)
     return m_genName.value(name);
 }
 
-// Overrides ListComponent::findByName() to include genetive name and HD index also in the search
+// Overrides ListComponent::findByName() to include genetive name also in the search
 SkyObject *StarComponent::findByName(const QString &name)
 {
-    foreach (SkyObject *o, m_ObjectList)
+    const QVector<SkyObjectIndex::Entry> entries = objectIndex().find(name);
+    for (const SkyObjectIndex::Entry &entry : entries)
     {
-        if (QString::compare(o->name(), name, Qt::CaseInsensitive) == 0 ||
-            QString::compare(o->longname(), name, Qt::CaseInsensitive) == 0 ||
-            QString::compare(o->name2(), name, Qt::CaseInsensitive) == 0 ||
-            QString::compare(((StarObject *)o)->gname(false), name, Qt::CaseInsensitive) == 0)
-            return o;
+        if (entry.owner == this)
+            return entry.object;
     }
     return 0;
 }
@@ -636,10 +639,19 @@ StarObject *StarComponent::findByHDIndex(int HDnum)
         ret = fread(&offset, 4, 1, hdidxFile);
         if (offset <= 0)
             return 0;
-        dataFile = m_DeepStarComponents.at(1)->getStarReader()->getFileHandle();
-        //KDE_fseek( dataFile, offset, SEEK_SET );
-        QT_FSEEK(dataFile, offset, SEEK_SET);
-        ret = fread(&stardata, sizeof(starData), 1, dataFile);
+        BinFileHelper *dataReader = m_DeepStarComponents.at(1)->getStarReader();
+        const char *record        = dataReader->getRecordPointer(offset);
+        if (record && offset + qint64(sizeof(starData)) <= dataReader->getMappedSize())
+        {
+            memcpy(&stardata, record, sizeof(starData));
+        }
+        else
+        {
+            dataFile = dataReader->getFileHandle();
+            //KDE_fseek( dataFile, offset, SEEK_SET );
+            QT_FSEEK(dataFile, offset, SEEK_SET);
+            ret = fread(&stardata, sizeof(starData), 1, dataFile);
+        }
         if (m_DeepStarComponents.at(1)->getStarReader()->getByteSwap())
         {
             byteSwap(&stardata);
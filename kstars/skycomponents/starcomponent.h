@@ -135,6 +135,9 @@ class StarComponent : public ListComponent
      */
     void starsInAperture(QList<StarObject *> &list, const SkyPoint &center, float radius, float maglim = -29);
 
+    /** @return the catalogs of unnamed stars, drawn after the named stars */
+    const QVector<DeepStarComponent *> &deepStarComponents() const { return m_DeepStarComponents; }
+
     // TODO: Make byteSwap a template method and put it in byteorder.h
     // It should ideally handle 32-bit, 16-bit fields and starData and
     // deepStarData fields
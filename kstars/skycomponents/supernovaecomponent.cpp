@@ -23,6 +23,7 @@
 #include "skypainter.h"
 #include "skymesh.h"
 #include "skylabeler.h"
+#include "skyobjectindex.h"
 #include "projections/projector.h"
 #include "dms.h"
 #include "Options.h"
@@ -69,6 +70,7 @@ void SupernovaeComponent::loadData()
 
     objectNames(SkyObject::SUPERNOVA).clear();
     objectLists(SkyObject::SUPERNOVA).clear();
+    objectIndex().remove(this);
 
     QString name, type, host, date, ra, de;
     float z, mag;
@@ -139,6 +141,7 @@ void SupernovaeComponent::loadData()
 
         m_ObjectList.append(sup);
         objectLists(SkyObject::SUPERNOVA).append(QPair<QString, const SkyObject *>(name, sup));
+        objectIndex().add(sup, this, name);
     }
 }
 
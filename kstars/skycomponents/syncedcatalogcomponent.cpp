@@ -21,6 +21,7 @@
 #include "deepskyobject.h"
 #include "Options.h"
 #include "catalogdata.h"
+#include "skyobjectindex.h"
 
 /* KDE Includes */
 
@@ -109,6 +110,8 @@ DeepSkyObject *SyncedCatalogComponent::addObject(CatalogEntryData catalogEntry)
         objectLists()[newObj->type()].append(QPair<QString, const SkyObject *>(newObj->name(), newObj));
     }
     m_ObjectList.append(newObj);
+    objectIndex().add(newObj, this);
+    appendIndex(newObj, true);
     qDebug() << "Added new SkyObject " << newObj->name() << " to synced catalog " << m_catName << " which now contains "
              << m_ObjectList.count() << " objects.";
     return newObj;
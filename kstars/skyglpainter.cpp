@@ -148,6 +148,12 @@ bool SkyGLPainter::addItem(SkyPoint *p, int type, float width, char sp)
     if (!visible)
         return false;
 
+    addItem(vec, type, width, sp);
+    return true;
+}
+
+void SkyGLPainter::addItem(const Vector2f &vec, int type, float width, char sp)
+{
     // Prevent crash if type > UNKNOWN
     if (type > SkyObject::TYPE_UNKNOWN)
         type = SkyObject::TYPE_UNKNOWN;
@@ -244,7 +250,6 @@ bool SkyGLPainter::addItem(SkyPoint *p, int type, float width, char sp)
     }
 
     ++m_idx[type];
-    return true;
 }
 
 void SkyGLPainter::drawTexturedRectangle(const QImage &img, const Vector2f &pos, const float angle, const float sizeX,
@@ -413,24 +418,59 @@ bool SkyGLPainter::drawPointSource(SkyPoint *loc, float mag, char sp)
     return addItem(loc, SkyObject::STAR, starWidth(mag), sp);
 }
 
+int SkyGLPainter::drawPointSources(const double *ra, const double *dec, const double *alt, const double *az,
+                                   const float *mag, const char *sp, int n)
+{
+    const int chunkSize = 64;
+    Vector2f screen[chunkSize];
+    bool visible[chunkSize];
+
+    const ViewParams &vp = m_proj->viewParams();
+    // Same horizon test as Projector::checkVisibility()
+    const double minAlt = -1.0 * dms::DegToRad;
+    int drawn           = 0;
+
+    for (int start = 0; start < n; start += chunkSize)
+    {
+        const int count = qMin(chunkSize, n - start);
+        if (vp.useAltAz)
+            m_proj->toScreenBatch(az + start, alt + start, count, screen, visible);
+        else
+            m_proj->toScreenBatch(ra + start, dec + start, count, screen, visible);
+
+        for (int i = 0; i < count; ++i)
+        {
+            if (!visible[i] || (vp.fillGround && alt[start + i] < minAlt))
+                continue;
+            addItem(screen[i], SkyObject::STAR, starWidth(mag[start + i]), sp[start + i]);
+            ++drawn;
+        }
+    }
+    return drawn;
+}
+
 void SkyGLPainter::drawSkyPolygon(LineList *list)
 {
     SkyList *points = list->points();
     bool isVisible, isVisibleLast;
-    SkyPoint *pLast = points->last();
-    Vector2f oLast  = m_proj->toScreenVec(pLast, true, &isVisibleLast);
+
+    // Project the whole polygon at once, then walk the buffers
+    projectPoints(m_proj, points, true);
+
+    SkyPoint *pLast = points->last().get();
+    Vector2f oLast  = m_screenBuffer.last();
     // & with the result of checkVisibility to clip away things below horizon
-    isVisibleLast &= m_proj->checkVisibility(pLast);
+    isVisibleLast = m_visibleBuffer.last() && m_proj->checkVisibility(pLast);
 
     //Guess that we will require around the same number of items as in points.
     QVector<Vector2f> polygon;
     polygon.reserve(points->size());
     for (int i = 0; i < points->size(); ++i)
     {
-        SkyPoint *pThis = points->at(i);
-        Vector2f oThis  = m_proj->toScreenVec(pThis, true, &isVisible);
+        SkyPoint *pThis = points->at(i).get();
+        Vector2f oThis  = m_screenBuffer[i];
         // & with the result of checkVisibility to clip away things below horizon
-        isVisible &= m_proj->checkVisibility(pThis);
+        isVisible = m_visibleBuffer[i] && m_proj->checkVisibility(pThis);
 
         if (isVisible && isVisibleLast)
         {
@@ -541,9 +581,13 @@ void SkyGLPainter::drawSkyPolyline(LineList *list, SkipList *skipList, LineListL
     glBegin(GL_LINE_STRIP);
     SkyList *points = list->points();
     bool isVisible, isVisibleLast;
-    Vector2f oLast = m_proj->toScreenVec(points->first(), true, &isVisibleLast);
+
+    // Project the whole line at once, then walk the buffers
+    projectPoints(m_proj, points, true);
+
+    Vector2f oLast = m_screenBuffer[0];
     // & with the result of checkVisibility to clip away things below horizon
-    isVisibleLast &= m_proj->checkVisibility(points->first());
+    isVisibleLast = m_visibleBuffer[0] && m_proj->checkVisibility(points->first().get());
     if (isVisibleLast)
     {
         glVertex2fv(oLast.data());
@@ -551,9 +595,9 @@ void SkyGLPainter::drawSkyPolyline(LineList *list, SkipList *skipList, LineListL
 
     for (int i = 1; i < points->size(); ++i)
     {
-        Vector2f oThis = m_proj->toScreenVec(points->at(i), true, &isVisible);
+        Vector2f oThis = m_screenBuffer[i];
         // & with the result of checkVisibility to clip away things below horizon
-        isVisible &= m_proj->checkVisibility(points->at(i));
+        isVisible = m_visibleBuffer[i] && m_proj->checkVisibility(points->at(i).get());
 
         bool doSkip = (skipList ? skipList->skip(i) : false);
         //This tells us whether we need to end the current line or whether we
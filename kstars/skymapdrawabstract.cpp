@@ -38,6 +38,7 @@
 #include "simclock.h"
 #include "observinglist.h"
 #include "skycomponents/constellationboundarylines.h"
+#include "skycomponents/deepstarcomponent.h"
 #include "skycomponents/skylabeler.h"
 #include "skycomponents/skymapcomposite.h"
 #include "skyqpainter.h"
@@ -403,10 +404,15 @@ void SkyMapDrawAbstract::exportSkyImage(SkyQPainter *painter, bool scale)
         painter->scale(scale, scale);
     }
 
+    // The image is drawn once, so the stars are loaded before drawing instead of in the background
+    bool synchronousLoading = DeepStarComponent::synchronousLoading();
+    DeepStarComponent::setSynchronousLoading(true);
+
     painter->drawSkyBackground();
     m_KStarsData->skyComposite()->draw(painter);
     drawOverlays(*painter);
     painter->setVectorStars(vectorStarState); // Restore the state of the painter
+    DeepStarComponent::setSynchronousLoading(synchronousLoading);
 }
 
 /* JM 2016-05-03: Not needed since we're not using OpenGL for now
@@ -42,6 +42,7 @@
 
 #include "ksplanetbase.h"
 #include "ksutils.h"
+#include "texturemanager.h"
 
 #include <QSGSimpleRectNode>
 //#include <QSGNode>
@@ -138,6 +139,8 @@ SkyMapLite::SkyMapLite()
 
     connect(this, SIGNAL(destinationChanged()), this, SLOT(slewFocus()));
     connect(KStarsData::Instance(), SIGNAL(skyUpdate(bool)), this, SLOT(slotUpdateSky(bool)));
+    // Deep-sky images are decoded in the background, the nodes that had none yet pick them up on the next update
+    connect(TextureManager::Create(), SIGNAL(imageLoaded(QString)), this, SLOT(forceUpdate()));
 
     ClientManagerLite *clientMng = KStarsLite::Instance()->clientManagerLite();
 
@@ -15,15 +15,26 @@
  ***************************************************************************/
 
 #include "skymapqdraw.h"
+#include "kstarsdata.h"
+#include "Options.h"
 #include "skymapcomposite.h"
 #include "skyqpainter.h"
 #include "skymap.h"
+#include "texturemanager.h"
+#include "constellationartcomponent.h"
+#include "auxiliary/colorscheme.h"
 #include "projections/projector.h"
 #include "printing/legend.h"
 
+#include <QDataStream>
+
 SkyMapQDraw::SkyMapQDraw(SkyMap *sm) : QWidget(sm), SkyMapDrawAbstract(sm)
 {
     m_SkyPixmap = new QPixmap(width(), height());
+
+    // Constellation art is decoded in the background and appears in the reference layer once loaded. Other images
+    // are drawn in the object layer, which is drawn on every frame
+    connect(TextureManager::Create(), SIGNAL(imageLoaded(QString)), this, SLOT(invalidateReferenceLayer(QString)));
 }
 
 SkyMapQDraw::~SkyMapQDraw()
@@ -69,20 +80,55 @@ void SkyMapQDraw::paintEvent(QPaintEvent *event)
     m_SkyMap->showFocusCoords();
     m_SkyMap->setupProjector();
 
+    SkyMapComposite *skyComposite = m_KStarsData->skyComposite();
+    SkyLabeler *skyLabeler        = SkyLabeler::Instance();
+
     SkyQPainter psky(this, m_SkyPixmap);
     //FIXME: we may want to move this into the components.
     psky.begin();
 
-    //Draw all sky elements
-    psky.drawSkyBackground();
-
     // Set Clipping
     QPainterPath path;
     path.addPolygon(m_SkyMap->projector()->clipPoly());
-    psky.setClipPath(path);
-    psky.setClipping(true);
 
-    m_KStarsData->skyComposite()->draw(&psky);
+    if (skyComposite->beginDraw())
+    {
+        const QByteArray key = referenceLayerKey();
+        if (key != m_ReferenceKey || m_ReferenceImage.size() != m_SkyPixmap->size())
+        {
+            m_ReferenceImage = QImage(m_SkyPixmap->size(), QImage::Format_ARGB32_Premultiplied);
+
+            SkyQPainter pref(this, &m_ReferenceImage);
+            pref.begin();
+            pref.drawSkyBackground();
+            pref.setClipPath(path);
+            pref.setClipping(true);
+            skyComposite->drawReferenceLayer(&pref);
+
+            // The labels of the reference layer go into its image
+            pref.setClipping(false);
+            skyLabeler->flush(pref);
+            pref.end();
+
+            m_ReferenceMarks = skyLabeler->saveMarks();
+            m_ReferenceKey   = key;
+        }
+        else
+        {
+            skyLabeler->restoreMarks(m_ReferenceMarks);
+        }
+
+        psky.drawImage(0, 0, m_ReferenceImage);
+        psky.setClipPath(path);
+        psky.setClipping(true);
+        skyComposite->drawObjectLayer(&psky);
+        skyComposite->endDraw();
+    }
+    else
+    {
+        psky.drawSkyBackground();
+    }
+
     //Finish up
     psky.end();
 
@@ -109,3 +155,53 @@ void SkyMapQDraw::resizeEvent(QResizeEvent *e)
     delete m_SkyPixmap;
     m_SkyPixmap = new QPixmap(width(), height());
 }
+
+void SkyMapQDraw::invalidateReferenceLayer(const QString &name)
+{
+    ConstellationArtComponent *art = m_KStarsData->skyComposite()->constellationArt();
+    if (art && art->hasImage(name))
+        m_ReferenceKey.clear();
+}
+
+QByteArray SkyMapQDraw::referenceLayerKey() const
+{
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+
+    const ViewParams &vp = m_SkyMap->projector()->viewParams();
+    stream << vp.width << vp.height << vp.zoomFactor << vp.useRefraction << vp.useAltAz << vp.fillGround
+           << Options::projection() << vp.focus->ra().Degrees() << vp.focus->dec().Degrees()
+           << vp.focus->alt().Degrees() << vp.focus->az().Degrees();
+
+    // Precession and nutation
+    stream << m_KStarsData->updateNumID();
+
+    // The horizontal coordinates, of the view in Alt/Az mode or of the horizontal grid
+    if (vp.useAltAz || Options::showHorizontalGrid())
+    {
+        stream << m_KStarsData->lst()->Degrees() << m_KStarsData->geo()->lat()->Degrees()
+               << m_KStarsData->geo()->lng()->Degrees();
+    }
+    else if (vp.fillGround)
+    {
+        // The lines are cut 1 degree below the horizon, under the ground, which hides a layer drawn up to a quarter
+        // of a degree (a minute) earlier
+        stream << qRound(m_KStarsData->lst()->Degrees() * 4.0) << m_KStarsData->geo()->lat()->Degrees()
+               << m_KStarsData->geo()->lng()->Degrees();
+    }
+
+    stream << Options::showMilkyWay() << Options::fillMilkyWay() << Options::showEquatorialGrid()
+           << Options::showHorizontalGrid() << Options::autoSelectGrid() << Options::showCBounds()
+           << Options::useLocalConstellNames() << Options::showCLines() << Options::showConstellationArt()
+           << Options::showEquator() << Options::showEcliptic() << Options::useAntialias();
+    stream << Options::hideOnSlew() << Options::hideMilkyWay() << Options::hideGrids() << Options::hideCBounds()
+           << Options::hideCLines() << m_SkyMap->isSlewing();
+
+    const ColorScheme *colorScheme = m_KStarsData->colorScheme();
+    for (unsigned int i = 0; i < colorScheme->numberOfColors(); i++)
+        stream << colorScheme->colorAt(i).rgba();
+
+    stream << m_KStarsData->skyComposite()->referenceLayerID();
+
+    return key;
+}
@@ -19,12 +19,19 @@
 #define SKYMAPQDRAW_H_
 
 #include "skymapdrawabstract.h"
+#include "skycomponents/skylabeler.h"
 
+#include <QImage>
 #include <QWidget>
 
 /**
  *@short This class draws the SkyMap using native QPainter. It
  * implements SkyMapDrawAbstract
+ *
+ * The reference layer of the sky map (Milky Way, coordinate grids,
+ * constellation lines and art, equator and ecliptic) is kept in an
+ * image, drawn again only when the view, the time or the options it
+ * depends on change. The objects are drawn over it on each update.
  *@version 1.0
  *@author Akarsh Simha <akarsh.simha@kdemail.net>
  */
@@ -50,6 +57,19 @@ class SkyMapQDraw : public QWidget, public SkyMapDrawAbstract
     void resizeEvent(QResizeEvent *e) Q_DECL_OVERRIDE;
 
     QPixmap *m_SkyPixmap;
+
+  private slots:
+    /** @short Draw the reference layer again on the next update if name is the image of a constellation */
+    void invalidateReferenceLayer(const QString &name);
+
+  private:
+    /** @return what the reference layer depends on, the image of the layer is reused while it is the same */
+    QByteArray referenceLayerKey() const;
+
+    QImage m_ReferenceImage;
+    QByteArray m_ReferenceKey;
+    // Regions taken by the labels of the reference layer, kept free of other labels
+    LabelMarks m_ReferenceMarks;
 };
 
 #endif
@@ -40,6 +40,14 @@ ConstellationsArt::~ConstellationsArt()
 
 void ConstellationsArt::loadImage()
 {
+#ifdef KSTARS_LITE
+    // The texture of the node is made once, from the image it is created with
     constellationArtImage = TextureManager::getImage(imageFileName);
     imageLoaded           = true;
+#else
+    // Tried again on the next draw while the image is decoded
+    bool pending          = false;
+    constellationArtImage = TextureManager::requestImage(imageFileName, &pending);
+    imageLoaded           = !pending;
+#endif
 }
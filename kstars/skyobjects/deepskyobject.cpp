@@ -41,8 +41,8 @@
 #include <KLocalizedString>
 
 DeepSkyObject::DeepSkyObject(const DeepSkyObject &o)
-    : SkyObject(o), PositionAngle(o.PositionAngle), m_image(o.m_image), UGC(o.UGC), PGC(o.PGC), MajorAxis(o.MajorAxis),
-      MinorAxis(o.MinorAxis), Catalog(o.Catalog)
+    : SkyObject(o), PositionAngle(o.PositionAngle), m_ImageName(o.m_ImageName), UGC(o.UGC), PGC(o.PGC),
+      MajorAxis(o.MajorAxis), MinorAxis(o.MinorAxis), Catalog(o.Catalog)
 {
     customCat = nullptr;
     Flux      = o.flux();
@@ -143,11 +143,11 @@ void DeepSkyObject::setCatalog(const QString &cat)
         Catalog = (unsigned char)CAT_UNKNOWN;
 }
 
-void DeepSkyObject::loadImage()
+QImage DeepSkyObject::image()
 {
-    QString tname = name().toLower().remove(' ');
-    m_image       = TextureManager::getImage(tname);
-    imageLoaded   = true;
+    if (m_ImageName.isNull())
+        m_ImageName = name().toLower().remove(' ');
+    return TextureManager::requestImage(m_ImageName);
 }
 
 double DeepSkyObject::labelOffset() const
@@ -165,20 +165,11 @@ class DeepSkyObject : public SkyObject
         	*/
     inline int pgc() const { return PGC; }
 
-    /** @return an object's image */
-    const QImage &image()
-    {
-        if (imageLoaded)
-            return m_image;
-        else
-        {
-            loadImage();
-            return m_image;
-        }
-    }
-
-    /** Try to load the object's image */
-    void loadImage();
+    /**
+     * @return an object's image, or an empty image while it is decoded in the background or if there is none.
+     * The image is held by TextureManager, which drops it when it needs the memory for others.
+     */
+    QImage image();
 
     /**
           *@return true if the object is in the Messier catalog
@@ -212,7 +203,8 @@ class DeepSkyObject : public SkyObject
 
   private:
     double PositionAngle;
-    QImage m_image;
+    // Name of the texture of the object, set on the first call to image()
+    QString m_ImageName;
     QList<const SkyObject *>
         m_Parents; // Q: Should we use KStars UUIDs, DB UUIDs, or SkyObject * pointers? Q: Should we extend this to stars? -- asimha
     QList<const SkyObject *>
@@ -226,7 +218,6 @@ class DeepSkyObject : public SkyObject
     int UGC, PGC;
     float MajorAxis, MinorAxis, Flux;
     unsigned char Catalog;
-    bool imageLoaded = false;
 };
 
 #endif
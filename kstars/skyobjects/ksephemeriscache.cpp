@@ -0,0 +1,227 @@
+/***************************************************************************
+                 ksephemeriscache.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : Tue 17 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "ksephemeriscache.h"
+
+#include "geolocation.h"
+#include "ksnumbers.h"
+#include "ksplanet.h"
+#include "kstarsdatetime.h"
+#include "skypoint.h"
+
+#include <KLocalizedString>
+
+#include <QtConcurrent>
+
+#include <cmath>
+#include <functional>
+#include <memory>
+
+namespace
+{
+// Copies of the body and of the Earth used by one segment
+struct SegmentTask
+{
+    int segment;
+    std::shared_ptr<KSPlanetBase> body;
+    std::shared_ptr<KSPlanet> earth;
+    bool ok;
+};
+
+void toVector(const dms &longitude, const dms &latitude, double *v)
+{
+    double sinLong, cosLong, sinLat, cosLat;
+    longitude.SinCos(sinLong, cosLong);
+    latitude.SinCos(sinLat, cosLat);
+    v[0] = cosLong * cosLat;
+    v[1] = sinLong * cosLat;
+    v[2] = sinLat;
+}
+}
+
+bool KSEphemerisCache::fit(const KSPlanetBase &body, long double startJD, long double stopJD, const GeoLocation *geo,
+                           double segmentDays)
+{
+    clear();
+
+    if (segmentDays <= 0)
+        segmentDays = (body.type() == SkyObject::MOON) ? 0.25 : 1.0;
+    int segments = qMax(1, int(ceil(double(stopJD - startJD) / segmentDays)));
+
+    // The data files are loaded here, once: the loaders share static tables and are not thread-safe
+    std::shared_ptr<KSPlanetBase> bodyCopy(static_cast<KSPlanetBase *>(body.clone()));
+    std::shared_ptr<KSPlanet> earth(new KSPlanet(I18N_NOOP("Earth"), QString(), QColor("white"), 12756.28));
+    if (!bodyCopy->loadData() || !earth->loadData())
+    {
+        qWarning() << "Could not load the orbital data of" << body.name();
+        return false;
+    }
+
+    // Each segment works on its own copies, made here as some bodies count their instances
+    QVector<SegmentTask> tasks;
+    for (int s = 0; s < segments; ++s)
+    {
+        SegmentTask task;
+        task.segment = s;
+        task.body.reset(static_cast<KSPlanetBase *>(bodyCopy->clone()));
+        task.earth.reset(earth->clone());
+        task.ok = true;
+        tasks.append(task);
+    }
+
+    QVector<double> coefficients(segments * CHANNELS * Nodes, 0.0);
+    double *out = coefficients.data();
+
+    std::function<void(SegmentTask &)> fitSegment = [&](SegmentTask &task) {
+        double values[CHANNELS][Nodes];
+
+        for (int k = 0; k < Nodes; ++k)
+        {
+            double tau     = cos(dms::PI * (k + 0.5) / Nodes);
+            long double jd = startJD + (task.segment + 0.5 * (1.0 + tau)) * segmentDays;
+            KSNumbers num(jd);
+
+            task.ok &= task.earth->findApparentPosition(&num);
+            if (geo)
+            {
+                CachingDms LST(geo->GSTtoLST(KStarsDateTime(jd).gst()));
+                task.ok &= task.body->findApparentPosition(&num, geo->lat(), &LST, task.earth.get());
+            }
+            else
+                task.ok &= task.body->findApparentPosition(&num, nullptr, nullptr, task.earth.get());
+
+            double v[3];
+            toVector(task.body->ra(), task.body->dec(), v);
+            values[EQ_X][k] = v[0];
+            values[EQ_Y][k] = v[1];
+            values[EQ_Z][k] = v[2];
+            toVector(task.body->ecLong(), task.body->ecLat(), v);
+            values[EC_X][k]   = v[0];
+            values[EC_Y][k]   = v[1];
+            values[EC_Z][k]   = v[2];
+            values[REARTH][k] = task.body->rearth();
+        }
+
+        // c_j = 2/N sum_k f(tau_k) T_j(tau_k), with c_0 halved so that f = sum_j c_j T_j
+        for (int c = 0; c < CHANNELS; ++c)
+        {
+            double *coefficient = out + (task.segment * CHANNELS + c) * Nodes;
+            for (int j = 0; j < Nodes; ++j)
+            {
+                double sum = 0;
+                for (int k = 0; k < Nodes; ++k)
+                    sum += values[c][k] * cos(dms::PI * j * (k + 0.5) / Nodes);
+                coefficient[j] = sum * 2.0 / Nodes;
+            }
+            coefficient[0] /= 2.0;
+        }
+    };
+    QtConcurrent::blockingMap(tasks, fitSegment);
+
+    for (const SegmentTask &task : tasks)
+    {
+        if (!task.ok)
+        {
+            qWarning() << "Could not compute the position of" << body.name();
+            return false;
+        }
+    }
+
+    m_StartJD      = startJD;
+    m_SegmentDays  = segmentDays;
+    m_Segments     = segments;
+    m_Coefficients = coefficients;
+    return true;
+}
+
+void KSEphemerisCache::clear()
+{
+    m_StartJD     = 0;
+    m_SegmentDays = 0;
+    m_Segments    = 0;
+    m_Coefficients.clear();
+}
+
+bool KSEphemerisCache::covers(long double jd) const
+{
+    return m_Segments > 0 && jd >= m_StartJD && jd <= m_StartJD + m_Segments * m_SegmentDays;
+}
+
+int KSEphemerisCache::segment(long double jd, double &tau) const
+{
+    double t = double(jd - m_StartJD) / m_SegmentDays;
+    int s    = qBound(0, int(floor(t)), m_Segments - 1);
+    tau      = 2.0 * (t - s) - 1.0;
+    return s;
+}
+
+double KSEphemerisCache::evaluate(long double jd, int channel) const
+{
+    double tau;
+    int s = segment(jd, tau);
+
+    const double *c = m_Coefficients.constData() + (s * CHANNELS + channel) * Nodes;
+    double b1 = 0, b2 = 0;
+    for (int j = Nodes - 1; j >= 1; --j)
+    {
+        double b0 = 2.0 * tau * b1 - b2 + c[j];
+        b2        = b1;
+        b1        = b0;
+    }
+    return tau * b1 - b2 + c[0];
+}
+
+void KSEphemerisCache::evaluateVector(long double jd, int channel, double &x, double &y, double &z) const
+{
+    x = evaluate(jd, channel);
+    y = evaluate(jd, channel + 1);
+    z = evaluate(jd, channel + 2);
+}
+
+void KSEphemerisCache::position(long double jd, SkyPoint &position) const
+{
+    double x, y, z;
+    evaluateVector(jd, EQ_X, x, y, z);
+
+    CachingDms ra, dec;
+    ra.setUsing_atan2(y, x);
+    dec.setUsing_atan2(z, sqrt(x * x + y * y));
+    position.set(ra.reduce(), dec);
+}
+
+double KSEphemerisCache::ecLong(long double jd) const
+{
+    double x, y, z;
+    evaluateVector(jd, EC_X, x, y, z);
+
+    dms longitude;
+    longitude.setRadians(atan2(y, x));
+    return longitude.reduce().Degrees();
+}
+
+double KSEphemerisCache::ecLat(long double jd) const
+{
+    double x, y, z;
+    evaluateVector(jd, EC_X, x, y, z);
+
+    return atan2(z, sqrt(x * x + y * y)) / dms::DegToRad;
+}
+
+double KSEphemerisCache::rearth(long double jd) const
+{
+    return evaluate(jd, REARTH);
+}
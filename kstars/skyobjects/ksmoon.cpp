@@ -98,8 +98,8 @@ KSMoon::~KSMoon()
 
 bool KSMoon::data_loaded   = false;
 int KSMoon::instance_count = 0;
-QList<KSMoon::MoonLRData> KSMoon::LRData;
-QList<KSMoon::MoonBData> KSMoon::BData;
+QVector<KSMoon::MoonLRData> KSMoon::LRData;
+QVector<KSMoon::MoonBData> KSMoon::BData;
 
 bool KSMoon::loadData()
 {
@@ -21,6 +21,8 @@
 #include "ksplanetbase.h"
 #include "dms.h"
 
+#include <QVector>
+
 /** @class KSMoon
 	*A subclass of SkyObject that provides information
 	*needed for the Moon.  Specifically, KSMoon provides a moon-specific
@@ -114,7 +116,7 @@ class KSMoon : public KSPlanetBase
         double Ri;
     };
 
-    static QList<MoonLRData> LRData;
+    static QVector<MoonLRData> LRData;
 
     /** @class MoonBData
          * Encapsulates the Latitude terms of the sums
@@ -132,7 +134,7 @@ class KSMoon : public KSPlanetBase
         double Bi;
     };
 
-    static QList<MoonBData> BData;
+    static QVector<MoonBData> BData;
     unsigned int iPhase;
 };
 
@@ -21,7 +21,9 @@
 
 #include <cmath>
 
+#include <QDateTime>
 #include <QFile>
+#include <QFileInfo>
 #include <QTextStream>
 
 #include <QDebug>
@@ -29,19 +31,93 @@
 #include "ksnumbers.h"
 #include "ksutils.h"
 #include "ksfilereader.h"
+#include "kspaths.h"
+#include "kstars/version.h"
+
+#include <cstring>
+
+namespace
+{
+// Header of the binary cache of a planet, followed by the A, B and C arrays of each of its
+// 18 series in the order Lon[0..5], Lat[0..5], Dst[0..5], in native byte order.
+const quint32 CacheMagic   = 0x56534f50; // "VSOP"
+const quint32 CacheVersion = 2;
+
+struct CacheHeader
+{
+    quint32 magic;
+    quint32 version;
+    // KStars version that wrote the cache, the text files ship with it
+    char kstarsVersion[32];
+    quint32 sizes[18];
+    // Size and modification time in ms of the text file of each series, -1 if it is missing,
+    // so that a text file edited or overridden in the user directory replaces the cache
+    qint64 sourceSizes[18];
+    qint64 sourceTimes[18];
+};
+
+QString cacheFileName(const QString &nl)
+{
+    return KSPaths::writableLocation(QStandardPaths::GenericDataLocation) + nl + ".vsop.bin";
+}
+
+QString seriesFileName(const QString &nl, int i)
+{
+    return nl + '.' + "LBR"[i / 6] + QString::number(i % 6) + ".vsop";
+}
+
+void fillCacheVersion(const QString &nl, CacheHeader &header)
+{
+    memset(&header, 0, sizeof(CacheHeader));
+    header.magic   = CacheMagic;
+    header.version = CacheVersion;
+    strncpy(header.kstarsVersion, KSTARS_VERSION, sizeof(header.kstarsVersion) - 1);
+
+    for (int i = 0; i < 18; ++i)
+    {
+        QFileInfo source(KSPaths::locate(QStandardPaths::GenericDataLocation, seriesFileName(nl, i)));
+        header.sourceSizes[i] = source.exists() ? source.size() : -1;
+        header.sourceTimes[i] = source.exists() ? source.lastModified().toMSecsSinceEpoch() : -1;
+    }
+}
+}
 
 KSPlanet::OrbitDataManager KSPlanet::odm;
 
+double KSPlanet::OrbitSeries::sum(double T) const
+{
+    const int n     = A.size();
+    const double *a = A.constData();
+    const double *b = B.constData();
+    const double *c = C.constData();
+
+    double sum = 0.0;
+    for (int j = 0; j < n; ++j)
+        sum += a[j] * cos(b[j] + c[j] * T);
+    return sum;
+}
+
 KSPlanet::OrbitDataColl::OrbitDataColl()
 {
 }
 
+double KSPlanet::OrbitDataColl::evaluate(const OBArray &series, double T)
+{
+    double Tpow = 1.0, sum = 0.0;
+    for (int i = 0; i < 6; ++i)
+    {
+        sum += series[i].sum(T) * Tpow;
+        Tpow *= T;
+    }
+    return sum;
+}
+
 KSPlanet::OrbitDataManager::OrbitDataManager()
 {
     //EMPTY
 }
 
-bool KSPlanet::OrbitDataManager::readOrbitData(const QString &fname, QVector<OrbitData> *vector)
+bool KSPlanet::OrbitDataManager::readOrbitData(const QString &fname, OrbitSeries *series)
 {
     QFile f;
 
@@ -58,7 +134,7 @@ bool KSPlanet::OrbitDataManager::readOrbitData(const QString &fname, QVector<Orb
                 double A = fields[0].toDouble();
                 double B = fields[1].toDouble();
                 double C = fields[2].toDouble();
-                vector->append(OrbitData(A, B, C));
+                series->append(A, B, C);
             }
         }
     }
@@ -71,62 +147,154 @@ bool KSPlanet::OrbitDataManager::readOrbitData(const QString &fname, QVector<Orb
 
 bool KSPlanet::OrbitDataManager::loadData(KSPlanet::OrbitDataColl &odc, const QString &n)
 {
-    QString fname, snum, line;
-    QFile f;
+    const OrbitDataColl *data = orbitData(n);
+    if (data == nullptr)
+        return false;
+
+    odc = *data;
+    return true;
+}
+
+const KSPlanet::OrbitDataColl *KSPlanet::OrbitDataManager::orbitData(const QString &n)
+{
+    QString fname, snum;
     int nCount = 0;
     QString nl = n.toLower();
 
-    if (hash.contains(nl))
-    {
-        odc = hash[nl];
-        return true; //orbit data already loaded
-    }
+    auto it = hash.constFind(nl);
+    if (it != hash.constEnd())
+        return it.value().data(); //orbit data already loaded
 
     //Create a new OrbitDataColl
-    OrbitDataColl ret;
+    QSharedPointer<OrbitDataColl> ret(new OrbitDataColl());
+
+    if (readCache(nl, *ret))
+    {
+        hash.insert(nl, ret);
+        return ret.data();
+    }
 
     //Ecliptic Longitude
     for (int i = 0; i < 6; ++i)
     {
         snum.setNum(i);
         fname = nl + ".L" + snum + ".vsop";
-        if (readOrbitData(fname, &ret.Lon[i]))
+        if (readOrbitData(fname, &ret->Lon[i]))
             nCount++;
     }
 
     if (nCount == 0)
-        return false;
+        return nullptr;
 
     //Ecliptic Latitude
     for (int i = 0; i < 6; ++i)
     {
         snum.setNum(i);
         fname = nl + ".B" + snum + ".vsop";
-        if (readOrbitData(fname, &ret.Lat[i]))
+        if (readOrbitData(fname, &ret->Lat[i]))
             nCount++;
     }
 
     if (nCount == 0)
-        return false;
+        return nullptr;
 
     //Heliocentric Distance
     for (int i = 0; i < 6; ++i)
     {
         snum.setNum(i);
         fname = nl + ".R" + snum + ".vsop";
-        if (readOrbitData(fname, &ret.Dst[i]))
+        if (readOrbitData(fname, &ret->Dst[i]))
             nCount++;
     }
 
     if (nCount == 0)
+        return nullptr;
+
+    writeCache(nl, *ret);
+
+    hash.insert(nl, ret);
+    return ret.data();
+}
+
+bool KSPlanet::OrbitDataManager::readCache(const QString &nl, KSPlanet::OrbitDataColl &odc)
+{
+    QFile f(cacheFileName(nl));
+    if (!f.open(QIODevice::ReadOnly) || f.size() < qint64(sizeof(CacheHeader)))
+        return false;
+
+    const uchar *data = f.map(0, f.size());
+    if (data == nullptr)
         return false;
 
-    hash[nl] = ret;
-    odc      = hash[nl];
+    CacheHeader header, expected;
+    memcpy(&header, data, sizeof(CacheHeader));
+    fillCacheVersion(nl, expected);
 
+    qint64 size = sizeof(CacheHeader);
+    for (int i = 0; i < 18; ++i)
+        size += qint64(header.sizes[i]) * 3 * sizeof(double);
+
+    if (header.magic != CacheMagic || header.version != CacheVersion ||
+        memcmp(header.kstarsVersion, expected.kstarsVersion, sizeof(header.kstarsVersion)) != 0 ||
+        memcmp(header.sourceSizes, expected.sourceSizes, sizeof(header.sourceSizes)) != 0 ||
+        memcmp(header.sourceTimes, expected.sourceTimes, sizeof(header.sourceTimes)) != 0 || size != f.size())
+    {
+        f.unmap(const_cast<uchar *>(data));
+        return false;
+    }
+
+    OrbitSeries *series[18];
+    for (int i = 0; i < 6; ++i)
+    {
+        series[i]      = &odc.Lon[i];
+        series[i + 6]  = &odc.Lat[i];
+        series[i + 12] = &odc.Dst[i];
+    }
+
+    const uchar *p = data + sizeof(CacheHeader);
+    for (int i = 0; i < 18; ++i)
+    {
+        const int count = header.sizes[i];
+        QVector<double> *arrays[3] = { &series[i]->A, &series[i]->B, &series[i]->C };
+        for (QVector<double> *array : arrays)
+        {
+            array->resize(count);
+            memcpy(array->data(), p, count * sizeof(double));
+            p += count * sizeof(double);
+        }
+    }
+
+    f.unmap(const_cast<uchar *>(data));
     return true;
 }
 
+void KSPlanet::OrbitDataManager::writeCache(const QString &nl, const KSPlanet::OrbitDataColl &odc)
+{
+    const OrbitSeries *series[18];
+    for (int i = 0; i < 6; ++i)
+    {
+        series[i]      = &odc.Lon[i];
+        series[i + 6]  = &odc.Lat[i];
+        series[i + 12] = &odc.Dst[i];
+    }
+
+    CacheHeader header;
+    fillCacheVersion(nl, header);
+    for (int i = 0; i < 18; ++i)
+        header.sizes[i] = series[i]->size();
+
+    QByteArray image(reinterpret_cast<const char *>(&header), sizeof(CacheHeader));
+    for (int i = 0; i < 18; ++i)
+    {
+        const int bytes = series[i]->size() * sizeof(double);
+        image.append(reinterpret_cast<const char *>(series[i]->A.constData()), bytes);
+        image.append(reinterpret_cast<const char *>(series[i]->B.constData()), bytes);
+        image.append(reinterpret_cast<const char *>(series[i]->C.constData()), bytes);
+    }
+
+    KSUtils::saveFile(cacheFileName(nl), image);
+}
+
 KSPlanet::KSPlanet(const QString &s, const QString &imfile, const QColor &c, double pSize)
     : KSPlanetBase(s, imfile, c, pSize), data_loaded(false)
 {
@@ -190,26 +358,23 @@ QString KSPlanet::untranslatedName() const
         return name();
 }
 
-//we don't need the reference to the ODC, so just give it a junk variable
 bool KSPlanet::loadData()
 {
-    OrbitDataColl odc;
-    return odm.loadData(odc, untranslatedName());
+    return orbitData() != nullptr;
 }
 
-void KSPlanet::calcEcliptic(double Tau, EclipticPosition &epret) const
+const KSPlanet::OrbitDataColl *KSPlanet::orbitData() const
 {
-    double sum[6];
-    OrbitDataColl odc;
-    double Tpow[6];
+    if (m_OrbitData == nullptr)
+        m_OrbitData = odm.orbitData(untranslatedName());
+    return m_OrbitData;
+}
 
-    Tpow[0] = 1.0;
-    for (int i = 1; i < 6; ++i)
-    {
-        Tpow[i] = Tpow[i - 1] * Tau;
-    }
+void KSPlanet::calcEcliptic(double Tau, EclipticPosition &epret) const
+{
+    const OrbitDataColl *odc = orbitData();
 
-    if (!odm.loadData(odc, untranslatedName()))
+    if (odc == nullptr)
     {
         epret.longitude = dms(0.0);
         epret.latitude  = dms(0.0);
@@ -219,50 +384,14 @@ void KSPlanet::calcEcliptic(double Tau, EclipticPosition &epret) const
     }
 
     //Ecliptic Longitude
-    for (int i = 0; i < 6; ++i)
-    {
-        sum[i] = 0.0;
-        for (int j = 0; j < odc.Lon[i].size(); ++j)
-        {
-            sum[i] += odc.Lon[i][j].A * cos(odc.Lon[i][j].B + odc.Lon[i][j].C * Tau);
-            /*
-            qDebug() << "sum[" << i <<"] =" << sum[i] <<
-            	" A = " << odc.Lon[i][j].A << " B = " << odc.Lon[i][j].B <<
-            	" C = " << odc.Lon[i][j].C << endl;
-            	*/
-        }
-        sum[i] *= Tpow[i];
-        //qDebug() << name() << " : sum[" << i << "] = " << sum[i];
-    }
-
-    epret.longitude.setRadians(sum[0] + sum[1] + sum[2] + sum[3] + sum[4] + sum[5]);
+    epret.longitude.setRadians(OrbitDataColl::evaluate(odc->Lon, Tau));
     epret.longitude.setD(epret.longitude.reduce().Degrees());
 
     //Compute Ecliptic Latitude
-    for (uint i = 0; i < 6; ++i)
-    {
-        sum[i] = 0.0;
-        for (int j = 0; j < odc.Lat[i].size(); ++j)
-        {
-            sum[i] += odc.Lat[i][j].A * cos(odc.Lat[i][j].B + odc.Lat[i][j].C * Tau);
-        }
-        sum[i] *= Tpow[i];
-    }
-
-    epret.latitude.setRadians(sum[0] + sum[1] + sum[2] + sum[3] + sum[4] + sum[5]);
+    epret.latitude.setRadians(OrbitDataColl::evaluate(odc->Lat, Tau));
 
     //Compute Heliocentric Distance
-    for (uint i = 0; i < 6; ++i)
-    {
-        sum[i] = 0.0;
-        for (int j = 0; j < odc.Dst[i].size(); ++j)
-        {
-            sum[i] += odc.Dst[i][j].A * cos(odc.Dst[i][j].B + odc.Dst[i][j].C * Tau);
-        }
-        sum[i] *= Tpow[i];
-    }
-
-    epret.radius = sum[0] + sum[1] + sum[2] + sum[3] + sum[4] + sum[5];
+    epret.radius = OrbitDataColl::evaluate(odc->Dst, Tau);
 
     /*
     qDebug() << name() << " pre: Lat = " << epret.latitude.toDMSString() << " Long = " <<
@@ -20,6 +20,7 @@
 
 #include <QVector>
 #include <QHash>
+#include <QSharedPointer>
 
 #include "ksplanetbase.h"
 #include "dms.h"
@@ -94,39 +95,35 @@ class KSPlanet : public KSPlanetBase
         	*/
     bool findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *Earth = nullptr) Q_DECL_OVERRIDE;
 
-    /** @class OrbitData
-        	*This class contains doubles A,B,C which represent a single term in a planet's
-        	*positional expansion sums (each sum-term is A*COS(B+C*T)).
-        	*@author Mark Hollomon
-        	*@version 1.0
+    /** @class OrbitSeries
+        	*This class contains the terms of a single sum in a planet's positional
+        	*expansion (each sum-term is A*COS(B+C*T)). The A, B and C values of the
+        	*terms are packed in three contiguous arrays.
         	*/
-    class OrbitData
+    class OrbitSeries
     {
       public:
-        /**
-                	*Default constructor
-                	*/
-        OrbitData() : A(0.), B(0.), C(0.) {}
-        /**
-                	*Constructor
-                	*@param a the A value
-                	*@param b the B value
-                	*@param c the C value
-                	*/
-        OrbitData(double a, double b, double c) : A(a), B(b), C(c) {}
+        /** @return the number of terms */
+        int size() const { return A.size(); }
 
-        /**
-                	*Assignment operator
-                	*/
-        OrbitData operator=(const OrbitData o) { return o; }
+        /** Append a term to the series */
+        void append(double a, double b, double c)
+        {
+            A.append(a);
+            B.append(b);
+            C.append(c);
+        }
+
+        /** @return the sum of the terms at time T */
+        double sum(double T) const;
 
-        double A, B, C;
+        QVector<double> A, B, C;
     };
 
-    typedef QVector<OrbitData> OBArray[6];
+    typedef OrbitSeries OBArray[6];
 
-    /** OrbitDataColl contains three groups of six QVectors.  Each QVector is a
-        	*list of OrbitData objects, representing a single sum used in computing
+    /** OrbitDataColl contains three groups of six OrbitSeries.  Each OrbitSeries is a
+        	*list of terms, representing a single sum used in computing
         	*the planet's position.  A set of six of these vectors comprises the large
         	*"meta-sum" which yields the planet's Longitude, Latitude, or Distance value.
         	*@author Mark Hollomon
@@ -138,6 +135,9 @@ class KSPlanet : public KSPlanetBase
         /**Constructor*/
         OrbitDataColl();
 
+        /** @return the "meta-sum" of the six series, the sum of series i being multiplied by T^i */
+        static double evaluate(const OBArray &series, double T);
+
         OBArray Lon;
         OBArray Lat;
         OBArray Dst;
@@ -165,22 +165,46 @@ class KSPlanet : public KSPlanetBase
                 	*/
         bool loadData(OrbitDataColl &odc, const QString &n);
 
+        /** Load orbital data for a planet, from the binary cache if it is up to date or else
+                	*from the text files, which are then cached.
+                	*@param n the name of the planet whose data is to be loaded.
+                	*@return the orbital data, which stay valid until the program exits, or nullptr
+                	*if they could not be loaded.
+                	*/
+        const OrbitDataColl *orbitData(const QString &n);
+
       private:
-        /** Read a single orbital data file from disk into an OrbitData vector.
+        /** Read a single orbital data file from disk into an OrbitSeries.
                 *The data files are named "name.[LBR][0...5].vsop", where
                 *"L"=Longitude data, "B"=Latitude data, and R=Radius data.
                 *@param fname the filename to be read.
-                *@param vector pointer to the OrbitData vector to be filled with these data.
+                *@param series pointer to the OrbitSeries to be filled with these data.
+                */
+        bool readOrbitData(const QString &fname, OrbitSeries *series);
+
+        /** Map the binary cache "name.vsop.bin" written by writeCache() and copy its series.
+                *@return false if there is no cache or it was written by another version of KStars or from other text files.
                 */
-        bool readOrbitData(const QString &fname, QVector<KSPlanet::OrbitData> *vector);
+        bool readCache(const QString &nl, OrbitDataColl &odc);
 
-        QHash<QString, OrbitDataColl> hash;
+        /** Write the series of a planet in a binary file, so they are mapped instead of parsed
+                *the next time the program starts.
+                */
+        void writeCache(const QString &nl, const OrbitDataColl &odc);
+
+        QHash<QString, QSharedPointer<OrbitDataColl>> hash;
     };
 
     static OrbitDataManager odm;
 
+    /** @return the orbital data of this planet, loaded the first time, or nullptr if they are not available */
+    const OrbitDataColl *orbitData() const;
+
   private:
     void findMagnitude(const KSNumbers *) Q_DECL_OVERRIDE;
+
+    // Cached orbitData() of this planet
+    mutable const OrbitDataColl *m_OrbitData { nullptr };
 };
 
 #endif
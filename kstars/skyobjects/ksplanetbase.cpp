@@ -152,6 +152,18 @@ void KSPlanetBase::findPosition(const KSNumbers *num, const CachingDms *lat, con
     }
 }
 
+bool KSPlanetBase::findApparentPosition(const KSNumbers *num, const CachingDms *lat, const CachingDms *LST,
+                                        const KSPlanetBase *Earth)
+{
+    if (!findGeocentricPosition(num, Earth))
+        return false;
+
+    if (lat && LST)
+        localizeCoords(num, lat, LST); //correct for figure-of-the-Earth
+
+    return true;
+}
+
 bool KSPlanetBase::isMajorPlanet() const
 {
     if (name() == i18n("Mercury") || name() == i18n("Venus") || name() == i18n("Mars") || name() == i18n("Jupiter") ||
@@ -179,6 +179,19 @@ class KSPlanetBase : public TrailObject
     void findPosition(const KSNumbers *num, const CachingDms *lat = 0, const CachingDms *LST = 0,
                       const KSPlanetBase *Earth = 0);
 
+    /**
+     * @short Find the apparent coordinates only, without the phase, magnitude, angular size or trail.
+     * Unlike findPosition(), this does not use KStarsData, so it can run on a copy of the body in another
+     * thread once loadData() was called.
+     * @param num KSNumbers pointer for the target date/time
+     * @param lat pointer to the geographic latitude; if nullptr, we skip localizeCoords()
+     * @param LST pointer to the local sidereal time; if nullptr, we skip localizeCoords()
+     * @param Earth pointer to the Earth (not used for the Moon)
+     * @return true if the position was successfully calculated.
+     */
+    bool findApparentPosition(const KSNumbers *num, const CachingDms *lat = nullptr, const CachingDms *LST = nullptr,
+                              const KSPlanetBase *Earth = nullptr);
+
     /** @return the Planet's position angle. */
     double pa() const Q_DECL_OVERRIDE { return PositionAngle; }
 
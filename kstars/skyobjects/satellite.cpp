@@ -21,7 +21,11 @@
 
 #include "math.h"
 #include <QDebug>
+#include <QtConcurrent>
 
+#include <functional>
+
+#include "geolocation.h"
 #include "kstarsdata.h"
 #include "ksplanetbase.h"
 #include "skymapcomposite.h"
@@ -715,14 +719,100 @@ void Satellite::init()
 
 int Satellite::updatePos()
 {
-    KStarsData *data = KStarsData::Instance();
-    return sgp4((data->clock()->utc().djd() - m_tle_jd) * MINPD);
+    return updatePos(currentContext());
+}
+
+int Satellite::updatePos(const Context &context)
+{
+    return sgp4((context.jd - m_tle_jd) * MINPD, context);
+}
+
+Satellite::Context Satellite::makeContext(double jd, GeoLocation *geo, const dms &lst, double sunAltitude)
+{
+    Context context;
+    double sinlat, coslat, thetageo, c, sq, achcp;
+
+    context.jd          = jd;
+    context.lst         = CachingDms(lst);
+    context.lat         = CachingDms(*geo->lat());
+    context.sunAltitude = sunAltitude;
+
+    // Observer ECI position
+    sinlat            = sin(geo->lat()->radians());
+    coslat            = cos(geo->lat()->radians());
+    thetageo          = geo->LMST(jd);
+    context.sinLat    = sinlat;
+    context.cosLat    = coslat;
+    context.sinTheta  = sin(thetageo);
+    context.cosTheta  = cos(thetageo);
+    c                 = 1.0 / sqrt(1.0 + F * (F - 2.0) * sinlat * sinlat);
+    sq                = (1.0 - F) * (1.0 - F) * c;
+    achcp             = (RADIUSEARTHKM * c + MEANALT) * coslat;
+    context.obsPos[0] = achcp * context.cosTheta;
+    context.obsPos[1] = achcp * context.sinTheta;
+    context.obsPos[2] = (RADIUSEARTHKM * sq + MEANALT) * sinlat;
+
+    // Find ECI coordinates of the sun
+    double mjd, year, T, M, L, e, C, O, Lsa, nu, R, eps;
+
+    mjd  = jd - 2415020.0;
+    year = 1900.0 + mjd / 365.25;
+    T    = (mjd + deltaET(year) / (MINPD * 60.0)) / 36525.0;
+    M    = DEG2RAD * (Modulus(358.47583 + Modulus(35999.04975 * T, 360.0) - (0.000150 + 0.0000033 * T) * T * T, 360.0));
+    L    = DEG2RAD * (Modulus(279.69668 + Modulus(36000.76892 * T, 360.0) + 0.0003025 * T * T, 360.0));
+    e    = 0.01675104 - (0.0000418 + 0.000000126 * T) * T;
+    C    = DEG2RAD * ((1.919460 - (0.004789 + 0.000014 * T) * T) * sin(M) + (0.020094 - 0.000100 * T) * sin(2 * M) +
+                   0.000293 * sin(3 * M));
+    O    = DEG2RAD * (Modulus(259.18 - 1934.142 * T, 360.0));
+    Lsa  = Modulus(L + C - DEG2RAD * (0.00569 - 0.00479 * sin(O)), TWOPI);
+    nu   = Modulus(M + C, TWOPI);
+    R    = 1.0000002 * (1.0 - e * e) / (1.0 + e * cos(nu));
+    eps  = DEG2RAD * (23.452294 - (0.0130125 + (0.00000164 - 0.000000503 * T) * T) * T + 0.00256 * cos(O));
+    R    = AU * R;
+
+    context.sunPos[0] = R * cos(Lsa);
+    context.sunPos[1] = R * sin(Lsa) * cos(eps);
+    context.sunPos[2] = R * sin(Lsa) * sin(eps);
+    context.sunW      = R;
+
+    return context;
 }
 
-int Satellite::sgp4(double tsince)
+Satellite::Context Satellite::currentContext()
 {
     KStarsData *data = KStarsData::Instance();
+    KSSun *sun       = (KSSun *)data->skyComposite()->findByName("Sun");
+
+    return makeContext(data->clock()->utc().djd(), data->geo(), *data->lst(), sun->alt().Degrees());
+}
+
+void Satellite::updatePositions(Satellite *const *satellites, int *rc, int count, const Context &context)
+{
+    // Satellites only share the context, so they can be propagated concurrently. Chunks keep the
+    // scheduling overhead low compared to the few microseconds sgp4() takes per satellite.
+    const int chunkSize = 64;
+
+    if (count <= chunkSize)
+    {
+        for (int i = 0; i < count; i++)
+            rc[i] = satellites[i]->updatePos(context);
+        return;
+    }
+
+    QVector<int> chunks;
+    for (int start = 0; start < count; start += chunkSize)
+        chunks.append(start);
 
+    std::function<void(int)> propagate = [&](int start) {
+        int end = qMin(start + chunkSize, count);
+        for (int i = start; i < end; i++)
+            rc[i] = satellites[i]->updatePos(context);
+    };
+    QtConcurrent::blockingMap(chunks, propagate);
+}
+
+int Satellite::sgp4(double tsince, const Context &context)
+{
     int ktr;
     double am, axnl, aynl, betal, cosim, cnod, cos2u, coseo1, cosi, cosip, cosisq, cossu, cosu, delm, delomg, em, emsq,
         ecose, el2, eo1, ep, esine, argpm, argpp, argpdf, pl,
@@ -730,12 +820,10 @@ int Satellite::sgp4(double tsince)
         t3, t4, tem5, temp, temp1, temp2, tempa, tempe, templ, u, ux, uy, uz, vx, vy, vz, inclm, mm, nm, nodem, xinc,
         xincp, xl, xlm, mp, xmdf, xmx, xmy, nodedf, xnode, nodep, tc, sat_posx, sat_posy, sat_posz, sat_posw, sat_velx,
         sat_vely, sat_velz, sinlat, obs_posx, obs_posy, obs_posz, obs_posw, /*obs_velx, obs_vely, obs_velz,*/
-        coslat, thetageo, sintheta, costheta, c, sq, achcp, vkmpersec;
+        coslat, sintheta, costheta, vkmpersec;
 
     const double temp4 = 1.5e-12;
 
-    double jul_utc = data->clock()->utc().djd();
-
     vkmpersec = RADIUSEARTHKM * XKE / 60.0;
 
     // Update for secular gravity and atmospheric drag
@@ -1142,17 +1230,13 @@ int Satellite::sgp4(double tsince)
     }
 
     // Observer ECI position and velocity
-    sinlat   = sin(data->geo()->lat()->radians());
-    coslat   = cos(data->geo()->lat()->radians());
-    thetageo = data->geo()->LMST(jul_utc);
-    sintheta = sin(thetageo);
-    costheta = cos(thetageo);
-    c        = 1.0 / sqrt(1.0 + F * (F - 2.0) * sinlat * sinlat);
-    sq       = (1.0 - F) * (1.0 - F) * c;
-    achcp    = (RADIUSEARTHKM * c + MEANALT) * coslat;
-    obs_posx = achcp * costheta;
-    obs_posy = achcp * sintheta;
-    obs_posz = (RADIUSEARTHKM * sq + MEANALT) * sinlat;
+    sinlat   = context.sinLat;
+    coslat   = context.cosLat;
+    sintheta = context.sinTheta;
+    costheta = context.cosTheta;
+    obs_posx = context.obsPos[0];
+    obs_posy = context.obsPos[1];
+    obs_posz = context.obsPos[2];
     obs_posw = sqrt(obs_posx * obs_posx + obs_posy * sat_posy + obs_posz * obs_posz);
     /*obs_velx = -MFACTOR * obs_posy;
     obs_vely = MFACTOR * obs_posx;
@@ -1185,31 +1269,13 @@ int Satellite::sgp4(double tsince)
 
     setAz(azimut / DEG2RAD);
     setAlt(elevation / DEG2RAD);
-    HorizontalToEquatorial(data->lst(), data->geo()->lat());
+    HorizontalToEquatorial(&context.lst, &context.lat);
 
     // is the satellite visible ?
-    // Find ECI coordinates of the sun
-    double mjd, year, T, M, L, e, C, O, Lsa, nu, R, eps;
-
-    mjd  = jul_utc - 2415020.0;
-    year = 1900.0 + mjd / 365.25;
-    T    = (mjd + deltaET(year) / (MINPD * 60.0)) / 36525.0;
-    M    = DEG2RAD * (Modulus(358.47583 + Modulus(35999.04975 * T, 360.0) - (0.000150 + 0.0000033 * T) * T * T, 360.0));
-    L    = DEG2RAD * (Modulus(279.69668 + Modulus(36000.76892 * T, 360.0) + 0.0003025 * T * T, 360.0));
-    e    = 0.01675104 - (0.0000418 + 0.000000126 * T) * T;
-    C    = DEG2RAD * ((1.919460 - (0.004789 + 0.000014 * T) * T) * sin(M) + (0.020094 - 0.000100 * T) * sin(2 * M) +
-                   0.000293 * sin(3 * M));
-    O    = DEG2RAD * (Modulus(259.18 - 1934.142 * T, 360.0));
-    Lsa  = Modulus(L + C - DEG2RAD * (0.00569 - 0.00479 * sin(O)), TWOPI);
-    nu   = Modulus(M + C, TWOPI);
-    R    = 1.0000002 * (1.0 - e * e) / (1.0 + e * cos(nu));
-    eps  = DEG2RAD * (23.452294 - (0.0130125 + (0.00000164 - 0.000000503 * T) * T) * T + 0.00256 * cos(O));
-    R    = AU * R;
-
-    double sun_posx = R * cos(Lsa);
-    double sun_posy = R * sin(Lsa) * cos(eps);
-    double sun_posz = R * sin(Lsa) * sin(eps);
-    double sun_posw = R;
+    double sun_posx = context.sunPos[0];
+    double sun_posy = context.sunPos[1];
+    double sun_posz = context.sunPos[2];
+    double sun_posw = context.sunW;
 
     // Calculates satellite's eclipse status and depth
     double sd_sun, sd_earth, delta, depth;
@@ -1227,10 +1293,9 @@ int Satellite::sgp4(double tsince)
     double earth_w = sat_posw;
     delta      = PIO2 - arcSin((sun_posx * earth_x + sun_posy * earth_y + sun_posz * earth_z) / (sun_posw * earth_w));
     depth      = sd_earth - sd_sun - delta;
-    KSSun *sun = (KSSun *)data->skyComposite()->findByName("Sun");
 
     m_is_eclipsed = sd_earth >= sd_sun && depth >= 0;
-    m_is_visible  = !m_is_eclipsed && sun->alt().Degrees() <= -12.0 && elevation >= 0.0;
+    m_is_visible  = !m_is_eclipsed && context.sunAltitude <= -12.0 && elevation >= 0.0;
 
     return (0);
 }
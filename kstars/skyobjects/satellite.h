@@ -23,6 +23,7 @@
 #include "skyobject.h"
 #include "skypoint.h"
 
+class GeoLocation;
 class KSPopupMenu;
 
 /**
@@ -34,6 +35,26 @@ class KSPopupMenu;
 class Satellite : public SkyObject
 {
   public:
+    /**
+         *@struct Context
+         *Time, observer and Sun dependent quantities that are shared by all the satellites
+         *updated for the same instant.
+         */
+    struct Context
+    {
+        double jd { 0 };          // Julian date (UTC)
+        double sinLat { 0 };      // Sine of the observer latitude
+        double cosLat { 1 };      // Cosine of the observer latitude
+        double sinTheta { 0 };    // Sine of the local mean sidereal time
+        double cosTheta { 1 };    // Cosine of the local mean sidereal time
+        double obsPos[3];         // Observer ECI position (km)
+        double sunPos[3];         // Sun ECI position (km)
+        double sunW { 0 };        // Sun distance (km)
+        double sunAltitude { 0 }; // Sun altitude above the observer horizon (degrees)
+        CachingDms lst;           // Local sidereal time
+        CachingDms lat;           // Observer latitude
+    };
+
     /**
          *@short Constructor
          */
@@ -51,10 +72,40 @@ class Satellite : public SkyObject
     ~Satellite();
 
     /**
-         *@short Update satellite position
+         *@short Update satellite position for the current simulation time and location
          */
     int updatePos();
 
+    /**
+         *@short Update satellite position
+         *@param context time, observer and Sun positions to use
+         *@return 0 on success, or an error code for sgp4ErrorString()
+         */
+    int updatePos(const Context &context);
+
+    /**
+         *@short Build the context of an update
+         *@param jd Julian date (UTC)
+         *@param geo observer location
+         *@param lst local sidereal time at jd
+         *@param sunAltitude altitude of the Sun at jd, in degrees
+         */
+    static Context makeContext(double jd, GeoLocation *geo, const dms &lst, double sunAltitude);
+
+    /**
+         *@return the context for the current simulation time and location
+         */
+    static Context currentContext();
+
+    /**
+         *@short Update the positions of many satellites, in parallel chunks
+         *@param satellites satellites to update
+         *@param rc return codes of Satellite::updatePos(), one per satellite
+         *@param count number of satellites
+         *@param context time, observer and Sun positions to use
+         */
+    static void updatePositions(Satellite *const *satellites, int *rc, int count, const Context &context);
+
     /**
          *@return True if the satellite is visible (above horizon, in the sunlight and sun at least 12° under horizon)
          */
@@ -108,12 +159,12 @@ class Satellite : public SkyObject
     /**
          *@short Compute satellite position
          */
-    int sgp4(double tsince);
+    int sgp4(double tsince, const Context &context);
 
     /**
          *@return Arcsine of the argument
          */
-    double arcSin(double arg);
+    static double arcSin(double arg);
 
     /**
          *Provides the difference between UT (approximately the same as UTC)
@@ -121,12 +172,12 @@ class Satellite : public SkyObject
          *This function is based on a least squares fit of data from 1950
          *to 1991 and will need to be updated periodically.
          */
-    double deltaET(double year);
+    static double deltaET(double year);
 
     /**
          *@return arg1 mod arg2
          */
-    double Modulus(double arg1, double arg2);
+    static double Modulus(double arg1, double arg2);
 
     // TLE
     int m_number;          // Satellite Number
@@ -22,6 +22,7 @@
 #include "skyobjects/satellite.h"
 
 #include <QTextStream>
+#include <QVector>
 
 SatelliteGroup::SatelliteGroup(const QString& name, const QString& tle_filename, const QUrl& update_url)
 {
@@ -65,19 +66,27 @@ void SatelliteGroup::readTLE()
 
 void SatelliteGroup::updateSatellitesPos()
 {
-    QMutableListIterator<Satellite *> sats(*this);
+    updateSatellitesPos(Satellite::currentContext());
+}
 
-    while (sats.hasNext())
+void SatelliteGroup::updateSatellitesPos(const Satellite::Context &context)
+{
+    QVector<Satellite *> sats;
+    sats.reserve(size());
+    foreach (Satellite *sat, *this)
     {
-        Satellite *sat = sats.next();
-
         if (sat->selected())
-        {
-            int rc = sat->updatePos();
-            // If position cannot be calculated, remove it from list
-            if (rc != 0)
-                sats.remove();
-        }
+            sats.append(sat);
+    }
+
+    QVector<int> rc(sats.size());
+    Satellite::updatePositions(sats.constData(), rc.data(), sats.size(), context);
+
+    // If position cannot be calculated, remove it from list
+    for (int i = 0; i < sats.size(); i++)
+    {
+        if (rc[i] != 0)
+            removeOne(sats[i]);
     }
 }
 
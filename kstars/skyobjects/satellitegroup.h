@@ -17,11 +17,11 @@
 
 #pragma once
 
+#include "satellite.h"
+
 #include <QString>
 #include <QUrl>
 
-class Satellite;
-
 /**
  * @class SatelliteGroup
  * Represents a group of artificial satellites.
@@ -51,6 +51,13 @@ class SatelliteGroup : public QList<Satellite *>
      */
     void updateSatellitesPos();
 
+    /**
+     * Compute the position of the selected satellites in the group, in parallel. Satellites whose position
+     * cannot be computed are removed from the group.
+     * @param context time, observer and Sun positions shared by all satellites
+     */
+    void updateSatellitesPos(const Satellite::Context &context);
+
     /**
      * @return TLE filename
      */
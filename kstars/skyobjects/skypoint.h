@@ -568,6 +568,7 @@ class SkyPoint
 #ifdef UNIT_TEST
     friend class TestSkyPoint; // Test class
 #endif
+    friend class SkyPointBatch; // Batch versions of updateCoords() and EquatorialToHorizontal()
 
   private:
     CachingDms RA0, Dec0; //catalog coordinates
@@ -0,0 +1,300 @@
+/***************************************************************************
+                  skypointbatch.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : Sat 14 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "skypointbatch.h"
+
+#include "ksnumbers.h"
+#include "kstarsdata.h"
+#include "Options.h"
+#include "skyobject.h"
+#include "skypoint.h"
+#include "skycomponents/skymapcomposite.h"
+
+#include <QtGlobal>
+
+#include <cmath>
+
+namespace
+{
+// Chunks live on the stack, so that the kernels never allocate
+typedef Eigen::Array<double, Eigen::Dynamic, 1, Eigen::ColMajor, SkyPointBatch::ChunkSize, 1> Chunk;
+typedef Eigen::Map<const Eigen::ArrayXd> ConstArrayMap;
+typedef Eigen::Map<Eigen::ArrayXd> ArrayMap;
+
+struct atan2Op
+{
+    double operator()(double y, double x) const { return std::atan2(y, x); }
+};
+
+// Rotation of the coordinate frame about the x axis
+Eigen::Matrix3d rotateX(double angle)
+{
+    double s = std::sin(angle), c = std::cos(angle);
+    Eigen::Matrix3d m;
+    m << 1, 0, 0, 0, c, s, 0, -s, c;
+    return m;
+}
+
+// Rotation of the coordinate frame about the z axis
+Eigen::Matrix3d rotateZ(double angle)
+{
+    double s = std::sin(angle), c = std::cos(angle);
+    Eigen::Matrix3d m;
+    m << c, s, 0, -s, c, 0, 0, 0, 1;
+    return m;
+}
+
+// v = M s, one component per array
+inline void rotate(const Eigen::Matrix3d &M, const Chunk &sx, const Chunk &sy, const Chunk &sz, Chunk &x, Chunk &y,
+                   Chunk &z)
+{
+    x = M(0, 0) * sx + M(0, 1) * sy + M(0, 2) * sz;
+    y = M(1, 0) * sx + M(1, 1) * sy + M(1, 2) * sz;
+    z = M(2, 0) * sx + M(2, 1) * sy + M(2, 2) * sz;
+}
+}
+
+SkyPointBatch::SkyPointBatch(const KSNumbers *num, const CachingDms *LST, const CachingDms *lat)
+{
+    setEpoch(num);
+    setLocation(LST, lat);
+}
+
+SkyPointBatch::SkyPointBatch(const CachingDms *LST, const CachingDms *lat)
+    : m_Apparent(Eigen::Matrix3d::Identity()), m_Sun(Eigen::Vector3d::Zero())
+{
+    setLocation(LST, lat);
+}
+
+void SkyPointBatch::setEpoch(const KSNumbers *num)
+{
+    m_Num = num;
+
+    // Nutation: go to ecliptic coordinates, add the nutation in longitude, and come back using the
+    // true obliquity. Combined with precession, this is a single rotation.
+    const double obliquity = num->obliquity()->radians();
+    const double dEcLong   = num->dEcLong() * dms::DegToRad;
+    const double dObliq    = num->dObliq() * dms::DegToRad;
+    m_Apparent = rotateX(-(obliquity + dObliq)) * rotateZ(-dEcLong) * rotateX(obliquity) * num->p2();
+
+    // Aberration, factored the same way as in SkyPoint::aberrate()
+    double sinL, cosL, sinP, cosP;
+    num->obliquity()->SinCos(m_SinOb, m_CosOb);
+    num->sunTrueLongitude().SinCos(sinL, cosL);
+    num->earthPerihelionLongitude().SinCos(sinP, cosP);
+    const double K = num->constAberr().radians();
+    const double e = num->earthEccentricity();
+    m_AberrA       = K * m_CosOb * (e * cosP - cosL);
+    m_AberrB       = K * (e * cosP - cosL);
+    m_AberrC       = K * (e * sinP - sinL);
+
+    m_Relativistic = false;
+    KStarsData *data = KStarsData::Instance();
+    if (Options::useRelativistic() && data && data->skyComposite())
+    {
+        SkyObject *sun = data->skyComposite()->findByName("Sun");
+        if (sun)
+        {
+            double sinRA, cosRA, sinDec, cosDec;
+            sun->ra().SinCos(sinRA, cosRA);
+            sun->dec().SinCos(sinDec, cosDec);
+            m_Sun << cosRA * cosDec, sinRA * cosDec, sinDec;
+            m_CosMaxAngle  = std::cos(1.75 * (30.0 / 200.0));
+            m_Relativistic = true;
+        }
+    }
+}
+
+void SkyPointBatch::setLocation(const CachingDms *LST, const CachingDms *lat)
+{
+    double sinLST, cosLST, sinLat, cosLat;
+    LST->SinCos(sinLST, cosLST);
+    lat->SinCos(sinLat, cosLat);
+
+    // Rows are the north, east and up directions. The azimuth is measured from the north towards the
+    // east, as in SkyPoint::EquatorialToHorizontal().
+    m_Horizontal << -sinLat * cosLST, -sinLat * sinLST, cosLat, -sinLST, cosLST, 0, cosLat * cosLST, cosLat * sinLST,
+        sinLat;
+}
+
+bool SkyPointBatch::bendsLight(double ra, double dec) const
+{
+    if (!m_Relativistic)
+        return false;
+    const double cosDec = std::cos(dec);
+    return m_Sun[0] * std::cos(ra) * cosDec + m_Sun[1] * std::sin(ra) * cosDec + m_Sun[2] * std::sin(dec) >=
+           m_CosMaxAngle;
+}
+
+namespace
+{
+/**
+ * Applies the aberration of SkyPoint::aberrate() to unit vectors. The offsets in RA and Dec are turned
+ * into a displacement along the local RA and Dec directions, so no trigonometric functions are needed.
+ */
+inline void aberrate(double A, double B, double C, double sinOb, double cosOb, Chunk &x, Chunk &y, Chunk &z)
+{
+    Chunk rho  = (x.square() + y.square()).sqrt();
+    Chunk cosA = (rho > 0.0).select(x / rho, 1.0);
+    Chunk sinA = (rho > 0.0).select(y / rho, 0.0);
+
+    // dRA * cos(Dec), and dDec
+    Chunk dRA  = A * cosA;
+    Chunk dDec = B * sinA * (sinOb * rho - cosOb * z) + C * cosA * z;
+
+    Chunk zDec = dDec * z;
+    x          = x - dRA * sinA - zDec * cosA;
+    y          = y + dRA * cosA - zDec * sinA;
+    z          = z + dDec * rho;
+}
+}
+
+void SkyPointBatch::apparentCoords(const double *ra0, const double *dec0, double *ra, double *dec, int n) const
+{
+    Q_ASSERT(m_Num);
+
+    for (int start = 0; start < n; start += ChunkSize)
+    {
+        const int count = qMin(int(ChunkSize), n - start);
+
+        ConstArrayMap inRA(ra0 + start, count), inDec(dec0 + start, count);
+        ArrayMap outRA(ra + start, count), outDec(dec + start, count);
+
+        Chunk cosDec = inDec.cos();
+        Chunk sx = inRA.cos() * cosDec, sy = inRA.sin() * cosDec, sz = inDec.sin();
+        Chunk x, y, z;
+        rotate(m_Apparent, sx, sy, sz, x, y, z);
+        aberrate(m_AberrA, m_AberrB, m_AberrC, m_SinOb, m_CosOb, x, y, z);
+
+        Chunk alpha = y.binaryExpr(x, atan2Op());
+        outRA       = (alpha < 0.0).select(alpha + 2.0 * dms::PI, alpha);
+        outDec      = z.binaryExpr((x.square() + y.square()).sqrt(), atan2Op());
+    }
+}
+
+void SkyPointBatch::toHorizontal(const double *ra, const double *dec, double *alt, double *az, int n) const
+{
+    for (int start = 0; start < n; start += ChunkSize)
+    {
+        const int count = qMin(int(ChunkSize), n - start);
+
+        ConstArrayMap inRA(ra + start, count), inDec(dec + start, count);
+        ArrayMap outAlt(alt + start, count), outAz(az + start, count);
+
+        Chunk cosDec = inDec.cos();
+        Chunk sx = inRA.cos() * cosDec, sy = inRA.sin() * cosDec, sz = inDec.sin();
+        Chunk north, east, up;
+        rotate(m_Horizontal, sx, sy, sz, north, east, up);
+
+        Chunk azimuth = east.binaryExpr(north, atan2Op());
+        outAlt        = up.max(-1.0).min(1.0).asin();
+        outAz         = (azimuth < 0.0).select(azimuth + 2.0 * dms::PI, azimuth);
+    }
+}
+
+void SkyPointBatch::updateCoords(SkyPoint *const *points, int n, bool forceRecompute) const
+{
+    Q_ASSERT(m_Num);
+
+    const double jd   = m_Num->getJD();
+    const bool always = forceRecompute || Options::alwaysRecomputeCoordinates();
+
+    for (int start = 0; start < n; start += ChunkSize)
+    {
+        const int end = qMin(start + int(ChunkSize), n);
+
+        // Gather the points that are due, using the cached sines and cosines of the catalog coordinates
+        SkyPoint *due[ChunkSize];
+        Chunk sx(int(ChunkSize)), sy(int(ChunkSize)), sz(int(ChunkSize));
+        int count = 0;
+        for (int i = start; i < end; ++i)
+        {
+            SkyPoint *p = points[i];
+            double sinRA, cosRA, sinDec, cosDec;
+
+            if (m_Relativistic)
+            {
+                p->RA.SinCos(sinRA, cosRA);
+                p->Dec.SinCos(sinDec, cosDec);
+                if (m_Sun[0] * cosRA * cosDec + m_Sun[1] * sinRA * cosDec + m_Sun[2] * sinDec >= m_CosMaxAngle)
+                {
+                    p->SkyPoint::updateCoords(m_Num, false, nullptr, nullptr, true);
+                    continue;
+                }
+            }
+            if (!always && std::abs(p->lastPrecessJD - jd) < 0.00069444) // Update once per solar minute
+                continue;
+
+            p->RA0.SinCos(sinRA, cosRA);
+            p->Dec0.SinCos(sinDec, cosDec);
+            sx[count]    = cosRA * cosDec;
+            sy[count]    = sinRA * cosDec;
+            sz[count]    = sinDec;
+            due[count++] = p;
+        }
+        if (count == 0)
+            continue;
+
+        sx.conservativeResize(count);
+        sy.conservativeResize(count);
+        sz.conservativeResize(count);
+        Chunk x, y, z;
+        rotate(m_Apparent, sx, sy, sz, x, y, z);
+        aberrate(m_AberrA, m_AberrB, m_AberrC, m_SinOb, m_CosOb, x, y, z);
+        Chunk sinDec = z / (x.square() + y.square() + z.square()).sqrt();
+
+        for (int i = 0; i < count; ++i)
+        {
+            SkyPoint *p = due[i];
+            p->RA.setUsing_atan2(y[i], x[i]);
+            p->RA.reduceToRange(dms::ZERO_TO_2PI);
+            p->Dec.setUsing_asin(qBound(-1.0, sinDec[i], 1.0));
+            p->lastPrecessJD = jd;
+        }
+    }
+}
+
+void SkyPointBatch::EquatorialToHorizontal(SkyPoint *const *points, int n) const
+{
+    for (int start = 0; start < n; start += ChunkSize)
+    {
+        const int count = qMin(int(ChunkSize), n - start);
+
+        Chunk sx(count), sy(count), sz(count);
+        for (int i = 0; i < count; ++i)
+        {
+            double sinRA, cosRA, sinDec, cosDec;
+            points[start + i]->RA.SinCos(sinRA, cosRA);
+            points[start + i]->Dec.SinCos(sinDec, cosDec);
+            sx[i] = cosRA * cosDec;
+            sy[i] = sinRA * cosDec;
+            sz[i] = sinDec;
+        }
+
+        Chunk north, east, up;
+        rotate(m_Horizontal, sx, sy, sz, north, east, up);
+        Chunk alt     = up.max(-1.0).min(1.0).asin();
+        Chunk azimuth = east.binaryExpr(north, atan2Op());
+        azimuth       = (azimuth < 0.0).select(azimuth + 2.0 * dms::PI, azimuth);
+
+        for (int i = 0; i < count; ++i)
+        {
+            points[start + i]->Alt.setRadians(alt[i]);
+            points[start + i]->Az.setRadians(azimuth[i]);
+        }
+    }
+}
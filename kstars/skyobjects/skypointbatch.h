@@ -0,0 +1,185 @@
+/***************************************************************************
+                   skypointbatch.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : Sat 14 Oct 2017
+    copyright            : (C) 2017 by KStars Team
+    email                : kstars-devel@kde.org
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include <Eigen/Core>
+
+class CachingDms;
+class KSNumbers;
+class SkyPoint;
+
+/**
+ * @class SkyPointBatch
+ * @short Converts many points between coordinate systems at once
+ *
+ * SkyPoint::updateCoords() and SkyPoint::EquatorialToHorizontal() convert one point per call and redo
+ * all the epoch- and location-dependent set-up every time. SkyPointBatch does that set-up once:
+ * precession and nutation are folded into a single rotation matrix built from a KSNumbers object, and
+ * the conversion to horizontal coordinates is a second rotation matrix built from the LST and the
+ * latitude. Points are then pushed through both as unit vectors, in chunks of packed doubles that
+ * Eigen can vectorize.
+ *
+ * The results agree with the scalar path to better than 0.1 arcseconds. Because nutation is applied
+ * as a rotation at every declination, points within 10 degrees of the poles come out slightly more
+ * accurate than with SkyPoint::nutate(), which ignores the nutation in obliquity there.
+ *
+ * @note The SkyPoint overloads only implement SkyPoint::updateCoords(). Do not use them for objects
+ * that override it, such as stars and solar system bodies.
+ *
+ * @version 0.1
+ */
+class SkyPointBatch
+{
+  public:
+    /** Number of points that are converted together */
+    static const int ChunkSize = 64;
+
+    /**
+     * @short Constructor. Prepares the conversions for the given epoch and location.
+     * @param num KSNumbers object describing the target epoch
+     * @param LST pointer to the local sidereal time
+     * @param lat pointer to the geographic latitude
+     */
+    SkyPointBatch(const KSNumbers *num, const CachingDms *LST, const CachingDms *lat);
+
+    /**
+     * @short Constructor for conversions to horizontal coordinates only
+     * @param LST pointer to the local sidereal time
+     * @param lat pointer to the geographic latitude
+     * @note updateCoords() and apparentCoords() must not be used until setEpoch() has been called.
+     */
+    SkyPointBatch(const CachingDms *LST, const CachingDms *lat);
+
+    /**
+     * @short Rebuild the precession-nutation matrix and the aberration terms for a new epoch
+     * @param num KSNumbers object describing the target epoch
+     */
+    void setEpoch(const KSNumbers *num);
+
+    /**
+     * @short Rebuild the equatorial to horizontal rotation for a new time or place
+     * @param LST pointer to the local sidereal time
+     * @param lat pointer to the geographic latitude
+     */
+    void setLocation(const CachingDms *LST, const CachingDms *lat);
+
+    /**
+     * @short Apply precession, nutation and aberration to arrays of catalog coordinates
+     * @param ra0 catalog right ascensions, in radians
+     * @param dec0 catalog declinations, in radians
+     * @param ra output apparent right ascensions in [0, 2pi), in radians
+     * @param dec output apparent declinations, in radians
+     * @param n number of points
+     * @note Light bending is not applied. Use bendsLight() to find the points that need it.
+     */
+    void apparentCoords(const double *ra0, const double *dec0, double *ra, double *dec, int n) const;
+
+    /**
+     * @short Convert arrays of apparent equatorial coordinates to horizontal coordinates
+     * @param ra apparent right ascensions, in radians
+     * @param dec apparent declinations, in radians
+     * @param alt output altitudes, in radians
+     * @param az output azimuths in [0, 2pi), in radians
+     * @param n number of points
+     */
+    void toHorizontal(const double *ra, const double *dec, double *alt, double *az, int n) const;
+
+    /**
+     * @return true if relativistic corrections are enabled and the given apparent position is close
+     * enough to the Sun for light bending to matter. Uses the same limit as SkyPoint::checkBendLight().
+     */
+    bool bendsLight(double ra, double dec) const;
+
+    /**
+     * @short Batch version of SkyPoint::updateCoords()
+     *
+     * Points that were updated less than a solar minute ago are skipped unless @p forceRecompute is
+     * set, and points close to the Sun are handed to SkyPoint::updateCoords() for light bending.
+     */
+    void updateCoords(SkyPoint *const *points, int n, bool forceRecompute = false) const;
+
+    /**
+     * @short Batch version of SkyPoint::EquatorialToHorizontal()
+     */
+    void EquatorialToHorizontal(SkyPoint *const *points, int n) const;
+
+    /**
+     * @short Convenience overload for containers of (smart) pointers to SkyPoints
+     */
+    template <typename Container>
+    void updateCoords(const Container &points, bool forceRecompute = false) const
+    {
+        SkyPoint *chunk[ChunkSize];
+        int n = 0;
+        for (const auto &p : points)
+        {
+            chunk[n++] = &*p;
+            if (n == ChunkSize)
+            {
+                updateCoords(chunk, n, forceRecompute);
+                n = 0;
+            }
+        }
+        if (n > 0)
+            updateCoords(chunk, n, forceRecompute);
+    }
+
+    /**
+     * @short Convenience overload for containers of (smart) pointers to SkyPoints
+     */
+    template <typename Container>
+    void EquatorialToHorizontal(const Container &points) const
+    {
+        SkyPoint *chunk[ChunkSize];
+        int n = 0;
+        for (const auto &p : points)
+        {
+            chunk[n++] = &*p;
+            if (n == ChunkSize)
+            {
+                EquatorialToHorizontal(chunk, n);
+                n = 0;
+            }
+        }
+        if (n > 0)
+            EquatorialToHorizontal(chunk, n);
+    }
+
+    /** @return the matrix that takes J2000 unit vectors to precessed and nutated ones */
+    inline const Eigen::Matrix3d &apparentMatrix() const { return m_Apparent; }
+
+    /** @return the matrix that takes equatorial unit vectors to (north, east, up) unit vectors */
+    inline const Eigen::Matrix3d &horizontalMatrix() const { return m_Horizontal; }
+
+  private:
+    const KSNumbers *m_Num { nullptr };
+    Eigen::Matrix3d m_Apparent;
+    Eigen::Matrix3d m_Horizontal;
+
+    // Aberration, see SkyPoint::aberrate()
+    double m_AberrA { 0 };
+    double m_AberrB { 0 };
+    double m_AberrC { 0 };
+    double m_SinOb { 0 };
+    double m_CosOb { 1 };
+
+    // Light bending, see SkyPoint::checkBendLight()
+    bool m_Relativistic { false };
+    Eigen::Vector3d m_Sun;
+    double m_CosMaxAngle { 1 };
+};
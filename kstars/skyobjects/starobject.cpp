@@ -144,21 +144,62 @@ StarObject *StarObject::clone() const
     return new StarObject(*this);
 }
 
+StarObject::CatalogData StarObject::decode(const starData *stardata)
+{
+    CatalogData data;
+    data.ra0    = stardata->RA / 1000000.0;
+    data.dec0   = stardata->Dec / 100000.0;
+    data.pmRA   = stardata->dRA / 10.0;
+    data.pmDec  = stardata->dDec / 10.0;
+    data.mag    = stardata->mag / 100.0;
+    data.spType = stardata->spec_type[0];
+    return data;
+}
+
+StarObject::CatalogData StarObject::decode(const deepStarData *stardata)
+{
+    CatalogData data;
+    data.ra0   = stardata->RA / 1000000.0;
+    data.dec0  = stardata->Dec / 100000.0;
+    data.pmRA  = stardata->dRA / 100.0;
+    data.pmDec = stardata->dDec / 100.0;
+
+    if (stardata->V == 30000 && stardata->B != 30000)
+        data.mag = (stardata->B - 1600) / 1000.0; // FIXME: Is it okay to make up stuff like this?
+    else
+        data.mag = stardata->V / 1000.0;
+
+    data.spType = 'B';
+    if (stardata->B == 30000 || stardata->V == 30000)
+    {
+        data.spType = '?';
+    }
+    else
+    {
+        double BV_Index = (stardata->B - stardata->V) / 1000.0;
+        (BV_Index > 0.0) && (data.spType = 'A');
+        (BV_Index > 0.325) && (data.spType = 'F');
+        (BV_Index > 0.575) && (data.spType = 'G');
+        (BV_Index > 0.975) && (data.spType = 'K');
+        (BV_Index > 1.6) && (data.spType = 'M');
+    }
+
+    return data;
+}
+
 void StarObject::init(const starData *stardata)
 {
-    double ra, dec;
-    ra  = stardata->RA / 1000000.0;
-    dec = stardata->Dec / 100000.0;
+    CatalogData data = decode(stardata);
     setType(SkyObject::STAR);
-    setMag(stardata->mag / 100.0);
-    setRA0(ra);
-    setDec0(dec);
+    setMag(data.mag);
+    setRA0(data.ra0);
+    setDec0(data.dec0);
     setRA(ra0());
     setDec(dec0());
-    SpType[0]    = stardata->spec_type[0];
+    SpType[0]    = data.spType;
     SpType[1]    = stardata->spec_type[1];
-    PM_RA        = stardata->dRA / 10.0;
-    PM_Dec       = stardata->dDec / 10.0;
+    PM_RA        = data.pmRA;
+    PM_Dec       = data.pmDec;
     Parallax     = stardata->parallax / 10.0;
     Multiplicity = stardata->flags & 0x02;
     Variability  = stardata->flags & 0x04;
@@ -195,41 +236,17 @@ void StarObject::init(const starData *stardata)
 
 void StarObject::init(const deepStarData *stardata)
 {
-    double ra, dec, BV_Index;
-
-    ra  = stardata->RA / 1000000.0;
-    dec = stardata->Dec / 100000.0;
+    CatalogData data = decode(stardata);
     setType(SkyObject::STAR);
-
-    if (stardata->V == 30000 && stardata->B != 30000)
-        setMag((stardata->B - 1600) / 1000.0); // FIXME: Is it okay to make up stuff like this?
-    else
-        setMag(stardata->V / 1000.0);
-
-    setRA0(ra);
-    setDec0(dec);
-    setRA(ra);
-    setDec(dec);
-
-    SpType[1] = '?';
-    SpType[0] = 'B';
-    if (stardata->B == 30000 || stardata->V == 30000)
-    {
-        BV_Index  = -100;
-        SpType[0] = '?';
-    }
-    else
-    {
-        BV_Index = (stardata->B - stardata->V) / 1000.0;
-        (BV_Index > 0.0) && (SpType[0] = 'A');
-        (BV_Index > 0.325) && (SpType[0] = 'F');
-        (BV_Index > 0.575) && (SpType[0] = 'G');
-        (BV_Index > 0.975) && (SpType[0] = 'K');
-        (BV_Index > 1.6) && (SpType[0] = 'M');
-    }
-
-    PM_RA        = stardata->dRA / 100.0;
-    PM_Dec       = stardata->dDec / 100.0;
+    setMag(data.mag);
+    setRA0(data.ra0);
+    setDec0(data.dec0);
+    setRA(data.ra0);
+    setDec(data.dec0);
+    SpType[0]    = data.spType;
+    SpType[1]    = '?';
+    PM_RA        = data.pmRA;
+    PM_Dec       = data.pmDec;
     Parallax     = 0.0;
     Multiplicity = 0;
     Variability  = 0;
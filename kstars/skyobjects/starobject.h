@@ -113,6 +113,27 @@ class StarObject : public SkyObject
          */
     void init(const deepStarData *stardata);
 
+    /** Position, proper motion, magnitude and spectral class decoded from a binary catalog record */
+    struct CatalogData
+    {
+        double ra0;    // hours
+        double dec0;   // degrees
+        double pmRA;   // milliarcseconds per year
+        double pmDec;  // milliarcseconds per year
+        float mag;
+        char spType;
+    };
+
+    /**
+         *@short  Decode a catalog record the way init() does, without initializing a StarObject
+         *
+         *This is used by StarBlock, which keeps most stars in packed arrays.
+         *@param  stardata  Pointer to the catalog record
+         *@return The decoded data
+         */
+    static CatalogData decode(const starData *stardata);
+    static CatalogData decode(const deepStarData *stardata);
+
     /**
          *@short  Sets the name, genetive name, and long name
          *
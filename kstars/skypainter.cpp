@@ -23,6 +23,7 @@
 #include "skymap.h"
 #include "Options.h"
 #include "kstarsdata.h"
+#include "projections/projector.h"
 #include "skycomponents/skiplist.h"
 #include "skycomponents/linelistlabel.h"
 #include "skyobjects/deepskyobject.h"
@@ -41,6 +42,18 @@ SkyPainter::~SkyPainter()
 {
 }
 
+void SkyPainter::projectPoints(const Projector *proj, const SkyList *points, bool oRefract)
+{
+    const int n = points->size();
+    m_pointBuffer.resize(n);
+    m_screenBuffer.resize(n);
+    m_visibleBuffer.resize(n);
+
+    for (int i = 0; i < n; ++i)
+        m_pointBuffer[i] = points->at(i).get();
+    proj->pointsToScreen(m_pointBuffer.constData(), n, m_screenBuffer.data(), m_visibleBuffer.data(), oRefract);
+}
+
 void SkyPainter::setSizeMagLimit(float sizeMagLim)
 {
     m_sizeMagLim = sizeMagLim;
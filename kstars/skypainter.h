@@ -22,6 +22,9 @@
 
 #include <QList>
 #include <QPainter>
+#include <QVector>
+
+#include <Eigen/Core>
 
 #include "skycomponents/typedef.h"
 
@@ -31,6 +34,7 @@ class KSComet;
 class KSPlanetBase;
 class LineList;
 class LineListLabel;
+class Projector;
 class Satellite;
 class SkipList;
 class SkyMap;
@@ -129,6 +133,21 @@ class SkyPainter
      */
     virtual bool drawPointSource(SkyPoint *loc, float mag, char sp = 'A') = 0;
 
+    /**
+     * @short Draw a run of point sources (e.g., stars) from packed coordinates.
+     * The positions are projected in one batch, see Projector::toScreenBatch().
+     * @param ra right ascensions of the sources, in radians
+     * @param dec declinations of the sources, in radians
+     * @param alt altitudes of the sources, in radians
+     * @param az azimuths of the sources, in radians
+     * @param mag magnitudes of the sources
+     * @param sp spectral classes of the sources
+     * @param n the number of sources
+     * @return the number of sources drawn
+     */
+    virtual int drawPointSources(const double *ra, const double *dec, const double *alt, const double *az,
+                                 const float *mag, const char *sp, int n) = 0;
+
     /**
      * @short Draw a deep sky object
      * @param obj the object to draw
@@ -172,8 +191,18 @@ class SkyPainter
     virtual bool drawConstellationArtImage(ConstellationsArt *obj) = 0;
 
   protected:
+    /**
+     * @short Project all points of a line list in one batch call
+     * The screen positions and visibility flags are left in m_screenBuffer and m_visibleBuffer.
+     * @see Projector::pointsToScreen()
+     */
+    void projectPoints(const Projector *proj, const SkyList *points, bool oRefract);
+
     SkyMap *m_sm { nullptr };
+    QVector<Eigen::Vector2f> m_screenBuffer;
+    QVector<bool> m_visibleBuffer;
 
   private:
     float m_sizeMagLim;
+    QVector<SkyPoint *> m_pointBuffer;
 };
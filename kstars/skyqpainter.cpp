@@ -20,6 +20,7 @@
 #include "skyqpainter.h"
 
 #include "kstarsdata.h"
+#include "ksutils.h"
 #include "Options.h"
 #include "skymap.h"
 #include "projections/projector.h"
@@ -295,18 +296,21 @@ void SkyQPainter::drawSkyPolyline(LineList *list, SkipList *skipList, LineListLa
     SkyList *points = list->points();
     bool isVisible, isVisibleLast;
 
-    QPointF oLast = m_proj->toScreen(points->first().get(), true, &isVisibleLast);
+    // Project the whole line at once, then walk the buffers
+    projectPoints(m_proj, points, true);
+
+    QPointF oLast = KSUtils::vecToPoint(m_screenBuffer[0]);
     // & with the result of checkVisibility to clip away things below horizon
-    isVisibleLast &= m_proj->checkVisibility(points->first().get());
+    isVisibleLast = m_visibleBuffer[0] && m_proj->checkVisibility(points->first().get());
     QPointF oThis, oThis2;
 
     for (int j = 1; j < points->size(); j++)
     {
         SkyPoint *pThis = points->at(j).get();
 
-        oThis2 = oThis = m_proj->toScreen(pThis, true, &isVisible);
+        oThis2 = oThis = KSUtils::vecToPoint(m_screenBuffer[j]);
         // & with the result of checkVisibility to clip away things below horizon
-        isVisible &= m_proj->checkVisibility(pThis);
+        isVisible = m_visibleBuffer[j] && m_proj->checkVisibility(pThis);
         bool doSkip = false;
         if (skipList)
         {
@@ -349,10 +353,11 @@ void SkyQPainter::drawSkyPolygon(LineList *list, bool forceClip)
 
     if (forceClip == false)
     {
+        projectPoints(m_proj, points, false);
         for (int i = 0; i < points->size(); ++i)
         {
-            polygon << m_proj->toScreen(points->at(i).get(), false, &isVisibleLast);
-            isVisible |= isVisibleLast;
+            polygon << KSUtils::vecToPoint(m_screenBuffer[i]);
+            isVisible |= m_visibleBuffer[i];
         }
 
         // If 1+ points are visible, draw it
@@ -362,17 +367,19 @@ void SkyQPainter::drawSkyPolygon(LineList *list, bool forceClip)
         return;
     }
 
+    projectPoints(m_proj, points, true);
+
     SkyPoint *pLast = points->last().get();
-    QPointF oLast   = m_proj->toScreen(pLast, true, &isVisibleLast);
+    QPointF oLast   = KSUtils::vecToPoint(m_screenBuffer.last());
     // & with the result of checkVisibility to clip away things below horizon
-    isVisibleLast &= m_proj->checkVisibility(pLast);
+    isVisibleLast = m_visibleBuffer.last() && m_proj->checkVisibility(pLast);
 
     for (int i = 0; i < points->size(); ++i)
     {
         SkyPoint *pThis = points->at(i).get();
-        QPointF oThis   = m_proj->toScreen(pThis, true, &isVisible);
+        QPointF oThis   = KSUtils::vecToPoint(m_screenBuffer[i]);
         // & with the result of checkVisibility to clip away things below horizon
-        isVisible &= m_proj->checkVisibility(pThis);
+        isVisible = m_visibleBuffer[i] && m_proj->checkVisibility(pThis);
 
         if (isVisible && isVisibleLast)
         {
@@ -548,6 +555,40 @@ bool SkyQPainter::drawPointSource(SkyPoint *loc, float mag, char sp)
     }
 }
 
+int SkyQPainter::drawPointSources(const double *ra, const double *dec, const double *alt, const double *az,
+                                  const float *mag, const char *sp, int n)
+{
+    const int chunkSize = 64;
+    Vector2f screen[chunkSize];
+    bool visible[chunkSize];
+
+    const ViewParams &vp = m_proj->viewParams();
+    // Same horizon test as Projector::checkVisibility()
+    const double minAlt = -1.0 * dms::DegToRad;
+    int drawn           = 0;
+
+    for (int start = 0; start < n; start += chunkSize)
+    {
+        const int count = qMin(chunkSize, n - start);
+        if (vp.useAltAz)
+            m_proj->toScreenBatch(az + start, alt + start, count, screen, visible);
+        else
+            m_proj->toScreenBatch(ra + start, dec + start, count, screen, visible);
+
+        for (int i = 0; i < count; ++i)
+        {
+            if (!visible[i] || (vp.fillGround && alt[start + i] < minAlt))
+                continue;
+            QPointF pos = KSUtils::vecToPoint(screen[i]);
+            if (!m_proj->onScreen(pos))
+                continue;
+            drawPointSource(pos, starWidth(mag[start + i]), sp[start + i]);
+            ++drawn;
+        }
+    }
+    return drawn;
+}
+
 void SkyQPainter::drawPointSource(const QPointF &pos, float size, char sp)
 {
     int isize = qMin(static_cast<int>(size), 14);
@@ -83,6 +83,8 @@ class SkyQPainter : public SkyPainter, public QPainter
     void drawSkyPolyline(LineList *list, SkipList *skipList = 0, LineListLabel *label = 0) Q_DECL_OVERRIDE;
     void drawSkyPolygon(LineList *list, bool forceClip = true) Q_DECL_OVERRIDE;
     bool drawPointSource(SkyPoint *loc, float mag, char sp = 'A') Q_DECL_OVERRIDE;
+    int drawPointSources(const double *ra, const double *dec, const double *alt, const double *az, const float *mag,
+                         const char *sp, int n) Q_DECL_OVERRIDE;
     bool drawDeepSkyObject(DeepSkyObject *obj, bool drawImage = false) Q_DECL_OVERRIDE;
     bool drawPlanet(KSPlanetBase *planet) Q_DECL_OVERRIDE;
     void drawObservingList(const QList<SkyObject *> &obs) Q_DECL_OVERRIDE;
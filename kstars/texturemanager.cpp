@@ -35,9 +35,11 @@
 #include <QGLWidget>
 #endif
 
-// We returning reference to image. We refer to this image when search
-// for image fails
-const static QImage emptyImage;
+#include <QDebug>
+#include <QDir>
+#include <QMutexLocker>
+#include <QThread>
+#include <QtConcurrent>
 
 TextureManager *TextureManager::m_p = nullptr;
 
@@ -54,72 +56,107 @@ void TextureManager::Release()
     m_p = nullptr;
 }
 
-const QImage &TextureManager::getImage(const QString &name)
+QImage TextureManager::getImage(const QString &name)
 {
     Create();
     if (name.isEmpty())
-        return emptyImage;
-    CacheIter it = findTexture(name);
-    if (it != m_p->m_textures.constEnd())
+        return QImage();
+
+    QString filename;
     {
-        return *it;
+        QMutexLocker locker(&m_p->m_mutex);
+
+        QImage *image = m_p->m_textures.object(name);
+        if (image)
+            return *image;
+
+        // Names without a file are not looked for on disk again
+        filename = m_p->m_files.value(name);
+        if (filename.isEmpty())
+            return QImage();
     }
-    else
+
+    return m_p->decode(name, filename);
+}
+
+QImage TextureManager::requestImage(const QString &name, bool *pending)
+{
+    Create();
+    if (pending)
+        *pending = false;
+    if (name.isEmpty())
+        return QImage();
+
+    QMutexLocker locker(&m_p->m_mutex);
+
+    QImage *image = m_p->m_textures.object(name);
+    if (image)
+        return *image;
+
+    QString filename = m_p->m_files.value(name);
+    if (filename.isEmpty())
+        return QImage();
+
+    if (pending)
+        *pending = true;
+
+    if (!m_p->m_pending.contains(name))
     {
-        return emptyImage;
+        TextureManager *manager = m_p;
+        manager->m_pending.insert(name);
+        QtConcurrent::run(&manager->m_decoders, [manager, name, filename]() {
+            manager->decode(name, filename);
+            emit manager->imageLoaded(name);
+        });
     }
+
+    return QImage();
 }
 
-// FIXME: should be cache images which are not found?
-TextureManager::CacheIter TextureManager::findTexture(const QString &name)
+QImage TextureManager::decode(const QString &name, const QString &filename)
 {
-    Create();
-    // Lookup in cache first
-    CacheIter it = m_p->m_textures.constFind(name);
-    if (it != m_p->m_textures.constEnd())
+    QImage image(filename, "PNG");
+
+    QMutexLocker locker(&m_mutex);
+
+    m_pending.remove(name);
+    if (image.isNull())
     {
-        return it;
+        // Not tried again
+        qWarning() << "Could not read texture" << filename;
+        m_files.remove(name);
+        return image;
     }
-    else
+
+    // Images larger than the cache are not kept
+    m_textures.insert(name, new QImage(image), qMax(1, image.byteCount() / 1024));
+    return image;
+}
+
+void TextureManager::indexTextures()
+{
+    // Images are searched for in the textures, then in the constellation art of the western and Inuit cultures,
+    // then in the data directory itself. Each of them is searched for in the data locations in turn.
+    const QStringList subdirs = { "textures/", "skycultures/western/", "skycultures/inuit/", QString() };
+
+    QStringList locations;
+    foreach (const QString &location, QStandardPaths::standardLocations(QStandardPaths::GenericDataLocation))
+        locations.append(location + "/kstars/");
+#ifdef ANDROID
+    locations.append("/data/data/org.kde.kstars.lite/qt-reserved-files/share/kstars/");
+#endif
+
+    foreach (const QString &subdir, subdirs)
     {
-        // Try to load from file in 'textures' subdirectory
-        QString filename = KSPaths::locate(QStandardPaths::GenericDataLocation, QString("textures/%1.png").arg(name));
-        if (!filename.isNull())
+        foreach (const QString &location, locations)
         {
-            return (TextureManager::CacheIter)m_p->m_textures.insert(name, QImage(filename, "PNG"));
-        }
-        else
-        {
-            //Try to load from the file in 'skycultures/western' subdirectory for western constellation art
-            QString filename =
-                KSPaths::locate(QStandardPaths::GenericDataLocation, QString("skycultures/western/%1.png").arg(name));
-            if (!filename.isNull())
-            {
-                return (TextureManager::CacheIter)m_p->m_textures.insert(name, QImage(filename, "PNG"));
-            }
-            else
+            QDir dir(location + subdir);
+            foreach (const QString &file,
+                     dir.entryList(QStringList("*.png"), QDir::Files | QDir::Readable | QDir::CaseSensitive))
             {
-                //Try to load from the file in 'skycultures/inuit' subdirectory for Inuit constellation art
-                QString filename =
-                    KSPaths::locate(QStandardPaths::GenericDataLocation, QString("skycultures/inuit/%1.png").arg(name));
-                if (!filename.isNull())
-                {
-                    return (TextureManager::CacheIter)m_p->m_textures.insert(name, QImage(filename, "PNG"));
-                }
-                else
-                {
-                    // Try to load from file in main data directory
-
-                    filename = KSPaths::locate(QStandardPaths::GenericDataLocation, QString("%1.png").arg(name));
-                    if (!filename.isNull())
-                    {
-                        return (TextureManager::CacheIter)m_p->m_textures.insert(name, QImage(filename, "PNG"));
-                    }
-                    else
-                    {
-                        return m_p->m_textures.constEnd();
-                    }
-                }
+                QString name = file.left(file.length() - 4);
+                if (!m_files.contains(name))
+                    m_files.insert(name, dir.filePath(file));
             }
         }
     }
@@ -138,9 +175,9 @@ void TextureManager::bindTexture(const QString &name, QGLWidget *cxt)
     Create();
     Q_ASSERT("Must be called only with valid GL context" && cxt);
 
-    CacheIter it = findTexture(name);
-    if (it != m_p->m_textures.constEnd())
-        bindImage(*it, cxt);
+    QImage image = getImage(name);
+    if (!image.isNull())
+        bindImage(image, cxt);
 }
 
 void TextureManager::bindFromImage(const QImage &image, QGLWidget *cxt)
@@ -167,6 +204,14 @@ void TextureManager::bindFromImage(const QImage &image, QGLWidget *cxt)
 }
 #endif
 
-TextureManager::TextureManager(QObject *parent) : QObject(parent)
+TextureManager::TextureManager(QObject *parent) : QObject(parent), m_textures(CacheBudget)
+{
+    // Leave most threads to the computations of the sky map
+    m_decoders.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+    indexTextures();
+}
+
+TextureManager::~TextureManager()
 {
+    m_decoders.waitForDone();
 }
@@ -19,21 +19,32 @@
 
 #pragma once
 
-#include <QObject>
+#include <QCache>
 #include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QThreadPool>
 
 #include <config-kstars.h>
 
 class QGLWidget;
-class QImage;
 
 /**
  * @brief a singleton class to manage texture loading/retrieval
+ *
+ * The texture directories are listed once, when the manager is created, so that a name without an image is
+ * known without looking at the disk. Decoded images are kept in a cache of limited size, the least recently used
+ * dropped first. The draw path requests images with requestImage(), which decodes them on threads of the manager.
  */
 class TextureManager : public QObject
 {
     Q_OBJECT
   public:
+    /** Size of the decoded images kept in the cache, in kB */
+    static const int CacheBudget = 128 * 1024;
+
     /** @short Create the instance of TextureManager */
     static TextureManager *Create();
     /** @short Release the instance of TextureManager */
@@ -41,9 +52,16 @@ class TextureManager : public QObject
 
     /**
      * Return texture image. If image is not found in cache tries to
-     * load it from disk if that fails too returns reference to empty image.
+     * load it from disk if that fails too returns an empty image.
+     */
+    static QImage getImage(const QString &name);
+
+    /**
+     * @short Return texture image if it is in the cache, or start decoding it in the background
+     * @param pending set to true if the image is being decoded. imageLoaded() is emitted once it is.
+     * @return the image, or an empty image if it is being decoded or if there is no such image
      */
-    static const QImage &getImage(const QString &name);
+    static QImage requestImage(const QString &name, bool *pending = nullptr);
 
 #ifdef HAVE_OPENGL
     /**
@@ -56,19 +74,31 @@ class TextureManager : public QObject
     static void bindFromImage(const QImage &image, QGLWidget *cxt);
 #endif
 
-  private:
-    /** Shorthand for iterator to hashtable */
-    typedef QHash<QString, QImage>::const_iterator CacheIter;
+  signals:
+    /** @short An image requested with requestImage() was decoded */
+    void imageLoaded(const QString &name);
 
+  private:
     /** Private constructor */
     explicit TextureManager(QObject *parent = 0);
-    /** Try find image in the cache and then to load it from disk if it's not found */
-    static CacheIter findTexture(const QString &name);
+    ~TextureManager();
+
+    /** @short List the images of the texture directories */
+    void indexTextures();
+
+    /** @short Decode an image and cache it. The mutex is not held. */
+    QImage decode(const QString &name, const QString &filename);
 
     // Pointer to singleton instance
     static TextureManager *m_p;
-    // List of named textures
-    QHash<QString, QImage> m_textures;
+    // Decoded images, with their size in kB as cost
+    QCache<QString, QImage> m_textures;
+    // Image file of each texture name
+    QHash<QString, QString> m_files;
+    // Names decoded in the background
+    QSet<QString> m_pending;
+    QMutex m_mutex;
+    QThreadPool m_decoders;
 
     // Prohibit copying
     TextureManager(const TextureManager &);
@@ -31,8 +31,10 @@
 #include "skyobjects/starobject.h"
 #include "widgets/dmsbox.h"
 #include "widgets/magnitudespinbox.h"
+#include "skycomponents/asteroidscomponent.h"
 #include "skycomponents/constellationboundarylines.h"
 #include "skycomponents/skymapcomposite.h"
+#include "skycomponents/solarsystemcomposite.h"
 
 ObsListWizardUI::ObsListWizardUI(QWidget *p) : QFrame(p)
 {
@@ -134,7 +136,7 @@ void ObsListWizard::initialize()
     ObjectCount   = 0;                                        //number of objects in observing list
     StarCount     = data->skyComposite()->stars().size();     //total number of stars
     PlanetCount   = 10;                                       //Sun, Moon, 8 planets
-    AsteroidCount = data->skyComposite()->asteroids().size(); //total number of asteroids
+    AsteroidCount = data->skyComposite()->objectNames(SkyObject::ASTEROID).size(); //total number of asteroids
     CometCount    = data->skyComposite()->comets().size();    //total number of comets
     //DeepSkyObjects
     OpenClusterCount = 0;
@@ -777,6 +779,8 @@ void ObsListWizard::applyFilters(bool doBuildList)
     //Asteroids
     if (isItemSelected(i18n("Asteroids"), olw->TypeList))
     {
+        // Asteroids fainter than the sky map are only created when asked for
+        data->skyComposite()->solarSystemComposite()->asteroidsComponent()->createToMag(maglimit);
         foreach (SkyObject *o, data->skyComposite()->asteroids())
         {
             if (olw->SelectByMagnitude->isChecked())
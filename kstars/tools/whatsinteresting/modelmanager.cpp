@@ -15,13 +15,17 @@
  *                                                                         *
  ***************************************************************************/
 
+#include "asteroidscomponent.h"
 #include "ksfilereader.h"
 #include "modelmanager.h"
 #include "kstarsdatetime.h"
 #include "skymapcomposite.h"
 #include "skyobject.h"
+#include "solarsystemcomposite.h"
 #include <QtConcurrent>
 
+#include <limits>
+
 ModelManager::ModelManager(ObsConditions *obs)
 {
     m_ObsConditions = obs;
@@ -41,6 +45,11 @@ ModelManager::ModelManager(ObsConditions *obs)
         m_ObjectList.append(QList<SkyObjItem *>());
     }
 
+    // Asteroids fainter than the sky map are only created when asked for. They are created here, as the lists are
+    // loaded in another thread.
+    KStarsData::Instance()->skyComposite()->solarSystemComposite()->asteroidsComponent()->createToMag(
+        std::numeric_limits<double>::infinity());
+
     QtConcurrent::run(this, &ModelManager::loadLists);
 }
 
@@ -37,7 +37,9 @@
 #include "dialogs/timedialog.h"
 #include "skyobjects/kssun.h"
 #include "skyobjects/ksmoon.h"
+#include "skycomponents/asteroidscomponent.h"
 #include "skycomponents/skymapcomposite.h"
+#include "skycomponents/solarsystemcomposite.h"
 #include "tools/observinglist.h"
 
 WUTDialogUI::WUTDialogUI(QWidget *p) : QFrame(p)
@@ -314,6 +316,7 @@ void WUTDialog::slotLoadList(const QString &c)
 
         else if (c == m_Categories[6]) //Asteroids
         {
+            data->skyComposite()->solarSystemComposite()->asteroidsComponent()->createToMag(m_Mag);
             foreach (SkyObject *o, data->skyComposite()->asteroids())
                 if (checkVisibility(o) && o->name() != i18n("Pluto") && o->mag() <= m_Mag)
                     visibleObjects(c).append(o);